@@ -128,7 +128,7 @@ void* stage1_mst_worker(void *arg) {
         
         if (success && mst_result.is_connected) {
             snprintf(job->mst_result, sizeof(job->mst_result),
-                     "MST: Weight=%d, Edges=%d", 
+                     "MST: Weight=%lld, Edges=%d", 
                      mst_result.total_weight, mst_result.num_edges);
             mst_result_free(&mst_result);
         } else {
@@ -156,12 +156,12 @@ void* stage2_maxflow_worker(void *arg) {
         
         printf("[Stage 2] Processing Job %d - MaxFlow Algorithm\n", job->job_id);
         
-        int flow_value;
+        long long flow_value;
         int success = graph_max_flow_default(job->graph, &flow_value);
         
         if (success) {
             snprintf(job->maxflow_result, sizeof(job->maxflow_result),
-                     "MaxFlow: Value=%d (source=0, sink=%d)", 
+                     "MaxFlow: Value=%lld (source=0, sink=%d)", 
                      flow_value, job->graph->n - 1);
         } else {
             snprintf(job->maxflow_result, sizeof(job->maxflow_result),
@@ -219,12 +219,12 @@ void* stage4_cliquecount_worker(void *arg) {
         
         printf("[Stage 4] Processing Job %d - CliqueCount Algorithm\n", job->job_id);
         
-        int total_cliques;
+        long long total_cliques;
         int success = graph_total_clique_count(job->graph, &total_cliques);
         
         if (success) {
             snprintf(job->cliquecount_result, sizeof(job->cliquecount_result),
-                     "CliqueCount: Total=%d", total_cliques);
+                     "CliqueCount: Total=%lld", total_cliques);
         } else {
             snprintf(job->cliquecount_result, sizeof(job->cliquecount_result),
                      "CliqueCount: Calculation failed");
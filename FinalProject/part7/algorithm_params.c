@@ -0,0 +1,76 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include "algorithm_params.h"
+#include <stddef.h>
+#include <time.h>
+
+#define BUDGET_CHECK_INTERVAL 256
+
+void algorithm_params_init(AlgorithmParams* params) {
+    if (!params) return;
+    params->source = -1;
+    params->sink = -1;
+    params->clique_size = 0;
+    params->time_budget_ms = 0;
+    params->num_threads = 1;
+    params->variant = ALGO_VARIANT_AUTO;
+    params->order = 0;
+    params->original_ids = NULL;
+}
+
+void algorithm_params_decode(AlgorithmParams* params, const int* words) {
+    algorithm_params_init(params);
+    if (!params || !words) return;
+
+    params->source = words[0] >= 0 ? words[0] : -1;
+    params->sink = words[1] >= 0 ? words[1] : -1;
+    params->clique_size = words[2] > 0 ? words[2] : 0;
+    params->time_budget_ms = words[3] > 0 ? words[3] : 0;
+    if (words[4] > 1) {
+        params->num_threads = words[4] < ALGO_PARAMS_MAX_THREADS ? words[4] : ALGO_PARAMS_MAX_THREADS;
+    }
+    if (words[5] > ALGO_VARIANT_AUTO && words[5] < ALGO_VARIANT_COUNT) {
+        params->variant = words[5];
+    }
+}
+
+void algorithm_params_encode(const AlgorithmParams* params, int* words) {
+    if (!params || !words) return;
+    words[0] = params->source;
+    words[1] = params->sink;
+    words[2] = params->clique_size;
+    words[3] = params->time_budget_ms;
+    words[4] = params->num_threads;
+    words[5] = params->variant;
+}
+
+int algorithm_params_flow_endpoints(const AlgorithmParams* params, int n,
+                                    int* source, int* sink) {
+    *source = (params && params->source >= 0) ? params->source : 0;
+    *sink = (params && params->sink >= 0) ? params->sink : n - 1;
+    return *source < n && *sink < n && *source != *sink;
+}
+
+static long long monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void search_budget_init(SearchBudget* budget, int budget_ms) {
+    if (!budget) return;
+    budget->deadline_ns = budget_ms > 0 ? monotonic_ns() + (long long)budget_ms * 1000000LL : 0;
+    budget->checks = 0;
+    budget->expired = 0;
+}
+
+int search_budget_expired(SearchBudget* budget) {
+    if (!budget || budget->deadline_ns == 0) return 0;
+    if (budget->expired) return 1;
+    if (++budget->checks < BUDGET_CHECK_INTERVAL) return 0;
+
+    budget->checks = 0;
+    if (monotonic_ns() >= budget->deadline_ns) budget->expired = 1;
+    return budget->expired;
+}
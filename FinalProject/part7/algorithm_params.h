@@ -0,0 +1,104 @@
+#ifndef ALGORITHM_PARAMS_H
+#define ALGORITHM_PARAMS_H
+
+/**
+ * @file algorithm_params.h
+ * Typed parameter block passed to the algorithm strategies, its wire format,
+ * and the time budget helper used by the exponential searches.
+ */
+
+/**
+ * Implementation variants. AUTO lets the dispatch layer pick one from the
+ * graph profile and the cost model; any other value forces that variant
+ * (and is ignored by algorithms it does not belong to).
+ */
+typedef enum {
+    ALGO_VARIANT_AUTO = 0,
+    ALGO_VARIANT_PRIM_MATRIX,       // Prim over an n x n weight matrix
+    ALGO_VARIANT_PRIM_LIST,         // Prim over the adjacency lists
+    ALGO_VARIANT_EDMONDS_KARP,      // BFS augmenting paths
+    ALGO_VARIANT_DINIC,             // Level graph + blocking flow
+    ALGO_VARIANT_CLIQUE_BACKTRACK,  // Plain backtracking
+    ALGO_VARIANT_CLIQUE_COLORING,   // Branch and bound with a coloring bound
+    ALGO_VARIANT_RADIX_HEAP,        // Dijkstra with a radix heap
+    ALGO_VARIANT_DELTA_STEPPING,    // Parallel bucketed relaxation
+    ALGO_VARIANT_COLOR_SMALLEST_LAST, // Greedy coloring in smallest-last order
+    ALGO_VARIANT_COLOR_DSATUR,      // Greedy coloring by saturation degree
+    ALGO_VARIANT_COLOR_JONES_PLASSMANN, // Parallel rounds of independent vertices
+    ALGO_VARIANT_COUNT
+} AlgorithmVariant;
+
+/**
+ * Per-request algorithm parameters. Fields left at their defaults keep the
+ * historical behavior (flow 0 -> n-1, all clique sizes, no limits).
+ */
+typedef struct {
+    int source;          // Max flow / shortest path source (-1 = vertex 0)
+    int sink;            // Max flow sink (-1 = vertex n-1)
+    int clique_size;     // Count only cliques of this size (0 = all sizes)
+    int time_budget_ms;  // Stop clique searches after this long (0 = no limit)
+    int num_threads;     // Threads an algorithm may use (0 or 1 = single-threaded)
+    int variant;         // AlgorithmVariant to force (ALGO_VARIANT_AUTO = choose)
+    int order;           // GraphOrder to relabel the graph with first (GRAPH_ORDER_NONE = as sent)
+    const int* original_ids; // While running on a relabeled copy: client id of each vertex
+} AlgorithmParams;
+
+/*
+ * Wire format. A client sets ALGO_PARAMS_FLAG on the algorithm id (part7/part8
+ * servers) or on the vertex count (part9 pipeline) and sends
+ * ALGO_PARAMS_WIRE_INTS ints right after that field:
+ *   [source][sink][clique_size][time_budget_ms][num_threads][variant]
+ * order and original_ids are local settings and are not sent.
+ */
+#define ALGO_PARAMS_FLAG      0x100
+#define ALGO_PARAMS_WIRE_INTS 6
+#define ALGO_PARAMS_MAX_THREADS 64
+
+/**
+ * Fill @p params with the defaults.
+ */
+void algorithm_params_init(AlgorithmParams* params);
+
+/**
+ * Decode a parameter block received from the network.
+ * Out-of-range values are clamped to the defaults.
+ * @param params OUT: decoded parameters.
+ * @param words ALGO_PARAMS_WIRE_INTS ints in wire order.
+ */
+void algorithm_params_decode(AlgorithmParams* params, const int* words);
+
+/**
+ * Encode a parameter block for sending.
+ * @param params Parameters to encode.
+ * @param words OUT: ALGO_PARAMS_WIRE_INTS ints in wire order.
+ */
+void algorithm_params_encode(const AlgorithmParams* params, int* words);
+
+/**
+ * Resolve the flow endpoints for a graph with @p n vertices.
+ * @return 1 if both endpoints are valid and distinct, 0 otherwise.
+ */
+int algorithm_params_flow_endpoints(const AlgorithmParams* params, int n,
+                                    int* source, int* sink);
+
+/**
+ * Wall-clock deadline for a search. The clock is only read every few
+ * hundred checks, so calling search_budget_expired() per search node is cheap.
+ */
+typedef struct {
+    long long deadline_ns;   // Absolute CLOCK_MONOTONIC deadline, 0 = none
+    unsigned int checks;     // Calls since the last clock read
+    int expired;             // Sticky once the deadline has passed
+} SearchBudget;
+
+/**
+ * Start a budget of @p budget_ms milliseconds from now (0 = unlimited).
+ */
+void search_budget_init(SearchBudget* budget, int budget_ms);
+
+/**
+ * @return 1 once the deadline has passed, 0 otherwise (always 0 for NULL).
+ */
+int search_budget_expired(SearchBudget* budget);
+
+#endif /* ALGORITHM_PARAMS_H */
@@ -3,24 +3,48 @@
 #include "mst.h"
 #include "maxclique.h"
 #include "cliquecount.h"
+#include "sssp.h"
+#include "bfs.h"
+#include "weightclique.h"
+#include "coloring.h"
+#include "graph_alloc.h"
+#include "cost_model.h"
+#include "graph_reorder.h"
+#include "strategy_plugin.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
+
+/**
+ * Vertex id as the client sent it; strategies may run on a relabeled copy.
+ */
+static int original_vertex(const AlgorithmParams* params, int v) {
+    return params && params->original_ids ? params->original_ids[v] : v;
+}
+
+static int compare_ints(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
 
 /**
  * Concrete Strategy Implementations
  */
 
-static char* euler_strategy_execute(const Graph* g) {
+static char* euler_strategy_execute(const Graph* g, const AlgorithmParams* params,
+                                    AlgorithmWorkspace* ws) {
+    (void)params;
+    (void)ws; // Hierholzer works on the adjacency lists directly
     char* result = (char*)malloc(256);
     if (!result) return NULL;
     
     if (graph_has_euler_circuit(g)) {
         int* cycle = NULL;
-        int len = 0;
+        long long len = 0;
         if (graph_find_euler_circuit(g, &cycle, &len)) {
-            snprintf(result, 256, "Euler circuit found (length: %d)", len);
-            free(cycle);
+            snprintf(result, 256, "Euler circuit found (length: %lld)", len);
+            GRAPH_FREE(cycle);
         } else {
             snprintf(result, 256, "Euler circuit exists but extraction failed");
         }
@@ -30,28 +54,39 @@ static char* euler_strategy_execute(const Graph* g) {
     return result;
 }
 
-static char* maxflow_strategy_execute(const Graph* g) {
+static char* maxflow_strategy_execute(const Graph* g, const AlgorithmParams* params,
+                                      AlgorithmWorkspace* ws) {
     char* result = (char*)malloc(256);
     if (!result) return NULL;
     
-    int flow_value;
-    if (graph_max_flow_default(g, &flow_value)) {
-        snprintf(result, 256, "Max flow is: %d", flow_value);
+    long long flow_value;
+    int source, sink;
+    if (!algorithm_params_flow_endpoints(params, g->n, &source, &sink)) {
+        snprintf(result, 256, "Max flow calculation failed (invalid source/sink)");
+    } else if (graph_max_flow_with_params(g, params, &flow_value, ws)) {
+        source = original_vertex(params, source);
+        sink = original_vertex(params, sink);
+        if (source == 0 && sink == g->n - 1) {
+            snprintf(result, 256, "Max flow is: %lld", flow_value);
+        } else {
+            snprintf(result, 256, "Max flow from %d to %d is: %lld", source, sink, flow_value);
+        }
     } else {
         snprintf(result, 256, "Max flow calculation failed");
     }
     return result;
 }
 
-static char* mst_strategy_execute(const Graph* g) {
+static char* mst_strategy_execute(const Graph* g, const AlgorithmParams* params,
+                                  AlgorithmWorkspace* ws) {
     char* result = (char*)malloc(1024);  
     if (!result) return NULL;
     MST_Result mst_result;
-    if (graph_mst_prim(g, &mst_result)) {
+    if (graph_mst_with_params(g, params, &mst_result, ws)) {
         if (mst_result.is_connected) {
             int offset = 0;
             offset += snprintf(result + offset, 1024 - offset, 
-                             "MST weight: %d, Edges: ", mst_result.total_weight);
+                             "MST weight: %lld, Edges: ", mst_result.total_weight);
             
             for (int i = 0; i < mst_result.num_edges; i++) {
                 if (i > 0) {
@@ -59,8 +94,8 @@ static char* mst_strategy_execute(const Graph* g) {
                 }
                 offset += snprintf(result + offset, 1024 - offset, 
                                  "%d-%d(%d)", 
-                                 mst_result.edges[i].u, 
-                                 mst_result.edges[i].v,
+                                 original_vertex(params, mst_result.edges[i].u), 
+                                 original_vertex(params, mst_result.edges[i].v),
                                  mst_result.edges[i].weight);
                 if (offset >= 1000) {
                     snprintf(result + 1000, 24, "...[truncated]");
@@ -78,45 +113,189 @@ static char* mst_strategy_execute(const Graph* g) {
     return result;
 }
 
-static char* maxclique_strategy_execute(const Graph* g) {
+static char* maxclique_strategy_execute(const Graph* g, const AlgorithmParams* params,
+                                        AlgorithmWorkspace* ws) {
     char* result = (char*)malloc(256);
     if (!result) return NULL;
     
-    int clique_size;
-    if (graph_max_clique_size(g, &clique_size)) {
-        snprintf(result, 256, "Max clique size is: %d", clique_size);
+    MaxClique_Result clique;
+    if (graph_max_clique_with_params(g, params, &clique, ws) && clique.is_valid) {
+        snprintf(result, 256, "Max clique size is: %d%s", clique.size,
+                 clique.timed_out ? " (time budget exceeded, best found)" : "");
+        maxclique_result_free(&clique);
     } else {
         snprintf(result, 256, "Max clique calculation failed");
     }
     return result;
 }
 
-static char* cliquecount_strategy_execute(const Graph* g) {
+static char* cliquecount_strategy_execute(const Graph* g, const AlgorithmParams* params,
+                                          AlgorithmWorkspace* ws) {
     char* result = (char*)malloc(256);
     if (!result) return NULL;
     
-    int total_cliques;
-    if (graph_total_clique_count(g, &total_cliques)) {
-        snprintf(result, 256, "Total cliques count is: %d", total_cliques);
+    CliqueCount_Result counts;
+    if (graph_count_cliques_with_params(g, params, &counts, ws) && counts.is_valid) {
+        const char* partial = counts.timed_out ? " (time budget exceeded, lower bound)" : "";
+        if (params && params->clique_size > 0) {
+            snprintf(result, 256, "Cliques of size %d count is: %lld%s",
+                     params->clique_size, counts.total_cliques, partial);
+        } else {
+            snprintf(result, 256, "Total cliques count is: %lld%s", counts.total_cliques, partial);
+        }
+        clique_count_result_free(&counts);
     } else {
         snprintf(result, 256, "Clique counting failed");
     }
     return result;
 }
 
+/**
+ * Append "v:d" for every vertex to @p result (1024 bytes), in the client's
+ * vertex order. Values come from @p dist, or from @p hops (any per-vertex
+ * int, such as a color) if it is NULL; negative ones are unreachable.
+ */
+static void format_distances(char* result, int offset, const Graph* g,
+                             const AlgorithmParams* params, const long long* dist,
+                             const int* hops) {
+    int* position = NULL;
+    if (params && params->original_ids) {
+        position = (int*)malloc(g->n * sizeof(int));
+        if (position) {
+            for (int v = 0; v < g->n; v++) position[params->original_ids[v]] = v;
+        }
+    }
+    
+    for (int i = 0; i < g->n; i++) {
+        int v = position ? position[i] : i;
+        int client = position ? i : original_vertex(params, v);
+        long long d = dist ? dist[v] : hops[v];
+        if (d < 0) {
+            offset += snprintf(result + offset, 1024 - offset, "%s%d:-", i ? ", " : "", client);
+        } else {
+            offset += snprintf(result + offset, 1024 - offset, "%s%d:%lld", i ? ", " : "",
+                               client, d);
+        }
+        if (offset >= 1000) {
+            snprintf(result + 1000, 24, "...[truncated]");
+            break;
+        }
+    }
+    
+    free(position);
+}
+
+static char* sssp_strategy_execute(const Graph* g, const AlgorithmParams* params,
+                                   AlgorithmWorkspace* ws) {
+    char* result = (char*)malloc(1024);
+    if (!result) return NULL;
+    
+    SSSP_Result paths;
+    if (!graph_sssp_with_params(g, params, &paths, ws)) {
+        snprintf(result, 1024, "Shortest paths calculation failed (invalid source or negative weight)");
+        return result;
+    }
+    
+    int offset = snprintf(result, 1024, "Shortest paths from %d (%d of %d reached): ",
+                          original_vertex(params, paths.source), paths.reached, g->n);
+    format_distances(result, offset, g, params, paths.dist, NULL);
+    sssp_result_free(&paths);
+    return result;
+}
+
+static char* hops_strategy_execute(const Graph* g, const AlgorithmParams* params,
+                                   AlgorithmWorkspace* ws) {
+    char* result = (char*)malloc(1024);
+    if (!result) return NULL;
+    
+    BFS_Result bfs;
+    if (!graph_bfs_with_params(g, params, &bfs, ws)) {
+        snprintf(result, 1024, "Hop distance calculation failed (invalid source)");
+        return result;
+    }
+    
+    int offset = snprintf(result, 1024, "Hop distances from %d (%d of %d reached, depth %d): ",
+                          original_vertex(params, bfs.source), bfs.reached, g->n, bfs.depth);
+    format_distances(result, offset, g, params, NULL, bfs.dist);
+    bfs_result_free(&bfs);
+    return result;
+}
+
+static char* weightclique_strategy_execute(const Graph* g, const AlgorithmParams* params,
+                                           AlgorithmWorkspace* ws) {
+    char* result = (char*)malloc(1024);
+    if (!result) return NULL;
+    
+    WeightClique_Result clique;
+    if (!graph_max_weight_clique_with_params(g, params, &clique, ws) || !clique.is_valid) {
+        snprintf(result, 1024, "Max weight clique calculation failed");
+        return result;
+    }
+    
+    int offset = snprintf(result, 1024, "Max weight clique: weight %lld%s, Vertices: ",
+                          clique.weight,
+                          clique.timed_out ? " (time budget exceeded, best found)" : "");
+    
+    // Client ids in ascending order, so the reply is the same with or without reordering
+    for (int i = 0; i < clique.size; i++) {
+        clique.vertices[i] = original_vertex(params, clique.vertices[i]);
+    }
+    qsort(clique.vertices, clique.size, sizeof(int), compare_ints);
+    for (int i = 0; i < clique.size; i++) {
+        offset += snprintf(result + offset, 1024 - offset, "%s%d", i ? ", " : "",
+                           clique.vertices[i]);
+        if (offset >= 1000) {
+            snprintf(result + 1000, 24, "...[truncated]");
+            break;
+        }
+    }
+    weight_clique_result_free(&clique);
+    return result;
+}
+
+static char* coloring_strategy_execute(const Graph* g, const AlgorithmParams* params,
+                                       AlgorithmWorkspace* ws) {
+    char* result = (char*)malloc(1024);
+    if (!result) return NULL;
+    
+    GraphColoring coloring;
+    if (!graph_color_with_params(g, params, &coloring, ws)) {
+        snprintf(result, 1024, "Graph coloring failed");
+        return result;
+    }
+    
+    int offset = snprintf(result, 1024, "Coloring with %d colors: ", coloring.num_colors);
+    format_distances(result, offset, g, params, NULL, coloring.colors);
+    graph_coloring_free(&coloring);
+    return result;
+}
+
 /**
  * Strategy Registry
  */
 static AlgorithmStrategy strategies[] = {
     {euler_strategy_execute, "euler", "Find Euler Circuit", 1},
-    {maxflow_strategy_execute, "maxflow", "Maximum Flow (Edmonds-Karp)", 2},
+    {maxflow_strategy_execute, "maxflow", "Maximum Flow (Edmonds-Karp/Dinic)", 2},
     {mst_strategy_execute, "mst", "Minimum Spanning Tree (Prim's)", 3},
     {maxclique_strategy_execute, "maxclique", "Maximum Clique", 4},
-    {cliquecount_strategy_execute, "cliquecount", "Count All Cliques", 5}
+    {cliquecount_strategy_execute, "cliquecount", "Count All Cliques", 5},
+    {sssp_strategy_execute, "sssp", "Shortest Paths (Radix Heap/Delta-Stepping)", 6},
+    {hops_strategy_execute, "hops", "Hop Distances (Direction-Optimizing BFS)", 7},
+    {weightclique_strategy_execute, "weightclique", "Maximum Weight Clique", 8},
+    {coloring_strategy_execute, "coloring", "Graph Coloring (Smallest-Last/DSATUR/Jones-Plassmann)", 9}
 };
 
 static const int num_strategies = sizeof(strategies) / sizeof(strategies[0]);
 
+/**
+ * 1 for the built-in table entries and the plugin slots, which are looked
+ * up again by id before running.
+ */
+static int is_registered(const AlgorithmStrategy* strategy) {
+    return (strategy >= strategies && strategy < strategies + num_strategies) ||
+           strategy_plugins_owns(strategy);
+}
+
 /**
  * Algorithm Context Implementation
  */
@@ -125,6 +304,9 @@ void algorithm_context_init(AlgorithmContext* context, const Graph* graph) {
     if (context) {
         context->strategy = NULL;
         context->graph = graph;
+        context->workspace = NULL;
+        context->params = NULL;
+        context->profile = NULL;
     }
 }
 
@@ -134,15 +316,171 @@ void algorithm_context_set_strategy(AlgorithmContext* context, AlgorithmStrategy
     }
 }
 
+void algorithm_context_set_workspace(AlgorithmContext* context, AlgorithmWorkspace* ws) {
+    if (context) {
+        context->workspace = ws;
+    }
+}
+
+void algorithm_context_set_params(AlgorithmContext* context, const AlgorithmParams* params) {
+    if (context) {
+        context->params = params;
+    }
+}
+
+void algorithm_context_set_profile(AlgorithmContext* context, const GraphProfile* profile) {
+    if (context) {
+        context->profile = profile;
+    }
+}
+
+/**
+ * Variant Dispatch
+ */
+
+static pthread_once_t cost_model_once = PTHREAD_ONCE_INIT;
+
+static void load_cost_model_from_env(void) {
+    const char* path = getenv("GRAPH_COST_MODEL");
+    if (!path || !*path) return;
+    
+    int loaded = cost_model_load(path);
+    if (loaded < 0) {
+        printf("Strategy: Could not read cost model '%s', using built-in defaults\n", path);
+    } else {
+        printf("Strategy: Loaded %d variant model(s) from '%s'\n", loaded, path);
+    }
+}
+
+/**
+ * Relabeling
+ */
+
+static pthread_once_t default_order_once = PTHREAD_ONCE_INIT;
+static GraphOrder default_order = GRAPH_ORDER_NONE;
+
+static void load_default_order_from_env(void) {
+    const char* name = getenv("GRAPH_REORDER");
+    if (!name || !*name) return;
+    
+    if (graph_order_parse(name, &default_order)) {
+        printf("Strategy: Relabeling graphs in '%s' order\n", name);
+    } else {
+        printf("Strategy: Unknown vertex order '%s', keeping client ids\n", name);
+    }
+}
+
+/**
+ * Run @p strategy on a copy of @p g relabeled in params->order, with the
+ * flow endpoints translated to the copy and params->original_ids set so the
+ * strategy reports client ids.
+ * @return 1 if it ran (*result set), 0 if the copy could not be built.
+ */
+static int execute_relabeled(AlgorithmStrategy* strategy, const Graph* g, AlgorithmParams* params,
+                             AlgorithmWorkspace* ws, char** result) {
+    GraphReordering reordering;
+    if (!graph_reordering_compute(g, (GraphOrder)params->order, &reordering)) return 0;
+    
+    Graph* relabeled = graph_reordering_apply(g, &reordering);
+    if (!relabeled) {
+        graph_reordering_free(&reordering);
+        return 0;
+    }
+    
+    // Defaults are positions (vertex n-1), so resolve them on the client's ids.
+    // Each endpoint on its own: shortest paths use only the source.
+    int source = params->source >= 0 ? params->source : 0;
+    int sink = params->sink >= 0 ? params->sink : g->n - 1;
+    if (source < g->n) params->source = reordering.new_id[source];
+    if (sink < g->n) params->sink = reordering.new_id[sink];
+    params->original_ids = reordering.old_id;
+    
+    *result = strategy->execute(relabeled, params, ws);
+    
+    graph_destroy(relabeled);
+    graph_reordering_free(&reordering);
+    return 1;
+}
+
+int algorithm_select_variant(int algorithm_id, const GraphProfile* profile, int requested) {
+    if (requested != ALGO_VARIANT_AUTO && cost_model_variant_algorithm(requested) == algorithm_id) {
+        return requested;
+    }
+    
+    pthread_once(&cost_model_once, load_cost_model_from_env);
+    
+    int best = ALGO_VARIANT_AUTO;
+    double best_ns = 0.0;
+    for (int v = ALGO_VARIANT_AUTO + 1; v < ALGO_VARIANT_COUNT; v++) {
+        if (cost_model_variant_algorithm(v) != algorithm_id) continue;
+        
+        // Without a profile keep the first (historical) implementation
+        if (!profile) return v;
+        
+        double ns = cost_model_estimate_ns(v, profile);
+        if (best == ALGO_VARIANT_AUTO || ns < best_ns) {
+            best = v;
+            best_ns = ns;
+        }
+    }
+    return best;
+}
+
 char* algorithm_context_execute(AlgorithmContext* context) {
     if (!context || !context->strategy || !context->graph) {
         return NULL;
     }
     
-    return context->strategy->execute(context->graph);
+    // Resolve the variant here so strategies only ever see a concrete one
+    AlgorithmParams resolved;
+    if (context->params) {
+        resolved = *context->params;
+    } else {
+        algorithm_params_init(&resolved);
+    }
+    
+    int id = context->strategy->id;
+    if (cost_model_variant_algorithm(resolved.variant) != id) {
+        GraphProfile profile;
+        const GraphProfile* p = context->profile;
+        if (!p && algorithm_select_variant(id, NULL, ALGO_VARIANT_AUTO) != ALGO_VARIANT_AUTO &&
+            graph_profile_compute(context->graph, &profile)) {
+            p = &profile;
+        }
+        resolved.variant = algorithm_select_variant(id, p, ALGO_VARIANT_AUTO);
+        if (resolved.variant != ALGO_VARIANT_AUTO) {
+            printf("Strategy: Selected variant '%s'\n", cost_model_variant_name(resolved.variant));
+        }
+    } else {
+        printf("Strategy: Using requested variant '%s'\n", cost_model_variant_name(resolved.variant));
+    }
+    
+    // Relabel into a cache-friendly order first when asked (or set by GRAPH_REORDER)
+    pthread_once(&default_order_once, load_default_order_from_env);
+    if (resolved.order == GRAPH_ORDER_NONE) resolved.order = default_order;
+    resolved.original_ids = NULL;
+    
+    // Run whatever is registered for the id now: a reload may have replaced
+    // the plugin the context was set up with, and must wait until we finish
+    strategy_plugins_poll();
+    strategy_plugins_read_lock();
+    AlgorithmStrategy* strategy = context->strategy;
+    if (is_registered(strategy)) {
+        strategy = strategy_plugins_lookup(id);
+        if (!strategy) strategy = algorithm_get_builtin_strategy(id);
+        if (!strategy) strategy = context->strategy;
+    }
+    
+    char* result;
+    if (resolved.order == GRAPH_ORDER_NONE ||
+        !execute_relabeled(strategy, context->graph, &resolved, context->workspace, &result)) {
+        result = strategy->execute(context->graph, &resolved, context->workspace);
+    }
+    strategy_plugins_read_unlock();
+    return result;
 }
 
-AlgorithmStrategy* algorithm_get_strategy(int algorithm_id) {
+AlgorithmStrategy* algorithm_get_builtin_strategy(int algorithm_id) {
     for (int i = 0; i < num_strategies; i++) {
         if (strategies[i].id == algorithm_id) {
             return &strategies[i];
@@ -151,9 +489,23 @@ AlgorithmStrategy* algorithm_get_strategy(int algorithm_id) {
     return NULL;
 }
 
+AlgorithmStrategy* algorithm_get_strategy(int algorithm_id) {
+    strategy_plugins_init();
+    strategy_plugins_read_lock();
+    AlgorithmStrategy* plugin = strategy_plugins_lookup(algorithm_id);
+    strategy_plugins_read_unlock();
+    return plugin ? plugin : algorithm_get_builtin_strategy(algorithm_id);
+}
+
 AlgorithmStrategy* algorithm_get_strategy_by_name(const char* algorithm_name) {
     if (!algorithm_name) return NULL;
     
+    strategy_plugins_init();
+    strategy_plugins_read_lock();
+    AlgorithmStrategy* plugin = strategy_plugins_lookup_by_name(algorithm_name);
+    strategy_plugins_read_unlock();
+    if (plugin) return plugin;
+    
     for (int i = 0; i < num_strategies; i++) {
         if (strcmp(strategies[i].name, algorithm_name) == 0) {
             return &strategies[i];
@@ -162,29 +514,58 @@ AlgorithmStrategy* algorithm_get_strategy_by_name(const char* algorithm_name) {
     return NULL;
 }
 
-AlgorithmStrategy** algorithm_get_all_strategies(int* count) {
-    if (count) {
-        *count = num_strategies;
-    }
-    
-    AlgorithmStrategy** result = (AlgorithmStrategy**)malloc(num_strategies * sizeof(AlgorithmStrategy*));
-    if (!result) return NULL;
+/**
+ * Built-in strategies with plugin overrides applied, then the plugin-only
+ * ones. Caller holds the plugin read lock.
+ */
+static int collect_strategies(AlgorithmStrategy** out) {
+    AlgorithmStrategy* plugins[STRATEGY_PLUGIN_MAX_STRATEGIES];
+    int num_plugins = strategy_plugins_list(plugins, STRATEGY_PLUGIN_MAX_STRATEGIES);
     
+    int count = 0;
     for (int i = 0; i < num_strategies; i++) {
-        result[i] = &strategies[i];
+        AlgorithmStrategy* plugin = strategy_plugins_lookup(strategies[i].id);
+        out[count++] = plugin ? plugin : &strategies[i];
+    }
+    for (int i = 0; i < num_plugins; i++) {
+        if (!algorithm_get_builtin_strategy(plugins[i]->id)) {
+            out[count++] = plugins[i];
+        }
     }
+    return count;
+}
+
+AlgorithmStrategy** algorithm_get_all_strategies(int* count) {
+    AlgorithmStrategy** result = (AlgorithmStrategy**)malloc(
+        (num_strategies + STRATEGY_PLUGIN_MAX_STRATEGIES) * sizeof(AlgorithmStrategy*));
+    if (!result) return NULL;
+    
+    strategy_plugins_init();
+    strategy_plugins_read_lock();
+    int total = collect_strategies(result);
+    strategy_plugins_read_unlock();
     
+    if (count) {
+        *count = total;
+    }
     return result;
 }
 
 void algorithm_print_strategies(void) {
+    AlgorithmStrategy* all[sizeof(strategies) / sizeof(strategies[0]) + STRATEGY_PLUGIN_MAX_STRATEGIES];
+    
+    strategy_plugins_init();
+    strategy_plugins_read_lock();
+    int total = collect_strategies(all);
     printf("Available Algorithm Strategies:\n");
-    for (int i = 0; i < num_strategies; i++) {
-        printf("  %d. %-12s - %s\n", 
-               strategies[i].id, 
-               strategies[i].name, 
-               strategies[i].description);
+    for (int i = 0; i < total; i++) {
+        printf("  %d. %-12s - %s%s\n", 
+               all[i]->id, 
+               all[i]->name, 
+               all[i]->description,
+               strategy_plugins_owns(all[i]) ? " (plugin)" : "");
     }
+    strategy_plugins_read_unlock();
 }
 
 char* algorithm_execute_by_id(const Graph* graph, int algorithm_id) {
@@ -2,6 +2,9 @@
 #define ALGORITHM_STRATEGY_H
 
 #include "graph.h"
+#include "workspace.h"
+#include "algorithm_params.h"
+#include "graph_profile.h"
 
 /**
  * @file algorithm_strategy.h
@@ -12,9 +15,12 @@
  */
 
 /**
- * Algorithm Strategy function pointer type
+ * Algorithm Strategy function pointer type.
+ * @p params carries per-request parameters; NULL means the defaults.
+ * @p ws supplies scratch memory; NULL means a temporary workspace per call.
  */
-typedef char* (*AlgorithmExecuteFunc)(const Graph* g);
+typedef char* (*AlgorithmExecuteFunc)(const Graph* g, const AlgorithmParams* params,
+                                      AlgorithmWorkspace* ws);
 
 /**
  * Algorithm Strategy structure
@@ -32,6 +38,9 @@ typedef struct {
 typedef struct {
     AlgorithmStrategy* strategy;   // Current strategy
     const Graph* graph;           // Graph to operate on
+    AlgorithmWorkspace* workspace; // Scratch memory (NULL = per-call)
+    const AlgorithmParams* params; // Request parameters (NULL = defaults)
+    const GraphProfile* profile;   // Profile of graph (NULL = computed on demand)
 } AlgorithmContext;
 
 /**
@@ -50,6 +59,44 @@ void algorithm_context_init(AlgorithmContext* context, const Graph* graph);
  */
 void algorithm_context_set_strategy(AlgorithmContext* context, AlgorithmStrategy* strategy);
 
+/**
+ * Set the workspace the strategy takes its scratch memory from.
+ * 
+ * @param context Algorithm context
+ * @param ws Workspace owned by the caller (one per thread), or NULL
+ */
+void algorithm_context_set_workspace(AlgorithmContext* context, AlgorithmWorkspace* ws);
+
+/**
+ * Set the parameters passed to the strategy.
+ * 
+ * @param context Algorithm context
+ * @param params Parameters owned by the caller, or NULL for defaults
+ */
+void algorithm_context_set_params(AlgorithmContext* context, const AlgorithmParams* params);
+
+/**
+ * Set the profile used to choose an algorithm variant. Callers that profile
+ * the graph when it is loaded pass it here to avoid profiling per request.
+ * 
+ * @param context Algorithm context
+ * @param profile Profile of the context's graph, or NULL
+ */
+void algorithm_context_set_profile(AlgorithmContext* context, const GraphProfile* profile);
+
+/**
+ * Choose the implementation variant for an algorithm.
+ * A @p requested variant that belongs to the algorithm wins; otherwise the
+ * variant with the lowest cost model estimate for @p profile is returned.
+ * The cost model is loaded once from $GRAPH_COST_MODEL when it is set.
+ * 
+ * @param algorithm_id Strategy ID
+ * @param profile Graph profile, or NULL (selects the historical default)
+ * @param requested Variant asked for by the client, or ALGO_VARIANT_AUTO
+ * @return Variant to run, or ALGO_VARIANT_AUTO if the algorithm has none
+ */
+int algorithm_select_variant(int algorithm_id, const GraphProfile* profile, int requested);
+
 /**
  * Execute current algorithm strategy.
  * 
@@ -59,13 +106,23 @@ void algorithm_context_set_strategy(AlgorithmContext* context, AlgorithmStrategy
 char* algorithm_context_execute(AlgorithmContext* context);
 
 /**
- * Get strategy by algorithm ID.
+ * Get strategy by algorithm ID. A loaded plugin (strategy_plugin.h) with
+ * the same ID takes precedence over the built-in strategy.
  * 
- * @param algorithm_id Algorithm ID (1-5)
+ * @param algorithm_id Algorithm ID (1-9, or a plugin's ID)
  * @return Strategy pointer, or NULL if not found
  */
 AlgorithmStrategy* algorithm_get_strategy(int algorithm_id);
 
+/**
+ * Get the built-in strategy for an ID, ignoring plugins. Safe to call from
+ * plugin code, e.g. to fall back on the original implementation.
+ * 
+ * @param algorithm_id Algorithm ID (1-9)
+ * @return Strategy pointer, or NULL if not found
+ */
+AlgorithmStrategy* algorithm_get_builtin_strategy(int algorithm_id);
+
 /**
  * Get strategy by algorithm name.
  * 
@@ -0,0 +1,928 @@
+/*
+** bench.c -- benchmark harness for the part7 graph algorithms
+**
+** Runs every algorithm over parameterized graph families and sizes with
+** warmup and repetitions, prints a summary table and writes machine-readable
+** JSON (one result object per line) for later comparison.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "graph.h"
+#include "mst.h"
+#include "maxflow.h"
+#include "maxclique.h"
+#include "cliquecount.h"
+#include "perfcounters.h"
+#include "graph_alloc.h"
+#include "graph_profile.h"
+#include "cost_model.h"
+#include "bitgraph.h"
+#include "simd_kernels.h"
+#include "graph_reorder.h"
+#include "components.h"
+#include "sssp.h"
+#include "bfs.h"
+#include "weightclique.h"
+#include "coloring.h"
+
+#define MAX_LIST 32
+#define DEFAULT_ALGOS    "euler,maxflow,mst,maxclique,cliquecount,triangles"
+#define DEFAULT_FAMILIES "random,sparse,grid,cycle"
+#define DEFAULT_SIZES    "16,32,64"
+
+/* Defaults for -C: every variant over families that spread the work estimates */
+#define CALIBRATE_ALGOS    "mst,mst-list,maxflow,maxflow-dinic,maxclique,maxclique-color"
+#define CALIBRATE_FAMILIES "random,sparse,grid,cycle"
+#define CALIBRATE_SIZES    "16,24,32,48,64,96,128,192,256"
+#define MAX_CALIBRATION    (MAX_LIST * MAX_LIST)
+
+/**
+ * Benchmark configuration (filled from the command line).
+ */
+typedef struct {
+    const char* algos[MAX_LIST];
+    int num_algos;
+    const char* families[MAX_LIST];
+    int num_families;
+    int sizes[MAX_LIST];
+    int num_sizes;
+    int warmup;          // Untimed runs before measuring
+    int reps;            // Timed repetitions
+    int seed;            // Base seed for graph generation
+    int max_weight;      // Edge weights are drawn from 1..max_weight
+    double density;      // Edge probability for the "random" family
+    int exp_cap;         // Largest n for exponential algorithms (cliques)
+    int hw_counters;     // 1 to record hardware performance counters
+    int alloc_profile;   // 1 to record allocations per call
+    int reuse_workspace; // 1 to keep one workspace across calls
+    int no_bitgraph;     // 1 to disable the small-graph bitset kernels
+    const char* simd;    // SIMD level to cap the kernels at (-S), NULL for the CPU's
+    GraphOrder order;    // Relabel every graph in this order before timing (-R)
+    const char* calibrate_path; // Fit the cost model and write it here (-C)
+    const char* out_path;
+} BenchConfig;
+
+/**
+ * Summary statistics over the timed samples of one benchmark case.
+ */
+typedef struct {
+    double min, max, mean, stddev;
+    double median, p90, p99;
+} BenchStats;
+
+/**
+ * Single algorithm under test. Returns 1 on success, 0 on failure.
+ */
+typedef int (*BenchFunc)(const Graph* g);
+
+typedef struct {
+    const char* name;
+    BenchFunc run;
+    int exponential;     // 1 if runtime grows exponentially with n
+    int variant;         // AlgorithmVariant measured, ALGO_VARIANT_AUTO if none
+} BenchAlgorithm;
+
+/**
+ * Measurements of one variant collected for the cost model fit.
+ */
+typedef struct {
+    double units[MAX_CALIBRATION];
+    double ns[MAX_CALIBRATION];
+    int count;
+} CalibrationSamples;
+
+static CalibrationSamples calibration[ALGO_VARIANT_COUNT];
+
+/* ---------- Timing ---------- */
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* ---------- Algorithm wrappers ---------- */
+
+/* Workspace shared by all calls with -K, NULL for a fresh one per call */
+static AlgorithmWorkspace* bench_ws = NULL;
+
+static int bench_euler(const Graph* g) {
+    int* cycle = NULL;
+    long long len = 0;
+    if (graph_find_euler_circuit(g, &cycle, &len)) GRAPH_FREE(cycle);
+    return 1; // "no circuit" is a valid outcome
+}
+
+static int bench_maxflow(const Graph* g) {
+    long long flow;
+    return graph_max_flow_default_ws(g, &flow, bench_ws);
+}
+
+static int bench_maxflow_dinic(const Graph* g) {
+    long long flow;
+    return g->n >= 2 && graph_max_flow_dinic_ws(g, 0, g->n - 1, &flow, bench_ws);
+}
+
+static int bench_mst(const Graph* g) {
+    MST_Result r;
+    if (!graph_mst_prim_ws(g, &r, bench_ws)) return 0;
+    mst_result_free(&r);
+    return 1;
+}
+
+static int bench_mst_list(const Graph* g) {
+    MST_Result r;
+    if (!graph_mst_prim_list_ws(g, &r, bench_ws)) return 0;
+    mst_result_free(&r);
+    return 1;
+}
+
+static int bench_maxclique(const Graph* g) {
+    MaxClique_Result r;
+    if (!graph_max_clique_ws(g, &r, bench_ws)) return 0;
+    maxclique_result_free(&r);
+    return 1;
+}
+
+static int bench_maxclique_color(const Graph* g) {
+    AlgorithmParams params;
+    algorithm_params_init(&params);
+    params.variant = ALGO_VARIANT_CLIQUE_COLORING;
+
+    MaxClique_Result r;
+    if (!graph_max_clique_with_params(g, &params, &r, bench_ws)) return 0;
+    maxclique_result_free(&r);
+    return 1;
+}
+
+static int bench_weightclique(const Graph* g) {
+    WeightClique_Result r;
+    if (!graph_max_weight_clique_with_params(g, NULL, &r, bench_ws)) return 0;
+    weight_clique_result_free(&r);
+    return 1;
+}
+
+static int bench_cliquecount(const Graph* g) {
+    CliqueCount_Result r;
+    if (!graph_count_all_cliques_ws(g, &r, bench_ws)) return 0;
+    clique_count_result_free(&r);
+    return 1;
+}
+
+static int bench_triangles(const Graph* g) {
+    long long count;
+    return graph_count_triangles_ws(g, &count, bench_ws);
+}
+
+#define BENCH_COMPONENTS_THREADS 4
+
+static int bench_components_threads(const Graph* g, int threads) {
+    GraphComponents cc;
+    WorkspaceMark mark = bench_ws ? workspace_mark(bench_ws) : (WorkspaceMark){0};
+    int ok = graph_connected_components_ws(g, threads, &cc, bench_ws);
+    if (bench_ws) {
+        workspace_release(bench_ws, mark);
+    } else {
+        graph_components_free(&cc);
+    }
+    return ok;
+}
+
+static int bench_components(const Graph* g) {
+    return bench_components_threads(g, 1);
+}
+
+static int bench_components_par(const Graph* g) {
+    return bench_components_threads(g, BENCH_COMPONENTS_THREADS);
+}
+
+static int bench_hops_threads(const Graph* g, int threads) {
+    AlgorithmParams params;
+    algorithm_params_init(&params);
+    params.num_threads = threads;
+
+    BFS_Result r;
+    if (!graph_bfs_with_params(g, &params, &r, bench_ws)) return 0;
+    bfs_result_free(&r);
+    return 1;
+}
+
+static int bench_hops(const Graph* g) {
+    return bench_hops_threads(g, 1);
+}
+
+static int bench_hops_par(const Graph* g) {
+    return bench_hops_threads(g, BENCH_COMPONENTS_THREADS);
+}
+
+static int bench_sssp_variant(const Graph* g, int variant, int threads) {
+    AlgorithmParams params;
+    algorithm_params_init(&params);
+    params.variant = variant;
+    params.num_threads = threads;
+
+    SSSP_Result r;
+    if (!graph_sssp_with_params(g, &params, &r, bench_ws)) return 0;
+    sssp_result_free(&r);
+    return 1;
+}
+
+static int bench_sssp(const Graph* g) {
+    return bench_sssp_variant(g, ALGO_VARIANT_RADIX_HEAP, 1);
+}
+
+static int bench_sssp_delta(const Graph* g) {
+    return bench_sssp_variant(g, ALGO_VARIANT_DELTA_STEPPING, BENCH_COMPONENTS_THREADS);
+}
+
+static int bench_coloring_variant(const Graph* g, int variant, int threads) {
+    AlgorithmParams params;
+    algorithm_params_init(&params);
+    params.variant = variant;
+    params.num_threads = threads;
+
+    GraphColoring r;
+    if (!graph_color_with_params(g, &params, &r, bench_ws)) return 0;
+    graph_coloring_free(&r);
+    return 1;
+}
+
+static int bench_coloring(const Graph* g) {
+    return bench_coloring_variant(g, ALGO_VARIANT_COLOR_SMALLEST_LAST, 1);
+}
+
+static int bench_coloring_dsatur(const Graph* g) {
+    return bench_coloring_variant(g, ALGO_VARIANT_COLOR_DSATUR, 1);
+}
+
+static int bench_coloring_jp(const Graph* g) {
+    return bench_coloring_variant(g, ALGO_VARIANT_COLOR_JONES_PLASSMANN, BENCH_COMPONENTS_THREADS);
+}
+
+static const BenchAlgorithm algorithms[] = {
+    {"euler",           bench_euler,           0, ALGO_VARIANT_AUTO},
+    {"maxflow",         bench_maxflow,         0, ALGO_VARIANT_EDMONDS_KARP},
+    {"maxflow-dinic",   bench_maxflow_dinic,   0, ALGO_VARIANT_DINIC},
+    {"mst",             bench_mst,             0, ALGO_VARIANT_PRIM_MATRIX},
+    {"mst-list",        bench_mst_list,        0, ALGO_VARIANT_PRIM_LIST},
+    {"maxclique",       bench_maxclique,       1, ALGO_VARIANT_CLIQUE_BACKTRACK},
+    {"maxclique-color", bench_maxclique_color, 1, ALGO_VARIANT_CLIQUE_COLORING},
+    {"weightclique",    bench_weightclique,    1, ALGO_VARIANT_AUTO},
+    {"cliquecount",     bench_cliquecount,     1, ALGO_VARIANT_AUTO},
+    {"triangles",       bench_triangles,       0, ALGO_VARIANT_AUTO},
+    {"components",      bench_components,      0, ALGO_VARIANT_AUTO},
+    {"components-par",  bench_components_par,  0, ALGO_VARIANT_AUTO},
+    {"sssp",            bench_sssp,            0, ALGO_VARIANT_RADIX_HEAP},
+    {"sssp-delta",      bench_sssp_delta,      0, ALGO_VARIANT_DELTA_STEPPING},
+    {"hops",            bench_hops,            0, ALGO_VARIANT_AUTO},
+    {"hops-par",        bench_hops_par,        0, ALGO_VARIANT_AUTO},
+    {"coloring",        bench_coloring,        0, ALGO_VARIANT_COLOR_SMALLEST_LAST},
+    {"coloring-dsatur", bench_coloring_dsatur, 0, ALGO_VARIANT_COLOR_DSATUR},
+    {"coloring-jp",     bench_coloring_jp,     0, ALGO_VARIANT_COLOR_JONES_PLASSMANN}
+};
+
+static const int num_algorithms = sizeof(algorithms) / sizeof(algorithms[0]);
+
+static const BenchAlgorithm* find_algorithm(const char* name) {
+    for (int i = 0; i < num_algorithms; i++) {
+        if (strcmp(algorithms[i].name, name) == 0) return &algorithms[i];
+    }
+    return NULL;
+}
+
+/* ---------- Graph families ---------- */
+
+static int random_weight(const BenchConfig* cfg) {
+    return (rand() % cfg->max_weight) + 1;
+}
+
+/**
+ * Erdos-Renyi G(n, p) with p = cfg->density.
+ */
+static void gen_random(Graph* g, const BenchConfig* cfg) {
+    for (int u = 0; u < g->n; u++) {
+        for (int v = u + 1; v < g->n; v++) {
+            if ((double)rand() / RAND_MAX < cfg->density) {
+                graph_add_weighted_edge(g, u, v, random_weight(cfg));
+            }
+        }
+    }
+}
+
+/**
+ * Sparse random graph with average degree ~4.
+ */
+static void gen_sparse(Graph* g, const BenchConfig* cfg) {
+    long target = 2L * g->n;
+    long max_edges = (long)g->n * (g->n - 1) / 2;
+    if (target > max_edges) target = max_edges;
+
+    long added = 0, attempts = 0;
+    while (added < target && attempts < target * 100) {
+        int u = rand() % g->n;
+        int v = rand() % g->n;
+        attempts++;
+        if (u == v) continue;
+        if (graph_add_weighted_edge(g, u, v, random_weight(cfg)) == 0) added++;
+    }
+}
+
+/**
+ * Square-ish grid; the last row may be partial.
+ */
+static void gen_grid(Graph* g, const BenchConfig* cfg) {
+    int cols = (int)ceil(sqrt((double)g->n));
+    for (int v = 0; v < g->n; v++) {
+        int right = v + 1, down = v + cols;
+        if ((v % cols) != cols - 1 && right < g->n) {
+            graph_add_weighted_edge(g, v, right, random_weight(cfg));
+        }
+        if (down < g->n) {
+            graph_add_weighted_edge(g, v, down, random_weight(cfg));
+        }
+    }
+}
+
+/**
+ * gen_grid() with the vertex ids shuffled, as a client might number them.
+ */
+static void gen_shuffled(Graph* g, const BenchConfig* cfg) {
+    int* id = (int*)malloc((size_t)g->n * sizeof(int));
+    if (!id) return;
+    for (int v = 0; v < g->n; v++) id[v] = v;
+    for (int v = g->n - 1; v > 0; v--) {
+        int j = rand() % (v + 1);
+        int t = id[v];
+        id[v] = id[j];
+        id[j] = t;
+    }
+
+    int cols = (int)ceil(sqrt((double)g->n));
+    for (int v = 0; v < g->n; v++) {
+        int right = v + 1, down = v + cols;
+        if ((v % cols) != cols - 1 && right < g->n) {
+            graph_add_weighted_edge(g, id[v], id[right], random_weight(cfg));
+        }
+        if (down < g->n) {
+            graph_add_weighted_edge(g, id[v], id[down], random_weight(cfg));
+        }
+    }
+    free(id);
+}
+
+/**
+ * Simple ring 0-1-...-(n-1)-0 (always Eulerian for n >= 3).
+ */
+static void gen_cycle(Graph* g, const BenchConfig* cfg) {
+    if (g->n < 3) return;
+    for (int v = 0; v < g->n; v++) {
+        graph_add_weighted_edge(g, v, (v + 1) % g->n, random_weight(cfg));
+    }
+}
+
+/**
+ * Complete graph K_n (expensive for clique algorithms).
+ */
+static void gen_complete(Graph* g, const BenchConfig* cfg) {
+    for (int u = 0; u < g->n; u++) {
+        for (int v = u + 1; v < g->n; v++) {
+            graph_add_weighted_edge(g, u, v, random_weight(cfg));
+        }
+    }
+}
+
+typedef void (*FamilyGenerator)(Graph* g, const BenchConfig* cfg);
+
+typedef struct {
+    const char* name;
+    FamilyGenerator generate;
+} GraphFamily;
+
+static const GraphFamily families[] = {
+    {"random",   gen_random},
+    {"sparse",   gen_sparse},
+    {"grid",     gen_grid},
+    {"shuffled", gen_shuffled},
+    {"cycle",    gen_cycle},
+    {"complete", gen_complete}
+};
+
+static const int num_families = sizeof(families) / sizeof(families[0]);
+
+static const GraphFamily* find_family(const char* name) {
+    for (int i = 0; i < num_families; i++) {
+        if (strcmp(families[i].name, name) == 0) return &families[i];
+    }
+    return NULL;
+}
+
+/**
+ * Build a graph of the given family and size. The seed depends on the
+ * family and size only, so every run of the harness sees the same graphs.
+ */
+static Graph* build_family_graph(const GraphFamily* fam, int n, const BenchConfig* cfg) {
+    Graph* g = graph_create(n);
+    if (!g) return NULL;
+
+    unsigned int seed = (unsigned int)cfg->seed;
+    for (const char* p = fam->name; *p; p++) seed = seed * 31u + (unsigned char)*p;
+    srand(seed ^ (unsigned int)n);
+
+    fam->generate(g, cfg);
+    return g;
+}
+
+/**
+ * Replace *g with a copy relabeled in @p order. Runs before timing, so the
+ * results show what the order does to the algorithms.
+ */
+static int relabel_graph(Graph** g, GraphOrder order) {
+    GraphReordering r;
+    if (!graph_reordering_compute(*g, order, &r)) return 0;
+
+    Graph* relabeled = graph_reordering_apply(*g, &r);
+    graph_reordering_free(&r);
+    if (!relabeled) return 0;
+    graph_destroy(*g);
+    *g = relabeled;
+    return 1;
+}
+
+static int count_edges(const Graph* g) {
+    int m = 0;
+    for (int u = 0; u < g->n; u++) {
+        for (EdgeNode* e = g->adj[u].head; e; e = e->next) {
+            if (u <= e->to) m++;
+        }
+    }
+    return m;
+}
+
+/* ---------- Statistics ---------- */
+
+static int cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Nearest-rank percentile over a sorted array.
+ */
+static double percentile(const double* sorted, int count, double pct) {
+    if (count <= 0) return 0.0;
+    int rank = (int)ceil(pct / 100.0 * count);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return sorted[rank - 1];
+}
+
+static void compute_stats(const double* samples, int count, BenchStats* st) {
+    double* sorted = (double*)malloc(sizeof(double) * (size_t)count);
+    memset(st, 0, sizeof(*st));
+    if (!sorted || count == 0) { free(sorted); return; }
+
+    memcpy(sorted, samples, sizeof(double) * (size_t)count);
+    qsort(sorted, (size_t)count, sizeof(double), cmp_double);
+
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) sum += sorted[i];
+    st->mean = sum / count;
+
+    double var = 0.0;
+    for (int i = 0; i < count; i++) var += (sorted[i] - st->mean) * (sorted[i] - st->mean);
+    st->stddev = count > 1 ? sqrt(var / (count - 1)) : 0.0;
+
+    st->min = sorted[0];
+    st->max = sorted[count - 1];
+    st->median = (count % 2) ? sorted[count / 2]
+                             : 0.5 * (sorted[count / 2 - 1] + sorted[count / 2]);
+    st->p90 = percentile(sorted, count, 90.0);
+    st->p99 = percentile(sorted, count, 99.0);
+    free(sorted);
+}
+
+/* ---------- Output ---------- */
+
+static void json_write_header(FILE* out, const BenchConfig* cfg) {
+    char host[128] = "unknown";
+    gethostname(host, sizeof(host) - 1);
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"schema\": 1,\n");
+    fprintf(out, "  \"host\": \"%s\",\n", host);
+    fprintf(out, "  \"timestamp\": %ld,\n", (long)time(NULL));
+    fprintf(out, "  \"seed\": %d,\n", cfg->seed);
+    fprintf(out, "  \"warmup\": %d,\n", cfg->warmup);
+    fprintf(out, "  \"reps\": %d,\n", cfg->reps);
+    fprintf(out, "  \"reuse_workspace\": %d,\n", cfg->reuse_workspace);
+    fprintf(out, "  \"bitgraph\": %d,\n", !cfg->no_bitgraph);
+    fprintf(out, "  \"simd\": \"%s\",\n", simd_level_name(simd_level()));
+    fprintf(out, "  \"order\": \"%s\",\n", graph_order_name(cfg->order));
+    fprintf(out, "  \"results\": [\n");
+}
+
+/**
+ * Write the per-call hardware counter averages as a JSON object member.
+ */
+static void json_write_hw(FILE* out, const PerfSample* hw) {
+    double calls = hw->calls ? (double)hw->calls : 1.0;
+    fprintf(out, ", \"hw\": {");
+    int first = 1;
+    for (int i = 0; i < PERF_EV_COUNT; i++) {
+        if (!(hw->valid_mask & (1u << i))) continue;
+        fprintf(out, "%s\"%s\": %.1f", first ? "" : ", ",
+                perf_event_name((PerfEvent)i), (double)hw->values[i] / calls);
+        first = 0;
+    }
+    fprintf(out, "}");
+}
+
+/**
+ * Write the allocation statistics of one call as a JSON object member.
+ */
+static void json_write_alloc(FILE* out, const GraphAllocStats* as) {
+    fprintf(out, ", \"alloc\": {\"allocations\": %llu, \"reallocs\": %llu, "
+                 "\"bytes\": %llu, \"peak_bytes\": %lld}",
+            as->allocations, as->reallocs, as->bytes, as->peak_live_bytes);
+}
+
+static void json_write_result(FILE* out, int first, const char* algo, const char* family,
+                              int n, int m, const double* samples, int count,
+                              const BenchStats* st, const PerfSample* hw,
+                              const GraphAllocStats* as) {
+    fprintf(out, "%s    {\"algorithm\": \"%s\", \"family\": \"%s\", \"n\": %d, \"m\": %d, "
+                 "\"reps\": %d, \"min_ns\": %.0f, \"median_ns\": %.0f, \"p90_ns\": %.0f, "
+                 "\"p99_ns\": %.0f, \"max_ns\": %.0f, \"mean_ns\": %.1f, \"stddev_ns\": %.1f, "
+                 "\"samples_ns\": [",
+            first ? "" : ",\n", algo, family, n, m, count,
+            st->min, st->median, st->p90, st->p99, st->max, st->mean, st->stddev);
+    for (int i = 0; i < count; i++) {
+        fprintf(out, "%s%.0f", i ? ", " : "", samples[i]);
+    }
+    fprintf(out, "]");
+    if (hw) json_write_hw(out, hw);
+    if (as) json_write_alloc(out, as);
+    fprintf(out, "}");
+}
+
+static void json_write_footer(FILE* out) {
+    fprintf(out, "\n  ]\n}\n");
+}
+
+/* ---------- Runner ---------- */
+
+/**
+ * Run one (algorithm, family, size) case: warmup, then timed repetitions.
+ * When @p pc is non-NULL, hardware counters are accumulated into @p hw.
+ * @return Number of successful timed samples written to @p samples.
+ */
+static int run_case(const BenchAlgorithm* algo, const Graph* g, const BenchConfig* cfg,
+                    double* samples, PerfCounters* pc, PerfSample* hw) {
+    for (int i = 0; i < cfg->warmup; i++) {
+        if (!algo->run(g)) return 0;
+        if (bench_ws) workspace_reset(bench_ws);
+    }
+
+    if (hw) memset(hw, 0, sizeof(*hw));
+
+    int count = 0;
+    for (int i = 0; i < cfg->reps; i++) {
+        if (pc) perf_counters_start(pc);
+        double t0 = now_ns();
+        int ok = algo->run(g);
+        double t1 = now_ns();
+        if (pc) {
+            PerfSample s;
+            perf_counters_stop(pc, &s);
+            perf_sample_add(hw, &s);
+        }
+        if (!ok) return 0;
+        samples[count++] = t1 - t0;
+        if (bench_ws) workspace_reset(bench_ws);
+    }
+    return count;
+}
+
+/**
+ * Run the algorithm once more, untimed, with allocation profiling on.
+ * @return 1 on success, 0 on failure.
+ */
+static int profile_allocations(const BenchAlgorithm* algo, const Graph* g, GraphAllocStats* as) {
+    graph_alloc_stats_reset();
+    graph_alloc_set_profiling(1);
+    int ok = algo->run(g);
+    graph_alloc_set_profiling(0);
+    if (bench_ws) workspace_reset(bench_ws);
+    graph_alloc_stats_get(as);
+    return ok;
+}
+
+/**
+ * Derived counter ratio for the summary table, or -1 if not measured.
+ */
+static double hw_ratio(const PerfSample* hw, PerfEvent num, PerfEvent den, double scale) {
+    unsigned int need = (1u << num) | (1u << den);
+    if ((hw->valid_mask & need) != need || hw->values[den] == 0) return -1.0;
+    return scale * (double)hw->values[num] / (double)hw->values[den];
+}
+
+static int run_benchmarks(const BenchConfig* cfg, FILE* json) {
+    double* samples = (double*)malloc(sizeof(double) * (size_t)cfg->reps);
+    if (!samples) return 0;
+
+    PerfCounters counters;
+    PerfCounters* pc = NULL;
+    if (cfg->hw_counters) {
+        if (perf_counters_open(&counters)) {
+            pc = &counters;
+        } else {
+            fprintf(stderr, "bench: hardware counters unavailable "
+                            "(check /proc/sys/kernel/perf_event_paranoid)\n");
+            perf_counters_close(&counters);
+        }
+    }
+
+    if (json) json_write_header(json, cfg);
+
+    printf("SIMD kernels: %s (CPU supports %s)\n\n", simd_level_name(simd_level()),
+           simd_level_name(simd_detected_level()));
+    printf("%-12s %-9s %6s %7s %12s %12s %12s %12s%s%s\n",
+           "algorithm", "family", "n", "m", "min(us)", "median(us)", "p90(us)", "p99(us)",
+           pc ? "    ipc  c-mpki  b-mpki" : "",
+           cfg->alloc_profile ? "   allocs    bytes  peak(B)" : "");
+    printf("------------ --------- ------ ------- ------------ ------------ ------------ ------------%s%s\n",
+           pc ? " ------ ------- -------" : "",
+           cfg->alloc_profile ? " -------- -------- --------" : "");
+
+    int first = 1;
+    for (int f = 0; f < cfg->num_families; f++) {
+        const GraphFamily* fam = find_family(cfg->families[f]);
+        for (int s = 0; s < cfg->num_sizes; s++) {
+            int n = cfg->sizes[s];
+            Graph* g = build_family_graph(fam, n, cfg);
+            if (!g) {
+                fprintf(stderr, "bench: failed to build %s graph with n=%d\n", fam->name, n);
+                continue;
+            }
+            if (cfg->order != GRAPH_ORDER_NONE && !relabel_graph(&g, cfg->order)) {
+                fprintf(stderr, "bench: failed to relabel %s graph with n=%d\n", fam->name, n);
+            }
+            int m = count_edges(g);
+            GraphProfile profile;
+            int have_profile = cfg->calibrate_path && graph_profile_compute(g, &profile);
+
+            for (int a = 0; a < cfg->num_algos; a++) {
+                const BenchAlgorithm* algo = find_algorithm(cfg->algos[a]);
+                if (algo->exponential && n > cfg->exp_cap) continue;
+
+                PerfSample hw;
+                int count = run_case(algo, g, cfg, samples, pc, pc ? &hw : NULL);
+                if (count == 0) {
+                    printf("%-12s %-9s %6d %7d %12s\n", algo->name, fam->name, n, m, "failed");
+                    continue;
+                }
+
+                BenchStats st;
+                compute_stats(samples, count, &st);
+                if (have_profile && algo->variant != ALGO_VARIANT_AUTO) {
+                    CalibrationSamples* cs = &calibration[algo->variant];
+                    if (cs->count < MAX_CALIBRATION) {
+                        cs->units[cs->count] = cost_model_work_units(algo->variant, &profile);
+                        cs->ns[cs->count] = st.median;
+                        cs->count++;
+                    }
+                }
+                printf("%-12s %-9s %6d %7d %12.2f %12.2f %12.2f %12.2f",
+                       algo->name, fam->name, n, m,
+                       st.min / 1e3, st.median / 1e3, st.p90 / 1e3, st.p99 / 1e3);
+                if (pc) {
+                    printf(" %6.2f %7.2f %7.2f",
+                           hw_ratio(&hw, PERF_EV_INSTRUCTIONS, PERF_EV_CYCLES, 1.0),
+                           hw_ratio(&hw, PERF_EV_CACHE_MISSES, PERF_EV_INSTRUCTIONS, 1000.0),
+                           hw_ratio(&hw, PERF_EV_BRANCH_MISSES, PERF_EV_INSTRUCTIONS, 1000.0));
+                }
+                GraphAllocStats as;
+                int have_alloc = cfg->alloc_profile && profile_allocations(algo, g, &as);
+                if (have_alloc) {
+                    printf(" %8llu %8llu %8lld", as.allocations + as.reallocs, as.bytes,
+                           as.peak_live_bytes);
+                }
+                printf("\n");
+
+                if (json) {
+                    json_write_result(json, first, algo->name, fam->name, n, m,
+                                      samples, count, &st, pc ? &hw : NULL,
+                                      have_alloc ? &as : NULL);
+                    first = 0;
+                }
+            }
+            graph_destroy(g);
+        }
+    }
+
+    if (json) json_write_footer(json);
+    if (pc) perf_counters_close(pc);
+    free(samples);
+    return 1;
+}
+
+/* ---------- Cost model calibration ---------- */
+
+/**
+ * Fit every variant that has measurements and write the model to @p path.
+ * @return 1 on success, 0 if the model file cannot be written.
+ */
+static int write_calibration(const char* path) {
+    printf("\nCost model fitted on this host:\n");
+    for (int v = ALGO_VARIANT_AUTO + 1; v < ALGO_VARIANT_COUNT; v++) {
+        CalibrationSamples* cs = &calibration[v];
+        if (!cost_model_fit(v, cs->units, cs->ns, cs->count)) {
+            printf("  %s: not enough measurements (%d), keeping defaults\n",
+                   cost_model_variant_name(v), cs->count);
+        }
+    }
+    cost_model_print();
+
+    if (!cost_model_save(path)) {
+        perror("bench: cost model");
+        return 0;
+    }
+    printf("Cost model written to %s (load it with GRAPH_COST_MODEL=%s)\n", path, path);
+    return 1;
+}
+
+/* ---------- Command line ---------- */
+
+/**
+ * Split a comma-separated list in place.
+ * @return Number of items stored, or -1 if there are more than @p max.
+ */
+static int split_list(char* s, const char** items, int max) {
+    int count = 0;
+    for (char* tok = strtok(s, ","); tok; tok = strtok(NULL, ",")) {
+        if (count == max) return -1;
+        items[count++] = tok;
+    }
+    return count;
+}
+
+static void print_usage(const char* prog) {
+    fprintf(stderr,
+        "Usage: %s [-a algos] [-f families] [-n sizes] [-w warmup] [-r reps]\n"
+        "          [-s seed] [-W max_weight] [-p density] [-x exp_cap] [-H] [-A] [-K] [-B]\n"
+        "          [-S level] [-R order] [-C model.txt] [-o out.json]\n"
+        "  -a  comma list of: euler,maxflow,maxflow-dinic,mst,mst-list,maxclique,\n"
+        "      maxclique-color,weightclique,cliquecount,triangles,components,\n"
+        "      components-par,sssp,sssp-delta,hops,hops-par,coloring,\n"
+        "      coloring-dsatur,coloring-jp\n"
+        "  -f  comma list of: random,sparse,grid,shuffled,cycle,complete\n"
+        "  -n  comma list of vertex counts (default " DEFAULT_SIZES ")\n"
+        "  -x  skip clique algorithms above this n (default 64)\n"
+        "  -H  record hardware counters (cycles, instructions, cache/branch misses)\n"
+        "  -A  record allocations, bytes and peak live bytes per call\n"
+        "  -K  reuse one algorithm workspace across calls (steady-state server mode)\n"
+        "  -B  disable the bitset kernels for n <= 256 (measure the general code)\n"
+        "  -S  cap the SIMD kernels at scalar, sse4.2, avx2 or avx512 (default: the CPU's)\n"
+        "  -R  relabel every graph before timing: none, degree, rcm or gorder\n"
+        "  -C  fit the variant cost model from the results and write it to a file\n"
+        "      (defaults to all variants over " CALIBRATE_SIZES ")\n",
+        prog);
+}
+
+int main(int argc, char* argv[]) {
+    BenchConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.warmup = 3;
+    cfg.reps = 20;
+    cfg.seed = 42;
+    cfg.max_weight = 10;
+    cfg.density = 0.3;
+    cfg.exp_cap = 64;
+
+    char algos_buf[256] = "";
+    char families_buf[256] = "";
+    char sizes_buf[256] = "";
+
+    int opt;
+    while ((opt = getopt(argc, argv, "a:f:n:w:r:s:W:p:x:HAKBS:R:C:o:h")) != -1) {
+        switch (opt) {
+            case 'a': snprintf(algos_buf, sizeof(algos_buf), "%s", optarg); break;
+            case 'f': snprintf(families_buf, sizeof(families_buf), "%s", optarg); break;
+            case 'n': snprintf(sizes_buf, sizeof(sizes_buf), "%s", optarg); break;
+            case 'w': cfg.warmup = atoi(optarg); break;
+            case 'r': cfg.reps = atoi(optarg); break;
+            case 's': cfg.seed = atoi(optarg); break;
+            case 'W': cfg.max_weight = atoi(optarg); break;
+            case 'p': cfg.density = atof(optarg); break;
+            case 'x': cfg.exp_cap = atoi(optarg); break;
+            case 'H': cfg.hw_counters = 1; break;
+            case 'A': cfg.alloc_profile = 1; break;
+            case 'K': cfg.reuse_workspace = 1; break;
+            case 'B': cfg.no_bitgraph = 1; break;
+            case 'S': cfg.simd = optarg; break;
+            case 'R':
+                if (!graph_order_parse(optarg, &cfg.order)) {
+                    fprintf(stderr, "bench: unknown vertex order '%s'\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'C': cfg.calibrate_path = optarg; break;
+            case 'o': cfg.out_path = optarg; break;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (cfg.warmup < 0 || cfg.reps <= 0 || cfg.max_weight <= 0 ||
+        cfg.density < 0.0 || cfg.density > 1.0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // Lists not given on the command line depend on the mode
+    int calibrating = cfg.calibrate_path != NULL;
+    if (!algos_buf[0]) snprintf(algos_buf, sizeof(algos_buf), "%s",
+                                calibrating ? CALIBRATE_ALGOS : DEFAULT_ALGOS);
+    if (!families_buf[0]) snprintf(families_buf, sizeof(families_buf), "%s",
+                                   calibrating ? CALIBRATE_FAMILIES : DEFAULT_FAMILIES);
+    if (!sizes_buf[0]) snprintf(sizes_buf, sizeof(sizes_buf), "%s",
+                                calibrating ? CALIBRATE_SIZES : DEFAULT_SIZES);
+
+    cfg.num_algos = split_list(algos_buf, cfg.algos, MAX_LIST);
+    cfg.num_families = split_list(families_buf, cfg.families, MAX_LIST);
+    const char* size_items[MAX_LIST];
+    cfg.num_sizes = split_list(sizes_buf, size_items, MAX_LIST);
+    if (cfg.num_algos <= 0 || cfg.num_families <= 0 || cfg.num_sizes <= 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    for (int i = 0; i < cfg.num_algos; i++) {
+        if (!find_algorithm(cfg.algos[i])) {
+            fprintf(stderr, "bench: unknown algorithm '%s'\n", cfg.algos[i]);
+            return 1;
+        }
+    }
+    for (int i = 0; i < cfg.num_families; i++) {
+        if (!find_family(cfg.families[i])) {
+            fprintf(stderr, "bench: unknown graph family '%s'\n", cfg.families[i]);
+            return 1;
+        }
+    }
+    for (int i = 0; i < cfg.num_sizes; i++) {
+        cfg.sizes[i] = atoi(size_items[i]);
+        if (cfg.sizes[i] <= 0) {
+            fprintf(stderr, "bench: invalid size '%s'\n", size_items[i]);
+            return 1;
+        }
+    }
+
+    FILE* json = NULL;
+    if (cfg.out_path) {
+        json = fopen(cfg.out_path, "w");
+        if (!json) {
+            perror("bench: fopen");
+            return 1;
+        }
+    }
+
+    bitgraph_set_enabled(!cfg.no_bitgraph);
+
+    if (cfg.simd) {
+        SimdLevel level;
+        if (!simd_parse_level(cfg.simd, &level)) {
+            fprintf(stderr, "bench: unknown SIMD level '%s'\n", cfg.simd);
+            if (json) fclose(json);
+            return 1;
+        }
+        simd_set_level(level);
+    }
+
+    AlgorithmWorkspace ws;
+    if (cfg.reuse_workspace) {
+        if (!workspace_init(&ws, 0)) {
+            fprintf(stderr, "bench: failed to initialize workspace\n");
+            if (json) fclose(json);
+            return 1;
+        }
+        bench_ws = &ws;
+    }
+
+    int ok = run_benchmarks(&cfg, json);
+    if (bench_ws) workspace_destroy(bench_ws);
+    if (ok && cfg.calibrate_path) ok = write_calibration(cfg.calibrate_path);
+
+    if (json) {
+        fclose(json);
+        printf("\nJSON results written to %s\n", cfg.out_path);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,320 @@
+/*
+** benchcmp.c -- compare two benchmark runs produced by graph_bench
+**
+** Matches results by (algorithm, family, n), applies a two-sided
+** Mann-Whitney U test to the raw samples to separate noise from real
+** changes, and exits with status 1 if any case got significantly slower
+** by more than the threshold.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+
+#define NAME_LEN 32
+
+/**
+ * One benchmark case parsed from the JSON output.
+ */
+typedef struct {
+    char algorithm[NAME_LEN];
+    char family[NAME_LEN];
+    int n;
+    double* samples;
+    int num_samples;
+    double median;
+} BenchCase;
+
+typedef struct {
+    BenchCase* cases;
+    int count, capacity;
+} BenchRun;
+
+/* ---------- Parsing ---------- */
+
+static char* read_file(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size < 0) { fclose(f); return NULL; }
+
+    char* buf = (char*)malloc((size_t)size + 1);
+    if (!buf) { fclose(f); return NULL; }
+    size_t got = fread(buf, 1, (size_t)size, f);
+    buf[got] = '\0';
+    fclose(f);
+    return buf;
+}
+
+/**
+ * Find the value that follows "key": inside [begin, end).
+ * @return Pointer to the first non-space character of the value, or NULL.
+ */
+static const char* find_value(const char* begin, const char* end, const char* key) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\"", key);
+    size_t plen = strlen(pattern);
+
+    for (const char* p = begin; p + plen < end; p++) {
+        if (strncmp(p, pattern, plen) != 0) continue;
+        p += plen;
+        while (p < end && (*p == ' ' || *p == ':')) p++;
+        return p < end ? p : NULL;
+    }
+    return NULL;
+}
+
+static int parse_string(const char* begin, const char* end, const char* key, char* out) {
+    const char* v = find_value(begin, end, key);
+    if (!v || *v != '"') return 0;
+    v++;
+    int i = 0;
+    while (v < end && *v != '"' && i < NAME_LEN - 1) out[i++] = *v++;
+    out[i] = '\0';
+    return i > 0;
+}
+
+static int parse_samples(const char* begin, const char* end, BenchCase* c) {
+    const char* v = find_value(begin, end, "samples_ns");
+    if (!v || *v != '[') return 0;
+    v++;
+
+    int cap = 16;
+    c->samples = (double*)malloc(sizeof(double) * (size_t)cap);
+    c->num_samples = 0;
+    if (!c->samples) return 0;
+
+    while (v < end && *v != ']') {
+        char* next;
+        double x = strtod(v, &next);
+        if (next == v) { v++; continue; } // skip ',' and spaces
+        if (c->num_samples == cap) {
+            cap *= 2;
+            double* ns = (double*)realloc(c->samples, sizeof(double) * (size_t)cap);
+            if (!ns) return 0;
+            c->samples = ns;
+        }
+        c->samples[c->num_samples++] = x;
+        v = next;
+    }
+    return c->num_samples > 0;
+}
+
+static int cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double median_of(const double* values, int count) {
+    double* sorted = (double*)malloc(sizeof(double) * (size_t)count);
+    if (!sorted) return 0.0;
+    memcpy(sorted, values, sizeof(double) * (size_t)count);
+    qsort(sorted, (size_t)count, sizeof(double), cmp_double);
+    double m = (count % 2) ? sorted[count / 2]
+                           : 0.5 * (sorted[count / 2 - 1] + sorted[count / 2]);
+    free(sorted);
+    return m;
+}
+
+/**
+ * Load every result object of a graph_bench JSON file.
+ * @return 1 on success, 0 on failure.
+ */
+static int load_run(const char* path, BenchRun* run) {
+    memset(run, 0, sizeof(*run));
+    char* text = read_file(path);
+    if (!text) {
+        fprintf(stderr, "benchcmp: cannot read %s\n", path);
+        return 0;
+    }
+
+    const char* marker = "{\"algorithm\"";
+    const char* end_of_text = text + strlen(text);
+    const char* p = strstr(text, marker);
+    while (p) {
+        const char* next = strstr(p + 1, marker);
+        const char* end = next ? next : end_of_text;
+
+        BenchCase c;
+        memset(&c, 0, sizeof(c));
+        const char* nval = find_value(p, end, "n");
+        if (parse_string(p, end, "algorithm", c.algorithm) &&
+            parse_string(p, end, "family", c.family) &&
+            nval && parse_samples(p, end, &c)) {
+            c.n = atoi(nval);
+            c.median = median_of(c.samples, c.num_samples);
+
+            if (run->count == run->capacity) {
+                int cap = run->capacity ? run->capacity * 2 : 32;
+                BenchCase* nc = (BenchCase*)realloc(run->cases, sizeof(BenchCase) * (size_t)cap);
+                if (!nc) { free(c.samples); free(text); return 0; }
+                run->cases = nc;
+                run->capacity = cap;
+            }
+            run->cases[run->count++] = c;
+        } else {
+            free(c.samples);
+        }
+        p = next;
+    }
+
+    free(text);
+    if (run->count == 0) {
+        fprintf(stderr, "benchcmp: no benchmark results found in %s\n", path);
+        return 0;
+    }
+    return 1;
+}
+
+static void free_run(BenchRun* run) {
+    for (int i = 0; i < run->count; i++) free(run->cases[i].samples);
+    free(run->cases);
+    run->cases = NULL;
+    run->count = run->capacity = 0;
+}
+
+static const BenchCase* find_case(const BenchRun* run, const BenchCase* key) {
+    for (int i = 0; i < run->count; i++) {
+        const BenchCase* c = &run->cases[i];
+        if (c->n == key->n && strcmp(c->algorithm, key->algorithm) == 0 &&
+            strcmp(c->family, key->family) == 0) {
+            return c;
+        }
+    }
+    return NULL;
+}
+
+/* ---------- Statistics ---------- */
+
+typedef struct {
+    double value;
+    int group;      // 0 = base, 1 = new
+} RankedSample;
+
+static int cmp_ranked(const void* a, const void* b) {
+    double x = ((const RankedSample*)a)->value, y = ((const RankedSample*)b)->value;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Two-sided Mann-Whitney U test (normal approximation with tie correction).
+ * @return p-value, or 1.0 if the samples are too small to say anything.
+ */
+static double mann_whitney_p(const double* a, int na, const double* b, int nb) {
+    if (na < 2 || nb < 2) return 1.0;
+
+    int total = na + nb;
+    RankedSample* all = (RankedSample*)malloc(sizeof(RankedSample) * (size_t)total);
+    if (!all) return 1.0;
+    for (int i = 0; i < na; i++) { all[i].value = a[i]; all[i].group = 0; }
+    for (int i = 0; i < nb; i++) { all[na + i].value = b[i]; all[na + i].group = 1; }
+    qsort(all, (size_t)total, sizeof(RankedSample), cmp_ranked);
+
+    // Average ranks over ties; accumulate the tie correction term
+    double rank_sum_a = 0.0, tie_term = 0.0;
+    for (int i = 0; i < total; ) {
+        int j = i;
+        while (j + 1 < total && all[j + 1].value == all[i].value) j++;
+        double avg_rank = 0.5 * (double)(i + j) + 1.0;
+        for (int k = i; k <= j; k++) {
+            if (all[k].group == 0) rank_sum_a += avg_rank;
+        }
+        double t = (double)(j - i + 1);
+        tie_term += t * t * t - t;
+        i = j + 1;
+    }
+    free(all);
+
+    double u = rank_sum_a - (double)na * (na + 1) / 2.0;
+    double mean_u = (double)na * nb / 2.0;
+    double var_u = (double)na * nb / 12.0 *
+                   ((double)(total + 1) - tie_term / ((double)total * (total - 1)));
+    if (var_u <= 0.0) return 1.0;
+
+    double z = (fabs(u - mean_u) - 0.5) / sqrt(var_u); // continuity correction
+    if (z < 0.0) z = 0.0;
+    return erfc(z / sqrt(2.0));
+}
+
+/* ---------- Main ---------- */
+
+static void print_usage(const char* prog) {
+    fprintf(stderr,
+        "Usage: %s [-t threshold_pct] [-a alpha] <base.json> <new.json>\n"
+        "  -t  minimum median slowdown to count as a regression (default 5%%)\n"
+        "  -a  significance level of the Mann-Whitney U test (default 0.05)\n"
+        "Exit status: 0 = no regressions, 1 = regressions found, 2 = usage/input error\n",
+        prog);
+}
+
+int main(int argc, char* argv[]) {
+    double threshold_pct = 5.0;
+    double alpha = 0.05;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "t:a:h")) != -1) {
+        switch (opt) {
+            case 't': threshold_pct = atof(optarg); break;
+            case 'a': alpha = atof(optarg); break;
+            default:
+                print_usage(argv[0]);
+                return 2;
+        }
+    }
+    if (argc - optind != 2 || threshold_pct < 0.0 || alpha <= 0.0 || alpha >= 1.0) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    BenchRun base, cur;
+    if (!load_run(argv[optind], &base)) return 2;
+    if (!load_run(argv[optind + 1], &cur)) { free_run(&base); return 2; }
+
+    printf("%-12s %-9s %6s %12s %12s %9s %9s  %s\n",
+           "algorithm", "family", "n", "base(us)", "new(us)", "change", "p-value", "verdict");
+    printf("------------ --------- ------ ------------ ------------ --------- ---------  -----------\n");
+
+    int regressions = 0, improvements = 0, unchanged = 0, missing = 0;
+    for (int i = 0; i < base.count; i++) {
+        const BenchCase* b = &base.cases[i];
+        const BenchCase* c = find_case(&cur, b);
+        if (!c) {
+            printf("%-12s %-9s %6d %12.2f %12s %9s %9s  %s\n",
+                   b->algorithm, b->family, b->n, b->median / 1e3, "-", "-", "-", "missing");
+            missing++;
+            continue;
+        }
+
+        double change = b->median > 0 ? 100.0 * (c->median - b->median) / b->median : 0.0;
+        double p = mann_whitney_p(b->samples, b->num_samples, c->samples, c->num_samples);
+
+        const char* verdict = "unchanged";
+        if (p < alpha && change > threshold_pct) {
+            verdict = "REGRESSION";
+            regressions++;
+        } else if (p < alpha && change < -threshold_pct) {
+            verdict = "improved";
+            improvements++;
+        } else {
+            unchanged++;
+        }
+
+        printf("%-12s %-9s %6d %12.2f %12.2f %+8.1f%% %9.4f  %s\n",
+               b->algorithm, b->family, b->n, b->median / 1e3, c->median / 1e3,
+               change, p, verdict);
+    }
+
+    printf("\nSummary: %d regressions, %d improvements, %d unchanged, %d missing "
+           "(threshold %.1f%%, alpha %.3f)\n",
+           regressions, improvements, unchanged, missing, threshold_pct, alpha);
+
+    free_run(&base);
+    free_run(&cur);
+    return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,435 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L   // pthread_barrier_t
+#endif
+#include "bfs.h"
+#include "graph_alloc.h"
+#include "parallel.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BFS_MAX_THREADS 64
+#define BFS_CHUNK 1024       // Multiple of 64, so a bottom-up chunk owns whole bitmap words
+#define BFS_ALPHA 14         // Go bottom-up once the frontier has 1/ALPHA of the unexplored arcs
+#define BFS_BETA 24          // Go back top-down once the frontier drops below n/BETA vertices
+
+#define LOAD(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+
+static void* bfs_alloc(AlgorithmWorkspace* ws, size_t bytes) {
+    return ws ? workspace_alloc(ws, bytes) : GRAPH_MALLOC(bytes);
+}
+
+static int csr_build(const Graph* g, GraphCSR* csr, int weighted, AlgorithmWorkspace* ws) {
+    if (!csr) return 0;
+    memset(csr, 0, sizeof(*csr));
+    if (!g || g->n < 1) return 0;
+
+    int n = g->n;
+    long long* offsets = (long long*)bfs_alloc(ws, (size_t)(n + 1) * sizeof(long long));
+    if (!offsets) return 0;
+    offsets[0] = 0;
+    for (int u = 0; u < n; u++) {
+        long long degree = 0;
+        for (EdgeNode* e = g->adj[u].head; e; e = e->next) degree++;
+        offsets[u + 1] = offsets[u] + degree;
+    }
+
+    size_t arcs = (size_t)(offsets[n] > 0 ? offsets[n] : 1);
+    int* targets = (int*)bfs_alloc(ws, arcs * sizeof(int));
+    int* weights = weighted ? (int*)bfs_alloc(ws, arcs * sizeof(int)) : NULL;
+    if (!targets || (weighted && !weights)) {
+        if (!ws) {
+            GRAPH_FREE(offsets);
+            GRAPH_FREE(targets);
+        }
+        return 0;
+    }
+    for (int u = 0; u < n; u++) {
+        long long pos = offsets[u];
+        for (EdgeNode* e = g->adj[u].head; e; e = e->next) {
+            if (weights) weights[pos] = e->weight;
+            targets[pos++] = e->to;
+        }
+    }
+
+    csr->n = n;
+    csr->num_arcs = offsets[n];
+    csr->offsets = offsets;
+    csr->targets = targets;
+    csr->weights = weights;
+    csr->owned = ws == NULL;
+    return 1;
+}
+
+int graph_csr_build(const Graph* g, GraphCSR* csr, AlgorithmWorkspace* ws) {
+    return csr_build(g, csr, 0, ws);
+}
+
+int graph_csr_build_weighted(const Graph* g, GraphCSR* csr, AlgorithmWorkspace* ws) {
+    return csr_build(g, csr, 1, ws);
+}
+
+void graph_csr_free(GraphCSR* csr) {
+    if (!csr) return;
+    if (csr->owned) {
+        GRAPH_FREE(csr->offsets);
+        GRAPH_FREE(csr->targets);
+        GRAPH_FREE(csr->weights);
+    }
+    memset(csr, 0, sizeof(*csr));
+}
+
+void bfs_options_init(BFS_Options* options, int source) {
+    if (!options) return;
+    options->source = source;
+    options->target = -1;
+    options->num_threads = 1;
+    options->filter = NULL;
+    options->filter_ctx = NULL;
+}
+
+void bfs_result_free(BFS_Result* result) {
+    if (!result) return;
+    if (result->owned) {
+        GRAPH_FREE(result->dist);
+        GRAPH_FREE(result->parent);
+    }
+    result->dist = NULL;
+    result->parent = NULL;
+}
+
+/* ---------- Search ---------- */
+
+/**
+ * Vertices found by one thread in the current level. With one thread the
+ * list is taken from the workspace at full size (n) and never grows.
+ */
+typedef struct {
+    int* items;
+    int size;
+    int capacity;
+    int growable;
+} VertexList;
+
+static int list_push(VertexList* list, int v) {
+    if (list->size == list->capacity) {
+        if (!list->growable) return 0;
+        int cap = list->capacity ? list->capacity * 2 : 256;
+        int* grown = (int*)GRAPH_REALLOC(list->items, (size_t)cap * sizeof(int));
+        if (!grown) return 0;
+        list->items = grown;
+        list->capacity = cap;
+    }
+    list->items[list->size++] = v;
+    return 1;
+}
+
+typedef struct {
+    const GraphCSR* csr;
+    const BFS_Options* options;
+    int* dist;
+    int* parent;
+    int* queue;                // Top-down frontier
+    uint64_t* bits[2];         // Bottom-up frontier and the next one
+    int num_threads;
+    ParallelTeam team;
+
+    VertexList lists[BFS_MAX_THREADS];
+    long long degree_sum[BFS_MAX_THREADS];   // Arcs of each thread's new vertices
+    int failed[BFS_MAX_THREADS];
+    int bottom_up_levels;      // Written by thread 0
+} BfsShared;
+
+typedef struct {
+    BfsShared* shared;
+    int index;
+} BfsTask;
+
+static void bfs_sync(BfsShared* s) {
+    parallel_sync(&s->team);
+}
+
+static int follow(const BFS_Options* o, int u, int v) {
+    return !o->filter || o->filter(o->filter_ctx, u, v);
+}
+
+static long long degree(const GraphCSR* csr, int v) {
+    return csr->offsets[v + 1] - csr->offsets[v];
+}
+
+/**
+ * Claim the unvisited neighbors of the queued frontier.
+ */
+static int top_down_step(BfsShared* s, int index, int queue_size, int level,
+                         VertexList* out, long long* arcs) {
+    const GraphCSR* csr = s->csr;
+    int ok = 1;
+    for (int chunk = index * BFS_CHUNK; chunk < queue_size; chunk += s->num_threads * BFS_CHUNK) {
+        int end = chunk + BFS_CHUNK < queue_size ? chunk + BFS_CHUNK : queue_size;
+        for (int i = chunk; i < end; i++) {
+            int u = s->queue[i];
+            for (long long a = csr->offsets[u]; a < csr->offsets[u + 1]; a++) {
+                int v = csr->targets[a];
+                int unvisited = -1;
+                if (LOAD(&s->dist[v]) >= 0 || !follow(s->options, u, v)) continue;
+                if (__atomic_compare_exchange_n(&s->dist[v], &unvisited, level + 1, 0,
+                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                    s->parent[v] = u;
+                    *arcs += degree(csr, v);
+                    if (!list_push(out, v)) ok = 0;
+                }
+            }
+        }
+    }
+    return ok;
+}
+
+/**
+ * Let every unvisited vertex of this thread's chunks find a parent in the
+ * frontier bitmap. Only the owner writes a vertex or its bitmap word.
+ */
+static int bottom_up_step(BfsShared* s, int index, const uint64_t* front, uint64_t* next,
+                          int level, VertexList* out, long long* arcs) {
+    const GraphCSR* csr = s->csr;
+    int n = csr->n;
+    int ok = 1;
+    for (int chunk = index * BFS_CHUNK; chunk < n; chunk += s->num_threads * BFS_CHUNK) {
+        int end = chunk + BFS_CHUNK < n ? chunk + BFS_CHUNK : n;
+        memset(next + chunk / 64, 0, (size_t)((end - chunk + 63) / 64) * sizeof(uint64_t));
+        for (int v = chunk; v < end; v++) {
+            if (LOAD(&s->dist[v]) >= 0) continue;
+            for (long long a = csr->offsets[v]; a < csr->offsets[v + 1]; a++) {
+                int u = csr->targets[a];
+                if (!(front[u >> 6] & (1ULL << (u & 63))) || !follow(s->options, u, v)) continue;
+                STORE(&s->dist[v], level + 1);
+                s->parent[v] = u;
+                next[v >> 6] |= 1ULL << (v & 63);
+                *arcs += degree(csr, v);
+                if (!list_push(out, v)) ok = 0;
+                break;
+            }
+        }
+    }
+    return ok;
+}
+
+static void* bfs_run(void* arg) {
+    BfsTask* t = (BfsTask*)arg;
+    BfsShared* s = t->shared;
+
+    const GraphCSR* csr = s->csr;
+    int n = csr->n;
+    int source = s->options->source;
+    int target = s->options->target;
+    uint64_t* front = s->bits[0];
+    uint64_t* next = s->bits[1];
+    VertexList* out = &s->lists[t->index];
+
+    int level = 0;
+    int bottom_up = 0;
+    int queue_size = 1;
+    int previous_size = 1;
+    long long unexplored = csr->num_arcs - degree(csr, source);
+
+    while (1) {
+        long long arcs = 0;
+        out->size = 0;
+        int ok = bottom_up ? bottom_up_step(s, t->index, front, next, level, out, &arcs)
+                           : top_down_step(s, t->index, queue_size, level, out, &arcs);
+        s->degree_sum[t->index] = arcs;
+        s->failed[t->index] = !ok;
+        bfs_sync(s);
+
+        // Every thread reads the same totals and takes the same decisions
+        int size = 0, failed = 0;
+        long long frontier_arcs = 0;
+        for (int i = 0; i < s->num_threads; i++) {
+            size += s->lists[i].size;
+            frontier_arcs += s->degree_sum[i];
+            failed |= s->failed[i];
+        }
+        int found = target >= 0 && LOAD(&s->dist[target]) >= 0;
+        if (failed || size == 0 || found) break;
+
+        unexplored -= frontier_arcs;
+        int next_bottom_up = bottom_up
+            ? !(size < n / BFS_BETA && size < previous_size)
+            : frontier_arcs > unexplored / BFS_ALPHA;
+        previous_size = size;
+        level++;
+
+        if (next_bottom_up && bottom_up) {
+            uint64_t* tmp = front;
+            front = next;
+            next = tmp;
+        } else if (next_bottom_up) {
+            // Top-down to bottom-up: turn the new vertices into a bitmap
+            for (int chunk = t->index * BFS_CHUNK; chunk < n; chunk += s->num_threads * BFS_CHUNK) {
+                int end = chunk + BFS_CHUNK < n ? chunk + BFS_CHUNK : n;
+                memset(front + chunk / 64, 0, (size_t)((end - chunk + 63) / 64) * sizeof(uint64_t));
+            }
+            bfs_sync(s);
+            for (int i = 0; i < out->size; i++) {
+                int v = out->items[i];
+                __atomic_fetch_or(&front[v >> 6], 1ULL << (v & 63), __ATOMIC_RELAXED);
+            }
+        } else {
+            // Next level top-down: concatenate the lists into the queue
+            int offset = 0;
+            for (int i = 0; i < t->index; i++) offset += s->lists[i].size;
+            if (out->size > 0) memcpy(s->queue + offset, out->items, (size_t)out->size * sizeof(int));
+            queue_size = size;
+        }
+        if (next_bottom_up && t->index == 0) s->bottom_up_levels++;
+        bottom_up = next_bottom_up;
+        bfs_sync(s);
+    }
+    return NULL;
+}
+
+/**
+ * Run the search with dist, parent and the frontiers already set up.
+ * @return 1 on success, 0 if a frontier list could not grow
+ */
+static int bfs_search(BfsShared* s, int num_threads, int n, AlgorithmWorkspace* ws) {
+    s->num_threads = num_threads;
+    s->bottom_up_levels = 0;
+    BfsTask tasks[BFS_MAX_THREADS];
+    for (int i = 0; i < num_threads; i++) {
+        tasks[i].shared = s;
+        tasks[i].index = i;
+        s->lists[i].items = NULL;
+        s->lists[i].size = 0;
+        s->lists[i].capacity = 0;
+        s->lists[i].growable = num_threads > 1;
+    }
+
+    if (num_threads == 1) {
+        s->lists[0].items = (int*)workspace_alloc(ws, (size_t)n * sizeof(int));
+        if (!s->lists[0].items) return 0;
+        s->lists[0].capacity = n;
+        parallel_run(&s->team, 1, bfs_run, tasks, sizeof(BfsTask));
+        return !s->failed[0];
+    }
+
+    // Without the whole team nothing ran: search serially instead
+    if (!parallel_run(&s->team, num_threads, bfs_run, tasks, sizeof(BfsTask))) {
+        return bfs_search(s, 1, n, ws);
+    }
+
+    int ok = 1;
+    for (int i = 0; i < num_threads; i++) {
+        if (s->failed[i]) ok = 0;
+        GRAPH_FREE(s->lists[i].items);
+    }
+    return ok;
+}
+
+/**
+ * BFS with the result taken from @p result_ws (NULL = GRAPH_MALLOC) and the
+ * frontiers from @p ws.
+ */
+static int bfs_into(const GraphCSR* csr, const BFS_Options* options, BFS_Result* result,
+                    AlgorithmWorkspace* result_ws, AlgorithmWorkspace* ws) {
+    int n = csr->n;
+    result->dist = (int*)bfs_alloc(result_ws, (size_t)n * sizeof(int));
+    result->parent = (int*)bfs_alloc(result_ws, (size_t)n * sizeof(int));
+    result->owned = result_ws == NULL;
+    if (!result->dist || !result->parent) {
+        bfs_result_free(result);
+        return 0;
+    }
+
+    WorkspaceMark mark = workspace_mark(ws);
+    size_t words = (size_t)(n + 63) / 64;
+    BfsShared shared;
+    memset(&shared, 0, sizeof(shared));
+    shared.csr = csr;
+    shared.options = options;
+    shared.dist = result->dist;
+    shared.parent = result->parent;
+    shared.queue = (int*)workspace_alloc(ws, (size_t)n * sizeof(int));
+    shared.bits[0] = (uint64_t*)workspace_alloc(ws, words * sizeof(uint64_t));
+    shared.bits[1] = (uint64_t*)workspace_alloc(ws, words * sizeof(uint64_t));
+    int ok = shared.queue && shared.bits[0] && shared.bits[1];
+
+    if (ok) {
+        for (int v = 0; v < n; v++) {
+            result->dist[v] = -1;
+            result->parent[v] = -1;
+        }
+        result->dist[options->source] = 0;
+        shared.queue[0] = options->source;
+
+        int threads = options->num_threads;
+        int max_useful = (n + BFS_CHUNK - 1) / BFS_CHUNK;
+        if (threads > max_useful) threads = max_useful;
+        if (threads > BFS_MAX_THREADS) threads = BFS_MAX_THREADS;
+        if (threads < 1) threads = 1;
+        ok = bfs_search(&shared, threads, n, ws);
+    }
+    workspace_release(ws, mark);
+    if (!ok) {
+        bfs_result_free(result);
+        return 0;
+    }
+
+    result->n = n;
+    result->source = options->source;
+    result->bottom_up_levels = shared.bottom_up_levels;
+    result->reached = 0;
+    result->depth = 0;
+    for (int v = 0; v < n; v++) {
+        if (result->dist[v] < 0) continue;
+        result->reached++;
+        if (result->dist[v] > result->depth) result->depth = result->dist[v];
+    }
+    return 1;
+}
+
+int graph_bfs_ws(const GraphCSR* csr, const BFS_Options* options, BFS_Result* result,
+                 AlgorithmWorkspace* ws) {
+    if (!result) return 0;
+    memset(result, 0, sizeof(*result));
+    if (!csr || !csr->offsets || !options || options->source < 0 ||
+        options->source >= csr->n || options->target >= csr->n) {
+        return 0;
+    }
+
+    AlgorithmWorkspace local;
+    AlgorithmWorkspace* scratch = ws;
+    if (!scratch) {
+        if (!workspace_init(&local, 0)) return 0;
+        scratch = &local;
+    }
+    int ok = bfs_into(csr, options, result, ws, scratch);
+    if (scratch == &local) workspace_destroy(&local);
+    return ok;
+}
+
+int graph_bfs_with_params(const Graph* g, const AlgorithmParams* params,
+                          BFS_Result* result, AlgorithmWorkspace* ws) {
+    if (!result) return 0;
+    memset(result, 0, sizeof(*result));
+    if (!g) return 0;
+
+    BFS_Options options;
+    bfs_options_init(&options, params && params->source >= 0 ? params->source : 0);
+    if (params) options.num_threads = params->num_threads;
+    if (options.source >= g->n) return 0;
+
+    AlgorithmWorkspace local;
+    if (!ws) {
+        if (!workspace_init(&local, 0)) return 0;
+        ws = &local;
+    }
+    WorkspaceMark mark = workspace_mark(ws);
+
+    GraphCSR csr;
+    int ok = graph_csr_build(g, &csr, ws) && bfs_into(&csr, &options, result, NULL, ws);
+
+    workspace_release(ws, mark);
+    if (ws == &local) workspace_destroy(&local);
+    return ok;
+}
@@ -0,0 +1,108 @@
+#ifndef BFS_H
+#define BFS_H
+
+#include "graph.h"
+#include "workspace.h"
+#include "algorithm_params.h"
+
+/**
+ * @file bfs.h
+ * Direction-optimizing breadth-first search over a CSR copy of the graph.
+ *
+ * A top-down step scans the edges of every frontier vertex. Once the
+ * frontier holds a large share of the remaining edges, a bottom-up step is
+ * cheaper: every unvisited vertex looks for one parent in a frontier
+ * bitmap and stops at the first hit. On low-diameter graphs the middle
+ * levels run bottom-up and most edges are never read. Both steps can be
+ * split over threads; top-down claims vertices with a compare-and-swap,
+ * bottom-up gives each thread whole bitmap words.
+ */
+
+/**
+ * Adjacency in compressed sparse row form: the neighbors of v are
+ * targets[offsets[v] .. offsets[v + 1]), in adjacency-list order.
+ */
+typedef struct {
+    int n;
+    long long num_arcs;
+    long long* offsets;   // n + 1 entries
+    int* targets;
+    int* weights;         // Weight of each arc, or NULL (see graph_csr_build_weighted())
+    int owned;            // 1 if the arrays were allocated with GRAPH_MALLOC
+} GraphCSR;
+
+/**
+ * Optional arc test: nonzero if the arc u -> v may be followed. Called from
+ * every BFS thread, so it must not modify shared state.
+ */
+typedef int (*BfsArcFilter)(void* ctx, int u, int v);
+
+typedef struct {
+    int source;
+    int target;            // Stop after the level that reaches it (-1 = visit everything)
+    int num_threads;       // 0 or 1 = single-threaded
+    BfsArcFilter filter;   // NULL = follow every arc
+    void* filter_ctx;
+} BFS_Options;
+
+typedef struct {
+    int n;
+    int source;
+    int* dist;             // Hops from the source, -1 if not reached
+    int* parent;           // BFS tree parent, -1 for the source and unreached vertices
+    int reached;           // Vertices reached (source included)
+    int depth;             // Largest distance reached
+    int bottom_up_levels;  // Levels expanded bottom-up
+    int owned;             // 1 if dist and parent were allocated with GRAPH_MALLOC
+} BFS_Result;
+
+/**
+ * Build the CSR form of @p g.
+ * @param ws Workspace for the arrays (valid until a mark taken before the
+ *           call is released), or NULL for GRAPH_MALLOC
+ * @return 1 on success, 0 on invalid arguments or allocation failure
+ */
+int graph_csr_build(const Graph* g, GraphCSR* csr, AlgorithmWorkspace* ws);
+
+/**
+ * graph_csr_build() that also copies the edge weights into csr->weights,
+ * for consumers that need them (flows and weighted cliques over views).
+ */
+int graph_csr_build_weighted(const Graph* g, GraphCSR* csr, AlgorithmWorkspace* ws);
+
+/**
+ * Free a CSR built without a workspace (no-op otherwise).
+ */
+void graph_csr_free(GraphCSR* csr);
+
+/**
+ * Defaults: full single-threaded BFS from @p source over every arc.
+ */
+void bfs_options_init(BFS_Options* options, int source);
+
+/**
+ * Breadth-first search over @p csr.
+ * @param result OUT: distances and parents (free with bfs_result_free)
+ * @param ws Workspace for the result and the frontiers, or NULL for
+ *           GRAPH_MALLOC; workspace results stay valid until a mark taken
+ *           before the call is released
+ * @return 1 on success, 0 on invalid arguments or allocation failure
+ */
+int graph_bfs_ws(const GraphCSR* csr, const BFS_Options* options, BFS_Result* result,
+                 AlgorithmWorkspace* ws);
+
+/**
+ * Hop distances in @p g from params->source (-1 = vertex 0), with
+ * params->num_threads threads. The result is always allocated with
+ * GRAPH_MALLOC; @p ws only holds the CSR and frontiers.
+ * @return 1 on success, 0 on invalid input or allocation failure
+ */
+int graph_bfs_with_params(const Graph* g, const AlgorithmParams* params,
+                          BFS_Result* result, AlgorithmWorkspace* ws);
+
+/**
+ * Free the distance and parent arrays (no-op for workspace results).
+ */
+void bfs_result_free(BFS_Result* result);
+
+#endif /* BFS_H */
@@ -0,0 +1,317 @@
+#include "bitgraph.h"
+#include "simd_kernels.h"
+#include <stdint.h>
+
+static int kernels_enabled = 1;
+
+/**
+ * Graph type for sets of @p bits vertices: one set per adjacency row.
+ */
+#define BITGRAPH_DEFINE_GRAPH(bits, set)                                  \
+    typedef struct {                                                      \
+        set adj[bits];   /* Neighbors of each vertex, self-loops excluded */ \
+        set vertices;    /* All n vertices */                             \
+        set loops;       /* Vertices with a self-loop */                  \
+        int n;                                                            \
+    } bitgraph##bits##_Graph;
+
+/**
+ * Sets of up to 64 vertices: one machine word.
+ */
+typedef uint64_t BitSet64;
+
+static inline BitSet64 bs64_zero(void) { return 0; }
+static inline BitSet64 bs64_bit(int i) { return (BitSet64)1 << i; }
+static inline BitSet64 bs64_and(BitSet64 a, BitSet64 b) { return a & b; }
+static inline BitSet64 bs64_or(BitSet64 a, BitSet64 b) { return a | b; }
+static inline BitSet64 bs64_andnot(BitSet64 a, BitSet64 b) { return a & ~b; }
+static inline BitSet64 bs64_without(BitSet64 a, int i) { return a & ~bs64_bit(i); }
+static inline void bs64_insert(BitSet64* a, int i) { *a |= bs64_bit(i); }
+static inline int bs64_empty(BitSet64 a) { return a == 0; }
+static inline int bs64_count(BitSet64 a) { return __builtin_popcountll(a); }
+static inline int bs64_first(BitSet64 a) { return __builtin_ctzll(a); }
+
+BITGRAPH_DEFINE_GRAPH(64, BitSet64)
+
+#define BITGRAPH_BITS 64
+#define BS BitSet64
+#define BS_(op) bs64_##op
+#define BG_GRAPH bitgraph64_Graph
+#define BG_(name) bitgraph64_##name
+#include "bitgraph_kernels.h"
+
+#ifdef __SIZEOF_INT128__
+#define BITGRAPH_HAVE_128 1
+
+/**
+ * Sets of up to 128 vertices: the compiler's 128-bit integer.
+ */
+typedef __uint128_t BitSet128;
+
+static inline BitSet128 bs128_zero(void) { return 0; }
+static inline BitSet128 bs128_bit(int i) { return (BitSet128)1 << i; }
+static inline BitSet128 bs128_and(BitSet128 a, BitSet128 b) { return a & b; }
+static inline BitSet128 bs128_or(BitSet128 a, BitSet128 b) { return a | b; }
+static inline BitSet128 bs128_andnot(BitSet128 a, BitSet128 b) { return a & ~b; }
+static inline BitSet128 bs128_without(BitSet128 a, int i) { return a & ~bs128_bit(i); }
+static inline void bs128_insert(BitSet128* a, int i) { *a |= bs128_bit(i); }
+static inline int bs128_empty(BitSet128 a) { return a == 0; }
+
+static inline int bs128_count(BitSet128 a) {
+    return __builtin_popcountll((uint64_t)a) + __builtin_popcountll((uint64_t)(a >> 64));
+}
+
+static inline int bs128_first(BitSet128 a) {
+    uint64_t low = (uint64_t)a;
+    return low ? __builtin_ctzll(low) : 64 + __builtin_ctzll((uint64_t)(a >> 64));
+}
+
+BITGRAPH_DEFINE_GRAPH(128, BitSet128)
+
+#define BITGRAPH_BITS 128
+#define BS BitSet128
+#define BS_(op) bs128_##op
+#define BG_GRAPH bitgraph128_Graph
+#define BG_(name) bitgraph128_##name
+#include "bitgraph_kernels.h"
+#endif
+
+/**
+ * Sets of up to 256 vertices: four words.
+ */
+typedef struct {
+    uint64_t w[4];
+} BitSet256;
+
+static inline BitSet256 bs256_zero(void) {
+    BitSet256 s = {{0, 0, 0, 0}};
+    return s;
+}
+
+static inline BitSet256 bs256_bit(int i) {
+    BitSet256 s = bs256_zero();
+    s.w[i >> 6] = (uint64_t)1 << (i & 63);
+    return s;
+}
+
+static inline BitSet256 bs256_and(BitSet256 a, BitSet256 b) {
+    for (int k = 0; k < 4; k++) a.w[k] &= b.w[k];
+    return a;
+}
+
+static inline BitSet256 bs256_or(BitSet256 a, BitSet256 b) {
+    for (int k = 0; k < 4; k++) a.w[k] |= b.w[k];
+    return a;
+}
+
+static inline BitSet256 bs256_andnot(BitSet256 a, BitSet256 b) {
+    for (int k = 0; k < 4; k++) a.w[k] &= ~b.w[k];
+    return a;
+}
+
+static inline BitSet256 bs256_without(BitSet256 a, int i) {
+    a.w[i >> 6] &= ~((uint64_t)1 << (i & 63));
+    return a;
+}
+
+static inline void bs256_insert(BitSet256* a, int i) {
+    a->w[i >> 6] |= (uint64_t)1 << (i & 63);
+}
+
+static inline int bs256_empty(BitSet256 a) {
+    return (a.w[0] | a.w[1] | a.w[2] | a.w[3]) == 0;
+}
+
+static inline int bs256_count(BitSet256 a) {
+    return __builtin_popcountll(a.w[0]) + __builtin_popcountll(a.w[1]) +
+           __builtin_popcountll(a.w[2]) + __builtin_popcountll(a.w[3]);
+}
+
+static inline int bs256_first(BitSet256 a) {
+    for (int k = 0; k < 3; k++) {
+        if (a.w[k]) return 64 * k + __builtin_ctzll(a.w[k]);
+    }
+    return 192 + __builtin_ctzll(a.w[3]);
+}
+
+BITGRAPH_DEFINE_GRAPH(256, BitSet256)
+
+#define BITGRAPH_BITS 256
+#define BS BitSet256
+#define BS_(op) bs256_##op
+#define BG_GRAPH bitgraph256_Graph
+#define BG_(name) bitgraph256_##name
+#include "bitgraph_kernels.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define BITGRAPH_HAVE_POPCNT 1
+
+/*
+ * The same kernels compiled again for hardware popcount, used when the CPU
+ * has it (simd_level() >= SIMD_LEVEL_SSE42). Counting bits is most of
+ * their work, and the baseline x86-64 build turns every count into a
+ * library call. Wider vector targets were measured slower here: the sets
+ * are passed by value and the 256-bit ones bounce between register files.
+ */
+#pragma GCC push_options
+#pragma GCC target("popcnt")
+
+#define BITGRAPH_BITS 64
+#define BS BitSet64
+#define BS_(op) bs64_##op
+#define BG_GRAPH bitgraph64_Graph
+#define BG_(name) bitgraph64_popcnt_##name
+#include "bitgraph_kernels.h"
+
+#ifdef BITGRAPH_HAVE_128
+#define BITGRAPH_BITS 128
+#define BS BitSet128
+#define BS_(op) bs128_##op
+#define BG_GRAPH bitgraph128_Graph
+#define BG_(name) bitgraph128_popcnt_##name
+#include "bitgraph_kernels.h"
+#endif
+
+#define BITGRAPH_BITS 256
+#define BS BitSet256
+#define BS_(op) bs256_##op
+#define BG_GRAPH bitgraph256_Graph
+#define BG_(name) bitgraph256_popcnt_##name
+#include "bitgraph_kernels.h"
+
+#pragma GCC pop_options
+
+/**
+ * Kernel @p name for @p bits-vertex sets, built for the instructions the
+ * CPU has.
+ */
+#define BITGRAPH_FN(bits, name)                                           \
+    (simd_level() >= SIMD_LEVEL_SSE42 ? bitgraph##bits##_popcnt_##name    \
+                                      : bitgraph##bits##_##name)
+#else
+#define BITGRAPH_FN(bits, name) bitgraph##bits##_##name
+#endif
+
+int bitgraph_width(int n) {
+    if (!kernels_enabled || n < 1 || n > BITGRAPH_MAX_N) return 0;
+    if (n <= 64) return 64;
+#ifdef BITGRAPH_HAVE_128
+    if (n <= 128) return 128;
+#endif
+    return 256;
+}
+
+void bitgraph_set_enabled(int enabled) {
+    kernels_enabled = enabled;
+}
+
+/**
+ * Build the sets of @p g at the width that fits it and call the kernel
+ * @p name, or return 0 if no width fits.
+ */
+#define BITGRAPH_CALL(bits, g, name, ...) {                               \
+        bitgraph##bits##_Graph bg;                                        \
+        BITGRAPH_FN(bits, build)((g), &bg);                               \
+        return BITGRAPH_FN(bits, name)(&bg, __VA_ARGS__);                 \
+    }
+
+#ifdef BITGRAPH_HAVE_128
+#define BITGRAPH_DISPATCH(g, name, ...)                                   \
+    switch (bitgraph_width((g)->n)) {                                     \
+        case 64:  BITGRAPH_CALL(64, g, name, __VA_ARGS__)                 \
+        case 128: BITGRAPH_CALL(128, g, name, __VA_ARGS__)                \
+        case 256: BITGRAPH_CALL(256, g, name, __VA_ARGS__)                \
+        default:  return 0;                                               \
+    }
+#else
+#define BITGRAPH_DISPATCH(g, name, ...)                                   \
+    switch (bitgraph_width((g)->n)) {                                     \
+        case 64:  BITGRAPH_CALL(64, g, name, __VA_ARGS__)                 \
+        case 256: BITGRAPH_CALL(256, g, name, __VA_ARGS__)                \
+        default:  return 0;                                               \
+    }
+#endif
+
+/**
+ * Wrap adjacency rows of at most 64 vertices for the 64-bit kernels.
+ * @return 1 on success, 0 if @p n is out of range.
+ */
+static int rows_graph(const uint64_t* rows, int n, uint64_t loops, bitgraph64_Graph* bg) {
+    if (!rows || n < 1 || n > 64) return 0;
+
+    bg->n = n;
+    bg->vertices = n == 64 ? ~(BitSet64)0 : bs64_bit(n) - 1;
+    bg->loops = loops & bg->vertices;
+    for (int v = 0; v < n; v++) bg->adj[v] = rows[v] & bs64_without(bg->vertices, v);
+    return 1;
+}
+
+int bitgraph_max_clique(const Graph* g, int coloring_bound, SearchBudget* budget,
+                        int* clique, int* size) {
+    if (!g || !clique || !size) return 0;
+
+    // The searches read budget->expired directly, so always pass one
+    SearchBudget unlimited;
+    if (!budget) {
+        search_budget_init(&unlimited, 0);
+        budget = &unlimited;
+    }
+    BITGRAPH_DISPATCH(g, max_clique, coloring_bound, budget, clique, size);
+}
+
+int bitgraph_count_cliques(const Graph* g, int target_size, SearchBudget* budget,
+                           long long* counts_by_size) {
+    if (!g || !counts_by_size || target_size < 0 || target_size > g->n) return 0;
+    BITGRAPH_DISPATCH(g, count_cliques, target_size, budget, counts_by_size);
+}
+
+int bitgraph_count_triangles(const Graph* g, long long* triangle_count) {
+    if (!g || !triangle_count) return 0;
+    BITGRAPH_DISPATCH(g, count_triangles, triangle_count);
+}
+
+int bitgraph_is_connected(const Graph* g, int* connected) {
+    if (!g || !connected) return 0;
+    BITGRAPH_DISPATCH(g, is_connected, connected);
+}
+
+int bitgraph_has_euler_circuit(const Graph* g, int* has_circuit) {
+    if (!g || !has_circuit) return 0;
+    BITGRAPH_DISPATCH(g, has_euler_circuit, has_circuit);
+}
+
+int bitgraph_rows_max_clique(const uint64_t* rows, int n, int coloring_bound,
+                             SearchBudget* budget, int* clique, int* size) {
+    bitgraph64_Graph bg;
+    if (!clique || !size || !rows_graph(rows, n, 0, &bg)) return 0;
+
+    SearchBudget unlimited;
+    if (!budget) {
+        search_budget_init(&unlimited, 0);
+        budget = &unlimited;
+    }
+    return BITGRAPH_FN(64, max_clique)(&bg, coloring_bound, budget, clique, size);
+}
+
+int bitgraph_rows_count_cliques(const uint64_t* rows, int n, int target_size,
+                                SearchBudget* budget, long long* counts_by_size) {
+    bitgraph64_Graph bg;
+    if (!counts_by_size || target_size < 0 || target_size > n ||
+        !rows_graph(rows, n, 0, &bg)) {
+        return 0;
+    }
+    return BITGRAPH_FN(64, count_cliques)(&bg, target_size, budget, counts_by_size);
+}
+
+int bitgraph_rows_count_triangles(const uint64_t* rows, int n, long long* triangle_count) {
+    bitgraph64_Graph bg;
+    if (!triangle_count || !rows_graph(rows, n, 0, &bg)) return 0;
+    return BITGRAPH_FN(64, count_triangles)(&bg, triangle_count);
+}
+
+int bitgraph_rows_has_euler_circuit(const uint64_t* rows, int n, uint64_t loops,
+                                    int* has_circuit) {
+    bitgraph64_Graph bg;
+    if (!has_circuit || !rows_graph(rows, n, loops, &bg)) return 0;
+    return BITGRAPH_FN(64, has_euler_circuit)(&bg, has_circuit);
+}
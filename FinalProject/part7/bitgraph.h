@@ -0,0 +1,113 @@
+#ifndef BITGRAPH_H
+#define BITGRAPH_H
+
+#include <stdint.h>
+#include "graph.h"
+#include "algorithm_params.h"
+
+/**
+ * @file bitgraph.h
+ * Bitset kernels for small graphs.
+ *
+ * When n <= BITGRAPH_MAX_N every adjacency row fits in one fixed-width set:
+ * a uint64_t for n <= 64, a __uint128_t for n <= 128 (where the compiler
+ * has one) and four words for n <= 256. The kernels are compiled once per
+ * width (and once more with hardware popcount, used when simd_level()
+ * reports it), keep the whole graph on the stack and replace the matrix
+ * scans of the general implementations with word-wide AND and popcount.
+ *
+ * Each function returns 1 if it handled the graph, or 0 if the graph is too
+ * large or the kernels are disabled, so the caller can fall back to the
+ * general implementation. graph_has_euler_circuit(), graph_count_triangles(),
+ * graph_max_clique_with_params() and the clique counting functions already
+ * do this.
+ */
+
+#define BITGRAPH_MAX_N 256
+
+/**
+ * Width of the sets used for a graph with @p n vertices (64, 128 or 256).
+ * @return The width, or 0 if @p n is too large or the kernels are disabled.
+ */
+int bitgraph_width(int n);
+
+/**
+ * Turn the kernels on or off (default on), e.g. to measure the general
+ * implementations. Set it before starting threads that run algorithms.
+ */
+void bitgraph_set_enabled(int enabled);
+
+/**
+ * Maximum clique. Vertices of the clique are written to @p clique (at least
+ * n ints). With @p coloring_bound the search uses a greedy coloring bound
+ * and the vertices are not sorted; otherwise it is the backtracking search
+ * of graph_max_clique(), pruned by candidate count, and returns the same
+ * clique in ascending order.
+ *
+ * @param budget Time budget, or NULL for none; budget->expired is set if it ran out
+ * @return 1 if handled, 0 otherwise
+ */
+int bitgraph_max_clique(const Graph* g, int coloring_bound, SearchBudget* budget,
+                        int* clique, int* size);
+
+/**
+ * Count cliques of size @p target_size, or of every size if it is 0.
+ * Counts are added to @p counts_by_size (n + 1 entries, indexed by size).
+ *
+ * @param budget Time budget, or NULL for none; budget->expired is set if it ran out
+ * @return 1 if handled, 0 otherwise
+ */
+int bitgraph_count_cliques(const Graph* g, int target_size, SearchBudget* budget,
+                           long long* counts_by_size);
+
+/**
+ * Count triangles.
+ * @return 1 if handled, 0 otherwise
+ */
+int bitgraph_count_triangles(const Graph* g, long long* triangle_count);
+
+/**
+ * Check that all vertices with at least one edge are in one component.
+ * @return 1 if handled, 0 otherwise
+ */
+int bitgraph_is_connected(const Graph* g, int* connected);
+
+/**
+ * Same test as graph_has_euler_circuit(): connected ignoring isolated
+ * vertices, every degree even, at least one edge.
+ * @return 1 if handled, 0 otherwise
+ */
+int bitgraph_has_euler_circuit(const Graph* g, int* has_circuit);
+
+/**
+ * bitgraph_max_clique() on a graph of at most 64 vertices given as
+ * adjacency rows: bit j of rows[i] is set when i--j is an edge. Diagonal
+ * bits and bits at or above n are ignored. The rows_ functions work even
+ * when the kernels are disabled.
+ * @return 1 on success, 0 for invalid arguments
+ */
+int bitgraph_rows_max_clique(const uint64_t* rows, int n, int coloring_bound,
+                             SearchBudget* budget, int* clique, int* size);
+
+/**
+ * bitgraph_count_cliques() on adjacency rows.
+ * @return 1 on success, 0 for invalid arguments
+ */
+int bitgraph_rows_count_cliques(const uint64_t* rows, int n, int target_size,
+                                SearchBudget* budget, long long* counts_by_size);
+
+/**
+ * bitgraph_count_triangles() on adjacency rows.
+ * @return 1 on success, 0 for invalid arguments
+ */
+int bitgraph_rows_count_triangles(const uint64_t* rows, int n, long long* triangle_count);
+
+/**
+ * bitgraph_has_euler_circuit() on adjacency rows; bit i of @p loops is set
+ * when vertex i has a self-loop.
+ * @return 1 on success, 0 for invalid arguments
+ */
+int bitgraph_rows_has_euler_circuit(const uint64_t* rows, int n, uint64_t loops,
+                                    int* has_circuit);
+
+#endif /* BITGRAPH_H */
@@ -0,0 +1,238 @@
+/**
+ * @file bitgraph_kernels.h
+ * Kernel bodies for one set width. bitgraph.c includes this file once per
+ * width and instruction set after defining:
+ *   BITGRAPH_BITS  capacity of the set type in vertices
+ *   BS             the set type
+ *   BS_(op)        name of a set operation (zero, bit, and, or, andnot,
+ *                  without, insert, empty, count, first)
+ *   BG_GRAPH       the graph type for this width
+ *   BG_(name)      name of a kernel for this width and instruction set
+ * It is not a public header and has no include guard.
+ */
+
+static void BG_(build)(const Graph* g, BG_GRAPH* bg) {
+    bg->n = g->n;
+    bg->vertices = BS_(zero)();
+    bg->loops = BS_(zero)();
+
+    for (int v = 0; v < g->n; v++) {
+        BS* row = &bg->adj[v];
+        *row = BS_(zero)();
+        for (EdgeNode* e = g->adj[v].head; e; e = e->next) {
+            if (e->to == v) BS_(insert)(&bg->loops, v);
+            else BS_(insert)(row, e->to);
+        }
+        BS_(insert)(&bg->vertices, v);
+    }
+}
+
+/**
+ * Vertices with at least one edge (a self-loop counts).
+ */
+static BS BG_(active)(const BG_GRAPH* bg) {
+    BS active = bg->loops;
+    for (int v = 0; v < bg->n; v++) {
+        if (!BS_(empty)(bg->adj[v])) active = BS_(or)(active, BS_(bit)(v));
+    }
+    return active;
+}
+
+/**
+ * Breadth-first search one frontier at a time.
+ * @return 1 if all of @p required is reachable from its first vertex.
+ */
+static int BG_(reaches_all)(const BG_GRAPH* bg, BS required) {
+    if (BS_(empty)(required)) return 1;
+
+    BS seen = BS_(bit)(BS_(first)(required));
+    BS frontier = seen;
+    while (!BS_(empty)(frontier)) {
+        BS reached = BS_(zero)();
+        while (!BS_(empty)(frontier)) {
+            int v = BS_(first)(frontier);
+            frontier = BS_(without)(frontier, v);
+            reached = BS_(or)(reached, bg->adj[v]);
+        }
+        frontier = BS_(andnot)(reached, seen);
+        seen = BS_(or)(seen, frontier);
+    }
+    return BS_(empty)(BS_(andnot)(required, seen));
+}
+
+static int BG_(is_connected)(const BG_GRAPH* bg, int* connected) {
+    *connected = BG_(reaches_all)(bg, BG_(active)(bg));
+    return 1;
+}
+
+static int BG_(has_euler_circuit)(const BG_GRAPH* bg, int* has_circuit) {
+    // A self-loop adds 2 to the degree, so only the row parity matters
+    BS active = BG_(active)(bg);
+    int ok = !BS_(empty)(active) && BG_(reaches_all)(bg, active);
+    for (int v = 0; v < bg->n && ok; v++) {
+        if (BS_(count)(bg->adj[v]) & 1) ok = 0;
+    }
+    *has_circuit = ok;
+    return 1;
+}
+
+static int BG_(count_triangles)(const BG_GRAPH* bg, long long* triangle_count) {
+    // For each edge i < j, the common neighbors above j close a triangle
+    long long count = 0;
+    BS later = bg->vertices;
+    for (int i = 0; i < bg->n; i++) {
+        later = BS_(without)(later, i);
+        BS higher = BS_(and)(bg->adj[i], later);
+        while (!BS_(empty)(higher)) {
+            int j = BS_(first)(higher);
+            higher = BS_(without)(higher, j);
+            count += BS_(count)(BS_(and)(higher, bg->adj[j]));
+        }
+    }
+    *triangle_count = count;
+    return 1;
+}
+
+/**
+ * Count every clique extending the current one (of @p size vertices) with
+ * vertices from @p candidates, all of which are adjacent to it.
+ */
+static void BG_(count_all)(const BG_GRAPH* bg, BS candidates, int size,
+                           long long* counts_by_size, SearchBudget* budget) {
+    while (!BS_(empty)(candidates)) {
+        if (search_budget_expired(budget)) return;
+
+        int v = BS_(first)(candidates);
+        candidates = BS_(without)(candidates, v);
+        counts_by_size[size + 1]++;
+
+        BS next = BS_(and)(candidates, bg->adj[v]);
+        if (!BS_(empty)(next)) BG_(count_all)(bg, next, size + 1, counts_by_size, budget);
+    }
+}
+
+/**
+ * Count the cliques of @p target vertices extending the current one.
+ */
+static void BG_(count_size)(const BG_GRAPH* bg, BS candidates, int size, int target,
+                            long long* count, SearchBudget* budget) {
+    // Every remaining candidate completes a clique
+    if (size + 1 == target) {
+        *count += BS_(count)(candidates);
+        return;
+    }
+
+    while (!BS_(empty)(candidates)) {
+        if (size + BS_(count)(candidates) < target) return;
+        if (search_budget_expired(budget)) return;
+
+        int v = BS_(first)(candidates);
+        candidates = BS_(without)(candidates, v);
+        BG_(count_size)(bg, BS_(and)(candidates, bg->adj[v]), size + 1, target, count, budget);
+    }
+}
+
+static int BG_(count_cliques)(const BG_GRAPH* bg, int target_size, SearchBudget* budget,
+                              long long* counts_by_size) {
+    if (target_size > 0) {
+        BG_(count_size)(bg, bg->vertices, 0, target_size, &counts_by_size[target_size], budget);
+    } else {
+        BG_(count_all)(bg, bg->vertices, 0, counts_by_size, budget);
+    }
+    return 1;
+}
+
+typedef struct {
+    const BG_GRAPH* bg;
+    int current[BITGRAPH_BITS];   // current[d] chosen at depth d
+    int* best_clique;
+    int best_size;
+    SearchBudget* budget;
+} BG_(CliqueSearch);
+
+static void BG_(record)(BG_(CliqueSearch)* cs, int size) {
+    cs->best_size = size;
+    for (int i = 0; i < size; i++) cs->best_clique[i] = cs->current[i];
+}
+
+/**
+ * Backtracking in ascending vertex order, skipping branches whose
+ * candidates cannot make a larger clique.
+ */
+static void BG_(backtrack)(BG_(CliqueSearch)* cs, BS candidates, int depth) {
+    if (search_budget_expired(cs->budget)) return;
+    if (depth > cs->best_size) BG_(record)(cs, depth);
+
+    while (!BS_(empty)(candidates)) {
+        if (depth + BS_(count)(candidates) <= cs->best_size) return;
+
+        int v = BS_(first)(candidates);
+        candidates = BS_(without)(candidates, v);
+        cs->current[depth] = v;
+        BG_(backtrack)(cs, BS_(and)(candidates, cs->bg->adj[v]), depth + 1);
+        if (cs->budget->expired) return;
+    }
+}
+
+/**
+ * Branch and bound with a greedy coloring bound: the candidates are split
+ * into independent sets, and a vertex in the k-th set cannot extend the
+ * clique by more than k.
+ */
+static void BG_(color_expand)(BG_(CliqueSearch)* cs, BS candidates, int depth) {
+    if (search_budget_expired(cs->budget)) return;
+
+    unsigned char order[BITGRAPH_BITS];
+    unsigned short color[BITGRAPH_BITS];
+    int count = 0;
+    int c = 0;
+    BS uncolored = candidates;
+    while (!BS_(empty)(uncolored)) {
+        c++;
+        BS available = uncolored;
+        while (!BS_(empty)(available)) {
+            int v = BS_(first)(available);
+            uncolored = BS_(without)(uncolored, v);
+            available = BS_(andnot)(BS_(without)(available, v), cs->bg->adj[v]);
+            order[count] = (unsigned char)v;
+            color[count++] = (unsigned short)c;
+        }
+    }
+
+    // Highest colors first; once depth + color cannot beat the best, stop
+    for (int i = count - 1; i >= 0; i--) {
+        if (depth + color[i] <= cs->best_size) return;
+
+        int v = order[i];
+        cs->current[depth] = v;
+        BS next = BS_(and)(candidates, cs->bg->adj[v]);
+        if (BS_(empty)(next)) {
+            if (depth + 1 > cs->best_size) BG_(record)(cs, depth + 1);
+        } else {
+            BG_(color_expand)(cs, next, depth + 1);
+            if (cs->budget->expired) return;
+        }
+        candidates = BS_(without)(candidates, v);
+    }
+}
+
+static int BG_(max_clique)(const BG_GRAPH* bg, int coloring_bound, SearchBudget* budget,
+                           int* clique, int* size) {
+    BG_(CliqueSearch) cs;
+    cs.bg = bg;
+    cs.best_clique = clique;
+    cs.best_size = 0;
+    cs.budget = budget;
+
+    if (coloring_bound) BG_(color_expand)(&cs, bg->vertices, 0);
+    else BG_(backtrack)(&cs, bg->vertices, 0);
+
+    *size = cs.best_size;
+    return 1;
+}
+
+#undef BITGRAPH_BITS
+#undef BS
+#undef BS_
+#undef BG_GRAPH
+#undef BG_
@@ -45,13 +45,17 @@ int main(int argc, char* argv[]) {
     printf("2. Max Flow (weighted) - shows flow value and source/sink\n");
     printf("3. MST Weight (weighted) - shows all edges with weights\n");
     printf("4. Max Clique (unweighted) - shows clique vertices\n");
-    printf("5. Clique Count (unweighted) - shows detailed breakdown\n\n");
+    printf("5. Clique Count (unweighted) - shows detailed breakdown\n");
+    printf("6. Shortest Paths (weighted) - distances from vertex 0\n");
+    printf("7. Hop Distances (edge list, weights ignored) - BFS levels from vertex 0\n");
+    printf("8. Max Weight Clique (weighted, self-loop u u w = vertex weight) - heaviest clique\n");
+    printf("9. Graph Coloring (edge list, weights ignored) - color of each vertex\n\n");
     
     while (1) {
         int algorithm_id, n;
         
         // Get algorithm choice
-        printf("Enter algorithm ID (1-5, 0 to exit): ");
+        printf("Enter algorithm ID (1-9, 0 to exit): ");
         scanf("%d", &algorithm_id);
         
         if (algorithm_id == 0) {
@@ -59,8 +63,8 @@ int main(int argc, char* argv[]) {
             break;
         }
         
-        if (algorithm_id < 1 || algorithm_id > 5) {
-            printf("Invalid algorithm ID. Please enter 1-5.\n");
+        if (algorithm_id < 1 || algorithm_id > 9) {
+            printf("Invalid algorithm ID. Please enter 1-9.\n");
             continue;
         }
         
@@ -74,8 +78,8 @@ int main(int argc, char* argv[]) {
         }
         
         // Different protocols based on algorithm
-        if (algorithm_id == 2 || algorithm_id == 3) { // Max Flow or MST - weighted protocol
-            printf("\n*** Max Flow/MST Algorithm - Weighted Graph Mode ***\n");
+        if (algorithm_id == 2 || algorithm_id == 3 || algorithm_id >= 6) { // Max Flow, MST, SSSP, hops, weighted clique or coloring - weighted protocol
+            printf("\n*** Max Flow/MST/SSSP/Hops/Weighted Clique/Coloring Algorithm - Weighted Graph Mode ***\n");
             
             // Weighted protocol: [algorithm_id][n][num_edges][edge_list]
             // Each edge: [src][dest][weight]
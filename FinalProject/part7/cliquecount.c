@@ -1,7 +1,18 @@
 #include "cliquecount.h"
+#include "graph_alloc.h"
+#include "bitgraph.h"
+#include "simd_kernels.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
+
+/* Triangle counting above the bitset kernels: neighbors are intersected as
+ * bitset rows when there is an edge per TRIANGLE_ROWS_WORDS_PER_EDGE row
+ * words and the rows take at most TRIANGLE_ROWS_MAX_BYTES, otherwise as
+ * sorted lists. */
+#define TRIANGLE_ROWS_WORDS_PER_EDGE 4
+#define TRIANGLE_ROWS_MAX_BYTES (64u << 20)
 
 /**
  * Build adjacency matrix from adjacency list for efficient clique operations.
@@ -46,7 +57,11 @@ static int is_connected_to_all(int** adj_matrix, int v, int* current_clique, int
  */
 static void count_cliques_recursive(int** adj_matrix, int n, int start_vertex,
                                    int* current_clique, int current_size,
-                                   int* counts_by_size, int max_possible_size) {
+                                   long long* counts_by_size, int max_possible_size,
+                                   SearchBudget* budget) {
+    
+    // Out of time: the counts become lower bounds
+    if (search_budget_expired(budget)) return;
     
     // Count current clique if size >= 1
     if (current_size > 0 && current_size <= max_possible_size) {
@@ -63,7 +78,7 @@ static void count_cliques_recursive(int** adj_matrix, int n, int start_vertex,
             // Recursive call
             count_cliques_recursive(adj_matrix, n, v + 1, 
                                    current_clique, current_size + 1,
-                                   counts_by_size, max_possible_size);
+                                   counts_by_size, max_possible_size, budget);
         }
     }
 }
@@ -73,7 +88,10 @@ static void count_cliques_recursive(int** adj_matrix, int n, int start_vertex,
  */
 static void count_cliques_of_size_recursive(int** adj_matrix, int n, int start_vertex,
                                            int* current_clique, int current_size,
-                                           int target_size, int* count) {
+                                           int target_size, long long* count, SearchBudget* budget) {
+    
+    // Out of time: the count becomes a lower bound
+    if (search_budget_expired(budget)) return;
     
     // Found a clique of target size
     if (current_size == target_size) {
@@ -96,92 +114,210 @@ static void count_cliques_of_size_recursive(int** adj_matrix, int n, int start_v
             // Recursive call
             count_cliques_of_size_recursive(adj_matrix, n, v + 1, 
                                            current_clique, current_size + 1,
-                                           target_size, count);
+                                           target_size, count, budget);
+        }
+    }
+}
+
+/**
+ * Work of one clique counting thread. Thread t takes the start vertices
+ * t, t + T, t + 2T, ... so the large subtrees of low vertices are spread out.
+ */
+typedef struct {
+    int** adj_matrix;           // Shared, read-only
+    int n;
+    int target_size;            // 0 = all sizes
+    int thread_index;
+    int num_threads;
+    int* current_clique;        // n ints, private
+    long long* counts_by_size;  // n + 1 counts, private
+    SearchBudget budget;        // Private copy of the shared deadline
+} CliqueCountTask;
+
+static void* clique_count_task_run(void* arg) {
+    CliqueCountTask* t = (CliqueCountTask*)arg;
+    
+    for (int v = t->thread_index; v < t->n && !t->budget.expired; v += t->num_threads) {
+        t->current_clique[0] = v;
+        if (t->target_size > 0) {
+            count_cliques_of_size_recursive(t->adj_matrix, t->n, v + 1, t->current_clique, 1,
+                                           t->target_size, &t->counts_by_size[t->target_size],
+                                           &t->budget);
+        } else {
+            count_cliques_recursive(t->adj_matrix, t->n, v + 1, t->current_clique, 1,
+                                   t->counts_by_size, t->n, &t->budget);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Fill counts_by_size using the backtracking search, split over
+ * params->num_threads threads.
+ * @return 1 on success, 0 on allocation failure.
+ */
+static int count_cliques_search(const Graph* g, const AlgorithmParams* params, int target_size,
+                                CliqueCount_Result* result, AlgorithmWorkspace* ws) {
+    int n = g->n;
+    int num_threads = (params && params->num_threads > 1) ? params->num_threads : 1;
+    if (num_threads > n) num_threads = n;
+    
+    // Single-threaded search on a small graph: bitset kernels, no matrix needed
+    if (num_threads == 1) {
+        SearchBudget budget;
+        search_budget_init(&budget, params ? params->time_budget_ms : 0);
+        if (bitgraph_count_cliques(g, target_size, &budget, result->counts_by_size)) {
+            result->timed_out = budget.expired;
+            return 1;
         }
     }
+    
+    int** adj_matrix = workspace_matrix(ws, n);
+    CliqueCountTask* tasks = (CliqueCountTask*)workspace_alloc(ws, num_threads * sizeof(CliqueCountTask));
+    pthread_t* threads = (pthread_t*)workspace_alloc(ws, num_threads * sizeof(pthread_t));
+    int* started = (int*)workspace_calloc(ws, num_threads, sizeof(int));
+    if (!adj_matrix || !tasks || !threads || !started) return 0;
+    
+    build_adjacency_matrix(g, adj_matrix);
+    
+    SearchBudget budget;
+    search_budget_init(&budget, params ? params->time_budget_ms : 0);
+    
+    for (int t = 0; t < num_threads; t++) {
+        tasks[t].adj_matrix = adj_matrix;
+        tasks[t].n = n;
+        tasks[t].target_size = target_size;
+        tasks[t].thread_index = t;
+        tasks[t].num_threads = num_threads;
+        tasks[t].current_clique = (int*)workspace_alloc(ws, n * sizeof(int));
+        tasks[t].counts_by_size = (long long*)workspace_calloc(ws, n + 1, sizeof(long long));
+        tasks[t].budget = budget;
+        if (!tasks[t].current_clique || !tasks[t].counts_by_size) return 0;
+    }
+    
+    // Thread 0 runs on the caller; a thread that cannot be started runs inline
+    for (int t = 1; t < num_threads; t++) {
+        started[t] = pthread_create(&threads[t], NULL, clique_count_task_run, &tasks[t]) == 0;
+    }
+    clique_count_task_run(&tasks[0]);
+    for (int t = 1; t < num_threads; t++) {
+        if (started[t]) pthread_join(threads[t], NULL);
+        else clique_count_task_run(&tasks[t]);
+    }
+    
+    // Merge the per-thread counts
+    for (int t = 0; t < num_threads; t++) {
+        for (int k = 1; k <= n; k++) {
+            result->counts_by_size[k] += tasks[t].counts_by_size[k];
+        }
+        if (tasks[t].budget.expired) result->timed_out = 1;
+    }
+    return 1;
 }
 
 /**
  * Count all cliques in the graph.
  */
 int graph_count_all_cliques(const Graph* g, CliqueCount_Result* result) {
+    return graph_count_all_cliques_ws(g, result, NULL);
+}
+
+/**
+ * Count all cliques with all scratch memory taken from a workspace.
+ */
+int graph_count_all_cliques_ws(const Graph* g, CliqueCount_Result* result, AlgorithmWorkspace* ws) {
+    return graph_count_cliques_with_params(g, NULL, result, ws);
+}
+
+/**
+ * Count cliques as requested by @p params (all sizes or one size, with a
+ * time budget and a thread count).
+ */
+int graph_count_cliques_with_params(const Graph* g, const AlgorithmParams* params,
+                                    CliqueCount_Result* result, AlgorithmWorkspace* ws) {
     if (!g || !result) return 0;
     
     int n = g->n;
+    int target_size = params ? params->clique_size : 0;
     
     // Initialize result
     result->counts_by_size = NULL;
     result->max_size = 0;
     result->total_cliques = 0;
     result->is_valid = 0;
+    result->timed_out = 0;
     
-    if (n == 0) {
+    if (n == 0 || target_size > n) {
         result->is_valid = 1;
         return 1;
     }
     
     // Allocate counts array (index 0 unused, indices 1 to n for clique sizes)
-    result->counts_by_size = (int*)calloc(n + 1, sizeof(int));
+    result->counts_by_size = (long long*)GRAPH_CALLOC(n + 1, sizeof(long long));
     if (!result->counts_by_size) return 0;
     
-    // Allocate adjacency matrix
-    int** adj_matrix = (int**)malloc(n * sizeof(int*));
-    if (!adj_matrix) {
-        free(result->counts_by_size);
-        return 0;
-    }
-    
-    for (int i = 0; i < n; i++) {
-        adj_matrix[i] = (int*)malloc(n * sizeof(int));
-        if (!adj_matrix[i]) {
-            for (int j = 0; j < i; j++) free(adj_matrix[j]);
-            free(adj_matrix);
-            free(result->counts_by_size);
+    // Without a caller workspace, use a temporary one for this call
+    AlgorithmWorkspace local;
+    if (!ws) {
+        if (!workspace_init(&local, 0)) {
+            GRAPH_FREE(result->counts_by_size);
+            result->counts_by_size = NULL;
             return 0;
         }
+        ws = &local;
     }
-    
-    // Build adjacency matrix
-    build_adjacency_matrix(g, adj_matrix);
-    
-    // Allocate working array
-    int* current_clique = (int*)malloc(n * sizeof(int));
-    if (!current_clique) {
-        for (int i = 0; i < n; i++) free(adj_matrix[i]);
-        free(adj_matrix);
-        free(result->counts_by_size);
-        return 0;
+    WorkspaceMark mark = workspace_mark(ws);
+    
+    // Small sizes have direct formulas; everything else needs the search
+    int ok = 1;
+    if (target_size == 1) {
+        result->counts_by_size[1] = n;
+    } else if (target_size == 2) {
+        ok = graph_count_edges(g, &result->counts_by_size[2]);
+    } else if (target_size == 3) {
+        ok = graph_count_triangles_ws(g, &result->counts_by_size[3], ws);
+    } else {
+        ok = count_cliques_search(g, params, target_size, result, ws);
     }
     
-    // Count cliques starting from each vertex
-    count_cliques_recursive(adj_matrix, n, 0, current_clique, 0, result->counts_by_size, n);
-    
-    // Calculate total and find max size
-    int total = 0;
-    int max_size = 0;
-    for (int i = 1; i <= n; i++) {
-        if (result->counts_by_size[i] > 0) {
-            total += result->counts_by_size[i];
-            max_size = i;
+    if (ok) {
+        // Calculate total and find max size
+        long long total = 0;
+        int max_size = 0;
+        for (int i = 1; i <= n; i++) {
+            if (result->counts_by_size[i] > 0) {
+                total += result->counts_by_size[i];
+                max_size = i;
+            }
         }
+        
+        result->total_cliques = total;
+        result->max_size = max_size;
+        result->is_valid = 1;
+    } else {
+        GRAPH_FREE(result->counts_by_size);
+        result->counts_by_size = NULL;
     }
     
-    result->total_cliques = total;
-    result->max_size = max_size;
-    result->is_valid = 1;
-    
     // Cleanup
-    free(current_clique);
-    for (int i = 0; i < n; i++) free(adj_matrix[i]);
-    free(adj_matrix);
+    workspace_release(ws, mark);
+    if (ws == &local) workspace_destroy(&local);
     
-    return 1;
+    return ok;
 }
 
 /**
  * Count cliques of a specific size.
  */
-int graph_count_cliques_of_size(const Graph* g, int clique_size, int* count) {
+int graph_count_cliques_of_size(const Graph* g, int clique_size, long long* count) {
+    return graph_count_cliques_of_size_ws(g, clique_size, count, NULL);
+}
+
+/**
+ * Count cliques of a specific size using a workspace.
+ */
+int graph_count_cliques_of_size_ws(const Graph* g, int clique_size, long long* count,
+                                   AlgorithmWorkspace* ws) {
     if (!g || !count || clique_size < 1) return 0;
     
     int n = g->n;
@@ -189,39 +325,39 @@ int graph_count_cliques_of_size(const Graph* g, int clique_size, int* count) {
     
     if (clique_size > n) return 1; // No cliques larger than number of vertices
     
-    // Allocate adjacency matrix
-    int** adj_matrix = (int**)malloc(n * sizeof(int*));
-    if (!adj_matrix) return 0;
-    
-    for (int i = 0; i < n; i++) {
-        adj_matrix[i] = (int*)malloc(n * sizeof(int));
-        if (!adj_matrix[i]) {
-            for (int j = 0; j < i; j++) free(adj_matrix[j]);
-            free(adj_matrix);
-            return 0;
-        }
+    // Small graphs: bitset kernels, no matrix or workspace needed
+    long long small_counts[BITGRAPH_MAX_N + 1] = {0};
+    if (bitgraph_count_cliques(g, clique_size, NULL, small_counts)) {
+        *count = small_counts[clique_size];
+        return 1;
     }
     
-    // Build adjacency matrix
-    build_adjacency_matrix(g, adj_matrix);
-    
-    // Allocate working array
-    int* current_clique = (int*)malloc(n * sizeof(int));
-    if (!current_clique) {
-        for (int i = 0; i < n; i++) free(adj_matrix[i]);
-        free(adj_matrix);
-        return 0;
+    // Without a caller workspace, use a temporary one for this call
+    AlgorithmWorkspace local;
+    if (!ws) {
+        if (!workspace_init(&local, 0)) return 0;
+        ws = &local;
+    }
+    WorkspaceMark mark = workspace_mark(ws);
+    
+    // Scratch: adjacency matrix and working array
+    int** adj_matrix = workspace_matrix(ws, n);
+    int* current_clique = (int*)workspace_alloc(ws, n * sizeof(int));
+    
+    int ok = adj_matrix && current_clique;
+    if (ok) {
+        // Build adjacency matrix
+        build_adjacency_matrix(g, adj_matrix);
+        
+        // Count cliques of specific size
+        count_cliques_of_size_recursive(adj_matrix, n, 0, current_clique, 0, clique_size, count, NULL);
     }
-    
-    // Count cliques of specific size
-    count_cliques_of_size_recursive(adj_matrix, n, 0, current_clique, 0, clique_size, count);
     
     // Cleanup
-    free(current_clique);
-    for (int i = 0; i < n; i++) free(adj_matrix[i]);
-    free(adj_matrix);
+    workspace_release(ws, mark);
+    if (ws == &local) workspace_destroy(&local);
     
-    return 1;
+    return ok;
 }
 
 /**
@@ -246,13 +382,13 @@ void graph_print_clique_counts(const Graph* g) {
     }
     
     printf("Clique Count Analysis:\n");
-    printf("Total cliques: %d\n", result.total_cliques);
+    printf("Total cliques: %lld\n", result.total_cliques);
     printf("Maximum clique size: %d\n", result.max_size);
     printf("\nBreakdown by size:\n");
     
     for (int i = 1; i <= result.max_size; i++) {
         if (result.counts_by_size[i] > 0) {
-            printf("  Size %d: %d cliques\n", i, result.counts_by_size[i]);
+            printf("  Size %d: %lld cliques\n", i, result.counts_by_size[i]);
         }
     }
     
@@ -268,7 +404,7 @@ void graph_print_clique_counts(const Graph* g) {
  */
 void clique_count_result_free(CliqueCount_Result* result) {
     if (result && result->counts_by_size) {
-        free(result->counts_by_size);
+        GRAPH_FREE(result->counts_by_size);
         result->counts_by_size = NULL;
         result->max_size = 0;
         result->total_cliques = 0;
@@ -277,59 +413,139 @@ void clique_count_result_free(CliqueCount_Result* result) {
 }
 
 /**
- * Count triangles (3-cliques) in the graph - optimized version.
+ * Compare ints for qsort().
  */
-int graph_count_triangles(const Graph* g, int* triangle_count) {
-    if (!g || !triangle_count) return 0;
-    
+static int cmp_int(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Count triangles of a graph too large for the bitset kernels. Each vertex
+ * keeps its higher neighbors, and a triangle i < j < k is counted once, as
+ * a common higher neighbor k of the edge i--j. The intersections run on the
+ * SIMD kernels picked for the CPU.
+ */
+static int count_triangles_large(const Graph* g, long long* triangle_count, AlgorithmWorkspace* ws) {
     int n = g->n;
-    *triangle_count = 0;
-    
-    if (n < 3) return 1; // Need at least 3 vertices for triangle
     
-    // Allocate adjacency matrix
-    int** adj_matrix = (int**)malloc(n * sizeof(int*));
-    if (!adj_matrix) return 0;
+    // Higher neighbors of each vertex as sorted lists without duplicates
+    long long* start = (long long*)workspace_alloc(ws, (size_t)(n + 1) * sizeof(long long));
+    int* size = (int*)workspace_alloc(ws, (size_t)n * sizeof(int));
+    if (!start || !size) return 0;
     
-    for (int i = 0; i < n; i++) {
-        adj_matrix[i] = (int*)malloc(n * sizeof(int));
-        if (!adj_matrix[i]) {
-            for (int j = 0; j < i; j++) free(adj_matrix[j]);
-            free(adj_matrix);
-            return 0;
+    start[0] = 0;
+    for (int u = 0; u < n; u++) {
+        int higher = 0;
+        for (EdgeNode* edge = g->adj[u].head; edge; edge = edge->next) {
+            if (edge->to > u) higher++;
         }
+        start[u + 1] = start[u] + higher;
     }
     
-    // Build adjacency matrix
-    build_adjacency_matrix(g, adj_matrix);
+    int* lists = (int*)workspace_alloc(ws, (size_t)start[n] * sizeof(int));
+    if (!lists) return 0;
     
-    // Count triangles: for each triple (i,j,k) where i < j < k
-    int count = 0;
-    for (int i = 0; i < n; i++) {
-        for (int j = i + 1; j < n; j++) {
-            if (adj_matrix[i][j]) {
-                for (int k = j + 1; k < n; k++) {
-                    if (adj_matrix[i][k] && adj_matrix[j][k]) {
-                        count++;
-                    }
-                }
+    long long edges = 0;
+    for (int u = 0; u < n; u++) {
+        int* list = lists + start[u];
+        int len = 0;
+        for (EdgeNode* edge = g->adj[u].head; edge; edge = edge->next) {
+            if (edge->to > u) list[len++] = edge->to;
+        }
+        qsort(list, (size_t)len, sizeof(int), cmp_int);
+    
+        size[u] = 0;
+        for (int i = 0; i < len; i++) {
+            if (size[u] == 0 || list[i] != list[size[u] - 1]) list[size[u]++] = list[i];
+        }
+        edges += size[u];
+    }
+    
+    // Common higher neighbors of u and v are above v, so the part of u's
+    // neighbors up to v is skipped
+    long long count = 0;
+    size_t words = ((size_t)n + 63) / 64;
+    size_t row_bytes = (size_t)n * words * sizeof(uint64_t);
+    if (edges * TRIANGLE_ROWS_WORDS_PER_EDGE >= (long long)(n * words) &&
+        row_bytes <= TRIANGLE_ROWS_MAX_BYTES) {
+        uint64_t* rows = (uint64_t*)workspace_calloc(ws, (size_t)n * words, sizeof(uint64_t));
+        if (!rows) return 0;
+    
+        for (int u = 0; u < n; u++) {
+            uint64_t* row = rows + (size_t)u * words;
+            for (int i = 0; i < size[u]; i++) {
+                int v = lists[start[u] + i];
+                row[v >> 6] |= (uint64_t)1 << (v & 63);
+            }
+        }
+        for (int u = 0; u < n; u++) {
+            for (int i = 0; i < size[u]; i++) {
+                int v = lists[start[u] + i];
+                size_t first = (size_t)v >> 6;
+                count += (long long)simd_and_popcount(rows + (size_t)u * words + first,
+                                                      rows + (size_t)v * words + first,
+                                                      words - first);
+            }
+        }
+    } else {
+        for (int u = 0; u < n; u++) {
+            const int* list = lists + start[u];
+            for (int i = 0; i < size[u]; i++) {
+                int v = list[i];
+                count += (long long)simd_intersect_count(list + i + 1, (size_t)(size[u] - i - 1),
+                                                         lists + start[v], (size_t)size[v]);
             }
         }
     }
     
     *triangle_count = count;
+    return 1;
+}
+
+/**
+ * Count triangles (3-cliques) in the graph - optimized version.
+ */
+int graph_count_triangles(const Graph* g, long long* triangle_count) {
+    return graph_count_triangles_ws(g, triangle_count, NULL);
+}
+
+/**
+ * Count triangles with the scratch lists taken from a workspace.
+ */
+int graph_count_triangles_ws(const Graph* g, long long* triangle_count, AlgorithmWorkspace* ws) {
+    if (!g || !triangle_count) return 0;
+    
+    int n = g->n;
+    *triangle_count = 0;
+    
+    if (n < 3) return 1; // Need at least 3 vertices for triangle
+    
+    // Small graphs: bitset kernel, no matrix or workspace needed
+    if (bitgraph_count_triangles(g, triangle_count)) return 1;
+    
+    // Without a caller workspace, use a temporary one for this call
+    AlgorithmWorkspace local;
+    if (!ws) {
+        if (!workspace_init(&local, 0)) return 0;
+        ws = &local;
+    }
+    WorkspaceMark mark = workspace_mark(ws);
+    
+    int ok = count_triangles_large(g, triangle_count, ws);
     
     // Cleanup
-    for (int i = 0; i < n; i++) free(adj_matrix[i]);
-    free(adj_matrix);
+    workspace_release(ws, mark);
+    if (ws == &local) workspace_destroy(&local);
     
-    return 1;
+    return ok;
 }
 
 /**
  * Count edges (2-cliques) in the graph.
  */
-int graph_count_edges(const Graph* g, int* edge_count) {
+int graph_count_edges(const Graph* g, long long* edge_count) {
     if (!g || !edge_count) return 0;
     
     *edge_count = 0;
@@ -350,11 +566,18 @@ int graph_count_edges(const Graph* g, int* edge_count) {
 /**
  * Get total number of cliques of all sizes.
  */
-int graph_total_clique_count(const Graph* g, int* total_count) {
+int graph_total_clique_count(const Graph* g, long long* total_count) {
+    return graph_total_clique_count_ws(g, total_count, NULL);
+}
+
+/**
+ * Get total number of cliques using a workspace.
+ */
+int graph_total_clique_count_ws(const Graph* g, long long* total_count, AlgorithmWorkspace* ws) {
     if (!g || !total_count) return 0;
     
     CliqueCount_Result result;
-    if (!graph_count_all_cliques(g, &result)) {
+    if (!graph_count_all_cliques_ws(g, &result, ws)) {
         return 0;
     }
     
@@ -372,7 +595,7 @@ int graph_total_clique_count(const Graph* g, int* total_count) {
  * Check if the graph has any cliques of a given size.
  */
 int graph_has_cliques_of_size(const Graph* g, int clique_size) {
-    int count;
+    long long count;
     if (!graph_count_cliques_of_size(g, clique_size, &count)) {
         return 0;
     }
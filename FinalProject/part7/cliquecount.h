@@ -2,6 +2,8 @@
 #define CLIQUE_COUNT_H
 
 #include "graph.h"
+#include "workspace.h"
+#include "algorithm_params.h"
 
 /**
  * @file clique_count.h
@@ -15,10 +17,11 @@
  * Clique Count Result structure
  */
 typedef struct {
-    int* counts_by_size;   // Array where counts_by_size[k] = number of k-cliques
-    int max_size;          // Maximum clique size found
-    int total_cliques;     // Total number of cliques (of all sizes >= 1)
-    int is_valid;          // 1 if result is valid, 0 otherwise
+    long long* counts_by_size; // Array where counts_by_size[k] = number of k-cliques
+    int max_size;              // Maximum clique size found
+    long long total_cliques;   // Total number of cliques (of all sizes >= 1)
+    int is_valid;              // 1 if result is valid, 0 otherwise
+    int timed_out;             // 1 if the time budget ran out (counts are lower bounds)
 } CliqueCount_Result;
 
 /**
@@ -30,6 +33,27 @@ typedef struct {
  */
 int graph_count_all_cliques(const Graph* g, CliqueCount_Result* result);
 
+/**
+ * Same as graph_count_all_cliques(), taking all scratch memory from @p ws.
+ * 
+ * @param ws Workspace to use, or NULL for a temporary one
+ * @return 1 on success, 0 on failure
+ */
+int graph_count_all_cliques_ws(const Graph* g, CliqueCount_Result* result, AlgorithmWorkspace* ws);
+
+/**
+ * Count cliques as requested by @p params: all sizes, or only
+ * params->clique_size (sizes 1-3 use direct counting). The search is split
+ * over params->num_threads threads and stops after params->time_budget_ms,
+ * setting result->timed_out.
+ * 
+ * @param params Parameters, or NULL for defaults (all sizes, one thread)
+ * @param ws Workspace to use, or NULL for a temporary one
+ * @return 1 on success, 0 on failure
+ */
+int graph_count_cliques_with_params(const Graph* g, const AlgorithmParams* params,
+                                    CliqueCount_Result* result, AlgorithmWorkspace* ws);
+
 /**
  * Count cliques of a specific size.
  * 
@@ -38,7 +62,16 @@ int graph_count_all_cliques(const Graph* g, CliqueCount_Result* result);
  * @param count OUT: pointer to store the count
  * @return 1 on success, 0 on failure
  */
-int graph_count_cliques_of_size(const Graph* g, int clique_size, int* count);
+int graph_count_cliques_of_size(const Graph* g, int clique_size, long long* count);
+
+/**
+ * Same as graph_count_cliques_of_size(), taking all scratch memory from @p ws.
+ * 
+ * @param ws Workspace to use, or NULL for a temporary one
+ * @return 1 on success, 0 on failure
+ */
+int graph_count_cliques_of_size_ws(const Graph* g, int clique_size, long long* count,
+                                   AlgorithmWorkspace* ws);
 
 /**
  * Print clique count result in a formatted way.
@@ -61,7 +94,15 @@ void clique_count_result_free(CliqueCount_Result* result);
  * @param triangle_count OUT: pointer to store triangle count
  * @return 1 on success, 0 on failure
  */
-int graph_count_triangles(const Graph* g, int* triangle_count);
+int graph_count_triangles(const Graph* g, long long* triangle_count);
+
+/**
+ * Same as graph_count_triangles(), taking the adjacency matrix from @p ws.
+ * 
+ * @param ws Workspace to use, or NULL for a temporary one
+ * @return 1 on success, 0 on failure
+ */
+int graph_count_triangles_ws(const Graph* g, long long* triangle_count, AlgorithmWorkspace* ws);
 
 /**
  * Count edges (2-cliques) in the graph.
@@ -70,7 +111,7 @@ int graph_count_triangles(const Graph* g, int* triangle_count);
  * @param edge_count OUT: pointer to store edge count
  * @return 1 on success, 0 on failure
  */
-int graph_count_edges(const Graph* g, int* edge_count);
+int graph_count_edges(const Graph* g, long long* edge_count);
 
 /**
  * Get total number of cliques of all sizes.
@@ -79,7 +120,15 @@ int graph_count_edges(const Graph* g, int* edge_count);
  * @param total_count OUT: pointer to store total count
  * @return 1 on success, 0 on failure
  */
-int graph_total_clique_count(const Graph* g, int* total_count);
+int graph_total_clique_count(const Graph* g, long long* total_count);
+
+/**
+ * Same as graph_total_clique_count(), taking all scratch memory from @p ws.
+ * 
+ * @param ws Workspace to use, or NULL for a temporary one
+ * @return 1 on success, 0 on failure
+ */
+int graph_total_clique_count_ws(const Graph* g, long long* total_count, AlgorithmWorkspace* ws);
 
 /**
  * Check if the graph has any cliques of a given size.
@@ -0,0 +1,488 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L   // pthread_barrier_t
+#endif
+#include "coloring.h"
+#include "graph_alloc.h"
+#include "parallel.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define COLORING_MAX_THREADS 64
+#define COLORING_CHUNK 256        // Vertices handed to a Jones-Plassmann thread at a time
+#define DSATUR_LOW_COLORS 64      // Neighbor colors below this are tracked in one word per vertex
+
+static int max_degree(const GraphCSR* csr) {
+    long long max = 0;
+    for (int v = 0; v < csr->n; v++) {
+        long long d = csr->offsets[v + 1] - csr->offsets[v];
+        if (d > max) max = d;
+    }
+    return (int)max;
+}
+
+/**
+ * Smallest color not used by a colored neighbor of @p v (colors < 0 are
+ * uncolored). The answer is at most the degree of v, so larger neighbor
+ * colors are skipped.
+ * @param forbidden Scratch of max_degree + 1 ints, never stamped with v + 1 before
+ */
+static int first_fit(const GraphCSR* csr, const int* colors, int v, int* forbidden) {
+    long long degree = csr->offsets[v + 1] - csr->offsets[v];
+    for (long long a = csr->offsets[v]; a < csr->offsets[v + 1]; a++) {
+        int c = colors[csr->targets[a]];
+        if (c >= 0 && c <= degree) forbidden[c] = v + 1;
+    }
+    int c = 0;
+    while (forbidden[c] == v + 1) c++;
+    return c;
+}
+
+/* ---------- Smallest-last ---------- */
+
+/**
+ * Bucket peeling (Batagelj-Zaversnik, as in graph_profile.c) over the CSR.
+ * vert[] ends in removal order.
+ * @return The degeneracy, or -1 if allocation failed
+ */
+static int smallest_last(const GraphCSR* csr, int* vert, AlgorithmWorkspace* ws) {
+    int n = csr->n;
+    int* deg = (int*)workspace_alloc(ws, (size_t)n * sizeof(int));
+    int* pos = (int*)workspace_alloc(ws, (size_t)n * sizeof(int));
+    if (!deg || !pos) return -1;
+
+    int max_deg = 0;
+    for (int v = 0; v < n; v++) {
+        int d = 0;
+        for (long long a = csr->offsets[v]; a < csr->offsets[v + 1]; a++) d += csr->targets[a] != v;
+        deg[v] = d;
+        if (d > max_deg) max_deg = d;
+    }
+
+    int* bin = (int*)workspace_calloc(ws, (size_t)max_deg + 1, sizeof(int));
+    if (!bin) return -1;
+    for (int v = 0; v < n; v++) bin[deg[v]]++;
+    int start = 0;
+    for (int d = 0; d <= max_deg; d++) {
+        int count = bin[d];
+        bin[d] = start;
+        start += count;
+    }
+    for (int v = 0; v < n; v++) {
+        pos[v] = bin[deg[v]];
+        vert[pos[v]] = v;
+        bin[deg[v]]++;
+    }
+    for (int d = max_deg; d > 0; d--) bin[d] = bin[d - 1];
+    bin[0] = 0;
+
+    // Remove vertices in degree order, moving neighbors down one bucket
+    int degeneracy = 0;
+    for (int i = 0; i < n; i++) {
+        int v = vert[i];
+        if (deg[v] > degeneracy) degeneracy = deg[v];
+
+        for (long long a = csr->offsets[v]; a < csr->offsets[v + 1]; a++) {
+            int u = csr->targets[a];
+            if (u == v || deg[u] <= deg[v]) continue;
+
+            int du = deg[u], pu = pos[u], pw = bin[du];
+            int w = vert[pw];
+            if (u != w) {
+                pos[u] = pw; vert[pu] = w;
+                pos[w] = pu; vert[pw] = u;
+            }
+            bin[du]++;
+            deg[u]--;
+        }
+    }
+    return degeneracy;
+}
+
+static int color_smallest_last(const GraphCSR* csr, int* colors, AlgorithmWorkspace* ws) {
+    int n = csr->n;
+    int* order = (int*)workspace_alloc(ws, (size_t)n * sizeof(int));
+    int* forbidden = (int*)workspace_calloc(ws, (size_t)max_degree(csr) + 1, sizeof(int));
+    if (!order || !forbidden || smallest_last(csr, order, ws) < 0) return 0;
+
+    // Last removed first: each vertex then has at most degeneracy colored neighbors
+    for (int i = n - 1; i >= 0; i--) {
+        int v = order[i];
+        colors[v] = first_fit(csr, colors, v, forbidden);
+    }
+    return 1;
+}
+
+/* ---------- DSATUR ---------- */
+
+typedef struct {
+    const GraphCSR* csr;
+    long long* key;        // Saturation * (max_degree + 1) + degree
+    int* heap;             // Max-heap of uncolored vertices by key
+    int* slot;             // Position of each vertex in the heap
+    int size;
+    uint64_t* low_seen;    // Neighbor colors below DSATUR_LOW_COLORS
+    int* high_seen;        // Larger neighbor colors of v at high_seen + offsets[v]
+    int* high_count;
+} Dsatur;
+
+static void heap_swap(Dsatur* d, int i, int j) {
+    int a = d->heap[i], b = d->heap[j];
+    d->heap[i] = b;
+    d->heap[j] = a;
+    d->slot[b] = i;
+    d->slot[a] = j;
+}
+
+static void heap_up(Dsatur* d, int i) {
+    while (i > 0 && d->key[d->heap[(i - 1) / 2]] < d->key[d->heap[i]]) {
+        heap_swap(d, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+static void heap_down(Dsatur* d, int i) {
+    while (1) {
+        int largest = i, l = 2 * i + 1, r = l + 1;
+        if (l < d->size && d->key[d->heap[l]] > d->key[d->heap[largest]]) largest = l;
+        if (r < d->size && d->key[d->heap[r]] > d->key[d->heap[largest]]) largest = r;
+        if (largest == i) return;
+        heap_swap(d, i, largest);
+        i = largest;
+    }
+}
+
+/**
+ * Note that a neighbor of @p u got color @p c.
+ * @return 1 if no neighbor of u had that color before
+ */
+static int dsatur_see(Dsatur* d, int u, int c) {
+    if (c < DSATUR_LOW_COLORS) {
+        uint64_t bit = (uint64_t)1 << c;
+        if (d->low_seen[u] & bit) return 0;
+        d->low_seen[u] |= bit;
+        return 1;
+    }
+
+    // u has at most degree(u) distinct neighbor colors, so its arc range has room
+    int* seen = d->high_seen + d->csr->offsets[u];
+    for (int i = 0; i < d->high_count[u]; i++) {
+        if (seen[i] == c) return 0;
+    }
+    seen[d->high_count[u]++] = c;
+    return 1;
+}
+
+static int color_dsatur(const GraphCSR* csr, int* colors, AlgorithmWorkspace* ws) {
+    int n = csr->n;
+    long long step = (long long)max_degree(csr) + 1;
+
+    Dsatur d;
+    d.csr = csr;
+    d.key = (long long*)workspace_alloc(ws, (size_t)n * sizeof(long long));
+    d.heap = (int*)workspace_alloc(ws, (size_t)n * sizeof(int));
+    d.slot = (int*)workspace_alloc(ws, (size_t)n * sizeof(int));
+    d.low_seen = (uint64_t*)workspace_calloc(ws, (size_t)n, sizeof(uint64_t));
+    d.high_seen = NULL;
+    d.high_count = NULL;
+    int* forbidden = (int*)workspace_calloc(ws, (size_t)step, sizeof(int));
+    if (!d.key || !d.heap || !d.slot || !d.low_seen || !forbidden) return 0;
+
+    for (int v = 0; v < n; v++) {
+        d.key[v] = csr->offsets[v + 1] - csr->offsets[v];
+        d.heap[v] = v;
+        d.slot[v] = v;
+    }
+    d.size = n;
+    for (int i = n / 2 - 1; i >= 0; i--) heap_down(&d, i);
+
+    while (d.size > 0) {
+        int v = d.heap[0];
+        heap_swap(&d, 0, --d.size);
+        heap_down(&d, 0);
+
+        int c = first_fit(csr, colors, v, forbidden);
+        colors[v] = c;
+
+        // Large colors are rare; only then pay for the per-arc lists
+        if (c >= DSATUR_LOW_COLORS && !d.high_seen) {
+            d.high_seen = (int*)workspace_alloc(ws, (size_t)(csr->num_arcs > 0 ? csr->num_arcs : 1) * sizeof(int));
+            d.high_count = (int*)workspace_calloc(ws, (size_t)n, sizeof(int));
+            if (!d.high_seen || !d.high_count) return 0;
+        }
+
+        for (long long a = csr->offsets[v]; a < csr->offsets[v + 1]; a++) {
+            int u = csr->targets[a];
+            if (colors[u] >= 0 || !dsatur_see(&d, u, c)) continue;
+            d.key[u] += step;
+            heap_up(&d, d.slot[u]);
+        }
+    }
+    return 1;
+}
+
+/* ---------- Jones-Plassmann ---------- */
+
+typedef struct {
+    const GraphCSR* csr;
+    int* colors;
+    uint64_t* priority;        // Log-degree in the high half, a hash of the id in the low half
+    int* waiting;              // Uncolored neighbors of higher priority
+    int* frontier[2];          // Vertices to color this round and the next
+    int frontier_size;
+    int next_size;
+    int* forbidden[COLORING_MAX_THREADS];
+    int rounds;                // Written by thread 0
+    int num_threads;
+    ParallelTeam team;
+} JonesPlassmann;
+
+typedef struct {
+    JonesPlassmann* shared;
+    int index;
+} JonesPlassmannTask;
+
+static void jp_sync(JonesPlassmann* s) {
+    parallel_sync(&s->team);
+}
+
+static int jp_higher(const uint64_t* priority, int u, int v) {
+    return priority[u] > priority[v] || (priority[u] == priority[v] && u > v);
+}
+
+static uint64_t jp_priority(const GraphCSR* csr, int v) {
+    uint32_t h = (uint32_t)v;
+    h ^= h >> 16;
+    h *= 0x7feb352dU;
+    h ^= h >> 15;
+    h *= 0x846ca68bU;
+    h ^= h >> 16;
+
+    long long degree = csr->offsets[v + 1] - csr->offsets[v];
+    uint64_t log_degree = 0;
+    while (degree > 0) {
+        log_degree++;
+        degree >>= 1;
+    }
+    return (log_degree << 32) | h;
+}
+
+/* Threads take chunks of [0, count) round-robin */
+#define FOR_MY_ITEMS(t, s, count, i)                                          \
+    for (int chunk_ = (t)->index * COLORING_CHUNK; chunk_ < (count);           \
+         chunk_ += (s)->num_threads * COLORING_CHUNK)                          \
+        for (int i = chunk_; i < chunk_ + COLORING_CHUNK && i < (count); i++)
+
+static void* jp_run(void* arg) {
+    JonesPlassmannTask* t = (JonesPlassmannTask*)arg;
+    JonesPlassmann* s = t->shared;
+
+    const GraphCSR* csr = s->csr;
+    const uint64_t* priority = s->priority;
+    int* forbidden = s->forbidden[t->index];
+    int n = csr->n;
+
+    FOR_MY_ITEMS(t, s, n, v) s->priority[v] = jp_priority(csr, v);
+    jp_sync(s);
+
+    // Vertices that wait for nobody start the first round
+    FOR_MY_ITEMS(t, s, n, v) {
+        int count = 0;
+        for (long long a = csr->offsets[v]; a < csr->offsets[v + 1]; a++) {
+            int u = csr->targets[a];
+            if (u != v && jp_higher(priority, u, v)) count++;
+        }
+        s->waiting[v] = count;
+        if (count == 0) s->frontier[0][__atomic_fetch_add(&s->frontier_size, 1, __ATOMIC_RELAXED)] = v;
+    }
+    jp_sync(s);
+
+    for (int round = 0; ; round++) {
+        int size = s->frontier_size;
+        if (size == 0) break;
+        const int* frontier = s->frontier[round & 1];
+        int* next = s->frontier[(round + 1) & 1];
+
+        // Higher neighbors were colored in earlier rounds. Lower ones are
+        // still waiting; they read v's color only after the barrier.
+        FOR_MY_ITEMS(t, s, size, i) {
+            int v = frontier[i];
+            for (long long a = csr->offsets[v]; a < csr->offsets[v + 1]; a++) {
+                int u = csr->targets[a];
+                if (u == v) continue;
+                if (jp_higher(priority, u, v)) {
+                    forbidden[s->colors[u]] = v + 1;
+                } else if (__atomic_sub_fetch(&s->waiting[u], 1, __ATOMIC_RELAXED) == 0) {
+                    next[__atomic_fetch_add(&s->next_size, 1, __ATOMIC_RELAXED)] = u;
+                }
+            }
+            int c = 0;
+            while (forbidden[c] == v + 1) c++;
+            s->colors[v] = c;
+        }
+        jp_sync(s);
+
+        if (t->index == 0) {
+            s->frontier_size = s->next_size;
+            s->next_size = 0;
+            s->rounds++;
+        }
+        jp_sync(s);
+    }
+    return NULL;
+}
+
+/**
+ * Run the rounds with @p num_threads threads (fewer if the graph is small).
+ * @return 1 on success, 0 if allocation failed
+ */
+static int color_jones_plassmann(const GraphCSR* csr, int num_threads, int* colors, int* rounds,
+                                 AlgorithmWorkspace* ws) {
+    int n = csr->n;
+    int max_useful = (n + COLORING_CHUNK - 1) / COLORING_CHUNK;
+    if (num_threads < 1) num_threads = 1;
+    if (num_threads > max_useful) num_threads = max_useful;
+    if (num_threads > COLORING_MAX_THREADS) num_threads = COLORING_MAX_THREADS;
+
+    JonesPlassmann s;
+    s.csr = csr;
+    s.colors = colors;
+    s.priority = (uint64_t*)workspace_alloc(ws, (size_t)n * sizeof(uint64_t));
+    s.waiting = (int*)workspace_alloc(ws, (size_t)n * sizeof(int));
+    s.frontier[0] = (int*)workspace_alloc(ws, (size_t)n * sizeof(int));
+    s.frontier[1] = (int*)workspace_alloc(ws, (size_t)n * sizeof(int));
+    if (!s.priority || !s.waiting || !s.frontier[0] || !s.frontier[1]) return 0;
+
+    // A vertex waits for at most degree neighbors, so its color fits in degree + 1
+    size_t colors_per_thread = (size_t)max_degree(csr) + 1;
+    for (int i = 0; i < num_threads; i++) {
+        s.forbidden[i] = (int*)workspace_calloc(ws, colors_per_thread, sizeof(int));
+        if (!s.forbidden[i]) return 0;
+    }
+
+    s.frontier_size = 0;
+    s.next_size = 0;
+    s.rounds = 0;
+    s.num_threads = num_threads;
+
+    JonesPlassmannTask tasks[COLORING_MAX_THREADS];
+    for (int i = 0; i < num_threads; i++) {
+        tasks[i].shared = &s;
+        tasks[i].index = i;
+    }
+    if (!parallel_run(&s.team, num_threads, jp_run, tasks, sizeof(JonesPlassmannTask))) {
+        // The threads could not be set up: color serially instead
+        return color_jones_plassmann(csr, 1, colors, rounds, ws);
+    }
+
+    *rounds = s.rounds;
+    return 1;
+}
+
+/* ---------- Entry points ---------- */
+
+int graph_smallest_last_order(const GraphCSR* csr, int* order, AlgorithmWorkspace* ws) {
+    if (!csr || !csr->offsets || !order || csr->n < 1) return -1;
+
+    AlgorithmWorkspace local;
+    if (!ws) {
+        if (!workspace_init(&local, 0)) return -1;
+        ws = &local;
+    }
+    WorkspaceMark mark = workspace_mark(ws);
+
+    int degeneracy = smallest_last(csr, order, ws);
+
+    workspace_release(ws, mark);
+    if (ws == &local) workspace_destroy(&local);
+    return degeneracy;
+}
+
+int graph_color_csr(const GraphCSR* csr, int variant, int num_threads,
+                    GraphColoring* result, AlgorithmWorkspace* ws) {
+    if (!result) return 0;
+    memset(result, 0, sizeof(*result));
+    if (!csr || !csr->offsets || csr->n < 1) return 0;
+
+    int n = csr->n;
+    result->n = n;
+    result->colors = (int*)GRAPH_MALLOC((size_t)n * sizeof(int));
+    if (!result->colors) return 0;
+    for (int v = 0; v < n; v++) result->colors[v] = -1;
+
+    AlgorithmWorkspace local;
+    if (!ws) {
+        if (!workspace_init(&local, 0)) {
+            graph_coloring_free(result);
+            return 0;
+        }
+        ws = &local;
+    }
+    WorkspaceMark mark = workspace_mark(ws);
+
+    int ok;
+    switch (variant) {
+        case ALGO_VARIANT_COLOR_DSATUR:
+            ok = color_dsatur(csr, result->colors, ws);
+            break;
+        case ALGO_VARIANT_COLOR_JONES_PLASSMANN:
+            ok = color_jones_plassmann(csr, num_threads, result->colors, &result->rounds, ws);
+            break;
+        default:
+            ok = color_smallest_last(csr, result->colors, ws);
+            break;
+    }
+
+    workspace_release(ws, mark);
+    if (ws == &local) workspace_destroy(&local);
+
+    if (!ok) {
+        graph_coloring_free(result);
+        return 0;
+    }
+    for (int v = 0; v < n; v++) {
+        if (result->colors[v] >= result->num_colors) result->num_colors = result->colors[v] + 1;
+    }
+    return 1;
+}
+
+int graph_color_with_params(const Graph* g, const AlgorithmParams* params,
+                            GraphColoring* result, AlgorithmWorkspace* ws) {
+    if (!result) return 0;
+    memset(result, 0, sizeof(*result));
+    if (!g || g->n < 1) return 0;
+
+    AlgorithmWorkspace local;
+    if (!ws) {
+        if (!workspace_init(&local, 0)) return 0;
+        ws = &local;
+    }
+    WorkspaceMark mark = workspace_mark(ws);
+
+    GraphCSR csr;
+    int ok = graph_csr_build(g, &csr, ws) &&
+             graph_color_csr(&csr, params ? params->variant : ALGO_VARIANT_AUTO,
+                             params ? params->num_threads : 1, result, ws);
+
+    workspace_release(ws, mark);
+    if (ws == &local) workspace_destroy(&local);
+    return ok;
+}
+
+int graph_coloring_is_proper(const Graph* g, const int* colors) {
+    if (!g || !colors) return 0;
+    for (int u = 0; u < g->n; u++) {
+        if (colors[u] < 0) return 0;
+        for (EdgeNode* e = g->adj[u].head; e; e = e->next) {
+            if (e->to != u && colors[e->to] == colors[u]) return 0;
+        }
+    }
+    return 1;
+}
+
+void graph_coloring_free(GraphColoring* coloring) {
+    if (!coloring) return;
+    GRAPH_FREE(coloring->colors);
+    coloring->colors = NULL;
+    coloring->num_colors = 0;
+}
@@ -0,0 +1,71 @@
+#ifndef COLORING_H
+#define COLORING_H
+
+#include "graph.h"
+#include "workspace.h"
+#include "algorithm_params.h"
+#include "bfs.h"
+
+/**
+ * @file coloring.h
+ * Greedy vertex coloring over the CSR form of a graph (see bfs.h).
+ *
+ * Every variant gives each vertex the smallest color not used by a
+ * neighbor colored before it; they differ in the order:
+ * - Smallest-last: repeatedly remove a vertex of minimum remaining degree
+ *   and color in reverse removal order. Uses at most degeneracy + 1 colors.
+ * - DSATUR: next color the vertex with the most distinct neighbor colors,
+ *   ties broken by degree. Slower, usually fewer colors.
+ * - Jones-Plassmann: each vertex waits for its neighbors of higher
+ *   priority (larger log-degree, then a hash of the id). A round colors
+ *   every vertex whose wait is over, split over threads.
+ *
+ * Self-loops are ignored.
+ */
+
+typedef struct {
+    int n;
+    int* colors;        // Color of each vertex, 0 .. num_colors - 1
+    int num_colors;
+    int rounds;         // Jones-Plassmann rounds, 0 for the sequential orders
+} GraphColoring;
+
+/**
+ * Smallest-last removal order: order[i] is the i-th vertex removed, so
+ * a vertex has at most the degeneracy neighbors later in the order.
+ * @param order OUT: n vertices
+ * @param ws Workspace for the buckets, or NULL for a temporary one
+ * @return The degeneracy, or -1 on invalid input or allocation failure
+ */
+int graph_smallest_last_order(const GraphCSR* csr, int* order, AlgorithmWorkspace* ws);
+
+/**
+ * Color @p csr with @p variant (ALGO_VARIANT_COLOR_*; AUTO = smallest-last).
+ * @param num_threads Threads for Jones-Plassmann (0 or 1 = single-threaded)
+ * @param result OUT: colors (free with graph_coloring_free)
+ * @param ws Workspace for the scratch arrays, or NULL for a temporary one
+ * @return 1 on success, 0 on invalid input or allocation failure
+ */
+int graph_color_csr(const GraphCSR* csr, int variant, int num_threads,
+                    GraphColoring* result, AlgorithmWorkspace* ws);
+
+/**
+ * Color @p g with the variant and thread count in @p params.
+ * @param params Parameters, or NULL for the defaults
+ * @return 1 on success, 0 on invalid input or allocation failure
+ */
+int graph_color_with_params(const Graph* g, const AlgorithmParams* params,
+                            GraphColoring* result, AlgorithmWorkspace* ws);
+
+/**
+ * Check that no edge joins two vertices of the same color.
+ * @return 1 if @p colors is a proper coloring of @p g, 0 otherwise
+ */
+int graph_coloring_is_proper(const Graph* g, const int* colors);
+
+/**
+ * Free the color array.
+ */
+void graph_coloring_free(GraphColoring* coloring);
+
+#endif /* COLORING_H */
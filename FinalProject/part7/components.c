@@ -0,0 +1,271 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L   // pthread_barrier_t
+#endif
+#include "components.h"
+#include "graph_alloc.h"
+#include "parallel.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define COMPONENTS_MAX_THREADS 64
+#define COMPONENTS_CHUNK 1024          // Vertices handed to a thread at a time
+#define AFFOREST_NEIGHBOR_ROUNDS 2     // Neighbors linked before sampling
+#define AFFOREST_SAMPLES 1024          // Vertices sampled to find the giant component
+#define AFFOREST_MIN_SAMPLED_N 4096    // Smaller graphs skip the sample (and Afforest on one thread)
+
+#define LOAD(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+
+/**
+ * Join the trees of @p u and @p v by pointing the higher root at the lower.
+ * Only roots are modified, with a CAS, so concurrent links cannot create a
+ * cycle; a failed CAS means another thread moved the root, and we retry
+ * from the new one.
+ */
+static void link_vertices(int* comp, int u, int v) {
+    int p1 = LOAD(&comp[u]);
+    int p2 = LOAD(&comp[v]);
+    while (p1 != p2) {
+        int high = p1 > p2 ? p1 : p2;
+        int low = p1 + p2 - high;
+        int p_high = LOAD(&comp[high]);
+        if (p_high == low) break;
+        int expected = high;
+        if (p_high == high &&
+            __atomic_compare_exchange_n(&comp[high], &expected, low, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            break;
+        }
+        p1 = LOAD(&comp[LOAD(&comp[high])]);
+        p2 = LOAD(&comp[low]);
+    }
+}
+
+/**
+ * Point @p u straight at its root (pointer jumping).
+ */
+static void compress(int* comp, int u) {
+    int parent = LOAD(&comp[u]);
+    int grandparent = LOAD(&comp[parent]);
+    while (parent != grandparent) {
+        STORE(&comp[u], grandparent);
+        parent = grandparent;
+        grandparent = LOAD(&comp[parent]);
+    }
+}
+
+/**
+ * Majority root (Boyer-Moore vote) among min(n, AFFOREST_SAMPLES)
+ * pseudo-random vertices: the giant component, if the graph has one.
+ * Without a majority the vote is arbitrary, which only costs phase 2
+ * some skipped vertices, never correctness.
+ */
+static int sample_frequent_root(const int* comp, int n) {
+    int samples = n < AFFOREST_SAMPLES ? n : AFFOREST_SAMPLES;
+    unsigned int state = 0x2545f491u;
+    int candidate = -1, votes = 0;
+    for (int i = 0; i < samples; i++) {
+        state = state * 1103515245u + 12345u;
+        int root = LOAD(&comp[(int)((state >> 1) % (unsigned int)n)]);
+        if (votes == 0) candidate = root;
+        votes += root == candidate ? 1 : -1;
+    }
+    return candidate;
+}
+
+typedef struct {
+    const Graph* g;
+    int* comp;
+    int num_threads;
+    ParallelTeam team;
+    int giant;                 // Sampled root, written by thread 0
+} AfforestShared;
+
+typedef struct {
+    AfforestShared* shared;
+    int index;
+} AfforestTask;
+
+static void afforest_sync(AfforestShared* s) {
+    parallel_sync(&s->team);
+}
+
+/* Threads take chunks round-robin, which balances skewed degree ranges */
+#define FOR_MY_VERTICES(t, s, u)                                              \
+    for (int chunk_ = (t)->index * COMPONENTS_CHUNK; chunk_ < (s)->g->n;      \
+         chunk_ += (s)->num_threads * COMPONENTS_CHUNK)                        \
+        for (int u = chunk_; u < chunk_ + COMPONENTS_CHUNK && u < (s)->g->n; u++)
+
+static void* afforest_run(void* arg) {
+    AfforestTask* t = (AfforestTask*)arg;
+    AfforestShared* s = t->shared;
+    int* comp = s->comp;
+
+    // Small graphs skip the sample and the rounds that feed it, and link
+    // every edge once from its lower end (giant = -1 matches no vertex)
+    int sampled = s->g->n >= AFFOREST_MIN_SAMPLED_N;
+    int rounds = sampled ? AFFOREST_NEIGHBOR_ROUNDS : 0;
+
+    // Phase 1: link each vertex with its r-th neighbor, then flatten
+    for (int r = 0; r < rounds; r++) {
+        FOR_MY_VERTICES(t, s, u) {
+            EdgeNode* e = s->g->adj[u].head;
+            for (int i = 0; i < r && e; i++) e = e->next;
+            if (e) link_vertices(comp, u, e->to);
+        }
+        afforest_sync(s);
+        FOR_MY_VERTICES(t, s, u) compress(comp, u);
+        afforest_sync(s);
+    }
+    if (sampled) {
+        if (t->index == 0) s->giant = sample_frequent_root(comp, s->g->n);
+        afforest_sync(s);
+    }
+
+    // Phase 2: the remaining edges, skipping the giant component's vertices.
+    // Both directions of an edge are stored, so an edge leaving the giant
+    // component is still linked from its other end.
+    int giant = s->giant;
+    FOR_MY_VERTICES(t, s, u) {
+        if (LOAD(&comp[u]) == giant) continue;
+        EdgeNode* e = s->g->adj[u].head;
+        for (int i = 0; i < rounds && e; i++) e = e->next;
+        for (; e; e = e->next) {
+if (sampled || e->to > u) link_vertices(comp, u, e->to);
+        }
+    }
+    afforest_sync(s);
+    FOR_MY_VERTICES(t, s, u) compress(comp, u);
+    return NULL;
+}
+
+/**
+ * One-thread labeling for graphs too small to sample, where a plain
+ * search beats the linking: each unvisited vertex, in increasing order,
+ * roots the vertices it reaches.
+ * @return 1 on success, 0 if the stack cannot be allocated
+ */
+static int label_by_search(const Graph* g, int* comp) {
+    int n = g->n;
+    int* stack = (int*)GRAPH_MALLOC((size_t)n * sizeof(int));
+    if (!stack) return 0;
+    for (int v = 0; v < n; v++) comp[v] = -1;
+
+    for (int root = 0; root < n; root++) {
+        if (comp[root] >= 0) continue;
+        comp[root] = root;
+        int top = 0;
+        stack[top++] = root;
+        while (top > 0) {
+            int u = stack[--top];
+            for (EdgeNode* e = g->adj[u].head; e; e = e->next) {
+                if (comp[e->to] >= 0) continue;
+                comp[e->to] = root;
+                stack[top++] = e->to;
+            }
+        }
+    }
+    GRAPH_FREE(stack);
+    return 1;
+}
+
+/**
+ * Run Afforest into @p comp (n ints); comp[v] ends as the root of v.
+ * Falls back to one thread if the others cannot be started.
+ */
+static void afforest(const Graph* g, int num_threads, int* comp) {
+    int n = g->n;
+    int max_useful = (n + COMPONENTS_CHUNK - 1) / COMPONENTS_CHUNK;
+    if (num_threads < 1) num_threads = 1;
+    if (num_threads > max_useful) num_threads = max_useful;
+    if (num_threads > COMPONENTS_MAX_THREADS) num_threads = COMPONENTS_MAX_THREADS;
+    if (num_threads == 1 && n < AFFOREST_MIN_SAMPLED_N && label_by_search(g, comp)) return;
+    for (int v = 0; v < n; v++) comp[v] = v;
+
+    AfforestShared shared;
+    shared.g = g;
+    shared.comp = comp;
+    shared.num_threads = num_threads;
+    shared.giant = -1;
+
+    AfforestTask tasks[COMPONENTS_MAX_THREADS];
+    for (int i = 0; i < num_threads; i++) {
+        tasks[i].shared = &shared;
+        tasks[i].index = i;
+    }
+    if (!parallel_run(&shared.team, num_threads, afforest_run, tasks, sizeof(AfforestTask))) {
+        afforest(g, 1, comp);
+    }
+}
+
+static void* components_alloc(AlgorithmWorkspace* ws, size_t bytes) {
+    return ws ? workspace_alloc(ws, bytes) : GRAPH_MALLOC(bytes);
+}
+
+int graph_connected_components_ws(const Graph* g, int num_threads, GraphComponents* cc,
+                                  AlgorithmWorkspace* ws) {
+    if (!cc) return 0;
+    memset(cc, 0, sizeof(*cc));
+    if (!g || g->n < 1) return 0;
+
+    int n = g->n;
+    int* comp = (int*)components_alloc(ws, (size_t)n * sizeof(int));
+    if (!comp) return 0;
+    afforest(g, num_threads, comp);
+
+    // Roots are the smallest vertex of their component
+    int count = 0;
+    for (int v = 0; v < n; v++) {
+        if (comp[v] == v) count++;
+    }
+    int* sizes = (int*)components_alloc(ws, (size_t)count * sizeof(int));
+    if (!sizes) {
+        if (!ws) GRAPH_FREE(comp);
+        return 0;
+    }
+
+    // Relabel in place: a root precedes its members, so comp[root] already
+    // holds the component number when a member reads it
+    int next = 0, largest = 0;
+    for (int v = 0; v < n; v++) {
+        int label;
+        if (comp[v] == v) {
+            label = next++;
+            sizes[label] = 0;
+        } else {
+            label = comp[comp[v]];
+        }
+        comp[v] = label;
+        sizes[label]++;
+    }
+    for (int c = 1; c < count; c++) {
+        if (sizes[c] > sizes[largest]) largest = c;
+    }
+
+    cc->n = n;
+    cc->labels = comp;
+    cc->sizes = sizes;
+    cc->num_components = count;
+    cc->largest = largest;
+    cc->owned = ws == NULL;
+    return 1;
+}
+
+int graph_component_roots(const Graph* g, int num_threads, int* roots) {
+    if (!g || g->n < 1 || !roots) return 0;
+    afforest(g, num_threads, roots);
+    return 1;
+}
+
+int graph_connected_components(const Graph* g, int num_threads, GraphComponents* cc) {
+    return graph_connected_components_ws(g, num_threads, cc, NULL);
+}
+
+void graph_components_free(GraphComponents* cc) {
+    if (!cc) return;
+    if (cc->owned) {
+        GRAPH_FREE(cc->labels);
+        GRAPH_FREE(cc->sizes);
+    }
+    memset(cc, 0, sizeof(*cc));
+}
@@ -0,0 +1,73 @@
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include "graph.h"
+#include "workspace.h"
+
+/**
+ * @file components.h
+ * Connected components with the Afforest algorithm.
+ *
+ * Afforest is a concurrent union-find. It first links every vertex to its
+ * first two neighbors, which already merges most of the giant component.
+ * Then it samples vertices to find that component. Only vertices outside
+ * it scan the rest of their lists, so most edges are never touched on
+ * typical graphs. Links go from the higher root to the lower one with a
+ * compare-and-swap, so threads need no locks. The root of each component is
+ * its smallest vertex. Small graphs skip the sample, and on one thread are
+ * labeled by a plain search instead.
+ */
+
+/**
+ * Component labels. Components are numbered 0..num_components-1 in order
+ * of their smallest vertex.
+ */
+typedef struct {
+    int n;
+    int* labels;          // labels[v]: component of v
+    int* sizes;           // Vertices per component
+    int num_components;
+    int largest;          // Component with the most vertices (lowest label on ties)
+    int owned;            // 1 if labels and sizes were allocated with GRAPH_MALLOC
+} GraphComponents;
+
+/**
+ * Label the connected components of @p g.
+ * @param num_threads Threads to use (0 or 1 = single-threaded)
+ * @param cc OUT: labels and sizes (free with graph_components_free)
+ * @return 1 on success, 0 on invalid arguments or allocation failure
+ */
+int graph_connected_components(const Graph* g, int num_threads, GraphComponents* cc);
+
+/**
+ * Same as graph_connected_components(), allocating the labels and sizes
+ * from @p ws. They stay valid until the caller releases a mark taken
+ * before the call, so requests that only need a yes/no answer do not
+ * allocate in steady state.
+ * @param ws Workspace to use, or NULL for GRAPH_MALLOC
+ */
+int graph_connected_components_ws(const Graph* g, int num_threads, GraphComponents* cc,
+                                  AlgorithmWorkspace* ws);
+
+/**
+ * Afforest alone, for connectivity checks: roots[v] ends as the smallest
+ * vertex of v's component. Skips the numbering and the sizes.
+ * @param roots OUT: n ints
+ * @return 1 on success, 0 on invalid arguments
+ */
+int graph_component_roots(const Graph* g, int num_threads, int* roots);
+
+/**
+ * Free the labels and sizes (no-op for workspace results, or after a failed
+ * graph_connected_components()).
+ */
+void graph_components_free(GraphComponents* cc);
+
+/**
+ * @return 1 if @p u and @p v are in the same component
+ */
+static inline int graph_components_same(const GraphComponents* cc, int u, int v) {
+    return cc->labels[u] == cc->labels[v];
+}
+
+#endif /* COMPONENTS_H */
@@ -0,0 +1,516 @@
+#include "compressed_graph.h"
+#include "graph_alloc.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Neighbor entry while building. A self-loop is kept once here and written
+ * twice, so repeats can be dropped by comparing neighbors. */
+typedef struct {
+    int to;
+    int weight;
+    int order;   // Arrival position in the list; the first of repeated edges wins
+} BuildArc;
+
+static int compare_build_arc(const void* a, const void* b) {
+    const BuildArc* x = (const BuildArc*)a;
+    const BuildArc* y = (const BuildArc*)b;
+    if (x->to != y->to) return x->to < y->to ? -1 : 1;
+    return (x->order > y->order) - (x->order < y->order);
+}
+
+static size_t put_varint(unsigned char* out, uint64_t value) {
+    size_t len = 0;
+    while (value >= 0x80) {
+        if (out) out[len] = (unsigned char)(value | 0x80);
+        len++;
+        value >>= 7;
+    }
+    if (out) out[len] = (unsigned char)value;
+    return len + 1;
+}
+
+static uint64_t zigzag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+/**
+ * Write (or only measure, with out == NULL) the block of vertex v from its
+ * sorted, repeat-free entries.
+ */
+static size_t encode_block(unsigned char* out, int v, const BuildArc* arcs, int count, int weighted) {
+    int degree = count;
+    for (int i = 0; i < count; i++) {
+        if (arcs[i].to == v) degree++;
+    }
+
+    size_t len = put_varint(out, (uint64_t)degree);
+    int prev = v;
+    int first = 1;
+    for (int i = 0; i < count; i++) {
+        int copies = arcs[i].to == v ? 2 : 1;
+        for (int c = 0; c < copies; c++) {
+            uint64_t code = first ? zigzag((int64_t)arcs[i].to - v) : (uint64_t)(arcs[i].to - prev);
+            len += put_varint(out ? out + len : NULL, code);
+            if (weighted) len += put_varint(out ? out + len : NULL, zigzag(arcs[i].weight));
+            prev = arcs[i].to;
+            first = 0;
+        }
+    }
+    return len;
+}
+
+/**
+ * Encode the per-vertex lists arcs[start[v] .. start[v] + count[v]).
+ */
+static int encode_lists(CompressedGraph* cg, int n, const BuildArc* arcs,
+                        const long long* start, const int* count) {
+    int weighted = 0;
+    long long num_arcs = 0;
+    for (int v = 0; v < n; v++) {
+        for (int i = 0; i < count[v]; i++) {
+            const BuildArc* arc = &arcs[start[v] + i];
+            if (arc->weight != 1) weighted = 1;
+            num_arcs += arc->to == v ? 2 : 1;
+        }
+    }
+
+    size_t* offsets = (size_t*)GRAPH_MALLOC((size_t)(n + 1) * sizeof(size_t));
+    if (!offsets) return 0;
+    offsets[0] = 0;
+    for (int v = 0; v < n; v++) {
+        offsets[v + 1] = offsets[v] + encode_block(NULL, v, arcs + start[v], count[v], weighted);
+    }
+
+    unsigned char* data = (unsigned char*)GRAPH_MALLOC(offsets[n] > 0 ? offsets[n] : 1);
+    if (!data) {
+        GRAPH_FREE(offsets);
+        return 0;
+    }
+    for (int v = 0; v < n; v++) {
+        encode_block(data + offsets[v], v, arcs + start[v], count[v], weighted);
+    }
+
+    cg->n = n;
+    cg->num_arcs = num_arcs;
+    cg->weighted = weighted;
+    cg->offsets = offsets;
+    cg->data = data;
+    return 1;
+}
+
+/**
+ * Sort each list and drop repeated neighbors, keeping the earliest.
+ */
+static void sort_lists(BuildArc* arcs, int n, const long long* start, int* count) {
+    for (int v = 0; v < n; v++) {
+        BuildArc* list = arcs + start[v];
+        if (count[v] < 2) continue;
+        qsort(list, (size_t)count[v], sizeof(BuildArc), compare_build_arc);
+        int kept = 1;
+        for (int i = 1; i < count[v]; i++) {
+            if (list[i].to != list[kept - 1].to) list[kept++] = list[i];
+        }
+        count[v] = kept;
+    }
+}
+
+int compressed_graph_build(CompressedGraph* cg, int n, long long m, const int* triples) {
+    if (!cg || n < 1 || m < 0 || (m > 0 && !triples)) return 0;
+    memset(cg, 0, sizeof(*cg));
+
+    long long* start = (long long*)GRAPH_CALLOC((size_t)n + 1, sizeof(long long));
+    int* count = (int*)GRAPH_CALLOC((size_t)n, sizeof(int));
+    if (!start || !count) {
+        GRAPH_FREE(start);
+        GRAPH_FREE(count);
+        return 0;
+    }
+
+    for (long long i = 0; i < m; i++) {
+        int u = triples[3 * i], v = triples[3 * i + 1];
+        if (u < 0 || u >= n || v < 0 || v >= n) continue;
+        start[u + 1]++;
+        if (u != v) start[v + 1]++;
+    }
+    for (int v = 0; v < n; v++) start[v + 1] += start[v];
+
+    BuildArc* arcs = (BuildArc*)GRAPH_MALLOC((size_t)(start[n] > 0 ? start[n] : 1) * sizeof(BuildArc));
+    if (!arcs) {
+        GRAPH_FREE(start);
+        GRAPH_FREE(count);
+        return 0;
+    }
+
+    for (long long i = 0; i < m; i++) {
+        int u = triples[3 * i], v = triples[3 * i + 1], w = triples[3 * i + 2];
+        if (u < 0 || u >= n || v < 0 || v >= n) continue;
+        arcs[start[u] + count[u]] = (BuildArc){v, w, count[u]};
+        count[u]++;
+        if (u != v) {
+            arcs[start[v] + count[v]] = (BuildArc){u, w, count[v]};
+            count[v]++;
+        }
+    }
+    sort_lists(arcs, n, start, count);
+
+    int ok = encode_lists(cg, n, arcs, start, count);
+    GRAPH_FREE(arcs);
+    GRAPH_FREE(start);
+    GRAPH_FREE(count);
+    return ok;
+}
+
+int compressed_graph_from_graph(CompressedGraph* cg, const Graph* g) {
+    if (!cg || !g || g->n < 1) return 0;
+    memset(cg, 0, sizeof(*cg));
+    int n = g->n;
+
+    long long* start = (long long*)GRAPH_CALLOC((size_t)n + 1, sizeof(long long));
+    int* count = (int*)GRAPH_CALLOC((size_t)n, sizeof(int));
+    if (!start || !count) {
+        GRAPH_FREE(start);
+        GRAPH_FREE(count);
+        return 0;
+    }
+    for (int u = 0; u < n; u++) {
+        long long entries = 0;
+        for (EdgeNode* e = g->adj[u].head; e; e = e->next) entries++;
+        start[u + 1] = start[u] + entries;
+    }
+
+    BuildArc* arcs = (BuildArc*)GRAPH_MALLOC((size_t)(start[n] > 0 ? start[n] : 1) * sizeof(BuildArc));
+    if (!arcs) {
+        GRAPH_FREE(start);
+        GRAPH_FREE(count);
+        return 0;
+    }
+
+    for (int u = 0; u < n; u++) {
+        int order = 0;
+        for (EdgeNode* e = g->adj[u].head; e; e = e->next) {
+            arcs[start[u] + count[u]++] = (BuildArc){e->to, e->weight, order++};
+        }
+    }
+    // The second node of each self-loop goes away with the repeats
+    sort_lists(arcs, n, start, count);
+
+    int ok = encode_lists(cg, n, arcs, start, count);
+    GRAPH_FREE(arcs);
+    GRAPH_FREE(start);
+    GRAPH_FREE(count);
+    return ok;
+}
+
+void compressed_graph_free(CompressedGraph* cg) {
+    if (!cg) return;
+    GRAPH_FREE(cg->offsets);
+    GRAPH_FREE(cg->data);
+    memset(cg, 0, sizeof(*cg));
+}
+
+size_t compressed_graph_bytes(const CompressedGraph* cg) {
+    if (!cg || !cg->offsets) return 0;
+    return cg->offsets[cg->n] + (size_t)(cg->n + 1) * sizeof(size_t);
+}
+
+/* ---------- Traversal ---------- */
+
+int compressed_graph_bfs(const CompressedGraph* cg, int source, int* dist) {
+    if (!cg || !cg->offsets || !dist || source < 0 || source >= cg->n) return 0;
+    int n = cg->n;
+
+    int* queue = (int*)GRAPH_MALLOC((size_t)n * sizeof(int));
+    if (!queue) return 0;
+    for (int v = 0; v < n; v++) dist[v] = -1;
+
+    int head = 0, tail = 0;
+    dist[source] = 0;
+    queue[tail++] = source;
+    while (head < tail) {
+        int u = queue[head++];
+        CompressedNeighborIter it;
+        int v;
+        compressed_graph_neighbors(cg, u, &it);
+        while (compressed_neighbor_next(&it, &v, NULL)) {
+            if (dist[v] < 0) {
+                dist[v] = dist[u] + 1;
+                queue[tail++] = v;
+            }
+        }
+    }
+
+    GRAPH_FREE(queue);
+    return 1;
+}
+
+int compressed_graph_is_connected(const CompressedGraph* cg, int* connected) {
+    if (!cg || !cg->offsets || !connected) return 0;
+    int n = cg->n;
+
+    int source = -1;
+    for (int v = 0; v < n && source < 0; v++) {
+        if (compressed_graph_degree(cg, v) > 0) source = v;
+    }
+    if (source < 0) {
+        *connected = 1;
+        return 1;
+    }
+
+    int* dist = (int*)GRAPH_MALLOC((size_t)n * sizeof(int));
+    if (!dist) return 0;
+    if (!compressed_graph_bfs(cg, source, dist)) {
+        GRAPH_FREE(dist);
+        return 0;
+    }
+
+    *connected = 1;
+    for (int v = 0; v < n; v++) {
+        if (dist[v] < 0 && compressed_graph_degree(cg, v) > 0) {
+            *connected = 0;
+            break;
+        }
+    }
+    GRAPH_FREE(dist);
+    return 1;
+}
+
+/* ---------- Euler circuit ---------- */
+
+int compressed_graph_has_euler_circuit(const CompressedGraph* cg) {
+    if (!cg || !cg->offsets || cg->num_arcs == 0) return 0;
+
+    for (int v = 0; v < cg->n; v++) {
+        if (compressed_graph_degree(cg, v) % 2 != 0) return 0;
+    }
+
+    int connected;
+    return compressed_graph_is_connected(cg, &connected) && connected;
+}
+
+/**
+ * twin[base[u] + i] = position of the other entry of the edge behind entry
+ * i of u, within its own list. Visiting u in ascending order, the entries
+ * pointing at v are met in the order v's sorted list holds them, so a
+ * running count per vertex gives the position. The two entries of a
+ * self-loop are adjacent and point at each other.
+ */
+static void pair_entries(const CompressedGraph* cg, const long long* base, int* twin, int* fill) {
+    for (int u = 0; u < cg->n; u++) {
+        CompressedNeighborIter it;
+        int v, i = 0, self = 0;
+        compressed_graph_neighbors(cg, u, &it);
+        while (compressed_neighbor_next(&it, &v, NULL)) {
+            if (v == u) {
+                twin[base[u] + i] = self++ == 0 ? i + 1 : i - 1;
+                fill[u]++;
+            } else {
+                twin[base[u] + i] = fill[v]++;
+            }
+            i++;
+        }
+    }
+}
+
+int compressed_graph_find_euler_circuit(const CompressedGraph* cg, int** out_cycle, long long* out_len) {
+    if (!cg || !out_cycle || !out_len) return 0;
+    *out_cycle = NULL;
+    *out_len = 0;
+
+    if (!compressed_graph_has_euler_circuit(cg)) return 0;
+    int n = cg->n;
+    long long num_edges = cg->num_arcs / 2;
+
+    long long* base = (long long*)GRAPH_MALLOC((size_t)(n + 1) * sizeof(long long));
+    int* fill = (int*)GRAPH_CALLOC((size_t)n, sizeof(int));
+    int* twin = (int*)GRAPH_MALLOC((size_t)cg->num_arcs * sizeof(int));
+    unsigned char* used = (unsigned char*)GRAPH_CALLOC((size_t)(cg->num_arcs + 7) / 8, 1);
+    CompressedNeighborIter* iters = (CompressedNeighborIter*)GRAPH_MALLOC((size_t)n * sizeof(CompressedNeighborIter));
+    int* stack = (int*)GRAPH_MALLOC((size_t)(num_edges + 1) * sizeof(int));
+    int* path = (int*)GRAPH_MALLOC((size_t)(num_edges + 1) * sizeof(int));
+    int ok = base && fill && twin && used && iters && stack && path;
+
+    if (ok) {
+        base[0] = 0;
+        for (int v = 0; v < n; v++) {
+            base[v + 1] = base[v] + compressed_graph_degree(cg, v);
+            compressed_graph_neighbors(cg, v, &iters[v]);
+        }
+        pair_entries(cg, base, twin, fill);
+
+        // fill[v] now equals the degree of v; reuse it as the next entry to read
+        memset(fill, 0, (size_t)n * sizeof(int));
+
+        int start = 0;
+        while (compressed_graph_degree(cg, start) == 0) start++;
+
+        long long top = 0, len = 0;
+        stack[top++] = start;
+        while (top > 0) {
+            int u = stack[top - 1];
+            int v, moved = 0;
+            while (compressed_neighbor_next(&iters[u], &v, NULL)) {
+                long long entry = base[u] + fill[u]++;
+                if (used[entry >> 3] & (1u << (entry & 7))) continue;
+
+                long long other = base[v] + twin[entry];
+                used[entry >> 3] |= (unsigned char)(1u << (entry & 7));
+                used[other >> 3] |= (unsigned char)(1u << (other & 7));
+                stack[top++] = v;
+                moved = 1;
+                break;
+            }
+            if (!moved) path[len++] = stack[--top];
+        }
+
+        // Reverse so the circuit follows the direction it was walked
+        for (long long i = 0, j = len - 1; i < j; i++, j--) {
+            int tmp = path[i];
+            path[i] = path[j];
+            path[j] = tmp;
+        }
+        *out_cycle = path;
+        *out_len = len;
+        path = NULL;
+    }
+
+    GRAPH_FREE(base);
+    GRAPH_FREE(fill);
+    GRAPH_FREE(twin);
+    GRAPH_FREE(used);
+    GRAPH_FREE(iters);
+    GRAPH_FREE(stack);
+    GRAPH_FREE(path);
+    return ok;
+}
+
+/* ---------- Minimum spanning tree ---------- */
+
+/* Binary heap of vertices ordered by key, with each vertex's slot in pos so
+ * a lower key moves it up in place: O(n) memory instead of one node per
+ * adjacency entry. */
+typedef struct {
+    int* heap;
+    int* pos;          // -1 if not in the heap
+    const int* key;
+    int size;
+} VertexHeap;
+
+static void heap_place(VertexHeap* h, int slot, int v) {
+    h->heap[slot] = v;
+    h->pos[v] = slot;
+}
+
+static void heap_sift_up(VertexHeap* h, int slot) {
+    int v = h->heap[slot];
+    while (slot > 0) {
+        int parent = (slot - 1) / 2;
+        if (h->key[h->heap[parent]] <= h->key[v]) break;
+        heap_place(h, slot, h->heap[parent]);
+        slot = parent;
+    }
+    heap_place(h, slot, v);
+}
+
+static void heap_sift_down(VertexHeap* h, int slot) {
+    int v = h->heap[slot];
+    for (;;) {
+        int child = 2 * slot + 1;
+        if (child >= h->size) break;
+        if (child + 1 < h->size && h->key[h->heap[child + 1]] < h->key[h->heap[child]]) child++;
+        if (h->key[h->heap[child]] >= h->key[v]) break;
+        heap_place(h, slot, h->heap[child]);
+        slot = child;
+    }
+    heap_place(h, slot, v);
+}
+
+static int heap_pop(VertexHeap* h) {
+    int top = h->heap[0];
+    h->pos[top] = -1;
+    h->size--;
+    if (h->size > 0) {
+        h->heap[0] = h->heap[h->size];
+        heap_sift_down(h, 0);
+    }
+    return top;
+}
+
+int compressed_graph_mst(const CompressedGraph* cg, MST_Result* result) {
+    if (!cg || !cg->offsets || !result || cg->n < 1) return 0;
+    int n = cg->n;
+
+    result->edges = NULL;
+    result->num_edges = 0;
+    result->total_weight = 0;
+    result->is_connected = 0;
+
+    if (n == 1) {
+        result->is_connected = 1;
+        return 1;
+    }
+
+    int* key = (int*)GRAPH_MALLOC((size_t)n * sizeof(int));
+    int* parent = (int*)GRAPH_MALLOC((size_t)n * sizeof(int));
+    int* heap = (int*)GRAPH_MALLOC((size_t)n * sizeof(int));
+    int* pos = (int*)GRAPH_MALLOC((size_t)n * sizeof(int));
+    unsigned char* in_mst = (unsigned char*)GRAPH_CALLOC((size_t)n, 1);
+    int ok = key && parent && heap && pos && in_mst;
+
+    if (ok) {
+        for (int v = 0; v < n; v++) {
+            key[v] = INT_MAX;
+            parent[v] = -1;
+            pos[v] = -1;
+        }
+        key[0] = 0;
+
+        VertexHeap h = {heap, pos, key, 0};
+        heap_place(&h, h.size++, 0);
+
+        int vertices_in_mst = 0;
+        while (h.size > 0) {
+            int u = heap_pop(&h);
+            in_mst[u] = 1;
+            vertices_in_mst++;
+
+            // Same edge rules as the list version: positive weights, no self-loops
+            CompressedNeighborIter it;
+            int v, weight;
+            compressed_graph_neighbors(cg, u, &it);
+            while (compressed_neighbor_next(&it, &v, &weight)) {
+                if (v == u || weight <= 0 || in_mst[v] || weight >= key[v]) continue;
+                key[v] = weight;
+                parent[v] = u;
+                if (pos[v] < 0) heap_place(&h, h.size++, v);
+                heap_sift_up(&h, pos[v]);
+            }
+        }
+        result->is_connected = (vertices_in_mst == n);
+    }
+
+    if (ok && result->is_connected) {
+        result->edges = (MST_Edge*)GRAPH_MALLOC((size_t)(n - 1) * sizeof(MST_Edge));
+        if (!result->edges) {
+            result->is_connected = 0;
+            ok = 0;
+        }
+    }
+
+    if (ok && result->is_connected) {
+        for (int v = 1; v < n; v++) {
+            result->edges[result->num_edges].u = parent[v];
+            result->edges[result->num_edges].v = v;
+            result->edges[result->num_edges].weight = key[v];
+            result->total_weight += key[v];
+            result->num_edges++;
+        }
+    }
+
+    GRAPH_FREE(key);
+    GRAPH_FREE(parent);
+    GRAPH_FREE(heap);
+    GRAPH_FREE(pos);
+    GRAPH_FREE(in_mst);
+    return ok;
+}
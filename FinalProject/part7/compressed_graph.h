@@ -0,0 +1,159 @@
+#ifndef COMPRESSED_GRAPH_H
+#define COMPRESSED_GRAPH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "graph.h"
+#include "mst.h"
+
+/**
+ * @file compressed_graph.h
+ * Read-only compressed adjacency for graphs too large for EdgeNode lists.
+ *
+ * The neighbors of each vertex are sorted and stored as one byte block:
+ * the degree, the first neighbor relative to the vertex (zigzag), then the
+ * gaps between consecutive neighbors, all as 7-bit varints. If any weight
+ * is not 1, every neighbor is followed by its weight (zigzag). Block v
+ * starts at offsets[v], so each list decodes on its own, front to back.
+ *
+ * Neighbors with nearby ids (web crawls, meshes, or any graph after
+ * graph_reorder.c) take one or two bytes per entry, against an EdgeNode of
+ * 16 bytes plus its malloc header. Like Graph, an edge is stored in both
+ * lists and a self-loop twice in its vertex's list.
+ */
+
+typedef struct {
+    int n;
+    long long num_arcs;     // Adjacency entries (2 per edge, self-loops included)
+    int weighted;           // 1 if the blocks carry weights
+    size_t* offsets;        // n + 1 byte offsets into data
+    unsigned char* data;
+} CompressedGraph;
+
+/**
+ * Position in one vertex's neighbor list. Set up with
+ * compressed_graph_neighbors() and advanced with compressed_neighbor_next().
+ */
+typedef struct {
+    const unsigned char* p;
+    int remaining;
+    int prev;               // Last neighbor returned (the vertex itself at first)
+    int first;
+    int weighted;
+} CompressedNeighborIter;
+
+static inline uint64_t compressed_read_varint(const unsigned char** p) {
+    uint64_t value = 0;
+    int shift = 0;
+    unsigned char byte;
+    do {
+        byte = *(*p)++;
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return value;
+}
+
+static inline int64_t compressed_unzigzag(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+/**
+ * Number of adjacency entries of @p v (a self-loop counts twice).
+ */
+static inline int compressed_graph_degree(const CompressedGraph* cg, int v) {
+    const unsigned char* p = cg->data + cg->offsets[v];
+    return (int)compressed_read_varint(&p);
+}
+
+static inline void compressed_graph_neighbors(const CompressedGraph* cg, int v,
+                                              CompressedNeighborIter* it) {
+    it->p = cg->data + cg->offsets[v];
+    it->remaining = (int)compressed_read_varint(&it->p);
+    it->prev = v;
+    it->first = 1;
+    it->weighted = cg->weighted;
+}
+
+/**
+ * Next neighbor in ascending order.
+ * @param weight OUT: edge weight (1 for unweighted graphs), may be NULL
+ * @return 1 if a neighbor was read, 0 at the end of the list
+ */
+static inline int compressed_neighbor_next(CompressedNeighborIter* it, int* to, int* weight) {
+    if (it->remaining == 0) return 0;
+    it->remaining--;
+
+    uint64_t code = compressed_read_varint(&it->p);
+    if (it->first) {
+        it->prev += (int)compressed_unzigzag(code);
+        it->first = 0;
+    } else {
+        it->prev += (int)code;
+    }
+    *to = it->prev;
+
+    int w = it->weighted ? (int)compressed_unzigzag(compressed_read_varint(&it->p)) : 1;
+    if (weight) *weight = w;
+    return 1;
+}
+
+/**
+ * Build from @p m (u, v, weight) triples. As with graph_add_weighted_edge(),
+ * edges with an endpoint out of range and repeats of an earlier edge are
+ * skipped. Needs 12 bytes per adjacency entry of scratch while building.
+ * @return 1 on success, 0 on invalid arguments or allocation failure
+ */
+int compressed_graph_build(CompressedGraph* cg, int n, long long m, const int* triples);
+
+/**
+ * Compress an existing graph.
+ * @return 1 on success, 0 on invalid arguments or allocation failure
+ */
+int compressed_graph_from_graph(CompressedGraph* cg, const Graph* g);
+
+/**
+ * Free a compressed graph (safe to call on a zeroed one).
+ */
+void compressed_graph_free(CompressedGraph* cg);
+
+/**
+ * Bytes held by the graph: the encoded blocks plus the offsets.
+ */
+size_t compressed_graph_bytes(const CompressedGraph* cg);
+
+/**
+ * Breadth-first distances from @p source; dist[v] = -1 if unreachable.
+ * @param dist OUT: n ints
+ * @return 1 on success, 0 on invalid arguments or allocation failure
+ */
+int compressed_graph_bfs(const CompressedGraph* cg, int source, int* dist);
+
+/**
+ * Check that all vertices with at least one edge are in one component.
+ * @return 1 on success, 0 on invalid arguments or allocation failure
+ */
+int compressed_graph_is_connected(const CompressedGraph* cg, int* connected);
+
+/**
+ * Same test as graph_has_euler_circuit().
+ * @return 1 if an Euler circuit exists, 0 otherwise
+ */
+int compressed_graph_has_euler_circuit(const CompressedGraph* cg);
+
+/**
+ * Hierholzer's algorithm, as graph_find_euler_circuit(). Needs 4 bytes and
+ * one bit per adjacency entry of scratch to pair the two entries of an edge.
+ * @param out_cycle On success, vertex sequence (free with GRAPH_FREE)
+ * @return 1 on success, 0 if there is no circuit or on failure
+ */
+int compressed_graph_find_euler_circuit(const CompressedGraph* cg, int** out_cycle, long long* out_len);
+
+/**
+ * Prim's algorithm with an indexed heap (O(n) scratch), with the result
+ * contract and edge rules of graph_mst_prim_list_ws().
+ * @return 1 on success, 0 on failure
+ */
+int compressed_graph_mst(const CompressedGraph* cg, MST_Result* result);
+
+#endif /* COMPRESSED_GRAPH_H */
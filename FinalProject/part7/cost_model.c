@@ -0,0 +1,191 @@
+#include "cost_model.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+/**
+ * Model of one variant. The defaults were fitted with graph_bench -C on an
+ * x86-64 development machine; run the calibration on the target host for
+ * better choices.
+ */
+typedef struct {
+    const char* name;
+    int algorithm_id;
+    double fixed_ns;
+    double ns_per_unit;
+} VariantModel;
+
+static VariantModel models[ALGO_VARIANT_COUNT] = {
+    [ALGO_VARIANT_AUTO]             = {"auto",          0, 0.0, 0.0},
+    [ALGO_VARIANT_PRIM_MATRIX]      = {"prim-matrix",   3, 1065.0, 2.10},
+    [ALGO_VARIANT_PRIM_LIST]        = {"prim-list",     3,  512.0, 1.38},
+    [ALGO_VARIANT_EDMONDS_KARP]     = {"edmonds-karp",  2, 3620.0, 1.29},
+    [ALGO_VARIANT_DINIC]            = {"dinic",         2, 3910.0, 1.19},
+    [ALGO_VARIANT_CLIQUE_BACKTRACK] = {"backtrack",     4,  553.0, 1.98},
+    [ALGO_VARIANT_CLIQUE_COLORING]  = {"coloring",      4, 1053.0, 0.49},
+    [ALGO_VARIANT_RADIX_HEAP]       = {"radix-heap",    6,  274.0, 3.40},
+    [ALGO_VARIANT_DELTA_STEPPING]   = {"delta-stepping", 6, 345964.0, 19.24},
+    [ALGO_VARIANT_COLOR_SMALLEST_LAST] = {"smallest-last", 9, 0.0, 9.76},
+    [ALGO_VARIANT_COLOR_DSATUR]     = {"dsatur",        9, 0.0, 3.56},
+    [ALGO_VARIANT_COLOR_JONES_PLASSMANN] = {"jones-plassmann", 9, 0.0, 20.11}
+};
+
+static int valid_variant(int variant) {
+    return variant > ALGO_VARIANT_AUTO && variant < ALGO_VARIANT_COUNT;
+}
+
+const char* cost_model_variant_name(int variant) {
+    if (variant == ALGO_VARIANT_AUTO || valid_variant(variant)) return models[variant].name;
+    return "unknown";
+}
+
+int cost_model_variant_from_name(const char* name) {
+    if (!name) return ALGO_VARIANT_AUTO;
+    for (int v = ALGO_VARIANT_AUTO + 1; v < ALGO_VARIANT_COUNT; v++) {
+        if (strcmp(models[v].name, name) == 0) return v;
+    }
+    return ALGO_VARIANT_AUTO;
+}
+
+int cost_model_variant_algorithm(int variant) {
+    return valid_variant(variant) ? models[variant].algorithm_id : 0;
+}
+
+/**
+ * Rough count of cliques a search visits: (1 + density)^k per start vertex
+ * for neighborhoods of size k, with k bounded by the degeneracy.
+ */
+static double clique_search_nodes(const GraphProfile* p, double exponent) {
+    if (exponent > 200.0) exponent = 200.0;
+    return (double)p->n * pow(1.0 + p->density, exponent);
+}
+
+double cost_model_work_units(int variant, const GraphProfile* p) {
+    if (!p) return 0.0;
+    double n = p->n;
+    double half_edges = 2.0 * p->m;
+
+    switch (variant) {
+        case ALGO_VARIANT_PRIM_MATRIX:
+            // Matrix fill plus one row scan per vertex
+            return n * n;
+        case ALGO_VARIANT_PRIM_LIST:
+            // Every adjacency node may push onto the heap
+            return n + half_edges * log2(half_edges + 2.0);
+        case ALGO_VARIANT_EDMONDS_KARP:
+            // Matrix fill, then one BFS over the arcs per augmenting path,
+            // about one path per edge at the source
+            return n * n + (n + half_edges) * (p->avg_degree + 1.0);
+        case ALGO_VARIANT_DINIC:
+            // Matrix fill, then few phases, each a BFS and a blocking flow over the arcs
+            return n * n + (n + half_edges) * (log2(p->avg_degree + 1.0) + 1.0);
+        case ALGO_VARIANT_CLIQUE_BACKTRACK:
+            // Enumerates every clique, scanning the remaining vertices at each one
+            return n * clique_search_nodes(p, p->degeneracy);
+        case ALGO_VARIANT_CLIQUE_COLORING: {
+            // Coloring costs d^2 per node, but the bound prunes most of the tree
+            double d = p->degeneracy + 1.0;
+            return n * n + d * d * clique_search_nodes(p, 0.5 * p->degeneracy);
+        }
+        case ALGO_VARIANT_RADIX_HEAP:
+            // One push per improving edge, each moved down a few buckets
+            return n + 2.0 * half_edges;
+        case ALGO_VARIANT_DELTA_STEPPING:
+            // Every edge relaxed about once, plus a barrier round per bucket
+            return n + half_edges;
+        case ALGO_VARIANT_COLOR_SMALLEST_LAST:
+        case ALGO_VARIANT_COLOR_JONES_PLASSMANN:
+            // A few passes over the arcs
+            return n + half_edges;
+        case ALGO_VARIANT_COLOR_DSATUR:
+            // A heap update per arc that raises a saturation
+            return (n + half_edges) * log2(n + 2.0);
+        default:
+            return 0.0;
+    }
+}
+
+double cost_model_estimate_ns(int variant, const GraphProfile* profile) {
+    if (!valid_variant(variant)) return HUGE_VAL;
+    return models[variant].fixed_ns +
+           models[variant].ns_per_unit * cost_model_work_units(variant, profile);
+}
+
+int cost_model_set(int variant, double fixed_ns, double ns_per_unit) {
+    if (!valid_variant(variant) || fixed_ns < 0.0 || ns_per_unit < 0.0) return 0;
+    models[variant].fixed_ns = fixed_ns;
+    models[variant].ns_per_unit = ns_per_unit;
+    return 1;
+}
+
+int cost_model_fit(int variant, const double* units, const double* ns, int count) {
+    if (!valid_variant(variant) || !units || !ns || count < 2) return 0;
+
+    // Weighted least squares with weights 1/t^2 (relative error)
+    double s = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (int i = 0; i < count; i++) {
+        if (ns[i] <= 0.0) continue;
+        double w = 1.0 / (ns[i] * ns[i]);
+        s += w;
+        sx += w * units[i];
+        sy += w * ns[i];
+        sxx += w * units[i] * units[i];
+        sxy += w * units[i] * ns[i];
+    }
+    if (s == 0.0 || sxx == 0.0) return 0;
+
+    double fixed = 0.0, slope;
+    double det = s * sxx - sx * sx;
+    if (det > 0.0) {
+        slope = (s * sxy - sx * sy) / det;
+        fixed = (sxx * sy - sx * sxy) / det;
+    } else {
+        slope = sxy / sxx;
+    }
+
+    // Keep both coefficients non-negative, refitting the other one alone
+    if (fixed < 0.0) {
+        fixed = 0.0;
+        slope = sxy / sxx;
+    }
+    if (slope < 0.0) {
+        slope = 0.0;
+        fixed = sy / s;
+    }
+    return cost_model_set(variant, fixed, slope);
+}
+
+int cost_model_load(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) return -1;
+
+    char line[256];
+    int loaded = 0;
+    while (fgets(line, sizeof(line), f)) {
+        char name[64];
+        double fixed, slope;
+        if (line[0] == '#') continue;
+        if (sscanf(line, "%63s %lf %lf", name, &fixed, &slope) != 3) continue;
+        if (cost_model_set(cost_model_variant_from_name(name), fixed, slope)) loaded++;
+    }
+    fclose(f);
+    return loaded;
+}
+
+int cost_model_save(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) return 0;
+
+    fprintf(f, "# variant fixed_ns ns_per_unit\n");
+    for (int v = ALGO_VARIANT_AUTO + 1; v < ALGO_VARIANT_COUNT; v++) {
+        fprintf(f, "%s %.6g %.6g\n", models[v].name, models[v].fixed_ns, models[v].ns_per_unit);
+    }
+    return fclose(f) == 0;
+}
+
+void cost_model_print(void) {
+    printf("%-14s %12s %12s\n", "variant", "fixed(ns)", "ns/unit");
+    for (int v = ALGO_VARIANT_AUTO + 1; v < ALGO_VARIANT_COUNT; v++) {
+        printf("%-14s %12.1f %12.4g\n", models[v].name, models[v].fixed_ns, models[v].ns_per_unit);
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef COST_MODEL_H
+#define COST_MODEL_H
+
+#include "graph_profile.h"
+#include "algorithm_params.h"
+
+/**
+ * @file cost_model.h
+ * Per-variant running time model used to pick an algorithm implementation.
+ *
+ * Each variant has a work estimate computed from the graph profile (for
+ * example n^2 for matrix Prim, (n + m) log m for list Prim) and a linear
+ * model  time_ns = fixed_ns + ns_per_unit * units  whose two coefficients
+ * are fitted on the host by the benchmark harness (graph_bench -C).
+ */
+
+/**
+ * Name of a variant ("prim-matrix", "dinic", ...), or "auto"/"unknown".
+ */
+const char* cost_model_variant_name(int variant);
+
+/**
+ * Look up a variant by name.
+ * @return The variant, or ALGO_VARIANT_AUTO if the name is unknown.
+ */
+int cost_model_variant_from_name(const char* name);
+
+/**
+ * Strategy id (2 = max flow, 3 = MST, 4 = max clique) a variant implements.
+ * @return The id, or 0 for ALGO_VARIANT_AUTO / unknown variants.
+ */
+int cost_model_variant_algorithm(int variant);
+
+/**
+ * Work estimate of @p variant on a graph with the given profile.
+ */
+double cost_model_work_units(int variant, const GraphProfile* profile);
+
+/**
+ * Predicted running time of @p variant in nanoseconds.
+ */
+double cost_model_estimate_ns(int variant, const GraphProfile* profile);
+
+/**
+ * Replace the coefficients of one variant.
+ * @return 1 on success, 0 for an unknown variant or negative coefficients.
+ */
+int cost_model_set(int variant, double fixed_ns, double ns_per_unit);
+
+/**
+ * Fit the coefficients of @p variant from measurements, minimizing the
+ * squared relative error so small and large graphs weigh the same.
+ *
+ * @param units Work estimates of the measured graphs
+ * @param ns Measured times (e.g. medians) in nanoseconds
+ * @param count Number of measurements (at least 2)
+ * @return 1 if the model was updated, 0 otherwise
+ */
+int cost_model_fit(int variant, const double* units, const double* ns, int count);
+
+/**
+ * Load coefficients written by cost_model_save(). Variants missing from the
+ * file keep their current coefficients.
+ * @return Number of variants loaded, or -1 if the file cannot be read.
+ */
+int cost_model_load(const char* path);
+
+/**
+ * Write the current coefficients, one "name fixed_ns ns_per_unit" line each.
+ * @return 1 on success, 0 on failure.
+ */
+int cost_model_save(const char* path);
+
+/**
+ * Print the current coefficients.
+ */
+void cost_model_print(void);
+
+#endif /* COST_MODEL_H */
@@ -0,0 +1,667 @@
+#define _POSIX_C_SOURCE 200809L
+#include "distcount.h"
+#include "graph_alloc.h"
+#include "simd_kernels.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+/* ---------- Connections ---------- */
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+static int send_exact(int fd, const void* buf, size_t len) {
+    const char* p = (const char*)buf;
+    while (len > 0) {
+        ssize_t sent = send(fd, p, len, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return 0;
+        p += sent;
+        len -= (size_t)sent;
+    }
+    return 1;
+}
+
+static int recv_exact(int fd, void* buf, size_t len) {
+    char* p = (char*)buf;
+    while (len > 0) {
+        ssize_t got = recv(fd, p, len, 0);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return 0;
+        p += got;
+        len -= (size_t)got;
+    }
+    return 1;
+}
+
+static int open_socket(const char* host, int port, int listening) {
+    char service[16];
+    snprintf(service, sizeof(service), "%d", port);
+    struct addrinfo hints, *res = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = listening ? AI_PASSIVE : 0;
+    if (getaddrinfo(listening ? NULL : host, service, &hints, &res) != 0 || !res) return -1;
+
+    int fd = socket(res->ai_family, res->ai_socktype, 0);
+    if (fd >= 0 && listening) {
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (bind(fd, res->ai_addr, res->ai_addrlen) < 0 || listen(fd, 64) < 0) {
+            close(fd);
+            fd = -1;
+        }
+    } else if (fd >= 0 && connect(fd, res->ai_addr, res->ai_addrlen) < 0) {
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+int dist_comm_connect(DistComm* comm, int rank, int size, const char* const* hosts,
+                      const int* ports, int timeout_ms) {
+    if (!comm) return 0;
+    memset(comm, 0, sizeof(*comm));
+    if (size < 1 || rank < 0 || rank >= size || !ports) return 0;
+    comm->rank = rank;
+    comm->size = size;
+    comm->fds = (int*)GRAPH_MALLOC((size_t)size * sizeof(int));
+    if (!comm->fds) return 0;
+    for (int p = 0; p < size; p++) comm->fds[p] = -1;
+
+    // Listen first: the workers above connect here while this one connects down
+    int listen_fd = -1;
+    if (rank < size - 1) {
+        listen_fd = open_socket(NULL, ports[rank], 1);
+        if (listen_fd < 0) {
+            perror("dist_comm_connect: listen");
+            dist_comm_close(comm);
+            return 0;
+        }
+    }
+
+    double deadline = now_ms() + timeout_ms;
+    int ok = 1;
+    for (int p = 0; p < rank && ok; p++) {
+        const char* host = hosts ? hosts[p] : "127.0.0.1";
+        int fd;
+        while ((fd = open_socket(host, ports[p], 0)) < 0 && now_ms() < deadline) {
+            struct timespec pause = {0, 50 * 1000000L};
+            nanosleep(&pause, NULL);
+        }
+        comm->fds[p] = fd;
+        ok = fd >= 0 && send_exact(fd, &rank, sizeof(rank));
+    }
+
+    for (int accepted = rank + 1; accepted < size && ok; accepted++) {
+        struct pollfd pfd = {listen_fd, POLLIN, 0};
+        double left = deadline - now_ms();
+        int peer = -1;
+        if (left <= 0 || poll(&pfd, 1, (int)left) <= 0) {
+            ok = 0;
+            break;
+        }
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0 || !recv_exact(fd, &peer, sizeof(peer)) ||
+            peer <= rank || peer >= size || comm->fds[peer] >= 0) {
+            if (fd >= 0) close(fd);
+            ok = 0;
+            break;
+        }
+        comm->fds[peer] = fd;
+    }
+    if (listen_fd >= 0) close(listen_fd);
+
+    if (!ok) {
+        fprintf(stderr, "dist_comm_connect: worker %d could not reach all %d workers\n",
+                rank, size);
+        dist_comm_close(comm);
+        return 0;
+    }
+    return 1;
+}
+
+void dist_comm_close(DistComm* comm) {
+    if (!comm) return;
+    if (comm->fds) {
+        for (int p = 0; p < comm->size; p++) {
+            if (comm->fds[p] >= 0) close(comm->fds[p]);
+        }
+        GRAPH_FREE(comm->fds);
+    }
+    memset(comm, 0, sizeof(*comm));
+}
+
+/* ---------- Exchange ---------- */
+
+int dist_buffer_append(DistBuffer* buf, const void* data, size_t bytes) {
+    if (buf->len + bytes > buf->cap) {
+        size_t cap = buf->cap ? buf->cap * 2 : 256;
+        while (cap < buf->len + bytes) cap *= 2;
+        char* grown = (char*)GRAPH_REALLOC(buf->data, cap);
+        if (!grown) return 0;
+        buf->data = grown;
+        buf->cap = cap;
+    }
+    memcpy(buf->data + buf->len, data, bytes);
+    buf->len += bytes;
+    return 1;
+}
+
+void dist_buffer_free(DistBuffer* buf) {
+    if (!buf) return;
+    GRAPH_FREE(buf->data);
+    memset(buf, 0, sizeof(*buf));
+}
+
+/**
+ * Progress of one peer's message in each direction: an 8-byte length, then
+ * the payload. Positions count both.
+ */
+typedef struct {
+    uint64_t send_header;
+    size_t send_pos;
+    uint64_t recv_header;
+    size_t recv_pos;
+} ExchangeState;
+
+/* Send or receive the next part of a [length][payload] stream without blocking */
+static ssize_t stream_step(int fd, int sending, uint64_t* header, char** payload,
+                           size_t* pos) {
+    char* p;
+    size_t left;
+    if (*pos < sizeof(uint64_t)) {
+        p = (char*)header + *pos;
+        left = sizeof(uint64_t) - *pos;
+    } else {
+        p = *payload + (*pos - sizeof(uint64_t));
+        left = (size_t)*header - (*pos - sizeof(uint64_t));
+    }
+    ssize_t moved = sending ? send(fd, p, left, MSG_DONTWAIT | MSG_NOSIGNAL)
+                            : recv(fd, p, left, MSG_DONTWAIT);
+    if (moved < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return 0;
+    if (moved <= 0) return -1;
+    *pos += (size_t)moved;
+    return moved;
+}
+
+int dist_comm_exchange(DistComm* comm, DistBuffer* send, DistBuffer* recv) {
+    int size = comm->size;
+    for (int p = 0; p < size; p++) memset(&recv[p], 0, sizeof(DistBuffer));
+    recv[comm->rank] = send[comm->rank];
+    memset(&send[comm->rank], 0, sizeof(DistBuffer));
+
+    ExchangeState* state = (ExchangeState*)GRAPH_CALLOC((size_t)size, sizeof(ExchangeState));
+    struct pollfd* pfds = (struct pollfd*)GRAPH_MALLOC((size_t)size * sizeof(struct pollfd));
+    int* peer_of = (int*)GRAPH_MALLOC((size_t)size * sizeof(int));
+    int ok = state && pfds && peer_of;
+    for (int p = 0; p < size && ok; p++) state[p].send_header = send[p].len;
+
+    while (ok) {
+        int active = 0;
+        for (int p = 0; p < size; p++) {
+            if (p == comm->rank) continue;
+            short events = 0;
+            if (state[p].send_pos < sizeof(uint64_t) + send[p].len) events |= POLLOUT;
+            if (state[p].recv_pos < sizeof(uint64_t) ||
+                state[p].recv_pos < sizeof(uint64_t) + state[p].recv_header) events |= POLLIN;
+            if (!events) continue;
+            pfds[active].fd = comm->fds[p];
+            pfds[active].events = events;
+            pfds[active].revents = 0;
+            peer_of[active++] = p;
+        }
+        if (active == 0) break;
+        if (poll(pfds, (nfds_t)active, -1) < 0) {
+            if (errno == EINTR) continue;
+            ok = 0;
+            break;
+        }
+
+        for (int i = 0; i < active && ok; i++) {
+            int p = peer_of[i];
+            ExchangeState* s = &state[p];
+            if (pfds[i].revents & POLLOUT) {
+                ssize_t moved = stream_step(comm->fds[p], 1, &s->send_header, &send[p].data,
+                                            &s->send_pos);
+                if (moved < 0) ok = 0;
+            }
+            if (ok && (pfds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                int had_header = s->recv_pos >= sizeof(uint64_t);
+                ssize_t moved = stream_step(comm->fds[p], 0, &s->recv_header, &recv[p].data,
+                                            &s->recv_pos);
+                if (moved < 0) {
+                    ok = 0;
+                } else if (!had_header && s->recv_pos == sizeof(uint64_t) && s->recv_header > 0) {
+                    // Length known: allocate the payload once
+                    recv[p].data = (char*)GRAPH_MALLOC((size_t)s->recv_header);
+                    recv[p].len = recv[p].cap = (size_t)s->recv_header;
+                    if (!recv[p].data) ok = 0;
+                }
+            }
+        }
+    }
+
+    for (int p = 0; p < size; p++) {
+        if (p == comm->rank) continue;
+        if (ok) {
+            comm->bytes_sent += (long long)send[p].len;
+            comm->bytes_received += (long long)recv[p].len;
+        } else {
+            dist_buffer_free(&recv[p]);
+        }
+        dist_buffer_free(&send[p]);
+    }
+    GRAPH_FREE(state);
+    GRAPH_FREE(pfds);
+    GRAPH_FREE(peer_of);
+    return ok;
+}
+
+/* Every worker sends @p value to all; @p combine is 0 for sum, 1 for max */
+static int all_reduce(DistComm* comm, long long* value, int combine) {
+    DistBuffer* send = (DistBuffer*)GRAPH_CALLOC((size_t)comm->size * 2, sizeof(DistBuffer));
+    if (!send) return 0;
+    DistBuffer* recv = send + comm->size;
+
+    int ok = 1;
+    for (int p = 0; p < comm->size && ok; p++) ok = dist_buffer_append(&send[p], value, sizeof(*value));
+    ok = ok && dist_comm_exchange(comm, send, recv);
+
+    long long result = combine ? *value : 0;
+    for (int p = 0; p < comm->size; p++) {
+        if (ok && recv[p].len == sizeof(long long)) {
+            long long v;
+            memcpy(&v, recv[p].data, sizeof(v));
+            if (combine == 0) result += v;
+            else if (v > result) result = v;
+        } else {
+            ok = 0;
+        }
+        dist_buffer_free(&send[p]);
+        dist_buffer_free(&recv[p]);
+    }
+    GRAPH_FREE(send);
+    if (ok) *value = result;
+    return ok;
+}
+
+int dist_comm_sum(DistComm* comm, long long* value) {
+    return all_reduce(comm, value, 0);
+}
+
+int dist_comm_max(DistComm* comm, long long* value) {
+    return all_reduce(comm, value, 1);
+}
+
+/* ---------- Partitioned graph ---------- */
+
+static int cmp_int(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+/* Edge direction: a -> b if a comes first in (degree, id) order */
+static int comes_before(const int* degree, int a, int b) {
+    return degree[a] < degree[b] || (degree[a] == degree[b] && a < b);
+}
+
+/* Exchange buffers, one per worker for sending and one for receiving */
+static DistBuffer* buffers_alloc(const DistComm* comm) {
+    return (DistBuffer*)GRAPH_CALLOC((size_t)comm->size * 2, sizeof(DistBuffer));
+}
+
+static void buffers_free(const DistComm* comm, DistBuffer* buffers) {
+    if (!buffers) return;
+    for (int p = 0; p < comm->size * 2; p++) dist_buffer_free(&buffers[p]);
+    GRAPH_FREE(buffers);
+}
+
+/**
+ * Send every arc to the owner of its tail and build the sorted, duplicate
+ * free adjacency lists of the local vertices.
+ */
+static int shuffle_edges(DistGraph* graph, DistComm* comm, const int* edges,
+                         long long num_edges, long long** adj_offsets, int** adj_targets) {
+    int size = comm->size;
+    DistBuffer* send = buffers_alloc(comm);
+    if (!send) return 0;
+    DistBuffer* recv = send + size;
+
+    int ok = 1;
+    for (long long e = 0; e < num_edges && ok; e++) {
+        int arc[2] = {edges[2 * e], edges[2 * e + 1]};
+        if (arc[0] == arc[1]) continue;
+        int back[2] = {arc[1], arc[0]};
+        ok = dist_buffer_append(&send[arc[0] % size], arc, sizeof(arc)) &&
+             dist_buffer_append(&send[arc[1] % size], back, sizeof(back));
+    }
+    if (!ok || !dist_comm_exchange(comm, send, recv)) {
+        buffers_free(comm, send);
+        return 0;
+    }
+
+    long long* offsets = (long long*)GRAPH_CALLOC((size_t)graph->local_n + 1, sizeof(long long));
+    long long arcs = 0;
+    for (int p = 0; p < size; p++) arcs += (long long)(recv[p].len / (2 * sizeof(int)));
+    int* targets = (int*)GRAPH_MALLOC((size_t)(arcs > 0 ? arcs : 1) * sizeof(int));
+    if (!offsets || !targets) {
+        GRAPH_FREE(offsets);
+        GRAPH_FREE(targets);
+        buffers_free(comm, send);
+        return 0;
+    }
+
+    // Counting sort by local tail, then sort and deduplicate each list
+    for (int p = 0; p < size; p++) {
+        const int* pairs = (const int*)recv[p].data;
+        size_t count = recv[p].len / (2 * sizeof(int));
+        for (size_t i = 0; i < count; i++) offsets[pairs[2 * i] / size + 1]++;
+    }
+    for (int v = 0; v < graph->local_n; v++) offsets[v + 1] += offsets[v];
+    for (int p = 0; p < size; p++) {
+        const int* pairs = (const int*)recv[p].data;
+        size_t count = recv[p].len / (2 * sizeof(int));
+        for (size_t i = 0; i < count; i++) targets[offsets[pairs[2 * i] / size]++] = pairs[2 * i + 1];
+    }
+    buffers_free(comm, send);
+    for (int v = graph->local_n; v > 0; v--) offsets[v] = offsets[v - 1];
+    offsets[0] = 0;
+
+    long long write = 0;
+    for (int v = 0; v < graph->local_n; v++) {
+        long long start = offsets[v], end = offsets[v + 1];
+        qsort(targets + start, (size_t)(end - start), sizeof(int), cmp_int);
+        offsets[v] = write;
+        for (long long a = start; a < end; a++) {
+            if (a == start || targets[a] != targets[a - 1]) targets[write++] = targets[a];
+        }
+    }
+    offsets[graph->local_n] = write;
+
+    *adj_offsets = offsets;
+    *adj_targets = targets;
+    return 1;
+}
+
+/* Send the degree of each local vertex to the owners of its neighbors */
+static int share_degrees(DistGraph* graph, DistComm* comm, const long long* adj_offsets,
+                         const int* adj_targets, int* degree) {
+    int size = comm->size, rank = comm->rank;
+    DistBuffer* send = buffers_alloc(comm);
+    int* stamp = (int*)GRAPH_MALLOC((size_t)size * sizeof(int));
+    if (!send || !stamp) {
+        buffers_free(comm, send);
+        GRAPH_FREE(stamp);
+        return 0;
+    }
+    DistBuffer* recv = send + size;
+    for (int p = 0; p < size; p++) stamp[p] = -1;
+
+    int ok = 1;
+    for (int i = 0; i < graph->local_n && ok; i++) {
+        int b = i * size + rank;
+        int pair[2] = {b, (int)(adj_offsets[i + 1] - adj_offsets[i])};
+        degree[b] = pair[1];
+        for (long long a = adj_offsets[i]; a < adj_offsets[i + 1] && ok; a++) {
+            int p = adj_targets[a] % size;
+            if (p == rank || stamp[p] == b) continue;
+            stamp[p] = b;
+            ok = dist_buffer_append(&send[p], pair, sizeof(pair));
+        }
+    }
+    GRAPH_FREE(stamp);
+    if (!ok || !dist_comm_exchange(comm, send, recv)) {
+        buffers_free(comm, send);
+        return 0;
+    }
+
+    for (int p = 0; p < size; p++) {
+        const int* pairs = (const int*)recv[p].data;
+        size_t count = recv[p].len / (2 * sizeof(int));
+        for (size_t i = 0; i < count; i++) degree[pairs[2 * i]] = pairs[2 * i + 1];
+    }
+    buffers_free(comm, send);
+    return 1;
+}
+
+/**
+ * Send the out-list of each local vertex to the owners of its in-neighbors
+ * (they will intersect with it) and index the lists received.
+ */
+static int share_out_lists(DistGraph* graph, DistComm* comm, const long long* adj_offsets,
+                           const int* adj_targets, const int* degree) {
+    int size = comm->size, rank = comm->rank;
+    DistBuffer* send = buffers_alloc(comm);
+    int* stamp = (int*)GRAPH_MALLOC((size_t)size * sizeof(int));
+    if (!send || !stamp) {
+        buffers_free(comm, send);
+        GRAPH_FREE(stamp);
+        return 0;
+    }
+    DistBuffer* recv = send + size;
+    for (int p = 0; p < size; p++) stamp[p] = -1;
+
+    // Message: [vertex][length][out-list] per vertex
+    int ok = 1;
+    for (int i = 0; i < graph->local_n && ok; i++) {
+        int b = i * size + rank;
+        int head[2] = {b, (int)(graph->offsets[i + 1] - graph->offsets[i])};
+        if (head[1] == 0) continue;
+        for (long long a = adj_offsets[i]; a < adj_offsets[i + 1] && ok; a++) {
+            int u = adj_targets[a], p = u % size;
+            if (p == rank || stamp[p] == b || !comes_before(degree, u, b)) continue;
+            stamp[p] = b;
+            ok = dist_buffer_append(&send[p], head, sizeof(head)) &&
+                 dist_buffer_append(&send[p], graph->targets + graph->offsets[i],
+                                    (size_t)head[1] * sizeof(int));
+        }
+    }
+    GRAPH_FREE(stamp);
+    if (!ok || !dist_comm_exchange(comm, send, recv)) {
+        buffers_free(comm, send);
+        return 0;
+    }
+
+    long long remote_ints = 0;
+    for (int p = 0; p < size; p++) {
+        const int* words = (const int*)recv[p].data;
+        size_t count = recv[p].len / sizeof(int);
+        for (size_t w = 0; w + 1 < count; w += 2 + (size_t)words[w + 1]) {
+            graph->num_remote++;
+            remote_ints += words[w + 1];
+        }
+    }
+    graph->remote_offsets = (long long*)GRAPH_MALLOC(((size_t)graph->num_remote + 1) *
+                                                     sizeof(long long));
+    graph->remote_targets = (int*)GRAPH_MALLOC((size_t)(remote_ints > 0 ? remote_ints : 1) *
+                                               sizeof(int));
+    if (!graph->remote_offsets || !graph->remote_targets) {
+        buffers_free(comm, send);
+        return 0;
+    }
+
+    // The degree array is not needed any more; it becomes the slot index
+    graph->remote_slot = (int*)degree;
+    memset(graph->remote_slot, 0xff, (size_t)graph->n * sizeof(int));
+    int slot = 0;
+    long long pos = 0;
+    for (int p = 0; p < size; p++) {
+        const int* words = (const int*)recv[p].data;
+        size_t count = recv[p].len / sizeof(int);
+        for (size_t w = 0; w + 1 < count; w += 2 + (size_t)words[w + 1]) {
+            int len = words[w + 1];
+            graph->remote_slot[words[w]] = slot;
+            graph->remote_offsets[slot++] = pos;
+            memcpy(graph->remote_targets + pos, words + w + 2, (size_t)len * sizeof(int));
+            pos += len;
+        }
+    }
+    graph->remote_offsets[slot] = pos;
+    buffers_free(comm, send);
+    return 1;
+}
+
+int dist_graph_build(DistGraph* graph, DistComm* comm, const int* edges, long long num_edges,
+                     int n) {
+    if (!graph) return 0;
+    memset(graph, 0, sizeof(*graph));
+    if (!comm || !comm->fds) return 0;
+
+    // Agree on n, and fail together on bad input
+    long long largest = -1, bad = num_edges < 0 || (num_edges > 0 && !edges) || n < 0;
+    for (long long e = 0; e < 2 * num_edges && !bad; e++) {
+        if (edges[e] < 0 || (n > 0 && edges[e] >= n)) bad = 1;
+        if (edges[e] > largest) largest = edges[e];
+    }
+    if (!dist_comm_max(comm, &bad) || bad || !dist_comm_max(comm, &largest)) return 0;
+    if (n == 0) {
+        if (largest >= 0x7fffffff) return 0;
+        n = (int)(largest + 1);
+    }
+
+    graph->n = n;
+    graph->rank = comm->rank;
+    graph->size = comm->size;
+    graph->local_n = n > comm->rank ? (n - 1 - comm->rank) / comm->size + 1 : 0;
+
+    long long* adj_offsets = NULL;
+    int* adj_targets = NULL;
+    int* degree = (int*)GRAPH_CALLOC((size_t)(n > 0 ? n : 1), sizeof(int));
+    int ok = degree && shuffle_edges(graph, comm, edges, num_edges, &adj_offsets, &adj_targets);
+    ok = ok && share_degrees(graph, comm, adj_offsets, adj_targets, degree);
+
+    // Keep the arcs that leave each local vertex in (degree, id) order
+    if (ok) {
+        graph->offsets = (long long*)GRAPH_MALLOC(((size_t)graph->local_n + 1) * sizeof(long long));
+        graph->targets = (int*)GRAPH_MALLOC((size_t)(adj_offsets[graph->local_n] > 0 ?
+                                                     adj_offsets[graph->local_n] : 1) * sizeof(int));
+        ok = graph->offsets && graph->targets;
+    }
+    if (ok) {
+        long long write = 0;
+        for (int i = 0; i < graph->local_n; i++) {
+            int u = i * comm->size + comm->rank;
+            graph->offsets[i] = write;
+            for (long long a = adj_offsets[i]; a < adj_offsets[i + 1]; a++) {
+                if (comes_before(degree, u, adj_targets[a])) graph->targets[write++] = adj_targets[a];
+            }
+        }
+        graph->offsets[graph->local_n] = write;
+        graph->edges = write;
+    }
+    ok = ok && share_out_lists(graph, comm, adj_offsets, adj_targets, degree);
+
+    GRAPH_FREE(adj_offsets);
+    GRAPH_FREE(adj_targets);
+    if (!graph->remote_slot) GRAPH_FREE(degree);
+    if (!ok) dist_graph_free(graph);
+    return ok;
+}
+
+void dist_graph_free(DistGraph* graph) {
+    if (!graph) return;
+    GRAPH_FREE(graph->offsets);
+    GRAPH_FREE(graph->targets);
+    GRAPH_FREE(graph->remote_offsets);
+    GRAPH_FREE(graph->remote_targets);
+    GRAPH_FREE(graph->remote_slot);
+    memset(graph, 0, sizeof(*graph));
+}
+
+/* ---------- Counting ---------- */
+
+/* Out-list of any vertex this worker can see (empty if it has none) */
+static const int* out_list(const DistGraph* graph, int v, int* len) {
+    if (v % graph->size == graph->rank) {
+        int i = v / graph->size;
+        *len = (int)(graph->offsets[i + 1] - graph->offsets[i]);
+        return graph->targets + graph->offsets[i];
+    }
+    int slot = graph->remote_slot[v];
+    if (slot < 0) {
+        *len = 0;
+        return NULL;
+    }
+    *len = (int)(graph->remote_offsets[slot + 1] - graph->remote_offsets[slot]);
+    return graph->remote_targets + graph->remote_offsets[slot];
+}
+
+/* Sorted-list intersection into @p out */
+static int intersect(const int* a, int a_len, const int* b, int b_len, int* out) {
+    int i = 0, j = 0, count = 0;
+    while (i < a_len && j < b_len) {
+        if (a[i] < b[j]) i++;
+        else if (a[i] > b[j]) j++;
+        else {
+            out[count++] = a[i];
+            i++;
+            j++;
+        }
+    }
+    return count;
+}
+
+/**
+ * Cliques of @p need more vertices inside @p cand, every pair joined by an
+ * arc. scratch holds (need - 2) levels of room for @p len ints.
+ */
+static long long count_in(const DistGraph* graph, const int* cand, int len, int need,
+                          int* scratch) {
+    if (need == 1) return len;
+    long long count = 0;
+    for (int i = 0; i < len; i++) {
+        int out_len;
+        const int* out = out_list(graph, cand[i], &out_len);
+        if (need == 2) {
+            count += (long long)simd_intersect_count(cand, (size_t)len, out, (size_t)out_len);
+        } else {
+            int next = intersect(cand, len, out, out_len, scratch);
+            count += count_in(graph, scratch, next, need - 1, scratch + len);
+        }
+    }
+    return count;
+}
+
+int dist_count_cliques(const DistGraph* graph, DistComm* comm, int k, long long* count,
+                       long long* local_count) {
+    if (!graph || !comm || !count || k < 3) return 0;
+
+    int max_out = 1;
+    for (int i = 0; i < graph->local_n; i++) {
+        int len = (int)(graph->offsets[i + 1] - graph->offsets[i]);
+        if (len > max_out) max_out = len;
+    }
+    int* scratch = NULL;
+    if (k > 3) {
+        scratch = (int*)GRAPH_MALLOC((size_t)(k - 3) * (size_t)max_out * sizeof(int));
+        if (!scratch) return 0;
+    }
+
+    // Each clique is counted at its first vertex in (degree, id) order
+    long long total = 0;
+    for (int i = 0; i < graph->local_n; i++) {
+        int len = (int)(graph->offsets[i + 1] - graph->offsets[i]);
+        total += count_in(graph, graph->targets + graph->offsets[i], len, k - 1, scratch);
+    }
+    GRAPH_FREE(scratch);
+
+    if (local_count) *local_count = total;
+    if (!dist_comm_sum(comm, &total)) return 0;
+    *count = total;
+    return 1;
+}
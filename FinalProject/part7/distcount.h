@@ -0,0 +1,132 @@
+#ifndef DISTCOUNT_H
+#define DISTCOUNT_H
+
+#include <stddef.h>
+
+/**
+ * @file distcount.h
+ * Triangle and k-clique counting over a graph split between processes.
+ *
+ * Workers are connected in a full mesh of TCP sockets (DistComm). The graph
+ * is split by vertex (1D): worker r owns the vertices v with
+ * v % size == r and keeps only their edges.
+ *
+ * Each edge is directed from the endpoint of lower (degree, id) to the
+ * higher one, which gives every vertex O(sqrt(m)) out-neighbors. A clique
+ * is counted once, at its lowest vertex u, as a (k-1)-clique among the
+ * out-neighbors of u. That search reads the out-lists of u's out-neighbors,
+ * so before counting each worker receives the out-lists of the remote
+ * vertices it needs (the boundary adjacency). Owners push them in a single
+ * exchange; nothing is requested per vertex.
+ *
+ * Memory per worker: its share of the edges, the boundary out-lists it
+ * receives and one int per vertex of the whole graph.
+ */
+
+/**
+ * Connections from one worker to all the others. fds[rank] is -1.
+ */
+typedef struct {
+    int rank;
+    int size;
+    int* fds;
+    long long bytes_sent;       // Exchange payload totals, for reports
+    long long bytes_received;
+} DistComm;
+
+/**
+ * Growable byte buffer for one exchange message.
+ */
+typedef struct {
+    char* data;
+    size_t len;
+    size_t cap;
+} DistBuffer;
+
+/**
+ * This worker's part of the graph: the out-lists of its own vertices
+ * (local index v / size) and the out-lists received for remote vertices.
+ * Lists hold global ids in increasing order.
+ */
+typedef struct {
+    int n;                      // Vertices in the whole graph
+    int rank;
+    int size;
+    int local_n;                // Vertices owned here
+    long long* offsets;         // local_n + 1 entries
+    int* targets;
+    int num_remote;             // Remote vertices whose out-list arrived
+    long long* remote_offsets;  // num_remote + 1 entries
+    int* remote_targets;
+    int* remote_slot;           // Slot in the remote lists of each vertex, -1 if none
+    long long edges;            // Distinct edges owned here (lower endpoint local)
+} DistGraph;
+
+/**
+ * Connect worker @p rank to every other worker.
+ *
+ * Worker r listens on ports[r], connects to the workers below it and
+ * accepts the ones above; connects are retried until @p timeout_ms, so the
+ * workers can start in any order.
+ *
+ * @param hosts Host of every worker (NULL = all on 127.0.0.1)
+ * @return 1 on success, 0 on failure
+ */
+int dist_comm_connect(DistComm* comm, int rank, int size, const char* const* hosts,
+                      const int* ports, int timeout_ms);
+
+/**
+ * Send send[p] to every worker p and receive one message from each.
+ * send[rank] becomes recv[rank] without being copied. All sends and
+ * receives run at once, so large messages cannot deadlock.
+ *
+ * @param send IN: one buffer per worker, emptied on return
+ * @param recv OUT: one buffer per worker (free with dist_buffer_free)
+ * @return 1 on success, 0 on a connection error
+ */
+int dist_comm_exchange(DistComm* comm, DistBuffer* send, DistBuffer* recv);
+
+/**
+ * Replace @p value on every worker by the sum / maximum over all workers.
+ * @return 1 on success, 0 on a connection error
+ */
+int dist_comm_sum(DistComm* comm, long long* value);
+int dist_comm_max(DistComm* comm, long long* value);
+
+/**
+ * Close the connections.
+ */
+void dist_comm_close(DistComm* comm);
+
+/**
+ * Append @p bytes bytes to @p buf.
+ * @return 1 on success, 0 on allocation failure
+ */
+int dist_buffer_append(DistBuffer* buf, const void* data, size_t bytes);
+
+void dist_buffer_free(DistBuffer* buf);
+
+/**
+ * Build this worker's part of the graph from its slice of the edge list.
+ * Any split of the edges between the workers works; duplicates and
+ * self-loops are dropped. Collective: every worker must call it.
+ *
+ * @param edges num_edges (u, v) pairs
+ * @param n Vertex count, or 0 to take the largest id seen by any worker + 1
+ * @return 1 on success, 0 on invalid input, allocation or connection failure
+ */
+int dist_graph_build(DistGraph* graph, DistComm* comm, const int* edges, long long num_edges,
+                     int n);
+
+/**
+ * Count the cliques of size @p k (k >= 3) in the whole graph. Collective;
+ * every worker gets the total.
+ * @param local_count OUT: cliques counted by this worker, may be NULL
+ * @return 1 on success, 0 on invalid input, allocation or connection failure
+ */
+int dist_count_cliques(const DistGraph* graph, DistComm* comm, int k, long long* count,
+                       long long* local_count);
+
+void dist_graph_free(DistGraph* graph);
+
+#endif /* DISTCOUNT_H */
@@ -0,0 +1,286 @@
+/*
+** distrun.c -- distributed triangle / k-clique counting (see distcount.h)
+**
+** Local mode forks one process per worker on this machine, listening on
+** ports port .. port+workers-1; it stands in for a cluster when testing.
+** Worker mode runs a single worker of a multi-machine job: start it on
+** every host with its own -r and the same -H list.
+**
+** Every worker reads the whole edge source but keeps only every
+** workers-th edge, so no process ever holds the full graph (except for
+** the -c check, which counts on one process for comparison).
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "distcount.h"
+#include "graph.h"
+#include "cliquecount.h"
+#include "graph_alloc.h"
+
+#define MAX_WORKERS 256
+#define CONNECT_TIMEOUT_MS 30000
+
+/**
+ * Run configuration (filled from the command line).
+ */
+typedef struct {
+    int workers;
+    int rank;               // -1 = local mode (fork every worker)
+    int port;               // First port in local mode
+    const char* hosts[MAX_WORKERS];
+    int ports[MAX_WORKERS];
+    int k;                  // Clique size
+    int check;              // -c: compare with a single-process count
+    const char* file;       // Edge list file, or NULL for the generator
+    int gen_n;              // -g n,m,seed: random edges
+    long long gen_m;
+    unsigned int gen_seed;
+} RunConfig;
+
+/**
+ * Edges kept by one worker.
+ */
+typedef struct {
+    int* pairs;
+    long long count, capacity;
+} EdgeSlice;
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+static int slice_add(EdgeSlice* slice, int u, int v) {
+    if (slice->count == slice->capacity) {
+        long long capacity = slice->capacity ? slice->capacity * 2 : 1024;
+        int* grown = (int*)GRAPH_REALLOC(slice->pairs, (size_t)capacity * 2 * sizeof(int));
+        if (!grown) return 0;
+        slice->pairs = grown;
+        slice->capacity = capacity;
+    }
+    slice->pairs[2 * slice->count] = u;
+    slice->pairs[2 * slice->count + 1] = v;
+    slice->count++;
+    return 1;
+}
+
+/* xorshift64*: the same stream on every worker for the same seed */
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545f4914f6cdd1dULL;
+}
+
+/**
+ * Read the edges with index % stride == offset: stride = workers for a
+ * worker's slice, stride 1 for the whole graph.
+ * @return 1 on success, 0 on a read or allocation error
+ */
+static int read_edges(const RunConfig* cfg, int offset, int stride, EdgeSlice* slice) {
+    memset(slice, 0, sizeof(*slice));
+    if (!cfg->file) {
+        uint64_t state = 0x9e3779b97f4a7c15ULL ^ cfg->gen_seed;
+        for (long long e = 0; e < cfg->gen_m; e++) {
+            int u = (int)(next_random(&state) % (uint64_t)cfg->gen_n);
+            int v = (int)(next_random(&state) % (uint64_t)cfg->gen_n);
+            if (e % stride == offset && !slice_add(slice, u, v)) return 0;
+        }
+        return 1;
+    }
+
+    // One "u v" pair per line; anything after it (a weight) and '#' lines are ignored
+    FILE* f = fopen(cfg->file, "r");
+    if (!f) {
+        perror(cfg->file);
+        return 0;
+    }
+    char line[256];
+    long long e = 0;
+    int ok = 1;
+    while (ok && fgets(line, sizeof(line), f)) {
+        int u, v;
+        if (line[0] == '#' || sscanf(line, "%d %d", &u, &v) != 2) continue;
+        if (e++ % stride == offset) ok = slice_add(slice, u, v);
+    }
+    fclose(f);
+    return ok;
+}
+
+/* Single-process count over the whole graph, for -c */
+static int check_count(const RunConfig* cfg, int n, long long* count) {
+    EdgeSlice all = {NULL, 0, 0};
+    Graph* g = graph_create(n);
+    int ok = g && read_edges(cfg, 0, 1, &all);
+    for (long long e = 0; ok && e < all.count; e++) {
+        int u = all.pairs[2 * e], v = all.pairs[2 * e + 1];
+        if (u != v) graph_add_edge(g, u, v);
+    }
+    if (ok) {
+        ok = cfg->k == 3 ? graph_count_triangles(g, count)
+                         : graph_count_cliques_of_size(g, cfg->k, count);
+    }
+    GRAPH_FREE(all.pairs);
+    if (g) graph_destroy(g);
+    return ok;
+}
+
+/* One worker: connect, build the partition, count, report */
+static int run_worker(const RunConfig* cfg, int rank) {
+    double start = now_ms();
+    EdgeSlice slice;
+    if (!read_edges(cfg, rank, cfg->workers, &slice)) return 0;
+    double read_ms = now_ms() - start;
+
+    DistComm comm;
+    DistGraph graph;
+    long long count = 0, local = 0;
+    int n = cfg->file ? 0 : cfg->gen_n;
+    if (!dist_comm_connect(&comm, rank, cfg->workers, cfg->hosts[0] ? cfg->hosts : NULL,
+                           cfg->ports, CONNECT_TIMEOUT_MS)) {
+        GRAPH_FREE(slice.pairs);
+        return 0;
+    }
+
+    double build_start = now_ms();
+    int ok = dist_graph_build(&graph, &comm, slice.pairs, slice.count, n);
+    GRAPH_FREE(slice.pairs);
+    double build_ms = now_ms() - build_start;
+    double count_start = now_ms();
+    ok = ok && dist_count_cliques(&graph, &comm, cfg->k, &count, &local);
+    double count_ms = now_ms() - count_start;
+
+    if (ok) {
+        printf("[worker %d] %d vertices, %lld edges, %d boundary lists, %.1f KB sent, "
+               "%.1f KB received, %lld local; read %.1f ms, build %.1f ms, count %.1f ms\n",
+               rank, graph.local_n, graph.edges, graph.num_remote, comm.bytes_sent / 1024.0,
+               comm.bytes_received / 1024.0, local, read_ms, build_ms, count_ms);
+        if (rank == 0) {
+            printf("Graph: %d vertices over %d workers\n", graph.n, cfg->workers);
+            printf("%d-cliques: %lld\n", cfg->k, count);
+        }
+        fflush(stdout);
+    } else {
+        fprintf(stderr, "[worker %d] counting failed\n", rank);
+    }
+
+    if (ok && rank == 0 && cfg->check) {
+        long long expected = 0;
+        if (!check_count(cfg, graph.n, &expected)) {
+            fprintf(stderr, "Check: single-process count failed\n");
+            ok = 0;
+        } else {
+            printf("Check: single process counts %lld (%s)\n", expected,
+                   expected == count ? "match" : "MISMATCH");
+            ok = expected == count;
+        }
+    }
+    dist_graph_free(&graph);
+    dist_comm_close(&comm);
+    return ok;
+}
+
+/* Parse "host:port,host:port,..." into the worker list */
+static int parse_hosts(char* list, RunConfig* cfg) {
+    cfg->workers = 0;
+    for (char* item = strtok(list, ","); item; item = strtok(NULL, ",")) {
+        char* colon = strrchr(item, ':');
+        if (!colon || cfg->workers >= MAX_WORKERS) return 0;
+        *colon = '\0';
+        cfg->hosts[cfg->workers] = item;
+        cfg->ports[cfg->workers++] = atoi(colon + 1);
+    }
+    return cfg->workers > 0;
+}
+
+static void print_usage(const char* prog) {
+    fprintf(stderr,
+        "Usage: %s [-w workers] [-p port] [-k size] [-c] (-f edges.txt | -g n,m,seed)\n"
+        "       %s -r rank -H host:port,host:port,... [-k size] (-f ... | -g ...)\n"
+        "  -w  Local worker processes (default 4) on ports port.. (default 9500)\n"
+        "  -r  Run only worker <rank> of the workers listed with -H\n"
+        "  -k  Clique size (default 3, triangles)\n"
+        "  -c  Also count on one process and compare (small graphs)\n"
+        "  -f  Edge list: one \"u v\" per line, 0-based, '#' comments\n"
+        "  -g  Random multigraph: m edges over n vertices\n",
+        prog, prog);
+}
+
+int main(int argc, char* argv[]) {
+    RunConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.workers = 4;
+    cfg.rank = -1;
+    cfg.port = 9500;
+    cfg.k = 3;
+
+    int opt, have_hosts = 0;
+    while ((opt = getopt(argc, argv, "w:p:r:H:k:cf:g:h")) != -1) {
+        switch (opt) {
+            case 'w': cfg.workers = atoi(optarg); break;
+            case 'p': cfg.port = atoi(optarg); break;
+            case 'r': cfg.rank = atoi(optarg); break;
+            case 'H':
+                if (!parse_hosts(optarg, &cfg)) { print_usage(argv[0]); return 1; }
+                have_hosts = 1;
+                break;
+            case 'k': cfg.k = atoi(optarg); break;
+            case 'c': cfg.check = 1; break;
+            case 'f': cfg.file = optarg; break;
+            case 'g':
+                if (sscanf(optarg, "%d,%lld,%u", &cfg.gen_n, &cfg.gen_m, &cfg.gen_seed) < 2 ||
+                    cfg.gen_n < 1 || cfg.gen_m < 0) {
+                    print_usage(argv[0]);
+                    return 1;
+                }
+                break;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+    if ((!cfg.file && cfg.gen_n < 1) || cfg.k < 3 || cfg.workers < 1 ||
+        cfg.workers > MAX_WORKERS || (cfg.rank >= 0) != have_hosts ||
+        cfg.rank >= cfg.workers) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    if (cfg.rank >= 0) return run_worker(&cfg, cfg.rank) ? 0 : 1;
+
+    // Local mode: one process per worker
+    for (int r = 0; r < cfg.workers; r++) cfg.ports[r] = cfg.port + r;
+    double start = now_ms();
+    pid_t pids[MAX_WORKERS];
+    for (int r = 0; r < cfg.workers; r++) {
+        pids[r] = fork();
+        if (pids[r] == 0) {
+            int ok = run_worker(&cfg, r);
+            fflush(stdout);
+            _exit(ok ? 0 : 1);
+        }
+        if (pids[r] < 0) {
+            perror("fork");
+            return 1;
+        }
+    }
+
+    int failed = 0;
+    for (int r = 0; r < cfg.workers; r++) {
+        int status;
+        if (waitpid(pids[r], &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            failed++;
+        }
+    }
+    printf("Total time: %.1f ms%s\n", now_ms() - start, failed ? " (workers failed)" : "");
+    return failed ? 1 : 0;
+}
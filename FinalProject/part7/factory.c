@@ -21,6 +21,10 @@ AlgorithmType algorithm_factory_get_type(int algorithm_id) {
         case 3: return ALGO_MST;
         case 4: return ALGO_MAX_CLIQUE;
         case 5: return ALGO_CLIQUE_COUNT;
+        case 6: return ALGO_SSSP;
+        case 7: return ALGO_HOPS;
+        case 8: return ALGO_WEIGHT_CLIQUE;
+        case 9: return ALGO_COLORING;
         default: return -1; // Invalid
     }
 }
@@ -52,6 +56,22 @@ AlgorithmStrategy* algorithm_factory_create_strategy(AlgorithmType algo_type) {
             printf("Factory: Creating Clique Count Strategy\n");
             return algorithm_get_strategy(5);
             
+        case ALGO_SSSP:
+            printf("Factory: Creating Shortest Paths Strategy\n");
+            return algorithm_get_strategy(6);
+            
+        case ALGO_HOPS:
+            printf("Factory: Creating Hop Distance Strategy\n");
+            return algorithm_get_strategy(7);
+            
+        case ALGO_WEIGHT_CLIQUE:
+            printf("Factory: Creating Max Weight Clique Strategy\n");
+            return algorithm_get_strategy(8);
+            
+        case ALGO_COLORING:
+            printf("Factory: Creating Graph Coloring Strategy\n");
+            return algorithm_get_strategy(9);
+            
         default:
             printf("Factory: Error - Unknown algorithm type %d\n", algo_type);
             return NULL;
@@ -62,18 +82,38 @@ AlgorithmStrategy* algorithm_factory_create_strategy(AlgorithmType algo_type) {
  * Check if algorithm type is supported by factory.
  */
 int algorithm_factory_is_supported(AlgorithmType algo_type) {
-    return (algo_type >= ALGO_EULER && algo_type <= ALGO_CLIQUE_COUNT);
+    return (algo_type >= ALGO_EULER && algo_type <= ALGO_COLORING);
 }
 
 /**
  * Factory method to execute algorithm using both patterns together.
  */
 char* algorithm_factory_execute(const Graph* g, int algorithm_id) {
+    return algorithm_factory_execute_ws(g, algorithm_id, NULL);
+}
+
+/**
+ * Factory execution with a caller-owned workspace.
+ */
+char* algorithm_factory_execute_ws(const Graph* g, int algorithm_id, AlgorithmWorkspace* ws) {
+    return algorithm_factory_execute_params(g, algorithm_id, NULL, ws);
+}
+
+/**
+ * Factory execution with request parameters and a caller-owned workspace.
+ */
+char* algorithm_factory_execute_params(const Graph* g, int algorithm_id,
+                                       const AlgorithmParams* params, AlgorithmWorkspace* ws) {
     printf("Factory: Received request for algorithm ID %d\n", algorithm_id);
     
     // Step 1: Factory converts ID to type
     AlgorithmType algo_type = algorithm_factory_get_type(algorithm_id);
+    AlgorithmStrategy* strategy = NULL;
     if (algo_type == -1) {
+        // IDs beyond the built-in ones may belong to a loaded plugin
+        strategy = algorithm_get_strategy(algorithm_id);
+    }
+    if (algo_type == -1 && !strategy) {
         printf("Factory: Error - Invalid algorithm ID %d\n", algorithm_id);
         char* error_result = (char*)malloc(64);
         if (error_result) {
@@ -82,10 +122,14 @@ char* algorithm_factory_execute(const Graph* g, int algorithm_id) {
         return error_result;
     }
     
-    printf("Factory: Converted ID %d to type %d\n", algorithm_id, algo_type);
+    if (strategy) {
+        printf("Factory: ID %d is provided by a plugin\n", algorithm_id);
+    } else {
+        printf("Factory: Converted ID %d to type %d\n", algorithm_id, algo_type);
+    }
     
     // Step 2: Factory checks if algorithm is supported
-    if (!algorithm_factory_is_supported(algo_type)) {
+    if (!strategy && !algorithm_factory_is_supported(algo_type)) {
         printf("Factory: Error - Algorithm type %d not supported\n", algo_type);
         char* error_result = (char*)malloc(64);
         if (error_result) {
@@ -95,7 +139,9 @@ char* algorithm_factory_execute(const Graph* g, int algorithm_id) {
     }
     
     // Step 3: Factory creates Strategy object
-    AlgorithmStrategy* strategy = algorithm_factory_create_strategy(algo_type);
+    if (!strategy) {
+        strategy = algorithm_factory_create_strategy(algo_type);
+    }
     if (!strategy) {
         printf("Factory: Error - Failed to create strategy\n");
         char* error_result = (char*)malloc(64);
@@ -115,6 +161,8 @@ char* algorithm_factory_execute(const Graph* g, int algorithm_id) {
     AlgorithmContext context;
     algorithm_context_init(&context, g);
     algorithm_context_set_strategy(&context, strategy);
+    algorithm_context_set_workspace(&context, ws);
+    algorithm_context_set_params(&context, params);
     char* result = algorithm_context_execute(&context);
     
     if (result) {
@@ -140,6 +188,10 @@ void algorithm_factory_print_available(void) {
     printf("3   MST          Min Spanning Tree (Weighted)\n");
     printf("4   MAX_CLIQUE   Maximum Clique\n");
     printf("5   CLIQUE_COUNT Count All Cliques\n");
+    printf("6   SSSP         Shortest Paths (Weighted)\n");
+    printf("7   HOPS         Hop Distances (BFS)\n");
+    printf("8   WEIGHT_CLIQUE Maximum Weight Clique (Weighted)\n");
+    printf("9   COLORING     Greedy Vertex Coloring\n");
 }
 
 // Legacy functions for backward compatibility
@@ -147,6 +199,15 @@ char* algorithm_execute(const Graph* g, AlgorithmType algo_type) {
     return algorithm_factory_execute(g, (int)algo_type);
 }
 
+// param1/param2 are source/sink for max flow and the clique size for clique counting
 char* algorithm_execute_with_params(const Graph* g, AlgorithmType algo_type, int param1, int param2) {
-    return algorithm_factory_execute(g, (int)algo_type);
+    AlgorithmParams params;
+    algorithm_params_init(&params);
+    if (algo_type == ALGO_MAX_FLOW) {
+        params.source = param1;
+        params.sink = param2;
+    } else if (algo_type == ALGO_CLIQUE_COUNT) {
+        params.clique_size = param1 > 0 ? param1 : 0;
+    }
+    return algorithm_factory_execute_params(g, (int)algo_type, &params, NULL);
 }
@@ -9,7 +9,11 @@ typedef enum {
     ALGO_MAX_FLOW,
     ALGO_MST,
     ALGO_MAX_CLIQUE,
-    ALGO_CLIQUE_COUNT
+    ALGO_CLIQUE_COUNT,
+    ALGO_SSSP,
+    ALGO_HOPS,
+    ALGO_WEIGHT_CLIQUE,
+    ALGO_COLORING
 } AlgorithmType;
 
 /**
@@ -25,7 +29,7 @@ AlgorithmStrategy* algorithm_factory_create_strategy(AlgorithmType algo_type);
 
 /**
  * Get algorithm type from algorithm ID.
- * @param algorithm_id Algorithm ID (1-5)
+ * @param algorithm_id Algorithm ID (1-9)
  * @return Algorithm type enum
  */
 AlgorithmType algorithm_factory_get_type(int algorithm_id);
@@ -38,6 +42,26 @@ AlgorithmType algorithm_factory_get_type(int algorithm_id);
  */
 char* algorithm_factory_execute(const Graph* g, int algorithm_id);
 
+/**
+ * Same as algorithm_factory_execute(), with scratch memory from @p ws.
+ * @param g Graph pointer
+ * @param algorithm_id Algorithm ID
+ * @param ws Caller's workspace (one per thread), or NULL
+ * @return Result string (caller must free), or NULL on failure
+ */
+char* algorithm_factory_execute_ws(const Graph* g, int algorithm_id, AlgorithmWorkspace* ws);
+
+/**
+ * Same as algorithm_factory_execute_ws(), with per-request parameters.
+ * @param g Graph pointer
+ * @param algorithm_id Algorithm ID
+ * @param params Parameters (source/sink, clique size, limits), or NULL for defaults
+ * @param ws Caller's workspace (one per thread), or NULL
+ * @return Result string (caller must free), or NULL on failure
+ */
+char* algorithm_factory_execute_params(const Graph* g, int algorithm_id,
+                                       const AlgorithmParams* params, AlgorithmWorkspace* ws);
+
 /**
  * Print available algorithms that the factory can create.
  */
@@ -1,4 +1,9 @@
 #include "graph.h"
+#include "graph_alloc.h"
+#include "bitgraph.h"
+#include "compressed_graph.h"
+#include "components.h"
+#include <limits.h>
 #include <stdio.h>
 #include <unistd.h> 
 #include <stdlib.h>
@@ -34,12 +39,12 @@ static int edge_exists_simple(const Graph* g, int u, int v){
 Graph* graph_create(int n) {
     if (n <= 0) return NULL;
 
-    Graph* g = (Graph*)malloc(sizeof(Graph));
+    Graph* g = (Graph*)GRAPH_MALLOC(sizeof(Graph));
     if (!g) return NULL;
 
     g->n = n;
-    g->adj = (Vertex*)calloc((size_t)n, sizeof(Vertex));
-    if (!g->adj) { free(g); return NULL; }
+    g->adj = (Vertex*)GRAPH_CALLOC((size_t)n, sizeof(Vertex));
+    if (!g->adj) { GRAPH_FREE(g); return NULL; }
 
     return g;
 }
@@ -54,11 +59,11 @@ void graph_destroy(Graph* g) {
         while (cur) {
             EdgeNode* tmp = cur;
             cur = cur->next;
-            free(tmp);
+            GRAPH_FREE(tmp);
         }
     }
-    free(g->adj);
-    free(g);
+    GRAPH_FREE(g->adj);
+    GRAPH_FREE(g);
 }
 
 /**
@@ -79,9 +84,9 @@ int graph_add_weighted_edge(Graph* g, int u, int v, int weight) {
 
     if (u == v) {
         // Self-loop: add two entries with same weight
-        EdgeNode* e1 = (EdgeNode*)malloc(sizeof(EdgeNode));
-        EdgeNode* e2 = (EdgeNode*)malloc(sizeof(EdgeNode));
-        if (!e1 || !e2) { free(e1); free(e2); return -2; }
+        EdgeNode* e1 = (EdgeNode*)GRAPH_MALLOC(sizeof(EdgeNode));
+        EdgeNode* e2 = (EdgeNode*)GRAPH_MALLOC(sizeof(EdgeNode));
+        if (!e1 || !e2) { GRAPH_FREE(e1); GRAPH_FREE(e2); return -2; }
         
         e1->to = u;
         e1->weight = weight;
@@ -95,9 +100,9 @@ int graph_add_weighted_edge(Graph* g, int u, int v, int weight) {
         return 0;
     } else {
         // Regular edge: add two directed edges
-        EdgeNode* e1 = (EdgeNode*)malloc(sizeof(EdgeNode));
-        EdgeNode* e2 = (EdgeNode*)malloc(sizeof(EdgeNode));
-        if (!e1 || !e2) { free(e1); free(e2); return -2; }
+        EdgeNode* e1 = (EdgeNode*)GRAPH_MALLOC(sizeof(EdgeNode));
+        EdgeNode* e2 = (EdgeNode*)GRAPH_MALLOC(sizeof(EdgeNode));
+        if (!e1 || !e2) { GRAPH_FREE(e1); GRAPH_FREE(e2); return -2; }
 
         e1->to = v;
         e1->weight = weight;
@@ -171,11 +176,11 @@ void graph_print(const Graph* g) {
  * Vec - tiny dynamic array implementation
  */
 typedef struct { int *a; int n, cap; } Vec;
-static int  v_reserve(Vec* v, int cap){ if (cap<=v->cap) return 0; int c=v->cap? v->cap*2:16; if(c<cap) c=cap; int*na=(int*)realloc(v->a, sizeof(int)*c); if(!na) return -1; v->a=na; v->cap=c; return 0; }
+static int  v_reserve(Vec* v, int cap){ if (cap<=v->cap) return 0; int c=v->cap? v->cap*2:16; if(c<cap) c=cap; int*na=(int*)GRAPH_REALLOC(v->a, sizeof(int)*c); if(!na) return -1; v->a=na; v->cap=c; return 0; }
 static int  v_push(Vec* v, int x){ if(v_reserve(v,v->n+1)) return -1; v->a[v->n++]=x; return 0; }
 static int  v_pop (Vec* v){ return v->a[--v->n]; }
 static int  v_back(const Vec* v){ return v->a[v->n-1]; }
-static void v_free(Vec* v){ free(v->a); v->a=NULL; v->n=v->cap=0; }
+static void v_free(Vec* v){ GRAPH_FREE(v->a); v->a=NULL; v->n=v->cap=0; }
 static void v_reverse(Vec* v){ for(int i=0,j=v->n-1;i<j;i++,j--){ int t=v->a[i]; v->a[i]=v->a[j]; v->a[j]=t; } }
 
 /**
@@ -190,8 +195,8 @@ typedef struct {
 static void ev_free(EdgeView* ev){
     if(!ev) return;
     for(int i=0;i<ev->n;i++) v_free(&ev->incid[i]);
-    free(ev->incid);
-    free(ev->edges);
+    GRAPH_FREE(ev->incid);
+    GRAPH_FREE(ev->edges);
 }
 
 static int degree_vertex_adj(const Graph* g, int v){
@@ -200,46 +205,39 @@ static int degree_vertex_adj(const Graph* g, int v){
 }
 
 static int is_connected_ignore_isolated(const Graph* g){
-    int start = -1;
-    for(int i=0;i<g->n;i++)
-        if (degree_vertex_adj(g,i)>0) { start=i; break; }
-    if (start==-1) return 1;
-
-    char* vis = (char*)calloc((size_t)g->n, 1);
-    if(!vis) return 0;
-    Vec st={0};
-    (void)v_push(&st, start); vis[start]=1;
-
-    while(st.n){
-        int u = v_pop(&st);
-        for(EdgeNode* e=g->adj[u].head; e; e=e->next){
-            int v = e->to;
-            if(!vis[v]){ vis[v]=1; (void)v_push(&st, v); }
-        }
+    int* roots = (int*)GRAPH_MALLOC(sizeof(int) * (size_t)g->n);
+    if (!roots || !graph_component_roots(g, 1, roots)) { GRAPH_FREE(roots); return 0; }
+
+    // Every vertex with an edge must share the first such vertex's root
+    int root = -1, ok = 1;
+    for(int i=0;i<g->n && ok;i++){
+        if (!g->adj[i].head) continue;
+        if (root < 0) root = roots[i];
+        else if (roots[i] != root) ok = 0;
     }
-    int ok=1;
-    for(int i=0;i<g->n;i++)
-        if (degree_vertex_adj(g,i)>0 && !vis[i]) { ok=0; break; }
-
-    v_free(&st); free(vis);
+    GRAPH_FREE(roots);
     return ok;
 }
 
-static int build_edge_view(const Graph* g, EdgeView* ev){
-    ev->n = g->n;
-    ev->edges = NULL; ev->m = 0;
-    ev->incid = (Vec*)calloc((size_t)ev->n, sizeof(Vec));
-    if(!ev->incid) return -1;
+/* build_edge_view() result when the edge ids would not fit in an int */
+#define EDGE_VIEW_TOO_LARGE (-2)
 
+static int build_edge_view(const Graph* g, EdgeView* ev){
     long long sumdeg = 0;
     for(int u=0; u<g->n; ++u)
         for(EdgeNode* e=g->adj[u].head; e; e=e->next) sumdeg++;
+    if (sumdeg/2 + 1 > INT_MAX) return EDGE_VIEW_TOO_LARGE;
     int m_est = (int)(sumdeg/2 + 1);
 
-    ev->edges = (UEEdge*)malloc(sizeof(UEEdge) * (size_t)m_est);
+    ev->n = g->n;
+    ev->edges = NULL; ev->m = 0;
+    ev->incid = (Vec*)GRAPH_CALLOC((size_t)ev->n, sizeof(Vec));
+    if(!ev->incid) return -1;
+
+    ev->edges = (UEEdge*)GRAPH_MALLOC(sizeof(UEEdge) * (size_t)m_est);
     if(!ev->edges){ ev_free(ev); return -1; }
 
-    int* loop_half = (int*)calloc((size_t)ev->n, sizeof(int));
+    int* loop_half = (int*)GRAPH_CALLOC((size_t)ev->n, sizeof(int));
     if(!loop_half){ ev_free(ev); return -1; }
 
     for(int u=0; u<g->n; ++u){
@@ -250,9 +248,9 @@ static int build_edge_view(const Graph* g, EdgeView* ev){
                 if ((++loop_half[u] & 1) == 0) {
                     if(ev->m == m_est){
                         m_est = m_est ? m_est*2 : 16;
-                        UEEdge* ne = (UEEdge*)realloc(ev->edges, sizeof(UEEdge)*(size_t)m_est);
+                        UEEdge* ne = (UEEdge*)GRAPH_REALLOC(ev->edges, sizeof(UEEdge)*(size_t)m_est);
                         if(!ne){ 
-                            free(loop_half);
+                            GRAPH_FREE(loop_half);
                              ev_free(ev); 
                              return -1; 
                         }
@@ -260,32 +258,35 @@ static int build_edge_view(const Graph* g, EdgeView* ev){
                     }
                     ev->edges[ev->m] = (UEEdge){u,u};
                     if (v_push(&ev->incid[u], ev->m) || v_push(&ev->incid[u], ev->m)) {
-                        free(loop_half); ev_free(ev); return -1;
+                        GRAPH_FREE(loop_half); ev_free(ev); return -1;
                     }
                     ev->m++;
                 }
             } else if (u < v) {
                 if(ev->m == m_est){
                     m_est = m_est ? m_est*2 : 16;
-                    UEEdge* ne = (UEEdge*)realloc(ev->edges, sizeof(UEEdge)*(size_t)m_est);
-                    if(!ne){ free(loop_half); ev_free(ev); return -1; }
+                    UEEdge* ne = (UEEdge*)GRAPH_REALLOC(ev->edges, sizeof(UEEdge)*(size_t)m_est);
+                    if(!ne){ GRAPH_FREE(loop_half); ev_free(ev); return -1; }
                     ev->edges = ne;
                 }
                 ev->edges[ev->m] = (UEEdge){u,v};
                 if (v_push(&ev->incid[u], ev->m) || v_push(&ev->incid[v], ev->m)) {
-                    free(loop_half); ev_free(ev); return -1;
+                    GRAPH_FREE(loop_half); ev_free(ev); return -1;
                 }
                 ev->m++;
             }
         }
     }
-    free(loop_half);
+    GRAPH_FREE(loop_half);
     return 0;
 }
 
 int graph_has_euler_circuit(const Graph* g){
     if (!g) return 0;
 
+    int has_circuit;
+    if (bitgraph_has_euler_circuit(g, &has_circuit)) return has_circuit;
+
     if (!is_connected_ignore_isolated(g)) return 0;
 
     long long sumdeg = 0;
@@ -299,13 +300,28 @@ int graph_has_euler_circuit(const Graph* g){
     return 1;
 }
 
-int graph_find_euler_circuit(const Graph* g, int** out_cycle, int* out_len){
+/**
+ * Euler circuit of a graph with 2^31 or more edges: the compressed walk
+ * keeps 64-bit entry indices and needs about 5 bytes per edge end.
+ */
+static int find_euler_circuit_compressed(const Graph* g, int** out_cycle, long long* out_len){
+    CompressedGraph cg;
+    if (!compressed_graph_from_graph(&cg, g)) return 0;
+    int ok = compressed_graph_find_euler_circuit(&cg, out_cycle, out_len);
+    compressed_graph_free(&cg);
+    return ok;
+}
+
+int graph_find_euler_circuit(const Graph* g, int** out_cycle, long long* out_len){
     if (!g || !out_cycle || !out_len) return 0;
     *out_cycle = NULL; *out_len = 0;
 
     if (!graph_has_euler_circuit(g)) return 0;
 
-    EdgeView ev; if (build_edge_view(g, &ev)) return 0;
+    EdgeView ev;
+    int rc = build_edge_view(g, &ev);
+    if (rc == EDGE_VIEW_TOO_LARGE) return find_euler_circuit_compressed(g, out_cycle, out_len);
+    if (rc) return 0;
 
     int start = -1;
     for (int i = 0; i < ev.n; ++i){
@@ -313,9 +329,9 @@ int graph_find_euler_circuit(const Graph* g, int** out_cycle, int* out_len){
     }
     if (start == -1) { ev_free(&ev); return 0; }
 
-    int* used = (int*)calloc((size_t)ev.m, sizeof(int));
-    int* it   = (int*)calloc((size_t)ev.n, sizeof(int));
-    if(!used || !it){ free(used); free(it); ev_free(&ev); return 0; }
+    int* used = (int*)GRAPH_CALLOC((size_t)ev.m, sizeof(int));
+    int* it   = (int*)GRAPH_CALLOC((size_t)ev.n, sizeof(int));
+    if(!used || !it){ GRAPH_FREE(used); GRAPH_FREE(it); ev_free(&ev); return 0; }
 
     Vec stack={0}, path={0};
     (void)v_push(&stack, start);
@@ -341,7 +357,7 @@ int graph_find_euler_circuit(const Graph* g, int** out_cycle, int* out_len){
 
     v_reverse(&path);
 
-    free(used); free(it);
+    GRAPH_FREE(used); GRAPH_FREE(it);
     ev_free(&ev);
     v_free(&stack);
 
@@ -82,10 +82,10 @@ int graph_has_euler_circuit(const Graph* g);
 /**
  * Find an Euler circuit using Hierholzer's algorithm.
  * @param g Graph pointer.
- * @param out_cycle On success, allocated array of vertex indices (caller frees).
- * @param out_len   On success, length of @p out_cycle (should be m+1).
+ * @param out_cycle On success, allocated array of vertex indices (caller frees with GRAPH_FREE).
+ * @param out_len   On success, length of @p out_cycle (should be m+1, 64-bit as m can pass 2^31).
  * @return 1 on success, 0 if no Euler circuit or on failure.
  */
-int graph_find_euler_circuit(const Graph* g, int** out_cycle, int* out_len);
+int graph_find_euler_circuit(const Graph* g, int** out_cycle, long long* out_len);
 
 #endif /* GRAPH_H */
\ No newline at end of file
@@ -0,0 +1,261 @@
+#include "graph_alloc.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#define MAX_SITES 128
+
+/**
+ * Default allocator: plain libc.
+ */
+static void* libc_malloc(size_t size, void* ctx) { (void)ctx; return malloc(size); }
+static void* libc_calloc(size_t nmemb, size_t size, void* ctx) { (void)ctx; return calloc(nmemb, size); }
+static void* libc_realloc(void* ptr, size_t size, void* ctx) { (void)ctx; return realloc(ptr, size); }
+static void  libc_free(void* ptr, void* ctx) { (void)ctx; free(ptr); }
+
+static const GraphAllocator libc_allocator = {
+    libc_malloc, libc_calloc, libc_realloc, libc_free, NULL
+};
+
+static GraphAllocator current_allocator = {
+    libc_malloc, libc_calloc, libc_realloc, libc_free, NULL
+};
+
+static int profiling = 0;        // Profile new allocations
+static int profiling_used = 0;   // Set once profiling was ever enabled
+
+/**
+ * Per-thread statistics and call-site totals.
+ */
+typedef struct {
+    GraphAllocStats stats;
+    GraphAllocSite sites[MAX_SITES];
+    int num_sites;
+} ThreadAllocState;
+
+static __thread ThreadAllocState tls_state;
+
+/* ---------- Live block table ---------- */
+
+/**
+ * Open-addressing table (linear probing, backward-shift deletion) mapping
+ * each profiled block to its size, so frees can update live bytes. Uses libc
+ * directly and is shared by all threads.
+ */
+typedef struct { void* ptr; size_t size; } LiveBlock;
+
+static LiveBlock* live_table = NULL;
+static size_t live_capacity = 0, live_count = 0;
+static pthread_mutex_t live_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static size_t hash_ptr(const void* p) {
+    uint64_t x = (uint64_t)(uintptr_t)p;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return (size_t)x;
+}
+
+static int live_grow(void) {
+    size_t cap = live_capacity ? live_capacity * 2 : 1024;
+    LiveBlock* table = (LiveBlock*)calloc(cap, sizeof(LiveBlock));
+    if (!table) return 0;
+
+    for (size_t i = 0; i < live_capacity; i++) {
+        if (!live_table[i].ptr) continue;
+        size_t j = hash_ptr(live_table[i].ptr) & (cap - 1);
+        while (table[j].ptr) j = (j + 1) & (cap - 1);
+        table[j] = live_table[i];
+    }
+    free(live_table);
+    live_table = table;
+    live_capacity = cap;
+    return 1;
+}
+
+/* Caller holds live_mutex */
+static void live_insert(void* ptr, size_t size) {
+    if ((live_count + 1) * 2 > live_capacity && !live_grow()) return;
+
+    size_t i = hash_ptr(ptr) & (live_capacity - 1);
+    while (live_table[i].ptr && live_table[i].ptr != ptr) i = (i + 1) & (live_capacity - 1);
+    if (!live_table[i].ptr) live_count++;
+    live_table[i].ptr = ptr;
+    live_table[i].size = size;
+}
+
+/* Caller holds live_mutex. @return 1 and the block size if ptr was tracked. */
+static int live_remove(void* ptr, size_t* size) {
+    if (!live_capacity) return 0;
+
+    size_t mask = live_capacity - 1;
+    size_t i = hash_ptr(ptr) & mask;
+    while (live_table[i].ptr && live_table[i].ptr != ptr) i = (i + 1) & mask;
+    if (!live_table[i].ptr) return 0;
+
+    *size = live_table[i].size;
+    live_count--;
+
+    // Backward-shift the following cluster so lookups never see a hole
+    size_t hole = i;
+    for (size_t j = (i + 1) & mask; live_table[j].ptr; j = (j + 1) & mask) {
+        size_t home = hash_ptr(live_table[j].ptr) & mask;
+        if (((j - home) & mask) >= ((j - hole) & mask)) {
+            live_table[hole] = live_table[j];
+            hole = j;
+        }
+    }
+    live_table[hole].ptr = NULL;
+    live_table[hole].size = 0;
+    return 1;
+}
+
+/* ---------- Accounting ---------- */
+
+static void record_site(const char* site, size_t size) {
+    ThreadAllocState* st = &tls_state;
+    for (int i = 0; i < st->num_sites; i++) {
+        if (st->sites[i].site == site) {
+            st->sites[i].allocations++;
+            st->sites[i].bytes += size;
+            return;
+        }
+    }
+    if (st->num_sites < MAX_SITES) {
+        GraphAllocSite* s = &st->sites[st->num_sites++];
+        s->site = site;
+        s->allocations = 1;
+        s->bytes = size;
+    }
+}
+
+static void add_live(long long delta) {
+    GraphAllocStats* s = &tls_state.stats;
+    s->live_bytes += delta;
+    if (s->live_bytes > s->peak_live_bytes) s->peak_live_bytes = s->live_bytes;
+}
+
+static void record_alloc(void* ptr, size_t size, const char* site) {
+    pthread_mutex_lock(&live_mutex);
+    live_insert(ptr, size);
+    pthread_mutex_unlock(&live_mutex);
+
+    tls_state.stats.allocations++;
+    tls_state.stats.bytes += size;
+    add_live((long long)size);
+    record_site(site, size);
+}
+
+/* ---------- Allocation entry points ---------- */
+
+void* graph_alloc_malloc(size_t size, const char* site) {
+    void* p = current_allocator.malloc_fn(size, current_allocator.ctx);
+    if (p && profiling) record_alloc(p, size, site);
+    return p;
+}
+
+void* graph_alloc_calloc(size_t nmemb, size_t size, const char* site) {
+    void* p = current_allocator.calloc_fn(nmemb, size, current_allocator.ctx);
+    if (p && profiling) record_alloc(p, nmemb * size, site);
+    return p;
+}
+
+void* graph_alloc_realloc(void* ptr, size_t size, const char* site) {
+    if (!ptr) return graph_alloc_malloc(size, site);
+    if (!profiling_used) return current_allocator.realloc_fn(ptr, size, current_allocator.ctx);
+
+    size_t old_size = 0;
+    pthread_mutex_lock(&live_mutex);
+    int tracked = live_remove(ptr, &old_size);
+    pthread_mutex_unlock(&live_mutex);
+
+    void* p = current_allocator.realloc_fn(ptr, size, current_allocator.ctx);
+
+    pthread_mutex_lock(&live_mutex);
+    if (!p) {
+        if (tracked) live_insert(ptr, old_size); // original block is still valid
+    } else if (tracked || profiling) {
+        live_insert(p, size);
+    }
+    pthread_mutex_unlock(&live_mutex);
+
+    if (p && profiling) {
+        tls_state.stats.reallocs++;
+        tls_state.stats.bytes += size;
+        add_live((long long)size - (long long)old_size);
+        record_site(site, size);
+    }
+    return p;
+}
+
+void graph_alloc_free(void* ptr) {
+    if (!ptr) return;
+    if (profiling_used) {
+        size_t size = 0;
+        pthread_mutex_lock(&live_mutex);
+        int tracked = live_remove(ptr, &size);
+        pthread_mutex_unlock(&live_mutex);
+        if (tracked) {
+            tls_state.stats.frees++;
+            add_live(-(long long)size);
+        }
+    }
+    current_allocator.free_fn(ptr, current_allocator.ctx);
+}
+
+/* ---------- Configuration and queries ---------- */
+
+void graph_alloc_set_allocator(const GraphAllocator* allocator) {
+    current_allocator = allocator ? *allocator : libc_allocator;
+}
+
+void graph_alloc_set_profiling(int enabled) {
+    if (enabled) profiling_used = 1;
+    profiling = enabled ? 1 : 0;
+}
+
+int graph_alloc_profiling_enabled(void) {
+    return profiling;
+}
+
+void graph_alloc_stats_reset(void) {
+    memset(&tls_state, 0, sizeof(tls_state));
+}
+
+void graph_alloc_stats_get(GraphAllocStats* out) {
+    if (out) *out = tls_state.stats;
+}
+
+static int cmp_site_bytes(const void* a, const void* b) {
+    unsigned long long x = ((const GraphAllocSite*)a)->bytes;
+    unsigned long long y = ((const GraphAllocSite*)b)->bytes;
+    return (x < y) - (x > y);
+}
+
+int graph_alloc_sites_get(GraphAllocSite* out, int max) {
+    if (!out || max <= 0) return 0;
+    GraphAllocSite sorted[MAX_SITES];
+    int count = tls_state.num_sites;
+    memcpy(sorted, tls_state.sites, sizeof(GraphAllocSite) * (size_t)count);
+    qsort(sorted, (size_t)count, sizeof(GraphAllocSite), cmp_site_bytes);
+
+    if (count > max) count = max;
+    memcpy(out, sorted, sizeof(GraphAllocSite) * (size_t)count);
+    return count;
+}
+
+void graph_alloc_print_report(FILE* out, int top) {
+    if (!out) return;
+    GraphAllocStats s = tls_state.stats;
+    fprintf(out, "Allocations: %llu (+%llu reallocs), frees: %llu, bytes: %llu, "
+                 "live: %lld, peak: %lld\n",
+            s.allocations, s.reallocs, s.frees, s.bytes, s.live_bytes, s.peak_live_bytes);
+
+    GraphAllocSite sites[MAX_SITES];
+    int count = graph_alloc_sites_get(sites, top < MAX_SITES ? top : MAX_SITES);
+    for (int i = 0; i < count; i++) {
+        fprintf(out, "  %-28s %8llu allocs %12llu bytes\n",
+                sites[i].site, sites[i].allocations, sites[i].bytes);
+    }
+}
@@ -0,0 +1,112 @@
+#ifndef GRAPH_ALLOC_H
+#define GRAPH_ALLOC_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * @file graph_alloc.h
+ * Pluggable allocator hooks used by the graph and algorithm code.
+ *
+ * All graph/algorithm allocations go through GRAPH_MALLOC, GRAPH_CALLOC,
+ * GRAPH_REALLOC and GRAPH_FREE. By default they forward to libc. A custom
+ * allocator (arena, pool, ...) can be installed with graph_alloc_set_allocator(),
+ * and allocation profiling can be switched on to count allocations, bytes,
+ * live/peak bytes and per-call-site totals.
+ *
+ * Statistics are kept per thread, so a request served entirely by one thread
+ * can be measured with graph_alloc_stats_reset() before and
+ * graph_alloc_stats_get() after it.
+ */
+
+/**
+ * Allocator interface. Every function receives the @p ctx pointer given at
+ * registration time. Install it before any worker threads start.
+ */
+typedef struct {
+    void* (*malloc_fn)(size_t size, void* ctx);
+    void* (*calloc_fn)(size_t nmemb, size_t size, void* ctx);
+    void* (*realloc_fn)(void* ptr, size_t size, void* ctx);
+    void  (*free_fn)(void* ptr, void* ctx);
+    void* ctx;
+} GraphAllocator;
+
+/**
+ * Allocation statistics of the calling thread since the last reset.
+ */
+typedef struct {
+    unsigned long long allocations;  // malloc/calloc calls plus reallocs of NULL
+    unsigned long long reallocs;     // realloc calls on existing blocks
+    unsigned long long frees;        // free calls on tracked blocks
+    unsigned long long bytes;        // Total bytes requested
+    long long live_bytes;            // Currently allocated bytes
+    long long peak_live_bytes;       // High-water mark of live_bytes
+} GraphAllocStats;
+
+/**
+ * Per-call-site totals of the calling thread since the last reset.
+ */
+typedef struct {
+    const char* site;                // "file.c:line"
+    unsigned long long allocations;
+    unsigned long long bytes;
+} GraphAllocSite;
+
+#define GRAPH_ALLOC_STR_(x) #x
+#define GRAPH_ALLOC_STR(x) GRAPH_ALLOC_STR_(x)
+#define GRAPH_ALLOC_SITE __FILE__ ":" GRAPH_ALLOC_STR(__LINE__)
+
+#define GRAPH_MALLOC(size)         graph_alloc_malloc((size), GRAPH_ALLOC_SITE)
+#define GRAPH_CALLOC(nmemb, size)  graph_alloc_calloc((nmemb), (size), GRAPH_ALLOC_SITE)
+#define GRAPH_REALLOC(ptr, size)   graph_alloc_realloc((ptr), (size), GRAPH_ALLOC_SITE)
+#define GRAPH_FREE(ptr)            graph_alloc_free(ptr)
+
+void* graph_alloc_malloc(size_t size, const char* site);
+void* graph_alloc_calloc(size_t nmemb, size_t size, const char* site);
+void* graph_alloc_realloc(void* ptr, size_t size, const char* site);
+void  graph_alloc_free(void* ptr);
+
+/**
+ * Install a custom allocator.
+ * @param allocator Allocator to use, or NULL to restore libc.
+ */
+void graph_alloc_set_allocator(const GraphAllocator* allocator);
+
+/**
+ * Enable or disable allocation profiling (process-wide).
+ * @param enabled 1 to enable, 0 to disable.
+ */
+void graph_alloc_set_profiling(int enabled);
+
+/**
+ * @return 1 if allocation profiling is enabled, 0 otherwise.
+ */
+int graph_alloc_profiling_enabled(void);
+
+/**
+ * Reset the calling thread's statistics and call-site totals.
+ */
+void graph_alloc_stats_reset(void);
+
+/**
+ * Get the calling thread's statistics.
+ * @param out OUT: statistics since the last reset.
+ */
+void graph_alloc_stats_get(GraphAllocStats* out);
+
+/**
+ * Get the calling thread's call-site totals, largest byte count first.
+ * @param out OUT: array of at least @p max entries.
+ * @param max Capacity of @p out.
+ * @return Number of entries written.
+ */
+int graph_alloc_sites_get(GraphAllocSite* out, int max);
+
+/**
+ * Print the calling thread's statistics and top call sites.
+ * @param out Output stream.
+ * @param top Maximum number of call sites to print.
+ */
+void graph_alloc_print_report(FILE* out, int top);
+
+#endif /* GRAPH_ALLOC_H */
@@ -0,0 +1,300 @@
+#include "graph_batch.h"
+#include "bitgraph.h"
+#include "maxflow.h"
+#include "mst.h"
+#include "workspace.h"
+#include "graph_alloc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#define BATCH_MAX_THREADS 64
+
+void graph_batch_init(GraphBatch* batch) {
+    if (batch) memset(batch, 0, sizeof(*batch));
+}
+
+void graph_batch_free(GraphBatch* batch) {
+    if (!batch) return;
+    GRAPH_FREE(batch->graphs);
+    GRAPH_FREE(batch->rows);
+    GRAPH_FREE(batch->edges);
+    memset(batch, 0, sizeof(*batch));
+}
+
+/**
+ * Make room for @p needed elements, doubling the capacity.
+ * @return The (possibly moved) array, or NULL on failure (the old one stays valid).
+ */
+static void* grow_array(void* data, int* capacity, int needed, size_t elem_size) {
+    if (needed <= *capacity) return data;
+
+    int cap = *capacity > 0 ? *capacity : 16;
+    while (cap < needed) cap *= 2;
+    void* grown = GRAPH_REALLOC(data, (size_t)cap * elem_size);
+    if (!grown) return NULL;
+    *capacity = cap;
+    return grown;
+}
+
+/**
+ * Reserve space for a graph with @p n vertices and up to @p max_edges edges
+ * and start its entry. Edges are added with batch_add_edge(), and the graph
+ * is committed with batch_commit().
+ */
+static GraphBatchEntry* batch_begin(GraphBatch* batch, int n, int max_edges) {
+    void* p = grow_array(batch->graphs, &batch->capacity, batch->count + 1, sizeof(GraphBatchEntry));
+    if (!p) return NULL;
+    batch->graphs = (GraphBatchEntry*)p;
+
+    p = grow_array(batch->rows, &batch->row_capacity, batch->num_rows + n, sizeof(uint64_t));
+    if (!p) return NULL;
+    batch->rows = (uint64_t*)p;
+
+    p = grow_array(batch->edges, &batch->edge_capacity, 3 * (batch->num_edges + max_edges), sizeof(int));
+    if (!p) return NULL;
+    batch->edges = (int*)p;
+
+    GraphBatchEntry* e = &batch->graphs[batch->count];
+    e->n = n;
+    e->m = 0;
+    e->first_row = batch->num_rows;
+    e->first_edge = batch->num_edges;
+    e->loops = 0;
+    memset(batch->rows + e->first_row, 0, (size_t)n * sizeof(uint64_t));
+    return e;
+}
+
+static void batch_add_edge(GraphBatch* batch, GraphBatchEntry* e, int u, int v, int weight) {
+    if (u < 0 || u >= e->n || v < 0 || v >= e->n || weight <= 0) return;
+
+    uint64_t* rows = batch->rows + e->first_row;
+    if (u == v) {
+        if (e->loops & ((uint64_t)1 << u)) return;
+        e->loops |= (uint64_t)1 << u;
+    } else {
+        if (rows[u] & ((uint64_t)1 << v)) return;
+        rows[u] |= (uint64_t)1 << v;
+        rows[v] |= (uint64_t)1 << u;
+    }
+
+    int* t = batch->edges + 3 * (e->first_edge + e->m);
+    t[0] = u;
+    t[1] = v;
+    t[2] = weight;
+    e->m++;
+}
+
+static void batch_commit(GraphBatch* batch, GraphBatchEntry* e) {
+    batch->num_rows += e->n;
+    batch->num_edges += e->m;
+    batch->count++;
+}
+
+int graph_batch_add(GraphBatch* batch, int n, int m, const int* triples) {
+    if (!batch || n < 1 || n > GRAPH_BATCH_MAX_N || m < 0 || (m > 0 && !triples)) return 0;
+
+    GraphBatchEntry* e = batch_begin(batch, n, m);
+    if (!e) return 0;
+    for (int i = 0; i < m; i++) {
+        batch_add_edge(batch, e, triples[3 * i], triples[3 * i + 1], triples[3 * i + 2]);
+    }
+    batch_commit(batch, e);
+    return 1;
+}
+
+int graph_batch_add_graph(GraphBatch* batch, const Graph* g) {
+    if (!batch || !g || g->n < 1 || g->n > GRAPH_BATCH_MAX_N) return 0;
+
+    int nodes = 0;
+    for (int u = 0; u < g->n; u++) {
+        for (EdgeNode* edge = g->adj[u].head; edge; edge = edge->next) nodes++;
+    }
+
+    GraphBatchEntry* e = batch_begin(batch, g->n, nodes);
+    if (!e) return 0;
+    for (int u = 0; u < g->n; u++) {
+        for (EdgeNode* edge = g->adj[u].head; edge; edge = edge->next) {
+            if (u <= edge->to) batch_add_edge(batch, e, u, edge->to, edge->weight);
+        }
+    }
+    batch_commit(batch, e);
+    return 1;
+}
+
+int graph_batch_decode(GraphBatch* batch, int count, const int* data, int size) {
+    if (!batch || count < 0 || size < 0 || (size > 0 && !data)) return -1;
+
+    int pos = 0;
+    for (int i = 0; i < count; i++) {
+        if (size - pos < 2) return -1;
+        int n = data[pos];
+        int m = data[pos + 1];
+        if (m < 0 || m > (size - pos - 2) / 3) return -1;
+        if (!graph_batch_add(batch, n, m, data + pos + 2)) return -1;
+        pos += 2 + 3 * m;
+    }
+    return pos;
+}
+
+/**
+ * Adjacency lists of one batch graph, built inside @p ws. Each edge gets
+ * two nodes, as graph_add_weighted_edge() would add them.
+ */
+static Graph* batch_graph(const GraphBatch* batch, const GraphBatchEntry* e, AlgorithmWorkspace* ws) {
+    Graph* g = (Graph*)workspace_alloc(ws, sizeof(Graph));
+    Vertex* adj = (Vertex*)workspace_calloc(ws, e->n, sizeof(Vertex));
+    EdgeNode* nodes = (EdgeNode*)workspace_alloc(ws, (size_t)2 * e->m * sizeof(EdgeNode));
+    if (!g || !adj || !nodes) return NULL;
+
+    for (int i = 0; i < e->m; i++) {
+        const int* t = batch->edges + 3 * (e->first_edge + i);
+        EdgeNode* a = &nodes[2 * i];
+        EdgeNode* b = &nodes[2 * i + 1];
+        a->to = t[1];
+        a->weight = t[2];
+        a->next = adj[t[0]].head;
+        adj[t[0]].head = a;
+        b->to = t[0];
+        b->weight = t[2];
+        b->next = adj[t[1]].head;
+        adj[t[1]].head = b;
+    }
+    g->n = e->n;
+    g->adj = adj;
+    return g;
+}
+
+/**
+ * One thread's share of a batch: graphs [begin, end).
+ */
+typedef struct {
+    const GraphBatch* batch;
+    int algorithm_id;
+    AlgorithmParams params;   // Per-graph parameters (single-threaded)
+    int begin;
+    int end;
+    long long* results;
+    int ok;
+} BatchTask;
+
+static long long batch_run_one(const BatchTask* t, const GraphBatchEntry* e, AlgorithmWorkspace* ws) {
+    const uint64_t* rows = t->batch->rows + e->first_row;
+    SearchBudget budget;
+    search_budget_init(&budget, t->params.time_budget_ms);
+
+    switch (t->algorithm_id) {
+        case 1: {
+            int has_circuit;
+            return bitgraph_rows_has_euler_circuit(rows, e->n, e->loops, &has_circuit) ? has_circuit : -1;
+        }
+        case 2: {
+            Graph* g = batch_graph(t->batch, e, ws);
+            long long flow;
+            return g && graph_max_flow_with_params(g, &t->params, &flow, ws) ? flow : -1;
+        }
+        case 3: {
+            Graph* g = batch_graph(t->batch, e, ws);
+            MST_Result mst;
+            if (!g || !graph_mst_with_params(g, &t->params, &mst, ws)) return -1;
+            long long weight = mst.is_connected ? mst.total_weight : -1;
+            mst_result_free(&mst);
+            return weight;
+        }
+        case 4: {
+            // The coloring bound is the faster search unless backtracking is asked for
+            int clique[GRAPH_BATCH_MAX_N];
+            int size;
+            int coloring = t->params.variant != ALGO_VARIANT_CLIQUE_BACKTRACK;
+            return bitgraph_rows_max_clique(rows, e->n, coloring, &budget, clique, &size) ? size : -1;
+        }
+        case 5: {
+            int k = t->params.clique_size;
+            if (k > e->n) return 0;
+
+            long long counts[GRAPH_BATCH_MAX_N + 1] = {0};
+            if (!bitgraph_rows_count_cliques(rows, e->n, k, &budget, counts)) return -1;
+            if (k > 0) return counts[k];
+
+            long long total = 0;
+            for (int size = 1; size <= e->n; size++) total += counts[size];
+            return total;
+        }
+        default:
+            return -1;
+    }
+}
+
+static void* batch_task_run(void* arg) {
+    BatchTask* t = (BatchTask*)arg;
+
+    // Scratch for the graphs that need adjacency lists, reused across graphs
+    AlgorithmWorkspace ws;
+    if (!workspace_init(&ws, 0)) return NULL;
+
+    for (int i = t->begin; i < t->end; i++) {
+        t->results[i] = batch_run_one(t, &t->batch->graphs[i], &ws);
+        workspace_reset(&ws);
+    }
+    workspace_destroy(&ws);
+    t->ok = 1;
+    return NULL;
+}
+
+int graph_batch_run(const GraphBatch* batch, int algorithm_id, const AlgorithmParams* params,
+                    long long* results) {
+    if (!batch || !results || algorithm_id < 1 || algorithm_id > 5) return 0;
+    if (batch->count == 0) return 1;
+
+    int num_threads = (params && params->num_threads > 1) ? params->num_threads : 1;
+    if (num_threads > BATCH_MAX_THREADS) num_threads = BATCH_MAX_THREADS;
+    if (num_threads > batch->count) num_threads = batch->count;
+
+    BatchTask tasks[BATCH_MAX_THREADS];
+    pthread_t threads[BATCH_MAX_THREADS];
+    int started[BATCH_MAX_THREADS] = {0};
+
+    // Contiguous chunks keep each thread's rows and edges together in memory
+    for (int t = 0; t < num_threads; t++) {
+        tasks[t].batch = batch;
+        tasks[t].algorithm_id = algorithm_id;
+        if (params) tasks[t].params = *params;
+        else algorithm_params_init(&tasks[t].params);
+        tasks[t].params.num_threads = 1;
+        tasks[t].begin = (int)((long long)batch->count * t / num_threads);
+        tasks[t].end = (int)((long long)batch->count * (t + 1) / num_threads);
+        tasks[t].results = results;
+        tasks[t].ok = 0;
+    }
+
+    // Thread 0 runs on the caller; a thread that cannot be started runs inline
+    for (int t = 1; t < num_threads; t++) {
+        started[t] = pthread_create(&threads[t], NULL, batch_task_run, &tasks[t]) == 0;
+    }
+    batch_task_run(&tasks[0]);
+    for (int t = 1; t < num_threads; t++) {
+        if (started[t]) pthread_join(threads[t], NULL);
+        else batch_task_run(&tasks[t]);
+    }
+
+    int ok = 1;
+    for (int t = 0; t < num_threads; t++) {
+        if (!tasks[t].ok) ok = 0;
+    }
+    return ok;
+}
+
+char* graph_batch_format_results(const long long* results, int count) {
+    if (!results || count < 0) return NULL;
+
+    size_t capacity = 64 + (size_t)count * 21;
+    char* out = (char*)malloc(capacity);
+    if (!out) return NULL;
+
+    size_t len = (size_t)snprintf(out, capacity, "Batch results (%d graphs):", count);
+    for (int i = 0; i < count; i++) {
+        len += (size_t)snprintf(out + len, capacity - len, " %lld", results[i]);
+    }
+    return out;
+}
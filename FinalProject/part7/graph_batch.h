@@ -0,0 +1,108 @@
+#ifndef GRAPH_BATCH_H
+#define GRAPH_BATCH_H
+
+#include <stdint.h>
+#include "graph.h"
+#include "algorithm_params.h"
+
+/**
+ * @file graph_batch.h
+ * Run one algorithm over many small graphs in a single call.
+ *
+ * A batch keeps all of its graphs in three contiguous arrays: one entry
+ * per graph, the adjacency rows of every graph as 64-bit masks (n rows
+ * each), and the weighted edge lists as (u, v, weight) triples. Euler, max
+ * clique and clique counting run the bitset kernels straight on the rows.
+ * MST and max flow build the graph's adjacency lists inside the worker's
+ * workspace. Graphs are split over threads in contiguous chunks, and
+ * nothing is allocated per graph apart from MST results.
+ */
+
+#define GRAPH_BATCH_MAX_N 64
+
+/**
+ * Set on the algorithm id (after the optional parameter block) to send a
+ * batch: [id | ALGO_BATCH_FLAG][count][payload_ints] followed by payload_ints
+ * ints holding count graphs, each [n][m] and m (u, v, weight) triples.
+ */
+#define ALGO_BATCH_FLAG 0x200
+
+typedef struct {
+    int n;              // Vertices (1..GRAPH_BATCH_MAX_N)
+    int m;              // Edges, self-loops included
+    int first_row;      // Index of row 0 of this graph in rows
+    int first_edge;     // Index of edge 0 of this graph in edges (triples)
+    uint64_t loops;     // Bit v set if v has a self-loop
+} GraphBatchEntry;
+
+typedef struct {
+    GraphBatchEntry* graphs;
+    int count;
+    int capacity;
+    uint64_t* rows;     // Bit j of a row set if the vertex has neighbor j
+    int num_rows;
+    int row_capacity;
+    int* edges;         // (u, v, weight) triples
+    int num_edges;
+    int edge_capacity;
+} GraphBatch;
+
+/**
+ * Initialize an empty batch.
+ */
+void graph_batch_init(GraphBatch* batch);
+
+/**
+ * Free all memory of a batch (it can be initialized again afterwards).
+ */
+void graph_batch_free(GraphBatch* batch);
+
+/**
+ * Append a graph given as @p m (u, v, weight) triples. Like the servers,
+ * edges with an endpoint out of range, a weight <= 0, or that repeat an
+ * earlier edge are skipped.
+ *
+ * @param n Vertex count, 1..GRAPH_BATCH_MAX_N
+ * @return 1 on success, 0 for an invalid n or on allocation failure
+ */
+int graph_batch_add(GraphBatch* batch, int n, int m, const int* triples);
+
+/**
+ * Append a copy of @p g (at most GRAPH_BATCH_MAX_N vertices).
+ * @return 1 on success, 0 if @p g is too large or on allocation failure
+ */
+int graph_batch_add_graph(GraphBatch* batch, const Graph* g);
+
+/**
+ * Parse @p count wire-format graphs ([n][m] and m triples each) from
+ * @p data and append them.
+ * @return Number of ints consumed, or -1 on malformed input.
+ */
+int graph_batch_decode(GraphBatch* batch, int count, const int* data, int size);
+
+/**
+ * Run strategy @p algorithm_id (1 euler, 2 max flow, 3 MST, 4 max clique,
+ * 5 clique count) on every graph in the batch. results[i] receives:
+ *   1 euler        1 if an Euler circuit exists, else 0
+ *   2 max flow     flow between the params endpoints (default 0 -> n-1)
+ *   3 MST          total weight, or -1 if the graph is not connected
+ *   4 max clique   size of the maximum clique
+ *   5 clique count number of cliques (of size params->clique_size if set)
+ * or -1 if the algorithm failed on that graph. params->time_budget_ms
+ * applies to each graph; params->num_threads is the number of threads
+ * that share the batch.
+ *
+ * @param params Parameters, or NULL for defaults
+ * @param results OUT: batch->count values
+ * @return 1 on success, 0 for an invalid algorithm or allocation failure
+ */
+int graph_batch_run(const GraphBatch* batch, int algorithm_id, const AlgorithmParams* params,
+                    long long* results);
+
+/**
+ * Format results as "Batch results (<count> graphs): r0 r1 ...".
+ * @return Heap string (free with free()), or NULL on allocation failure.
+ */
+char* graph_batch_format_results(const long long* results, int count);
+
+#endif /* GRAPH_BATCH_H */
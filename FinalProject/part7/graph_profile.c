@@ -0,0 +1,99 @@
+#include "graph_profile.h"
+#include "graph_alloc.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Core numbers by bucket peeling (Batagelj-Zaversnik). On return deg[v]
+ * holds the core number of v.
+ * @return The degeneracy (largest core number).
+ */
+static int peel_cores(const Graph* g, int* deg, int* bin, int* pos, int* vert, int max_degree) {
+    int n = g->n;
+
+    // Bucket sort vertices by degree
+    memset(bin, 0, (size_t)(max_degree + 1) * sizeof(int));
+    for (int v = 0; v < n; v++) bin[deg[v]]++;
+
+    int start = 0;
+    for (int d = 0; d <= max_degree; d++) {
+        int count = bin[d];
+        bin[d] = start;
+        start += count;
+    }
+    for (int v = 0; v < n; v++) {
+        pos[v] = bin[deg[v]];
+        vert[pos[v]] = v;
+        bin[deg[v]]++;
+    }
+    for (int d = max_degree; d > 0; d--) bin[d] = bin[d - 1];
+    bin[0] = 0;
+
+    // Remove vertices in degree order, moving neighbors down one bucket
+    int degeneracy = 0;
+    for (int i = 0; i < n; i++) {
+        int v = vert[i];
+        if (deg[v] > degeneracy) degeneracy = deg[v];
+
+        for (EdgeNode* e = g->adj[v].head; e; e = e->next) {
+            int u = e->to;
+            if (u == v || deg[u] <= deg[v]) continue;
+
+            int du = deg[u], pu = pos[u], pw = bin[du];
+            int w = vert[pw];
+            if (u != w) {
+                pos[u] = pw; vert[pu] = w;
+                pos[w] = pu; vert[pw] = u;
+            }
+            bin[du]++;
+            deg[u]--;
+        }
+    }
+    return degeneracy;
+}
+
+int graph_profile_compute(const Graph* g, GraphProfile* profile) {
+    if (!g || !profile || g->n < 1) return 0;
+
+    int n = g->n;
+    memset(profile, 0, sizeof(*profile));
+    profile->n = n;
+
+    // One block: degrees, positions and vertex order (n each), then buckets
+    int* deg = (int*)GRAPH_MALLOC((size_t)3 * n * sizeof(int));
+    if (!deg) return 0;
+    int* pos = deg + n;
+    int* vert = pos + n;
+
+    long long half_edges = 0;
+    for (int v = 0; v < n; v++) {
+        deg[v] = 0;
+        for (EdgeNode* e = g->adj[v].head; e; e = e->next) {
+            if (e->to != v) deg[v]++;
+        }
+        half_edges += deg[v];
+        if (deg[v] > profile->max_degree) profile->max_degree = deg[v];
+    }
+
+    profile->m = half_edges / 2;
+    profile->avg_degree = (double)half_edges / n;
+    profile->density = n > 1 ? (double)half_edges / ((double)n * (n - 1)) : 0.0;
+
+    int* bin = (int*)GRAPH_MALLOC((size_t)(profile->max_degree + 1) * sizeof(int));
+    if (!bin) {
+        GRAPH_FREE(deg);
+        return 0;
+    }
+    profile->degeneracy = peel_cores(g, deg, bin, pos, vert, profile->max_degree);
+
+    GRAPH_FREE(bin);
+    GRAPH_FREE(deg);
+    return 1;
+}
+
+void graph_profile_print(const GraphProfile* profile) {
+    if (!profile) return;
+    printf("Graph profile: n=%d m=%lld density=%.3f avg_degree=%.2f max_degree=%d degeneracy=%d\n",
+           profile->n, profile->m, profile->density, profile->avg_degree,
+           profile->max_degree, profile->degeneracy);
+}
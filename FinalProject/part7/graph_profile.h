@@ -0,0 +1,36 @@
+#ifndef GRAPH_PROFILE_H
+#define GRAPH_PROFILE_H
+
+#include "graph.h"
+
+/**
+ * @file graph_profile.h
+ * Cheap structural summary of a graph, computed once when the graph is
+ * loaded and used by the dispatch layer to choose algorithm variants.
+ */
+
+typedef struct {
+    int n;              // Number of vertices
+    long long m;        // Number of undirected edges (self-loops excluded)
+    double density;     // m / (n(n-1)/2), 0 for n < 2
+    double avg_degree;  // 2m / n
+    int max_degree;     // Largest vertex degree
+    int degeneracy;     // Largest k with a non-empty k-core
+} GraphProfile;
+
+/**
+ * Compute the profile of @p g in O(n + m).
+ * The degeneracy comes from bucket-based core peeling (Matula-Beck).
+ *
+ * @param g Graph pointer
+ * @param profile OUT: computed profile
+ * @return 1 on success, 0 on failure
+ */
+int graph_profile_compute(const Graph* g, GraphProfile* profile);
+
+/**
+ * Print a one-line summary of the profile.
+ */
+void graph_profile_print(const GraphProfile* profile);
+
+#endif /* GRAPH_PROFILE_H */
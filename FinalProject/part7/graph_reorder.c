@@ -0,0 +1,344 @@
+#include "graph_reorder.h"
+#include "graph_alloc.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Gorder-lite: vertices placed in the last GORDER_WINDOW positions attract
+ * their neighbors and, through neighbors of at most GORDER_HUB_DEGREE edges,
+ * the vertices they share a neighbor with. */
+#define GORDER_WINDOW 5
+#define GORDER_HUB_DEGREE 64
+
+static const char* const order_names[GRAPH_ORDER_COUNT] = {"none", "degree", "rcm", "gorder"};
+
+const char* graph_order_name(GraphOrder order) {
+    if (order < GRAPH_ORDER_NONE || order >= GRAPH_ORDER_COUNT) return "unknown";
+    return order_names[order];
+}
+
+int graph_order_parse(const char* name, GraphOrder* order) {
+    if (!name || !order) return 0;
+    for (int i = 0; i < GRAPH_ORDER_COUNT; i++) {
+        if (strcmp(name, order_names[i]) == 0) {
+            *order = (GraphOrder)i;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void graph_reordering_free(GraphReordering* r) {
+    if (!r) return;
+    GRAPH_FREE(r->new_id);
+    GRAPH_FREE(r->old_id);
+    memset(r, 0, sizeof(*r));
+}
+
+/**
+ * Adjacency nodes of each vertex; a self-loop counts twice, as stored.
+ */
+static void vertex_degrees(const Graph* g, int* degree, int* max_degree) {
+    *max_degree = 0;
+    for (int v = 0; v < g->n; v++) {
+        int d = 0;
+        for (EdgeNode* e = g->adj[v].head; e; e = e->next) d++;
+        degree[v] = d;
+        if (d > *max_degree) *max_degree = d;
+    }
+}
+
+/**
+ * Vertices sorted by degree (stable counting sort), descending if asked.
+ */
+static int sort_by_degree(int n, const int* degree, int max_degree, int descending, int* out) {
+    int* start = (int*)GRAPH_CALLOC((size_t)max_degree + 2, sizeof(int));
+    if (!start) return 0;
+
+    for (int v = 0; v < n; v++) {
+        int key = descending ? max_degree - degree[v] : degree[v];
+        start[key + 1]++;
+    }
+    for (int k = 0; k <= max_degree; k++) start[k + 1] += start[k];
+    for (int v = 0; v < n; v++) {
+        int key = descending ? max_degree - degree[v] : degree[v];
+        out[start[key]++] = v;
+    }
+    GRAPH_FREE(start);
+    return 1;
+}
+
+static int cmp_long_long(const void* a, const void* b) {
+    long long x = *(const long long*)a;
+    long long y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Reverse Cuthill-McKee: breadth-first from a lowest-degree vertex of each
+ * component, visiting neighbors by increasing degree, then reversed.
+ */
+static int order_rcm(const Graph* g, const int* degree, int max_degree, int* old_id) {
+    int n = g->n;
+    int* by_degree = (int*)GRAPH_MALLOC((size_t)n * sizeof(int));
+    unsigned char* placed = (unsigned char*)GRAPH_CALLOC((size_t)n, 1);
+    long long* keys = (long long*)GRAPH_MALLOC(((size_t)max_degree + 1) * sizeof(long long));
+    int ok = by_degree && placed && keys && sort_by_degree(n, degree, max_degree, 0, by_degree);
+
+    int tail = 0;
+    for (int s = 0; ok && s < n; s++) {
+        int root = by_degree[s];
+        if (placed[root]) continue;
+        placed[root] = 1;
+        old_id[tail++] = root;
+
+        for (int head = tail - 1; head < tail; head++) {
+            int v = old_id[head];
+            int count = 0;
+            for (EdgeNode* e = g->adj[v].head; e; e = e->next) {
+                if (placed[e->to]) continue;
+                placed[e->to] = 1;
+                keys[count++] = ((long long)degree[e->to] << 32) | (unsigned int)e->to;
+            }
+            qsort(keys, (size_t)count, sizeof(long long), cmp_long_long);
+            for (int i = 0; i < count; i++) old_id[tail++] = (int)(keys[i] & 0xffffffffLL);
+        }
+    }
+
+    for (int i = 0; ok && i < n / 2; i++) {
+        int t = old_id[i];
+        old_id[i] = old_id[n - 1 - i];
+        old_id[n - 1 - i] = t;
+    }
+    GRAPH_FREE(by_degree);
+    GRAPH_FREE(placed);
+    GRAPH_FREE(keys);
+    return ok;
+}
+
+/**
+ * Max-heap of (score, vertex) with lazy deletion: an entry is stale once
+ * the vertex is placed or its score has changed.
+ */
+typedef struct {
+    long long* entries;   // score << 32 | (INT_MAX - vertex), so ties pick the lower id
+    int count;
+    int capacity;
+} ScoreHeap;
+
+static int heap_push(ScoreHeap* h, int score, int v) {
+    if (h->count == h->capacity) {
+        int cap = h->capacity > 0 ? 2 * h->capacity : 256;
+        long long* grown = (long long*)GRAPH_REALLOC(h->entries, (size_t)cap * sizeof(long long));
+        if (!grown) return 0;
+        h->entries = grown;
+        h->capacity = cap;
+    }
+
+    long long key = ((long long)score << 32) | (unsigned int)(0x7fffffff - v);
+    int i = h->count++;
+    while (i > 0 && h->entries[(i - 1) / 2] < key) {
+        h->entries[i] = h->entries[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    h->entries[i] = key;
+    return 1;
+}
+
+static long long heap_pop(ScoreHeap* h) {
+    long long top = h->entries[0];
+    long long last = h->entries[--h->count];
+    int i = 0;
+    for (;;) {
+        int c = 2 * i + 1;
+        if (c >= h->count) break;
+        if (c + 1 < h->count && h->entries[c + 1] > h->entries[c]) c++;
+        if (h->entries[c] <= last) break;
+        h->entries[i] = h->entries[c];
+        i = c;
+    }
+    if (h->count > 0) h->entries[i] = last;
+    return top;
+}
+
+typedef struct {
+    const Graph* g;
+    const int* degree;
+    int* score;
+    const unsigned char* placed;
+    ScoreHeap heap;
+    int ok;
+} GorderState;
+
+static void gorder_bump(GorderState* st, int x, int delta) {
+    if (st->placed[x]) return;
+    st->score[x] += delta;
+    if (st->score[x] > 0 && !heap_push(&st->heap, st->score[x], x)) st->ok = 0;
+}
+
+/**
+ * Add (@p delta = 1) or remove (-1) the pull of @p v on the unplaced
+ * vertices: one per edge to v and one per neighbor shared with v.
+ */
+static void gorder_window_update(GorderState* st, int v, int delta) {
+    for (EdgeNode* e = st->g->adj[v].head; e; e = e->next) {
+        int u = e->to;
+        if (u == v) continue;
+        gorder_bump(st, u, delta);
+        if (st->degree[u] > GORDER_HUB_DEGREE) continue;
+        for (EdgeNode* f = st->g->adj[u].head; f; f = f->next) {
+            if (f->to != v && f->to != u) gorder_bump(st, f->to, delta);
+        }
+    }
+}
+
+/**
+ * Gorder-lite: repeatedly place the vertex with the most edges and shared
+ * neighbors into the last GORDER_WINDOW placed vertices, falling back to
+ * the highest-degree unplaced vertex.
+ */
+static int order_gorder(const Graph* g, const int* degree, int max_degree, int* old_id) {
+    int n = g->n;
+    int* by_degree = (int*)GRAPH_MALLOC((size_t)n * sizeof(int));
+    unsigned char* placed = (unsigned char*)GRAPH_CALLOC((size_t)n, 1);
+    GorderState st;
+    memset(&st, 0, sizeof(st));
+    st.g = g;
+    st.degree = degree;
+    st.score = (int*)GRAPH_CALLOC((size_t)n, sizeof(int));
+    st.placed = placed;
+    st.ok = by_degree && placed && st.score && sort_by_degree(n, degree, max_degree, 1, by_degree);
+
+    int next_fallback = 0;
+    for (int i = 0; st.ok && i < n; i++) {
+        int v = -1;
+        while (st.heap.count > 0) {
+            long long top = heap_pop(&st.heap);
+            int c = 0x7fffffff - (int)(top & 0xffffffffLL);
+            if (!placed[c] && st.score[c] == (int)(top >> 32)) {
+                v = c;
+                break;
+            }
+        }
+        while (v < 0) {
+            if (!placed[by_degree[next_fallback]]) v = by_degree[next_fallback];
+            next_fallback++;
+        }
+
+        placed[v] = 1;
+        old_id[i] = v;
+        gorder_window_update(&st, v, 1);
+        if (i >= GORDER_WINDOW) gorder_window_update(&st, old_id[i - GORDER_WINDOW], -1);
+    }
+
+    int ok = st.ok;
+    GRAPH_FREE(st.heap.entries);
+    GRAPH_FREE(st.score);
+    GRAPH_FREE(by_degree);
+    GRAPH_FREE(placed);
+    return ok;
+}
+
+int graph_reordering_compute(const Graph* g, GraphOrder order, GraphReordering* r) {
+    if (!g || !r || g->n < 1 || order < GRAPH_ORDER_NONE || order >= GRAPH_ORDER_COUNT) return 0;
+
+    int n = g->n;
+    memset(r, 0, sizeof(*r));
+    r->n = n;
+    r->new_id = (int*)GRAPH_MALLOC((size_t)n * sizeof(int));
+    r->old_id = (int*)GRAPH_MALLOC((size_t)n * sizeof(int));
+    int* degree = (int*)GRAPH_MALLOC((size_t)n * sizeof(int));
+    int ok = r->new_id && r->old_id && degree;
+
+    if (ok) {
+        int max_degree;
+        vertex_degrees(g, degree, &max_degree);
+        switch (order) {
+            case GRAPH_ORDER_DEGREE:
+                ok = sort_by_degree(n, degree, max_degree, 1, r->old_id);
+                break;
+            case GRAPH_ORDER_RCM:
+                ok = order_rcm(g, degree, max_degree, r->old_id);
+                break;
+            case GRAPH_ORDER_GORDER:
+                ok = order_gorder(g, degree, max_degree, r->old_id);
+                break;
+            default:
+                for (int v = 0; v < n; v++) r->old_id[v] = v;
+                break;
+        }
+    }
+    if (ok) {
+        for (int i = 0; i < n; i++) r->new_id[r->old_id[i]] = i;
+    }
+
+    GRAPH_FREE(degree);
+    if (!ok) graph_reordering_free(r);
+    return ok;
+}
+
+typedef struct {
+    int to;
+    int weight;
+} RenamedEdge;
+
+static int cmp_renamed_edge(const void* a, const void* b) {
+    const RenamedEdge* x = (const RenamedEdge*)a;
+    const RenamedEdge* y = (const RenamedEdge*)b;
+    return (x->to > y->to) - (x->to < y->to);
+}
+
+Graph* graph_reordering_apply(const Graph* g, const GraphReordering* r) {
+    if (!g || !r || !r->new_id || !r->old_id || r->n != g->n) return NULL;
+
+    int n = g->n;
+    int degree_bound = 0;
+    for (int v = 0; v < n; v++) {
+        int d = 0;
+        for (EdgeNode* e = g->adj[v].head; e; e = e->next) d++;
+        if (d > degree_bound) degree_bound = d;
+    }
+
+    Graph* out = graph_create(n);
+    RenamedEdge* edges = (RenamedEdge*)GRAPH_MALLOC(((size_t)degree_bound + 1) * sizeof(RenamedEdge));
+    if (!out || !edges) {
+        graph_destroy(out);
+        GRAPH_FREE(edges);
+        return NULL;
+    }
+
+    // Nodes are allocated vertex by vertex in the new order, so a scan of
+    // consecutive vertices walks memory mostly forward
+    for (int v = 0; v < n; v++) {
+        int count = 0;
+        for (EdgeNode* e = g->adj[r->old_id[v]].head; e; e = e->next) {
+            edges[count].to = r->new_id[e->to];
+            edges[count].weight = e->weight;
+            count++;
+        }
+        qsort(edges, (size_t)count, sizeof(RenamedEdge), cmp_renamed_edge);
+
+        EdgeNode** tail = &out->adj[v].head;
+        for (int i = 0; i < count; i++) {
+            EdgeNode* node = (EdgeNode*)GRAPH_MALLOC(sizeof(EdgeNode));
+            if (!node) {
+                graph_destroy(out);
+                GRAPH_FREE(edges);
+                return NULL;
+            }
+            node->to = edges[i].to;
+            node->weight = edges[i].weight;
+            node->next = NULL;
+            *tail = node;
+            tail = &node->next;
+        }
+    }
+    GRAPH_FREE(edges);
+    return out;
+}
+
+void graph_reordering_to_original(const GraphReordering* r, int* ids, int count) {
+    if (!r || !r->old_id || !ids) return;
+    for (int i = 0; i < count; i++) {
+        if (ids[i] >= 0 && ids[i] < r->n) ids[i] = r->old_id[ids[i]];
+    }
+}
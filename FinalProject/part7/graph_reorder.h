@@ -0,0 +1,67 @@
+#ifndef GRAPH_REORDER_H
+#define GRAPH_REORDER_H
+
+#include "graph.h"
+
+/**
+ * @file graph_reorder.h
+ * Relabel a graph's vertices into an order with better memory locality.
+ *
+ * Clients number vertices however they like, so the neighbors visited by
+ * BFS, flow and clique code are scattered over the vertex arrays and the
+ * adjacency nodes. A reordering computes a permutation that places related
+ * vertices next to each other, and graph_reordering_apply() builds a copy
+ * in that order with the adjacency nodes allocated in the same order and
+ * each list sorted by neighbor. Results on the copy are mapped back to the
+ * client's ids with old_id.
+ */
+
+typedef enum {
+    GRAPH_ORDER_NONE = 0,   // Keep the ids as given
+    GRAPH_ORDER_DEGREE,     // Highest degree first (hubs share cache lines)
+    GRAPH_ORDER_RCM,        // Reverse Cuthill-McKee (small bandwidth)
+    GRAPH_ORDER_GORDER,     // Greedy window of shared neighbors (Gorder-lite)
+    GRAPH_ORDER_COUNT
+} GraphOrder;
+
+typedef struct {
+    int n;
+    int* new_id;   // new_id[v]: position of original vertex v
+    int* old_id;   // old_id[i]: original vertex at position i
+} GraphReordering;
+
+/**
+ * Compute a reordering of @p g. GRAPH_ORDER_NONE gives the identity.
+ * @return 1 on success, 0 on invalid arguments or allocation failure.
+ */
+int graph_reordering_compute(const Graph* g, GraphOrder order, GraphReordering* r);
+
+/**
+ * Free the arrays of a reordering (safe to call on a zeroed one).
+ */
+void graph_reordering_free(GraphReordering* r);
+
+/**
+ * Build a copy of @p g with vertex v renamed to r->new_id[v].
+ * @return New graph (free with graph_destroy()), or NULL on failure.
+ */
+Graph* graph_reordering_apply(const Graph* g, const GraphReordering* r);
+
+/**
+ * Map @p count vertex ids of the reordered graph back to the original ids,
+ * in place. Ids out of range are left unchanged.
+ */
+void graph_reordering_to_original(const GraphReordering* r, int* ids, int count);
+
+/**
+ * Name of an order ("none", "degree", "rcm", "gorder").
+ */
+const char* graph_order_name(GraphOrder order);
+
+/**
+ * Parse an order name.
+ * @return 1 on success, 0 for an unknown name
+ */
+int graph_order_parse(const char* name, GraphOrder* order);
+
+#endif /* GRAPH_REORDER_H */
@@ -1,4 +1,7 @@
 #include "maxclique.h"
+#include "graph_alloc.h"
+#include "bitgraph.h"
+#include "coloring.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -46,7 +49,10 @@ static int is_connected_to_all(int** adj_matrix, int v, int* current_clique, int
  */
 static void max_clique_backtrack(int** adj_matrix, int n, int start_vertex,
                                 int* current_clique, int current_size,
-                                int* best_clique, int* best_size) {
+                                int* best_clique, int* best_size, SearchBudget* budget) {
+    
+    // Out of time: keep the best clique found so far
+    if (search_budget_expired(budget)) return;
     
     // Update best clique if current is larger
     if (current_size > *best_size) {
@@ -66,15 +72,161 @@ static void max_clique_backtrack(int** adj_matrix, int n, int start_vertex,
             // Recursive call
             max_clique_backtrack(adj_matrix, n, v + 1, 
                                current_clique, current_size + 1,
-                               best_clique, best_size);
+                               best_clique, best_size, budget);
+        }
+    }
+}
+
+/**
+ * State of the branch-and-bound search with a coloring bound (Tomita's MCQ).
+ * Row d of order/colors holds the colored candidate set at depth d.
+ */
+typedef struct {
+    int** adj_matrix;
+    int** order;         // Candidates at each depth, sorted by color
+    int** colors;        // colors[d][i] = color of order[d][i] (1-based)
+    int* current;        // Current clique, current[d] chosen at depth d
+    int* best_clique;
+    int best_size;
+    int* candidates;     // Next depth's candidate set before coloring
+    int* color_of;       // Scratch for coloring_sort()
+    int* counts;         // Scratch for coloring_sort()
+    SearchBudget* budget;
+} ColoringSearch;
+
+/**
+ * Greedy sequential coloring of @p candidates, then a counting sort by color
+ * into order[depth]/colors[depth]. A set that needs k colors cannot contain
+ * a clique larger than k, which is the bound used to prune the search.
+ */
+static void coloring_sort(ColoringSearch* cs, const int* candidates, int count, int depth) {
+    int** adj = cs->adj_matrix;
+    int* color_of = cs->color_of;
+    int* used = cs->counts;
+    int max_color = 0;
+    
+    for (int i = 0; i <= count + 1; i++) used[i] = 0;
+    
+    for (int i = 0; i < count; i++) {
+        int v = candidates[i];
+        // Smallest color not used by an earlier neighbor (stamped with i + 1)
+        for (int j = 0; j < i; j++) {
+            if (adj[v][candidates[j]]) used[color_of[j]] = i + 1;
+        }
+        int c = 1;
+        while (used[c] == i + 1) c++;
+        color_of[i] = c;
+        if (c > max_color) max_color = c;
+    }
+    
+    for (int c = 0; c <= max_color + 1; c++) used[c] = 0;
+    for (int i = 0; i < count; i++) used[color_of[i] + 1]++;
+    for (int c = 1; c <= max_color + 1; c++) used[c] += used[c - 1];
+    for (int i = 0; i < count; i++) {
+        int slot = used[color_of[i]]++;
+        cs->order[depth][slot] = candidates[i];
+        cs->colors[depth][slot] = color_of[i];
+    }
+}
+
+static void coloring_expand(ColoringSearch* cs, const int* candidates, int count, int depth) {
+    if (search_budget_expired(cs->budget)) return;
+    
+    coloring_sort(cs, candidates, count, depth);
+    int* order = cs->order[depth];
+    int* colors = cs->colors[depth];
+    
+    // Highest colors first; once depth + color cannot beat the best, stop
+    for (int i = count - 1; i >= 0; i--) {
+        if (depth + colors[i] <= cs->best_size) return;
+        
+        int v = order[i];
+        cs->current[depth] = v;
+        
+        // Remaining candidates are order[0..i-1]; keep the neighbors of v
+        int next_count = 0;
+        for (int j = 0; j < i; j++) {
+            if (cs->adj_matrix[v][order[j]]) cs->candidates[next_count++] = order[j];
+        }
+        
+        if (next_count == 0) {
+            if (depth + 1 > cs->best_size) {
+                cs->best_size = depth + 1;
+                for (int k = 0; k <= depth; k++) cs->best_clique[k] = cs->current[k];
+            }
+        } else {
+            coloring_expand(cs, cs->candidates, next_count, depth + 1);
+            if (cs->budget->expired) return;
+        }
+    }
+}
+
+/**
+ * Root candidate order for the coloring search: reverse smallest-last, so
+ * the first coloring starts from the densest core. Falls back to id order.
+ */
+static void initial_order(const Graph* g, int* candidates, AlgorithmWorkspace* ws) {
+    int n = g->n;
+    WorkspaceMark mark = workspace_mark(ws);
+    
+    GraphCSR csr;
+    int* removal = (int*)workspace_alloc(ws, n * sizeof(int));
+    if (removal && graph_csr_build(g, &csr, ws) && graph_smallest_last_order(&csr, removal, ws) >= 0) {
+        for (int i = 0; i < n; i++) candidates[i] = removal[n - 1 - i];
+    } else {
+        for (int v = 0; v < n; v++) candidates[v] = v;
+    }
+    
+    workspace_release(ws, mark);
+}
+
+/**
+ * Copy a clique found by a search into @p result, sorting the vertices
+ * ascending first when the search did not visit them in order.
+ */
+static int store_max_clique(MaxClique_Result* result, int* clique, int size, int sort) {
+    if (sort) {
+        for (int i = 1; i < size; i++) {
+            int v = clique[i], j = i - 1;
+            while (j >= 0 && clique[j] > v) {
+                clique[j + 1] = clique[j];
+                j--;
+            }
+            clique[j + 1] = v;
+        }
+    }
+    
+    if (size > 0) {
+        result->vertices = (int*)GRAPH_MALLOC(size * sizeof(int));
+        if (!result->vertices) return 0;
+        for (int i = 0; i < size; i++) {
+            result->vertices[i] = clique[i];
         }
+        result->size = size;
+        result->is_valid = 1;
     }
+    return 1;
 }
 
 /**
  * Find maximum clique using backtracking algorithm.
  */
 int graph_max_clique(const Graph* g, MaxClique_Result* result) {
+    return graph_max_clique_ws(g, result, NULL);
+}
+
+/**
+ * Backtracking max clique with all scratch memory taken from a workspace.
+ */
+int graph_max_clique_ws(const Graph* g, MaxClique_Result* result, AlgorithmWorkspace* ws) {
+    return graph_max_clique_with_params(g, NULL, result, ws);
+}
+
+/**
+ * Max clique honoring the time budget and variant in @p params.
+ */
+int graph_max_clique_with_params(const Graph* g, const AlgorithmParams* params,
+                                 MaxClique_Result* result, AlgorithmWorkspace* ws) {
     if (!g || !result) return 0;
     
     int n = g->n;
@@ -83,6 +235,7 @@ int graph_max_clique(const Graph* g, MaxClique_Result* result) {
     result->vertices = NULL;
     result->size = 0;
     result->is_valid = 0;
+    result->timed_out = 0;
     
     if (n == 0) {
         result->is_valid = 1;
@@ -91,7 +244,7 @@ int graph_max_clique(const Graph* g, MaxClique_Result* result) {
     
     // Single vertex is always a clique of size 1
     if (n == 1) {
-        result->vertices = (int*)malloc(sizeof(int));
+        result->vertices = (int*)GRAPH_MALLOC(sizeof(int));
         if (!result->vertices) return 0;
         result->vertices[0] = 0;
         result->size = 1;
@@ -99,66 +252,77 @@ int graph_max_clique(const Graph* g, MaxClique_Result* result) {
         return 1;
     }
     
-    // Allocate adjacency matrix
-    int** adj_matrix = (int**)malloc(n * sizeof(int*));
-    if (!adj_matrix) return 0;
-    
-    for (int i = 0; i < n; i++) {
-        adj_matrix[i] = (int*)malloc(n * sizeof(int));
-        if (!adj_matrix[i]) {
-            for (int j = 0; j < i; j++) free(adj_matrix[j]);
-            free(adj_matrix);
-            return 0;
-        }
+    int coloring = params && params->variant == ALGO_VARIANT_CLIQUE_COLORING;
+    int best_size = 0;
+    SearchBudget budget;
+    search_budget_init(&budget, params ? params->time_budget_ms : 0);
+    
+    // Small graphs: bitset kernels, no matrix or workspace needed
+    int small_clique[BITGRAPH_MAX_N];
+    if (bitgraph_max_clique(g, coloring, &budget, small_clique, &best_size)) {
+        result->timed_out = budget.expired;
+        return store_max_clique(result, small_clique, best_size, coloring);
     }
     
-    // Build adjacency matrix
-    build_adjacency_matrix(g, adj_matrix);
-    
-    // Allocate working arrays
-    int* current_clique = (int*)malloc(n * sizeof(int));
-    int* best_clique = (int*)malloc(n * sizeof(int));
-    
-    if (!current_clique || !best_clique) {
-        free(current_clique); free(best_clique);
-        for (int i = 0; i < n; i++) free(adj_matrix[i]);
-        free(adj_matrix);
-        return 0;
+    // Without a caller workspace, use a temporary one for this call
+    AlgorithmWorkspace local;
+    if (!ws) {
+        if (!workspace_init(&local, 0)) return 0;
+        ws = &local;
+    }
+    WorkspaceMark mark = workspace_mark(ws);
+    
+    // Scratch: adjacency matrix and working arrays
+    int** adj_matrix = workspace_matrix(ws, n);
+    int* current_clique = (int*)workspace_alloc(ws, n * sizeof(int));
+    int* best_clique = (int*)workspace_alloc(ws, n * sizeof(int));
+    
+    ColoringSearch cs;
+    if (coloring) {
+        cs.order = workspace_matrix(ws, n);
+        cs.colors = workspace_matrix(ws, n);
+        cs.candidates = (int*)workspace_alloc(ws, n * sizeof(int));
+        cs.color_of = (int*)workspace_alloc(ws, n * sizeof(int));
+        cs.counts = (int*)workspace_alloc(ws, (n + 2) * sizeof(int));
     }
     
-    int best_size = 0;
-    
-    // Try starting from each vertex
-    for (int start = 0; start < n; start++) {
-        current_clique[0] = start;
-        max_clique_backtrack(adj_matrix, n, start + 1,
-                           current_clique, 1,
-                           best_clique, &best_size);
-    }
-    
-    // Store result
-    if (best_size > 0) {
-        result->vertices = (int*)malloc(best_size * sizeof(int));
-        if (!result->vertices) {
-            free(current_clique); free(best_clique);
-            for (int i = 0; i < n; i++) free(adj_matrix[i]);
-            free(adj_matrix);
-            return 0;
-        }
+    int ok = adj_matrix && current_clique && best_clique &&
+             (!coloring || (cs.order && cs.colors && cs.candidates && cs.color_of && cs.counts));
+    if (ok) {
+        // Build adjacency matrix
+        build_adjacency_matrix(g, adj_matrix);
         
-        for (int i = 0; i < best_size; i++) {
-            result->vertices[i] = best_clique[i];
+        if (coloring) {
+            cs.adj_matrix = adj_matrix;
+            cs.current = current_clique;
+            cs.best_clique = best_clique;
+            cs.best_size = 0;
+            cs.budget = &budget;
+            initial_order(g, cs.candidates, ws);
+            coloring_expand(&cs, cs.candidates, n, 0);
+            best_size = cs.best_size;
+        } else {
+            // Try starting from each vertex
+            for (int start = 0; start < n && !budget.expired; start++) {
+                current_clique[0] = start;
+                max_clique_backtrack(adj_matrix, n, start + 1,
+                                   current_clique, 1,
+                                   best_clique, &best_size, &budget);
+            }
         }
-        result->size = best_size;
-        result->is_valid = 1;
+        result->timed_out = budget.expired;
+    }
+    
+    // Store result (owned by the caller), ascending like the backtracking search
+    if (ok) {
+        ok = store_max_clique(result, best_clique, best_size, coloring);
     }
     
     // Cleanup
-    free(current_clique); free(best_clique);
-    for (int i = 0; i < n; i++) free(adj_matrix[i]);
-    free(adj_matrix);
+    workspace_release(ws, mark);
+    if (ws == &local) workspace_destroy(&local);
     
-    return 1;
+    return ok;
 }
 
 /**
@@ -206,7 +370,7 @@ void graph_print_max_clique(const Graph* g) {
  */
 void maxclique_result_free(MaxClique_Result* result) {
     if (result && result->vertices) {
-        free(result->vertices);
+        GRAPH_FREE(result->vertices);
         result->vertices = NULL;
         result->size = 0;
         result->is_valid = 0;
@@ -217,10 +381,17 @@ void maxclique_result_free(MaxClique_Result* result) {
  * Get max clique size only (simpler interface).
  */
 int graph_max_clique_size(const Graph* g, int* clique_size) {
+    return graph_max_clique_size_ws(g, clique_size, NULL);
+}
+
+/**
+ * Get max clique size only, using a workspace.
+ */
+int graph_max_clique_size_ws(const Graph* g, int* clique_size, AlgorithmWorkspace* ws) {
     if (!g || !clique_size) return 0;
     
     MaxClique_Result result;
-    if (!graph_max_clique(g, &result)) {
+    if (!graph_max_clique_ws(g, &result, ws)) {
         return 0;
     }
     
@@ -238,6 +409,13 @@ int graph_max_clique_size(const Graph* g, int* clique_size) {
  * Check if a given set of vertices forms a clique.
  */
 int graph_is_clique(const Graph* g, int* vertices, int size) {
+    return graph_is_clique_ws(g, vertices, size, NULL);
+}
+
+/**
+ * Clique check with the adjacency matrix taken from a workspace.
+ */
+int graph_is_clique_ws(const Graph* g, int* vertices, int size, AlgorithmWorkspace* ws) {
     if (!g || !vertices || size < 0) return 0;
     
     if (size <= 1) return 1; // Single vertex or empty set is trivially a clique
@@ -249,34 +427,34 @@ int graph_is_clique(const Graph* g, int* vertices, int size) {
         if (vertices[i] < 0 || vertices[i] >= n) return 0;
     }
     
-    // Build adjacency matrix
-    int** adj_matrix = (int**)malloc(n * sizeof(int*));
-    if (!adj_matrix) return 0;
-    
-    for (int i = 0; i < n; i++) {
-        adj_matrix[i] = (int*)malloc(n * sizeof(int));
-        if (!adj_matrix[i]) {
-            for (int j = 0; j < i; j++) free(adj_matrix[j]);
-            free(adj_matrix);
-            return 0;
-        }
+    // Without a caller workspace, use a temporary one for this call
+    AlgorithmWorkspace local;
+    if (!ws) {
+        if (!workspace_init(&local, 0)) return 0;
+        ws = &local;
     }
+    WorkspaceMark mark = workspace_mark(ws);
     
-    build_adjacency_matrix(g, adj_matrix);
-    
-    // Check if every pair of vertices is connected
-    int is_clique = 1;
-    for (int i = 0; i < size && is_clique; i++) {
-        for (int j = i + 1; j < size && is_clique; j++) {
-            if (!adj_matrix[vertices[i]][vertices[j]]) {
-                is_clique = 0;
+    // Build adjacency matrix
+    int** adj_matrix = workspace_matrix(ws, n);
+    int is_clique = 0;
+    if (adj_matrix) {
+        build_adjacency_matrix(g, adj_matrix);
+        
+        // Check if every pair of vertices is connected
+        is_clique = 1;
+        for (int i = 0; i < size && is_clique; i++) {
+            for (int j = i + 1; j < size && is_clique; j++) {
+                if (!adj_matrix[vertices[i]][vertices[j]]) {
+                    is_clique = 0;
+                }
             }
         }
     }
     
     // Cleanup
-    for (int i = 0; i < n; i++) free(adj_matrix[i]);
-    free(adj_matrix);
+    workspace_release(ws, mark);
+    if (ws == &local) workspace_destroy(&local);
     
     return is_clique;
 }
@@ -295,11 +473,11 @@ static void bron_kerbosch(int** adj_matrix, int n,
         // Found a maximal clique
         if (*num_results >= *capacity) {
             *capacity *= 2;
-            *results = (MaxClique_Result*)realloc(*results, *capacity * sizeof(MaxClique_Result));
+            *results = (MaxClique_Result*)GRAPH_REALLOC(*results, *capacity * sizeof(MaxClique_Result));
             if (!*results) return;
         }
         
-        (*results)[*num_results].vertices = (int*)malloc(R_size * sizeof(int));
+        (*results)[*num_results].vertices = (int*)GRAPH_MALLOC(R_size * sizeof(int));
         if (!(*results)[*num_results].vertices) return;
         
         for (int i = 0; i < R_size; i++) {
@@ -307,12 +485,13 @@ static void bron_kerbosch(int** adj_matrix, int n,
         }
         (*results)[*num_results].size = R_size;
         (*results)[*num_results].is_valid = 1;
+        (*results)[*num_results].timed_out = 0;
         (*num_results)++;
         return;
     }
     
     // Make copies of P for iteration
-    int* P_copy = (int*)malloc(P_size * sizeof(int));
+    int* P_copy = (int*)GRAPH_MALLOC(P_size * sizeof(int));
     if (!P_copy) return;
     for (int i = 0; i < P_size; i++) P_copy[i] = P[i];
     int P_copy_size = P_size;
@@ -324,7 +503,7 @@ static void bron_kerbosch(int** adj_matrix, int n,
         R[R_size] = v;
         
         // P' = P ∩ N(v)
-        int* P_new = (int*)malloc(n * sizeof(int));
+        int* P_new = (int*)GRAPH_MALLOC(n * sizeof(int));
         int P_new_size = 0;
         for (int j = 0; j < P_size; j++) {
             if (adj_matrix[v][P[j]]) {
@@ -333,7 +512,7 @@ static void bron_kerbosch(int** adj_matrix, int n,
         }
         
         // X' = X ∩ N(v)
-        int* X_new = (int*)malloc(n * sizeof(int));
+        int* X_new = (int*)GRAPH_MALLOC(n * sizeof(int));
         int X_new_size = 0;
         for (int j = 0; j < X_size; j++) {
             if (adj_matrix[v][X[j]]) {
@@ -357,11 +536,11 @@ static void bron_kerbosch(int** adj_matrix, int n,
         }
         X[X_size++] = v;
         
-        free(P_new);
-        free(X_new);
+        GRAPH_FREE(P_new);
+        GRAPH_FREE(X_new);
     }
     
-    free(P_copy);
+    GRAPH_FREE(P_copy);
 }
 
 /**
@@ -377,14 +556,14 @@ int graph_find_all_maximal_cliques(const Graph* g, MaxClique_Result** max_clique
     if (n == 0) return 1;
     
     // Build adjacency matrix
-    int** adj_matrix = (int**)malloc(n * sizeof(int*));
+    int** adj_matrix = (int**)GRAPH_MALLOC(n * sizeof(int*));
     if (!adj_matrix) return 0;
     
     for (int i = 0; i < n; i++) {
-        adj_matrix[i] = (int*)malloc(n * sizeof(int));
+        adj_matrix[i] = (int*)GRAPH_MALLOC(n * sizeof(int));
         if (!adj_matrix[i]) {
-            for (int j = 0; j < i; j++) free(adj_matrix[j]);
-            free(adj_matrix);
+            for (int j = 0; j < i; j++) GRAPH_FREE(adj_matrix[j]);
+            GRAPH_FREE(adj_matrix);
             return 0;
         }
     }
@@ -392,14 +571,14 @@ int graph_find_all_maximal_cliques(const Graph* g, MaxClique_Result** max_clique
     build_adjacency_matrix(g, adj_matrix);
     
     // Initialize for Bron-Kerbosch
-    int* R = (int*)malloc(n * sizeof(int)); // Current clique (empty)
-    int* P = (int*)malloc(n * sizeof(int)); // All vertices initially
-    int* X = (int*)malloc(n * sizeof(int)); // Excluded vertices (empty)
+    int* R = (int*)GRAPH_MALLOC(n * sizeof(int)); // Current clique (empty)
+    int* P = (int*)GRAPH_MALLOC(n * sizeof(int)); // All vertices initially
+    int* X = (int*)GRAPH_MALLOC(n * sizeof(int)); // Excluded vertices (empty)
     
     if (!R || !P || !X) {
-        free(R); free(P); free(X);
-        for (int i = 0; i < n; i++) free(adj_matrix[i]);
-        free(adj_matrix);
+        GRAPH_FREE(R); GRAPH_FREE(P); GRAPH_FREE(X);
+        for (int i = 0; i < n; i++) GRAPH_FREE(adj_matrix[i]);
+        GRAPH_FREE(adj_matrix);
         return 0;
     }
     
@@ -409,20 +588,20 @@ int graph_find_all_maximal_cliques(const Graph* g, MaxClique_Result** max_clique
     }
     
     int capacity = 10;
-    *max_cliques = (MaxClique_Result*)malloc(capacity * sizeof(MaxClique_Result));
+    *max_cliques = (MaxClique_Result*)GRAPH_MALLOC(capacity * sizeof(MaxClique_Result));
     if (!*max_cliques) {
-        free(R); free(P); free(X);
-        for (int i = 0; i < n; i++) free(adj_matrix[i]);
-        free(adj_matrix);
+        GRAPH_FREE(R); GRAPH_FREE(P); GRAPH_FREE(X);
+        for (int i = 0; i < n; i++) GRAPH_FREE(adj_matrix[i]);
+        GRAPH_FREE(adj_matrix);
         return 0;
     }
     
     bron_kerbosch(adj_matrix, n, R, 0, P, n, X, 0, max_cliques, num_cliques, &capacity);
     
     // Cleanup
-    free(R); free(P); free(X);
-    for (int i = 0; i < n; i++) free(adj_matrix[i]);
-    free(adj_matrix);
+    GRAPH_FREE(R); GRAPH_FREE(P); GRAPH_FREE(X);
+    for (int i = 0; i < n; i++) GRAPH_FREE(adj_matrix[i]);
+    GRAPH_FREE(adj_matrix);
     
     return 1;
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #define MAXCLIQUE_H
 
 #include "graph.h"
+#include "workspace.h"
+#include "algorithm_params.h"
 
 /**
  * @file maxclique.h
@@ -18,6 +20,7 @@ typedef struct {
     int* vertices;     // Array of vertices in the max clique
     int size;          // Size of the max clique
     int is_valid;      // 1 if result is valid, 0 otherwise
+    int timed_out;     // 1 if the time budget ran out (best clique found so far)
 } MaxClique_Result;
 
 /**
@@ -29,6 +32,27 @@ typedef struct {
  */
 int graph_max_clique(const Graph* g, MaxClique_Result* result);
 
+/**
+ * Same as graph_max_clique(), taking all scratch memory from @p ws.
+ * 
+ * @param ws Workspace to use, or NULL for a temporary one
+ * @return 1 on success, 0 on failure
+ */
+int graph_max_clique_ws(const Graph* g, MaxClique_Result* result, AlgorithmWorkspace* ws);
+
+/**
+ * Max clique honoring params->time_budget_ms. When the budget runs out the
+ * best clique found so far is returned and result->timed_out is set.
+ * params->variant ALGO_VARIANT_CLIQUE_COLORING selects branch and bound with
+ * a greedy coloring bound; otherwise plain backtracking is used.
+ * 
+ * @param params Parameters, or NULL for defaults
+ * @param ws Workspace to use, or NULL for a temporary one
+ * @return 1 on success, 0 on failure
+ */
+int graph_max_clique_with_params(const Graph* g, const AlgorithmParams* params,
+                                 MaxClique_Result* result, AlgorithmWorkspace* ws);
+
 /**
  * Print max clique result in a formatted way.
  * 
@@ -51,6 +75,13 @@ void maxclique_result_free(MaxClique_Result* result);
  */
 int graph_max_clique_size(const Graph* g, int* clique_size);
 
+/**
+ * Same as graph_max_clique_size(), taking all scratch memory from @p ws.
+ * @param ws Workspace to use, or NULL for a temporary one
+ * @return 1 on success, 0 on failure
+ */
+int graph_max_clique_size_ws(const Graph* g, int* clique_size, AlgorithmWorkspace* ws);
+
 /**
  * Check if a given set of vertices forms a clique.
  * @param g Graph pointer
@@ -60,6 +91,13 @@ int graph_max_clique_size(const Graph* g, int* clique_size);
  */
 int graph_is_clique(const Graph* g, int* vertices, int size);
 
+/**
+ * Same as graph_is_clique(), taking the adjacency matrix from @p ws.
+ * @param ws Workspace to use, or NULL for a temporary one
+ * @return 1 if vertices form a clique, 0 otherwise
+ */
+int graph_is_clique_ws(const Graph* g, int* vertices, int size, AlgorithmWorkspace* ws);
+
 /**
  * Find all maximal cliques (Bron-Kerbosch algorithm).
  * @param g Graph pointer
@@ -1,71 +1,23 @@
 #include "maxflow.h"
+#include "bfs.h"
+#include "components.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
 
-/**
- * Queue implementation for BFS
- */
-typedef struct {
-    int* data;
-    int front, rear, size, capacity;
-} Queue;
-
-static Queue* queue_create(int capacity) {
-    Queue* q = (Queue*)malloc(sizeof(Queue));
-    if (!q) return NULL;
-    
-    q->data = (int*)malloc(sizeof(int) * capacity);
-    if (!q->data) {
-        free(q);
-        return NULL;
-    }
-    
-    q->front = q->rear = q->size = 0;
-    q->capacity = capacity;
-    return q;
-}
-
-static void queue_destroy(Queue* q) {
-    if (q) {
-        free(q->data);
-        free(q);
-    }
-}
-
-static int queue_is_empty(const Queue* q) {
-    return q->size == 0;
-}
-
-static int queue_enqueue(Queue* q, int item) {
-    if (q->size >= q->capacity) return 0; // Queue full
-    
-    q->data[q->rear] = item;
-    q->rear = (q->rear + 1) % q->capacity;
-    q->size++;
-    return 1;
-}
-
-static int queue_dequeue(Queue* q) {
-    if (queue_is_empty(q)) return -1;
-    
-    int item = q->data[q->front];
-    q->front = (q->front + 1) % q->capacity;
-    q->size--;
-    return item;
-}
-
 /**
  * Convert adjacency list graph to capacity matrix.
  * For unweighted graph, each edge has capacity 1.
  * 
  * @param g Graph pointer
  * @param capacity_matrix OUT: n×n matrix to fill with capacities
+ * @param num_arcs OUT: adjacency entries read (self-loops excluded)
  * @return 1 on success, 0 on failure
  */
-static int build_capacity_matrix(const Graph* g, int** capacity_matrix) {
+static int build_capacity_matrix(const Graph* g, int** capacity_matrix, long long* num_arcs) {
     int n = g->n;
+    *num_arcs = 0;
     
     // Initialize matrix to 0
     for (int i = 0; i < n; i++) {
@@ -81,57 +33,92 @@ static int build_capacity_matrix(const Graph* g, int** capacity_matrix) {
             if (u != v) { // Skip self-loops for flow networks
                 // Use edge weight as capacity (instead of hardcoded 1)
                 capacity_matrix[u][v] = edge->weight;
+                (*num_arcs)++;
             }
         }
     }
     return 1;
 }
 
+/* Below one arc per this many matrix cells, the BFS lists are copied from
+ * the adjacency lists instead of scanned out of the matrix */
+#define FLOW_CSR_LIST_RATIO 32
+
 /**
- * BFS to find augmenting path in residual graph.
- * 
- * @param res_graph Residual graph as capacity matrix
- * @param n Number of vertices
- * @param source Source vertex
- * @param sink Sink vertex
- * @param parent OUT: array to store the path
- * @return 1 if augmenting path found, 0 otherwise
+ * Adjacency of the flow network for the BFS engine. Capacities are
+ * symmetric, so the lists also serve the bottom-up steps, and a pair
+ * without capacity at the start never gains residual capacity. Sparse
+ * networks copy their adjacency lists. Dense ones scan the matrix rows,
+ * which is cheaper than chasing that many list nodes and gives sorted
+ * neighbor lists. Without @p g, the matrix is always scanned.
  */
-static int bfs_find_path(int** res_graph, int n, int source, int sink, int* parent) {
-    int* visited = (int*)calloc(n, sizeof(int));
-    if (!visited) return 0;
-    
-    Queue* q = queue_create(n);
-    if (!q) {
-        free(visited);
-        return 0;
-    }
+static int build_residual_csr(const Graph* g, int** capacity_matrix, int n, long long num_arcs,
+                              GraphCSR* csr, AlgorithmWorkspace* ws) {
+    if (g && num_arcs * FLOW_CSR_LIST_RATIO < (long long)n * n) return graph_csr_build(g, csr, ws);
     
-    queue_enqueue(q, source);
-    visited[source] = 1;
-    parent[source] = -1;
+    memset(csr, 0, sizeof(*csr));
+    long long* offsets = (long long*)workspace_alloc(ws, (n + 1) * sizeof(long long));
+    if (!offsets) return 0;
     
-    int found = 0;
+    offsets[0] = 0;
+    for (int u = 0; u < n; u++) {
+        long long degree = 0;
+        for (int v = 0; v < n; v++) degree += capacity_matrix[u][v] > 0;
+        offsets[u + 1] = offsets[u] + degree;
+    }
     
-    while (!queue_is_empty(q) && !found) {
-        int u = queue_dequeue(q);
-        
+    int* targets = (int*)workspace_alloc(ws, (offsets[n] > 0 ? offsets[n] : 1) * sizeof(int));
+    if (!targets) return 0;
+    for (int u = 0; u < n; u++) {
+        long long pos = offsets[u];
         for (int v = 0; v < n; v++) {
-            if (!visited[v] && res_graph[u][v] > 0) {
-                parent[v] = u;
-                visited[v] = 1;
-                queue_enqueue(q, v);
-                
-                if (v == sink) {
-                    found = 1;
-                    break;
-                }
-            }
+            if (capacity_matrix[u][v] > 0) targets[pos++] = v;
         }
     }
     
-    queue_destroy(q);
-    free(visited);
+    csr->n = n;
+    csr->num_arcs = offsets[n];
+    csr->offsets = offsets;
+    csr->targets = targets;
+    return 1;
+}
+
+/**
+ * Residual arc test for the BFS engine: u -> v has capacity left.
+ */
+static int residual_arc(void* ctx, int u, int v) {
+    int** res_graph = (int**)ctx;
+    return res_graph[u][v] > 0;
+}
+
+/**
+ * BFS from the source over the residual arcs, stopping at the level that
+ * reaches @p sink. Residual capacity only ever appears between adjacent
+ * vertices, so the search walks the CSR lists instead of whole matrix rows.
+ * 
+ * @param res_graph Residual graph as capacity matrix
+ * @param csr Adjacency of the flow network
+ * @param dist OUT: hops from the source, -1 past the sink's level
+ * @param parent OUT: BFS tree, so the path to the sink, or NULL
+ * @param ws Workspace for the search
+ * @return 1 if the sink is reachable, 0 otherwise
+ */
+static int residual_bfs(int** res_graph, const GraphCSR* csr, int source, int sink,
+                        int* dist, int* parent, AlgorithmWorkspace* ws) {
+    BFS_Options options;
+    bfs_options_init(&options, source);
+    options.target = sink;
+    options.filter = residual_arc;
+    options.filter_ctx = res_graph;
+    
+    WorkspaceMark mark = workspace_mark(ws);
+    BFS_Result bfs;
+    int found = graph_bfs_ws(csr, &options, &bfs, ws) && bfs.dist[sink] >= 0;
+    if (bfs.dist) {
+        if (dist) memcpy(dist, bfs.dist, csr->n * sizeof(int));
+        if (parent) memcpy(parent, bfs.parent, csr->n * sizeof(int));
+    }
+    workspace_release(ws, mark);
     return found;
 }
 
@@ -165,7 +152,15 @@ static void update_residual_graph(int** res_graph, int source, int sink, int* pa
 /**
  * Calculate maximum flow from source to sink using Edmonds-Karp algorithm.
  */
-int graph_max_flow(const Graph* g, int source, int sink, int* max_flow_value) {
+int graph_max_flow(const Graph* g, int source, int sink, long long* max_flow_value) {
+    return graph_max_flow_ws(g, source, sink, max_flow_value, NULL);
+}
+
+/**
+ * Edmonds-Karp with all scratch memory taken from a workspace.
+ */
+int graph_max_flow_ws(const Graph* g, int source, int sink, long long* max_flow_value,
+                      AlgorithmWorkspace* ws) {
     if (!g || !max_flow_value || source < 0 || sink < 0 || 
         source >= g->n || sink >= g->n || source == sink) {
         return 0;
@@ -174,73 +169,459 @@ int graph_max_flow(const Graph* g, int source, int sink, int* max_flow_value) {
     int n = g->n;
     *max_flow_value = 0;
     
-    // Allocate capacity/residual matrix
-    int** res_graph = (int**)malloc(n * sizeof(int*));
-    if (!res_graph) return 0;
+    // Without a caller workspace, use a temporary one for this call
+    AlgorithmWorkspace local;
+    if (!ws) {
+        if (!workspace_init(&local, 0)) return 0;
+        ws = &local;
+    }
+    WorkspaceMark mark = workspace_mark(ws);
     
-    for (int i = 0; i < n; i++) {
-        res_graph[i] = (int*)malloc(n * sizeof(int));
-        if (!res_graph[i]) {
-            // Cleanup on failure
-            for (int j = 0; j < i; j++) {
-                free(res_graph[j]);
-            }
-            free(res_graph);
-            return 0;
+    // Scratch: residual matrix, adjacency for the BFS and the path found
+    int** res_graph = workspace_matrix(ws, n);
+    int* parent = (int*)workspace_alloc(ws, n * sizeof(int));
+    GraphCSR csr;
+    long long num_arcs;
+    
+    int ok = res_graph && parent && build_capacity_matrix(g, res_graph, &num_arcs) &&
+             build_residual_csr(g, res_graph, n, num_arcs, &csr, ws);
+    if (ok) {
+        long long max_flow = 0;
+        
+        // Edmonds-Karp main loop
+        while (residual_bfs(res_graph, &csr, source, sink, NULL, parent, ws)) {
+            // Find minimum capacity along the path
+            int path_flow = find_path_flow(res_graph, source, sink, parent);
+            
+            // Update residual graph
+            update_residual_graph(res_graph, source, sink, parent, path_flow);
+            
+            // Add path flow to total flow
+            max_flow += path_flow;
+        }
+        
+        *max_flow_value = max_flow;
+    }
+    
+    // Cleanup
+    workspace_release(ws, mark);
+    if (ws == &local) workspace_destroy(&local);
+    
+    return ok;
+}
+
+/**
+ * Push flow along one level-increasing path. next[u] is the position of
+ * the first arc of u not yet known to lead to a dead end in this phase.
+ * @return Flow pushed, 0 if no path is left.
+ */
+static int dinic_push(int** res_graph, const GraphCSR* csr, int u, int sink, int limit,
+                      const int* level, long long* next) {
+    if (u == sink) return limit;
+    
+    for (; next[u] < csr->offsets[u + 1]; next[u]++) {
+        int v = csr->targets[next[u]];
+        if (res_graph[u][v] <= 0 || level[v] != level[u] + 1) continue;
+        
+        int pushed = dinic_push(res_graph, csr, v, sink,
+                                limit < res_graph[u][v] ? limit : res_graph[u][v],
+                                level, next);
+        if (pushed > 0) {
+            res_graph[u][v] -= pushed;
+            res_graph[v][u] += pushed;
+            return pushed;
         }
     }
+    return 0;
+}
+
+/**
+ * Dinic phases on @p res_graph until the sink is unreachable.
+ * @param level Scratch array of n ints
+ * @param next Scratch array of n positions
+ * @return Flow added to the residual graph's current flow
+ */
+static long long dinic_augment(int** res_graph, const GraphCSR* csr, int source, int sink,
+                               int* level, long long* next, AlgorithmWorkspace* ws) {
+    long long added = 0;
     
-    // Build initial capacity matrix
-    if (!build_capacity_matrix(g, res_graph)) {
-        // Cleanup
-        for (int i = 0; i < n; i++) {
-            free(res_graph[i]);
+    // Level graph up to the sink's level; vertices beyond it stay at -1
+    while (residual_bfs(res_graph, csr, source, sink, level, NULL, ws)) {
+        memcpy(next, csr->offsets, csr->n * sizeof(long long));
+        int pushed;
+        while ((pushed = dinic_push(res_graph, csr, source, sink, INT_MAX, level, next)) > 0) {
+            added += pushed;
         }
-        free(res_graph);
+    }
+    return added;
+}
+
+/**
+ * Dinic's algorithm on the same residual matrix as Edmonds-Karp. Each phase
+ * saturates all shortest paths at once, so far fewer BFS passes are needed
+ * when the flow decomposes into many paths.
+ */
+int graph_max_flow_dinic_ws(const Graph* g, int source, int sink, long long* max_flow_value,
+                            AlgorithmWorkspace* ws) {
+    if (!g || !max_flow_value || source < 0 || sink < 0 || 
+        source >= g->n || sink >= g->n || source == sink) {
         return 0;
     }
     
-    int* parent = (int*)malloc(n * sizeof(int));
-    if (!parent) {
-        for (int i = 0; i < n; i++) {
-            free(res_graph[i]);
+    int n = g->n;
+    *max_flow_value = 0;
+    
+    AlgorithmWorkspace local;
+    if (!ws) {
+        if (!workspace_init(&local, 0)) return 0;
+        ws = &local;
+    }
+    WorkspaceMark mark = workspace_mark(ws);
+    
+    int** res_graph = workspace_matrix(ws, n);
+    int* level = (int*)workspace_alloc(ws, n * sizeof(int));
+    long long* next = (long long*)workspace_alloc(ws, n * sizeof(long long));
+    GraphCSR csr;
+    long long num_arcs;
+    
+    int ok = res_graph && level && next && build_capacity_matrix(g, res_graph, &num_arcs) &&
+             build_residual_csr(g, res_graph, n, num_arcs, &csr, ws);
+    if (ok) {
+        *max_flow_value = dinic_augment(res_graph, &csr, source, sink, level, next, ws);
+    }
+    
+    workspace_release(ws, mark);
+    if (ws == &local) workspace_destroy(&local);
+    
+    return ok;
+}
+
+/**
+ * Run the max flow variant and endpoints requested in @p params.
+ */
+int graph_max_flow_with_params(const Graph* g, const AlgorithmParams* params,
+                               long long* max_flow_value, AlgorithmWorkspace* ws) {
+    if (!g) return 0;
+    
+    int source, sink;
+    if (!algorithm_params_flow_endpoints(params, g->n, &source, &sink)) return 0;
+    
+    // Endpoints in different components: no path, so skip the n x n residual matrix
+    GraphComponents cc;
+    WorkspaceMark mark = ws ? workspace_mark(ws) : (WorkspaceMark){0};
+    int separated = max_flow_value &&
+                    graph_connected_components_ws(g, params ? params->num_threads : 1, &cc, ws) &&
+                    !graph_components_same(&cc, source, sink);
+    if (ws) {
+        workspace_release(ws, mark);
+    } else if (max_flow_value) {
+        graph_components_free(&cc);
+    }
+    if (separated) {
+        *max_flow_value = 0;
+        return 1;
+    }
+    
+    if (params && params->variant == ALGO_VARIANT_DINIC) {
+        return graph_max_flow_dinic_ws(g, source, sink, max_flow_value, ws);
+    }
+    return graph_max_flow_ws(g, source, sink, max_flow_value, ws);
+}
+
+/**
+ * Capacity matrix and BFS lists of the flow network induced by @p view,
+ * read straight from the parent's arcs (capacity = arc weight, 1 without
+ * weights; self-loops skipped).
+ */
+static int build_view_network(const SubgraphView* view, int** capacity_matrix,
+                              GraphCSR* csr, AlgorithmWorkspace* ws) {
+    int n = view->n;
+    memset(csr, 0, sizeof(*csr));
+    long long* offsets = (long long*)workspace_alloc(ws, (n + 1) * sizeof(long long));
+    if (!offsets) return 0;
+    
+    for (int u = 0; u < n; u++) memset(capacity_matrix[u], 0, n * sizeof(int));
+    
+    offsets[0] = 0;
+    for (int u = 0; u < n; u++) {
+        SubgraphNeighborIter it;
+        int v, weight;
+        long long degree = 0;
+        subgraph_view_neighbors(view, u, &it);
+        while (subgraph_neighbor_next(&it, &v, &weight)) {
+            if (u == v) continue;
+            capacity_matrix[u][v] = weight;
+            degree++;
         }
-        free(res_graph);
+        offsets[u + 1] = offsets[u] + degree;
+    }
+    
+    int* targets = (int*)workspace_alloc(ws, (offsets[n] > 0 ? offsets[n] : 1) * sizeof(int));
+    if (!targets) return 0;
+    for (int u = 0; u < n; u++) {
+        SubgraphNeighborIter it;
+        int v;
+        long long pos = offsets[u];
+        subgraph_view_neighbors(view, u, &it);
+        while (subgraph_neighbor_next(&it, &v, NULL)) {
+            if (u != v) targets[pos++] = v;
+        }
+    }
+    
+    csr->n = n;
+    csr->num_arcs = offsets[n];
+    csr->offsets = offsets;
+    csr->targets = targets;
+    return 1;
+}
+
+int graph_max_flow_view_ws(const SubgraphView* view, int source, int sink,
+                           long long* max_flow_value, AlgorithmWorkspace* ws) {
+    if (!view || !max_flow_value || source < 0 || sink < 0 ||
+        source >= view->n || sink >= view->n || source == sink) {
         return 0;
     }
     
-    int max_flow = 0;
+    int n = view->n;
+    *max_flow_value = 0;
     
-    // Edmonds-Karp main loop
-    while (bfs_find_path(res_graph, n, source, sink, parent)) {
-        // Find minimum capacity along the path
-        int path_flow = find_path_flow(res_graph, source, sink, parent);
-        
-        // Update residual graph
-        update_residual_graph(res_graph, source, sink, parent, path_flow);
-        
-        // Add path flow to total flow
-        max_flow += path_flow;
+    AlgorithmWorkspace local;
+    if (!ws) {
+        if (!workspace_init(&local, 0)) return 0;
+        ws = &local;
     }
+    WorkspaceMark mark = workspace_mark(ws);
     
-    *max_flow_value = max_flow;
+    int** res_graph = workspace_matrix(ws, n);
+    int* level = (int*)workspace_alloc(ws, n * sizeof(int));
+    long long* next = (long long*)workspace_alloc(ws, n * sizeof(long long));
+    GraphCSR csr;
     
-    // Cleanup
-    free(parent);
-    for (int i = 0; i < n; i++) {
-        free(res_graph[i]);
+    int ok = res_graph && level && next && build_view_network(view, res_graph, &csr, ws);
+    if (ok) {
+        *max_flow_value = dinic_augment(res_graph, &csr, source, sink, level, next, ws);
     }
-    free(res_graph);
     
+    workspace_release(ws, mark);
+    if (ws == &local) workspace_destroy(&local);
+    
+    return ok;
+}
+
+/**
+ * Rebuild the session's BFS lists from the capacity matrix after a pair
+ * outside them gained capacity.
+ */
+static int session_refresh_csr(MaxFlowSession* session) {
+    if (!session->csr_stale) return 1;
+    
+    workspace_release(&session->ws, session->csr_mark);
+    if (!build_residual_csr(NULL, session->capacity, session->n, 0, &session->csr, &session->ws)) {
+        return 0;
+    }
+    session->csr_stale = 0;
     return 1;
 }
 
+/**
+ * Whether v is in the BFS list of u.
+ */
+static int session_csr_has_arc(const MaxFlowSession* session, int u, int v) {
+    const GraphCSR* csr = &session->csr;
+    for (long long i = csr->offsets[u]; i < csr->offsets[u + 1]; i++) {
+        if (csr->targets[i] == v) return 1;
+    }
+    return 0;
+}
+
+/**
+ * Push up to @p amount units from @p from to @p to along residual paths.
+ * @return Units pushed
+ */
+static int session_push(MaxFlowSession* session, int from, int to, int amount, int* parent) {
+    int pushed = 0;
+    if (from == to) return 0;
+    
+    while (pushed < amount &&
+           residual_bfs(session->residual, &session->csr, from, to, NULL, parent, &session->ws)) {
+        int path_flow = find_path_flow(session->residual, from, to, parent);
+        if (path_flow > amount - pushed) path_flow = amount - pushed;
+        update_residual_graph(session->residual, from, to, parent, path_flow);
+        pushed += path_flow;
+    }
+    return pushed;
+}
+
+/**
+ * Restore conservation after the flow on u -> v was cut by @p excess, which
+ * left u receiving that much more than it sends and v that much less.
+ * The excess is first rerouted from u to v; what cannot be is returned
+ * to a terminal from u and taken from one for v. The terminals themselves
+ * may be unbalanced.
+ * @return 1 if the flow is feasible again, 0 otherwise
+ */
+static int session_repair(MaxFlowSession* session, int u, int v, int excess) {
+    int source = session->source, sink = session->sink;
+    
+    // The refresh rewinds the workspace to csr_mark, so it goes first
+    if (!session_refresh_csr(session)) return 0;
+    
+    WorkspaceMark mark = workspace_mark(&session->ws);
+    int* parent = (int*)workspace_alloc(&session->ws, session->n * sizeof(int));
+    if (!parent) {
+        workspace_release(&session->ws, mark);
+        return 0;
+    }
+    
+    int left = excess - session_push(session, u, v, excess, parent);
+    int at_u = (u == source || u == sink) ? 0 : left;
+    int at_v = (v == source || v == sink) ? 0 : left;
+    
+    // Send u's surplus back to the source, or on to the sink
+    at_u -= session_push(session, u, source, at_u, parent);
+    at_u -= session_push(session, u, sink, at_u, parent);
+    
+    // Cover v's shortfall from the sink's inflow, or from the source
+    at_v -= session_push(session, sink, v, at_v, parent);
+    at_v -= session_push(session, source, v, at_v, parent);
+    
+    workspace_release(&session->ws, mark);
+    return at_u == 0 && at_v == 0;
+}
+
+/**
+ * Net flow out of the source.
+ */
+static long long session_source_outflow(const MaxFlowSession* session) {
+    long long flow = 0;
+    int s = session->source;
+    
+    for (int v = 0; v < session->n; v++) {
+        flow += session->capacity[s][v] - session->residual[s][v];
+    }
+    return flow;
+}
+
+/**
+ * Start a session with zero flow on the capacities of @p g.
+ */
+int max_flow_session_init(MaxFlowSession* session, const Graph* g, int source, int sink) {
+    if (!session) return 0;
+    memset(session, 0, sizeof(*session));
+    if (!g || source < 0 || sink < 0 || source >= g->n || sink >= g->n || source == sink) {
+        return 0;
+    }
+    if (!workspace_init(&session->ws, 0)) return 0;
+    
+    int n = g->n;
+    session->n = n;
+    session->source = source;
+    session->sink = sink;
+    session->capacity = workspace_matrix(&session->ws, n);
+    session->residual = workspace_matrix(&session->ws, n);
+    session->csr_mark = workspace_mark(&session->ws);
+    
+    long long num_arcs;
+    int ok = session->capacity && session->residual &&
+             build_capacity_matrix(g, session->capacity, &num_arcs) &&
+             build_residual_csr(g, session->capacity, n, num_arcs, &session->csr, &session->ws);
+    if (!ok) {
+        max_flow_session_destroy(session);
+        return 0;
+    }
+    
+    // Zero flow: every arc has its full capacity left
+    for (int u = 0; u < n; u++) {
+        memcpy(session->residual[u], session->capacity[u], n * sizeof(int));
+    }
+    return 1;
+}
+
+/**
+ * Change one edge capacity, keeping the current flow feasible.
+ */
+int max_flow_session_set_capacity(MaxFlowSession* session, int u, int v, int capacity) {
+    if (!session || !session->capacity || u < 0 || v < 0 ||
+        u >= session->n || v >= session->n || capacity < 0) {
+        return 0;
+    }
+    if (u == v) return 1;  // Self-loops carry no flow
+    
+    // Orient the pair along its flow
+    int flow = session->capacity[u][v] - session->residual[u][v];
+    if (flow < 0) {
+        int t = u;
+        u = v;
+        v = t;
+        flow = -flow;
+    }
+    int excess = flow > capacity ? flow - capacity : 0;
+    flow -= excess;
+    
+    if (capacity > 0 && !session->csr_stale && !session_csr_has_arc(session, u, v)) {
+        session->csr_stale = 1;
+    }
+    session->capacity[u][v] = session->capacity[v][u] = capacity;
+    session->residual[u][v] = capacity - flow;
+    session->residual[v][u] = capacity + flow;
+    
+    // If the excess cannot be placed, start over from zero flow
+    if (excess > 0 && !session_repair(session, u, v, excess)) {
+        for (int i = 0; i < session->n; i++) {
+            memcpy(session->residual[i], session->capacity[i], session->n * sizeof(int));
+        }
+    }
+    
+    session->flow_value = session_source_outflow(session);
+    return 1;
+}
+
+/**
+ * Augment from the current flow with Dinic phases.
+ */
+int max_flow_session_solve(MaxFlowSession* session, long long* max_flow_value) {
+    if (!session || !session->capacity || !max_flow_value) return 0;
+    if (!session_refresh_csr(session)) return 0;
+    
+    int n = session->n;
+    WorkspaceMark mark = workspace_mark(&session->ws);
+    int* level = (int*)workspace_alloc(&session->ws, n * sizeof(int));
+    long long* next = (long long*)workspace_alloc(&session->ws, n * sizeof(long long));
+    if (!level || !next) {
+        workspace_release(&session->ws, mark);
+        return 0;
+    }
+    
+    session->flow_value += dinic_augment(session->residual, &session->csr, session->source,
+                                         session->sink, level, next, &session->ws);
+    workspace_release(&session->ws, mark);
+    
+    *max_flow_value = session->flow_value;
+    return 1;
+}
+
+/**
+ * Free the session's workspace.
+ */
+void max_flow_session_destroy(MaxFlowSession* session) {
+    if (!session) return;
+    workspace_destroy(&session->ws);
+    memset(session, 0, sizeof(*session));
+}
+
 /**
  * Calculate maximum flow with default source=0 and sink=n-1.
  */
-int graph_max_flow_default(const Graph* g, int* max_flow_value) {
+int graph_max_flow_default(const Graph* g, long long* max_flow_value) {
+    return graph_max_flow_default_ws(g, max_flow_value, NULL);
+}
+
+/**
+ * Maximum flow with default source/sink, using a workspace.
+ */
+int graph_max_flow_default_ws(const Graph* g, long long* max_flow_value, AlgorithmWorkspace* ws) {
     if (!g || g->n < 2) return 0;
-    return graph_max_flow(g, 0, g->n - 1, max_flow_value);
+    return graph_max_flow_ws(g, 0, g->n - 1, max_flow_value, ws);
 }
 
 /**
@@ -263,9 +644,9 @@ void graph_print_max_flow(const Graph* g, int source, int sink) {
         return;
     }
     
-    int max_flow_value;
+    long long max_flow_value;
     if (graph_max_flow(g, source, sink, &max_flow_value)) {
-        printf("Max flow from vertex %d to vertex %d is: %d\n", 
+        printf("Max flow from vertex %d to vertex %d is: %lld\n", 
                source, sink, max_flow_value);
     } else {
         printf("Failed to calculate max flow from vertex %d to vertex %d\n", 
@@ -2,6 +2,10 @@
 #define MAXFLOW_H
 
 #include "graph.h"
+#include "workspace.h"
+#include "bfs.h"
+#include "subgraph.h"
+#include "algorithm_params.h"
 
 /**
  * @file maxflow.h
@@ -16,19 +20,120 @@
  * @param g Graph pointer (treated as flow network with unit capacities)
  * @param source Source vertex index
  * @param sink Sink vertex index  
- * @param max_flow_value OUT: pointer to store the maximum flow value
+ * @param max_flow_value OUT: maximum flow value (a sum of capacities, so 64-bit)
  * @return 1 on success, 0 on failure (invalid input or no path exists)
  */
-int graph_max_flow(const Graph* g, int source, int sink, int* max_flow_value);
+int graph_max_flow(const Graph* g, int source, int sink, long long* max_flow_value);
+
+/**
+ * Same as graph_max_flow(), taking all scratch memory from @p ws.
+ * 
+ * @param ws Workspace to use, or NULL for a temporary one
+ * @return 1 on success, 0 on failure
+ */
+int graph_max_flow_ws(const Graph* g, int source, int sink, long long* max_flow_value,
+                      AlgorithmWorkspace* ws);
+
+/**
+ * Maximum flow using Dinic's algorithm (level graph + blocking flow).
+ * Same contract as graph_max_flow_ws().
+ * 
+ * @param ws Workspace to use, or NULL for a temporary one
+ * @return 1 on success, 0 on failure
+ */
+int graph_max_flow_dinic_ws(const Graph* g, int source, int sink, long long* max_flow_value,
+                            AlgorithmWorkspace* ws);
+
+/**
+ * Maximum flow between the endpoints in @p params (default 0 -> n-1), using
+ * the variant in @p params->variant (ALGO_VARIANT_DINIC, otherwise Edmonds-Karp).
+ * 
+ * @param params Parameters, or NULL for the defaults
+ * @param ws Workspace to use, or NULL for a temporary one
+ * @return 1 on success, 0 on failure or invalid endpoints
+ */
+int graph_max_flow_with_params(const Graph* g, const AlgorithmParams* params,
+                               long long* max_flow_value, AlgorithmWorkspace* ws);
+
+/**
+ * Dinic max flow on the network induced by @p view, without copying it
+ * into a Graph. Capacities are the parent's arc weights (1 if it has none,
+ * see graph_csr_build_weighted()).
+ * 
+ * @param source Source vertex (view id)
+ * @param sink Sink vertex (view id)
+ * @param ws Workspace to use, or NULL for a temporary one
+ * @return 1 on success, 0 on failure
+ */
+int graph_max_flow_view_ws(const SubgraphView* view, int source, int sink,
+                           long long* max_flow_value, AlgorithmWorkspace* ws);
 
 /**
  * Calculate maximum flow with default source=0 and sink=n-1.
  * 
  * @param g Graph pointer
- * @param max_flow_value OUT: pointer to store the maximum flow value
+ * @param max_flow_value OUT: maximum flow value (a sum of capacities, so 64-bit)
+ * @return 1 on success, 0 on failure
+ */
+int graph_max_flow_default(const Graph* g, long long* max_flow_value);
+
+/**
+ * Same as graph_max_flow_default(), taking all scratch memory from @p ws.
+ * 
+ * @param ws Workspace to use, or NULL for a temporary one
  * @return 1 on success, 0 on failure
  */
-int graph_max_flow_default(const Graph* g, int* max_flow_value);
+int graph_max_flow_default_ws(const Graph* g, long long* max_flow_value, AlgorithmWorkspace* ws);
+
+/**
+ * Max flow between fixed endpoints, kept between calls. Capacity changes
+ * edit the residual graph in place: an increase leaves the current flow
+ * valid, and a decrease below the flow on an edge reroutes the excess (or
+ * cancels it back to the terminals). The next solve then augments from
+ * that flow instead of from zero.
+ */
+typedef struct {
+    int n;
+    int source;
+    int sink;
+    int** capacity;           // Symmetric edge capacities
+    int** residual;           // Capacity left in each direction
+    GraphCSR csr;             // Pairs that have had capacity, for the BFS
+    int csr_stale;            // A pair outside csr gained capacity
+    long long flow_value;     // Current flow out of the source
+    AlgorithmWorkspace ws;    // Owns the matrices, csr and scratch
+    WorkspaceMark csr_mark;   // Workspace position of csr; a refresh rewinds to it,
+                              // so nothing allocated above it may outlive one
+} MaxFlowSession;
+
+/**
+ * Start a session on the capacities of @p g (edge weights), with zero flow.
+ * The graph is not referenced afterwards.
+ * 
+ * @return 1 on success, 0 on invalid input or allocation failure
+ */
+int max_flow_session_init(MaxFlowSession* session, const Graph* g, int source, int sink);
+
+/**
+ * Set the capacity of the undirected edge u--v (0 removes it). The flow is
+ * kept feasible; call max_flow_session_solve() for the new maximum.
+ * 
+ * @return 1 on success, 0 on invalid vertices or a negative capacity
+ */
+int max_flow_session_set_capacity(MaxFlowSession* session, int u, int v, int capacity);
+
+/**
+ * Augment the current flow to a maximum flow.
+ * 
+ * @param max_flow_value OUT: maximum flow value
+ * @return 1 on success, 0 on invalid input or allocation failure
+ */
+int max_flow_session_solve(MaxFlowSession* session, long long* max_flow_value);
+
+/**
+ * Free everything owned by the session.
+ */
+void max_flow_session_destroy(MaxFlowSession* session);
 
 /**
  * Print maximum flow result in a formatted string.
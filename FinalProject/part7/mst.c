@@ -1,4 +1,6 @@
 #include "mst.h"
+#include "graph_alloc.h"
+#include "components.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -19,26 +21,13 @@ typedef struct {
     int capacity;
 } PriorityQueue;
 
-static PriorityQueue* pq_create(int capacity) {
-    PriorityQueue* pq = (PriorityQueue*)malloc(sizeof(PriorityQueue));
-    if (!pq) return NULL;
-    
-    pq->data = (PQ_Node*)malloc(sizeof(PQ_Node) * capacity);
-    if (!pq->data) {
-        free(pq);
-        return NULL;
-    }
-    
+/**
+ * Initialize a queue over caller-provided storage.
+ */
+static void pq_init(PriorityQueue* pq, PQ_Node* data, int capacity) {
+    pq->data = data;
     pq->size = 0;
     pq->capacity = capacity;
-    return pq;
-}
-
-static void pq_destroy(PriorityQueue* pq) {
-    if (pq) {
-        free(pq->data);
-        free(pq);
-    }
 }
 
 static void pq_swap(PQ_Node* a, PQ_Node* b) {
@@ -134,6 +123,13 @@ static int build_weight_matrix(const Graph* g, int** weight_matrix) {
  * Now properly handles weighted graphs.
  */
 int graph_mst_prim(const Graph* g, MST_Result* result) {
+    return graph_mst_prim_ws(g, result, NULL);
+}
+
+/**
+ * Prim's algorithm with all scratch memory taken from a workspace.
+ */
+int graph_mst_prim_ws(const Graph* g, MST_Result* result, AlgorithmWorkspace* ws) {
     if (!g || !result || g->n < 1) return 0;
     
     int n = g->n;
@@ -149,122 +145,236 @@ int graph_mst_prim(const Graph* g, MST_Result* result) {
         return 1;
     }
     
-    // Allocate weight matrix
-    int** weight_matrix = (int**)malloc(n * sizeof(int*));
-    if (!weight_matrix) return 0;
+    // Without a caller workspace, use a temporary one for this call
+    AlgorithmWorkspace local;
+    if (!ws) {
+        if (!workspace_init(&local, 0)) return 0;
+        ws = &local;
+    }
+    WorkspaceMark mark = workspace_mark(ws);
+    
+    // Scratch: weight matrix, Prim's arrays and the heap
+    int** weight_matrix = workspace_matrix(ws, n);
+    int* in_mst = (int*)workspace_calloc(ws, n, sizeof(int));
+    int* key = (int*)workspace_alloc(ws, n * sizeof(int));
+    int* parent = (int*)workspace_alloc(ws, n * sizeof(int));
+    PQ_Node* heap = (PQ_Node*)workspace_alloc(ws, (size_t)n * n * sizeof(PQ_Node)); // Generous capacity
+    
+    int ok = weight_matrix && in_mst && key && parent && heap;
+    if (ok) {
+        // Build weight matrix with actual edge weights
+        build_weight_matrix(g, weight_matrix);
+        
+        // Initialize arrays
+        for (int i = 0; i < n; i++) {
+            key[i] = INT_MAX;
+            parent[i] = -1;
+        }
+        key[0] = 0; // Start from vertex 0
+        
+        PriorityQueue pq;
+        pq_init(&pq, heap, n * n);
+        pq_push(&pq, 0, 0); // {weight=0, vertex=0}
+        
+        // Prim's main loop
+        while (!pq_is_empty(&pq)) {
+            PQ_Node current = pq_pop(&pq);
+            int u = current.vertex;
+            
+            if (in_mst[u]) continue; // Already in MST
+            
+            in_mst[u] = 1;
+            
+            // Update keys of adjacent vertices using actual edge weights
+            for (int v = 0; v < n; v++) {
+                int weight = weight_matrix[u][v];
+                if (weight > 0 && !in_mst[v] && weight < key[v]) {
+                    key[v] = weight;
+                    parent[v] = u;
+                    pq_push(&pq, weight, v);
+                }
+            }
+        }
+        
+        // Check if all vertices are reachable (graph is connected)
+        int vertices_in_mst = 0;
+        for (int i = 0; i < n; i++) {
+            if (in_mst[i]) vertices_in_mst++;
+        }
+        
+        // A disconnected graph is a success without a spanning tree
+        result->is_connected = (vertices_in_mst == n);
+    }
     
-    for (int i = 0; i < n; i++) {
-        weight_matrix[i] = (int*)malloc(n * sizeof(int));
-        if (!weight_matrix[i]) {
-            for (int j = 0; j < i; j++) free(weight_matrix[j]);
-            free(weight_matrix);
-            return 0;
+    if (ok && result->is_connected) {
+        // Build MST edges array (owned by the caller)
+        result->edges = (MST_Edge*)GRAPH_MALLOC((n-1) * sizeof(MST_Edge));
+        if (!result->edges) {
+            result->is_connected = 0;
+            ok = 0;
         }
     }
     
-    // Build weight matrix with actual edge weights
-    build_weight_matrix(g, weight_matrix);
+    if (ok && result->is_connected) {
+        int edge_count = 0;
+        long long total_weight = 0;
+        
+        for (int v = 1; v < n; v++) { // Skip vertex 0 (root)
+            if (parent[v] != -1) {
+                result->edges[edge_count].u = parent[v];
+                result->edges[edge_count].v = v;
+                result->edges[edge_count].weight = weight_matrix[parent[v]][v];
+                total_weight += weight_matrix[parent[v]][v];
+                edge_count++;
+            }
+        }
+        
+        result->num_edges = edge_count;
+        result->total_weight = total_weight;
+    }
     
-    // Prim's algorithm variables
-    int* in_mst = (int*)calloc(n, sizeof(int));
-    int* key = (int*)malloc(n * sizeof(int));
-    int* parent = (int*)malloc(n * sizeof(int));
+    // Cleanup
+    workspace_release(ws, mark);
+    if (ws == &local) workspace_destroy(&local);
     
-    if (!in_mst || !key || !parent) {
-        free(in_mst); free(key); free(parent);
-        for (int i = 0; i < n; i++) free(weight_matrix[i]);
-        free(weight_matrix);
-        return 0;
+    return ok;
+}
+
+/**
+ * Prim's algorithm over the adjacency lists: O((n + m) log m) instead of
+ * O(n^2), and no n x n matrix, which pays off on sparse graphs.
+ */
+int graph_mst_prim_list_ws(const Graph* g, MST_Result* result, AlgorithmWorkspace* ws) {
+    if (!g || !result || g->n < 1) return 0;
+    
+    int n = g->n;
+    
+    result->edges = NULL;
+    result->num_edges = 0;
+    result->total_weight = 0;
+    result->is_connected = 0;
+    
+    if (n == 1) {
+        result->is_connected = 1;
+        return 1;
     }
     
-    // Initialize arrays
-    for (int i = 0; i < n; i++) {
-        key[i] = INT_MAX;
-        parent[i] = -1;
+    // Every adjacency node can push at most once, plus the root
+    int heap_capacity = 1;
+    for (int u = 0; u < n; u++) {
+        for (EdgeNode* edge = g->adj[u].head; edge; edge = edge->next) heap_capacity++;
     }
-    key[0] = 0; // Start from vertex 0
     
-    PriorityQueue* pq = pq_create(n * n); // Generous capacity
-    if (!pq) {
-        free(in_mst); free(key); free(parent);
-        for (int i = 0; i < n; i++) free(weight_matrix[i]);
-        free(weight_matrix);
-        return 0;
+    AlgorithmWorkspace local;
+    if (!ws) {
+        if (!workspace_init(&local, 0)) return 0;
+        ws = &local;
     }
+    WorkspaceMark mark = workspace_mark(ws);
     
-    pq_push(pq, 0, 0); // {weight=0, vertex=0}
+    int* in_mst = (int*)workspace_calloc(ws, n, sizeof(int));
+    int* key = (int*)workspace_alloc(ws, n * sizeof(int));
+    int* parent = (int*)workspace_alloc(ws, n * sizeof(int));
+    PQ_Node* heap = (PQ_Node*)workspace_alloc(ws, (size_t)heap_capacity * sizeof(PQ_Node));
     
-    // Prim's main loop
-    while (!pq_is_empty(pq)) {
-        PQ_Node current = pq_pop(pq);
-        int u = current.vertex;
-        
-        if (in_mst[u]) continue; // Already in MST
+    int ok = in_mst && key && parent && heap;
+    int vertices_in_mst = 0;
+    if (ok) {
+        for (int i = 0; i < n; i++) {
+            key[i] = INT_MAX;
+            parent[i] = -1;
+        }
+        key[0] = 0;
         
-        in_mst[u] = 1;
+        PriorityQueue pq;
+        pq_init(&pq, heap, heap_capacity);
+        pq_push(&pq, 0, 0);
         
-        // Update keys of adjacent vertices using actual edge weights
-        for (int v = 0; v < n; v++) {
-            int weight = weight_matrix[u][v];
-            if (weight > 0 && !in_mst[v] && weight < key[v]) {
-                key[v] = weight;
-                parent[v] = u;
-                pq_push(pq, weight, v);
+        while (!pq_is_empty(&pq)) {
+            PQ_Node current = pq_pop(&pq);
+            int u = current.vertex;
+            
+            if (in_mst[u]) continue;
+            
+            in_mst[u] = 1;
+            vertices_in_mst++;
+            
+            // Same edge rules as the matrix version: positive weights, no self-loops
+            for (EdgeNode* edge = g->adj[u].head; edge; edge = edge->next) {
+                int v = edge->to;
+                int weight = edge->weight;
+                if (v != u && weight > 0 && !in_mst[v] && weight < key[v]) {
+                    key[v] = weight;
+                    parent[v] = u;
+                    pq_push(&pq, weight, v);
+                }
             }
         }
+        
+        result->is_connected = (vertices_in_mst == n);
     }
     
-    // Check if all vertices are reachable (graph is connected)
-    int vertices_in_mst = 0;
-    for (int i = 0; i < n; i++) {
-        if (in_mst[i]) vertices_in_mst++;
+    if (ok && result->is_connected) {
+        result->edges = (MST_Edge*)GRAPH_MALLOC((n-1) * sizeof(MST_Edge));
+        if (!result->edges) {
+            result->is_connected = 0;
+            ok = 0;
+        }
     }
     
-    if (vertices_in_mst != n) {
-        // Graph is not connected
-        result->is_connected = 0;
-        pq_destroy(pq);
-        free(in_mst); free(key); free(parent);
-        for (int i = 0; i < n; i++) free(weight_matrix[i]);
-        free(weight_matrix);
-        return 1; // Success, but no spanning tree
+    if (ok && result->is_connected) {
+        int edge_count = 0;
+        long long total_weight = 0;
+        
+        for (int v = 1; v < n; v++) {
+            if (parent[v] != -1) {
+                result->edges[edge_count].u = parent[v];
+                result->edges[edge_count].v = v;
+                result->edges[edge_count].weight = key[v];
+                total_weight += key[v];
+                edge_count++;
+            }
+        }
+        
+        result->num_edges = edge_count;
+        result->total_weight = total_weight;
     }
     
-    result->is_connected = 1;
+    workspace_release(ws, mark);
+    if (ws == &local) workspace_destroy(&local);
     
-    // Build MST edges array
-    result->edges = (MST_Edge*)malloc((n-1) * sizeof(MST_Edge));
-    if (!result->edges) {
-        pq_destroy(pq);
-        free(in_mst); free(key); free(parent);
-        for (int i = 0; i < n; i++) free(weight_matrix[i]);
-        free(weight_matrix);
-        return 0;
+    return ok;
+}
+
+/**
+ * Run the MST variant selected in @p params (the matrix version by default).
+ */
+int graph_mst_with_params(const Graph* g, const AlgorithmParams* params,
+                          MST_Result* result, AlgorithmWorkspace* ws) {
+    if (!g || !result) return 0;
+    
+    // A disconnected graph has no spanning tree: answer before building the matrix
+    GraphComponents cc;
+    WorkspaceMark mark = ws ? workspace_mark(ws) : (WorkspaceMark){0};
+    int disconnected = graph_connected_components_ws(g, params ? params->num_threads : 1, &cc, ws) &&
+                       cc.num_components > 1;
+    if (ws) {
+        workspace_release(ws, mark);
+    } else {
+        graph_components_free(&cc);
     }
-    
-    int edge_count = 0;
-    int total_weight = 0;
-    
-    for (int v = 1; v < n; v++) { // Skip vertex 0 (root)
-        if (parent[v] != -1) {
-            result->edges[edge_count].u = parent[v];
-            result->edges[edge_count].v = v;
-            result->edges[edge_count].weight = weight_matrix[parent[v]][v];
-            total_weight += weight_matrix[parent[v]][v];
-            edge_count++;
-        }
+    if (disconnected) {
+        result->edges = NULL;
+        result->num_edges = 0;
+        result->total_weight = 0;
+        result->is_connected = 0;
+        return 1;
     }
     
-    result->num_edges = edge_count;
-    result->total_weight = total_weight;
-    
-    // Cleanup
-    pq_destroy(pq);
-    free(in_mst); free(key); free(parent);
-    for (int i = 0; i < n; i++) free(weight_matrix[i]);
-    free(weight_matrix);
-    
-    return 1;
+    if (params && params->variant == ALGO_VARIANT_PRIM_LIST) {
+        return graph_mst_prim_list_ws(g, result, ws);
+    }
+    return graph_mst_prim_ws(g, result, ws);
 }
 
 /**
@@ -288,7 +398,7 @@ void graph_print_mst(const Graph* g) {
     }
     
     printf("Minimum Spanning Tree:\n");
-    printf("Total weight: %d\n", result.total_weight);
+    printf("Total weight: %lld\n", result.total_weight);
     printf("Edges in MST:\n");
     
     for (int i = 0; i < result.num_edges; i++) {
@@ -304,7 +414,7 @@ void graph_print_mst(const Graph* g) {
  */
 void mst_result_free(MST_Result* result) {
     if (result && result->edges) {
-        free(result->edges);
+        GRAPH_FREE(result->edges);
         result->edges = NULL;
         result->num_edges = 0;
     }
@@ -313,7 +423,7 @@ void mst_result_free(MST_Result* result) {
 /**
  * Get MST total weight only (simpler interface).
  */
-int graph_mst_weight(const Graph* g, int* total_weight) {
+int graph_mst_weight(const Graph* g, long long* total_weight) {
     if (!g || !total_weight) return 0;
     
     MST_Result result;
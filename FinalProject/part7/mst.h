@@ -2,6 +2,8 @@
 #define MST_H
 
 #include "graph.h"
+#include "workspace.h"
+#include "algorithm_params.h"
 
 /**
  * @file mst.h
@@ -24,10 +26,10 @@ typedef struct {
  * MST Result structure
  */
 typedef struct {
-    MST_Edge* edges;  // Array of MST edges
-    int num_edges;    // Number of edges in MST
-    int total_weight; // Total weight of MST
-    int is_connected; // 1 if graph is connected, 0 otherwise
+    MST_Edge* edges;        // Array of MST edges
+    int num_edges;          // Number of edges in MST
+    long long total_weight; // Total weight of MST (can exceed INT_MAX)
+    int is_connected;       // 1 if graph is connected, 0 otherwise
 } MST_Result;
 
 /**
@@ -40,6 +42,36 @@ typedef struct {
  */
 int graph_mst_prim(const Graph* g, MST_Result* result);
 
+/**
+ * Same as graph_mst_prim(), taking all scratch memory from @p ws.
+ * 
+ * @param g Graph pointer
+ * @param result OUT: MST result structure (edges are heap-allocated)
+ * @param ws Workspace to use, or NULL for a temporary one
+ * @return 1 on success, 0 on failure
+ */
+int graph_mst_prim_ws(const Graph* g, MST_Result* result, AlgorithmWorkspace* ws);
+
+/**
+ * Prim's algorithm over the adjacency lists (no n x n matrix).
+ * Same result contract as graph_mst_prim_ws(); better on sparse graphs.
+ * 
+ * @param ws Workspace to use, or NULL for a temporary one
+ * @return 1 on success, 0 on failure
+ */
+int graph_mst_prim_list_ws(const Graph* g, MST_Result* result, AlgorithmWorkspace* ws);
+
+/**
+ * Run the MST variant requested in @p params->variant
+ * (ALGO_VARIANT_PRIM_LIST, otherwise the matrix version).
+ * 
+ * @param params Parameters, or NULL for the matrix version
+ * @param ws Workspace to use, or NULL for a temporary one
+ * @return 1 on success, 0 on failure
+ */
+int graph_mst_with_params(const Graph* g, const AlgorithmParams* params,
+                          MST_Result* result, AlgorithmWorkspace* ws);
+
 /**
  * Print MST result in a formatted way.
  * 
@@ -61,6 +93,6 @@ void mst_result_free(MST_Result* result);
  * @param total_weight OUT: pointer to store total weight
  * @return 1 on success, 0 on failure
  */
-int graph_mst_weight(const Graph* g, int* total_weight);
+int graph_mst_weight(const Graph* g, long long* total_weight);
 
 #endif /* MST_H */
\ No newline at end of file
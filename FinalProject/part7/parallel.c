@@ -0,0 +1,73 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L   // pthread_barrier_t
+#endif
+#include "parallel.h"
+
+/**
+ * What a started thread needs: its task, and the gate to wait at.
+ */
+typedef struct {
+    ParallelTeam* team;
+    void* (*fn)(void*);
+    void* task;
+} ParallelMember;
+
+static void* parallel_member(void* arg) {
+    ParallelMember* m = (ParallelMember*)arg;
+    ParallelTeam* team = m->team;
+
+    // The barriers need every thread, so wait until all were created
+    pthread_mutex_lock(&team->start_mutex);
+    while (team->start == 0) pthread_cond_wait(&team->start_cond, &team->start_mutex);
+    int run = team->start > 0;
+    pthread_mutex_unlock(&team->start_mutex);
+
+    if (run) m->fn(m->task);
+    return NULL;
+}
+
+int parallel_run(ParallelTeam* team, int num_threads, void* (*fn)(void*), void* tasks,
+                 size_t stride) {
+    team->num_threads = num_threads > 1 ? num_threads : 1;
+    if (num_threads <= 1) {
+        fn(tasks);
+        return 1;
+    }
+    if (num_threads > PARALLEL_MAX_THREADS ||
+        pthread_barrier_init(&team->barrier, NULL, (unsigned)num_threads) != 0) {
+        return 0;
+    }
+    pthread_mutex_init(&team->start_mutex, NULL);
+    pthread_cond_init(&team->start_cond, NULL);
+    team->start = 0;
+
+    ParallelMember members[PARALLEL_MAX_THREADS];
+    pthread_t threads[PARALLEL_MAX_THREADS];
+    int started = 1;
+    while (started < num_threads) {
+        members[started].team = team;
+        members[started].fn = fn;
+        members[started].task = (char*)tasks + (size_t)started * stride;
+        if (pthread_create(&threads[started], NULL, parallel_member, &members[started]) != 0) {
+            break;
+        }
+        started++;
+    }
+
+    // Too few threads for the barrier count: send them home
+    pthread_mutex_lock(&team->start_mutex);
+    team->start = started == num_threads ? 1 : -1;
+    pthread_cond_broadcast(&team->start_cond);
+    pthread_mutex_unlock(&team->start_mutex);
+
+    if (team->start > 0) fn(tasks);
+    for (int i = 1; i < started; i++) pthread_join(threads[i], NULL);
+    pthread_barrier_destroy(&team->barrier);
+    pthread_mutex_destroy(&team->start_mutex);
+    pthread_cond_destroy(&team->start_cond);
+    return team->start > 0;
+}
+
+void parallel_sync(ParallelTeam* team) {
+    if (team->num_threads > 1) pthread_barrier_wait(&team->barrier);
+}
@@ -0,0 +1,48 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stddef.h>
+#include <pthread.h>
+
+/**
+ * @file parallel.h
+ * Fixed teams of threads that meet at barriers.
+ *
+ * The parallel algorithms (components, BFS, SSSP, coloring) run one task
+ * per thread, and the tasks wait for each other at a barrier between
+ * phases. A barrier counts every thread, so a team only starts once all of
+ * its threads exist: if one cannot be created, the others are sent home
+ * before doing any work and parallel_run() reports it, so the caller can
+ * run the algorithm on one thread instead.
+ *
+ * Include this after defining _POSIX_C_SOURCE 200809L (pthread_barrier_t).
+ */
+
+#define PARALLEL_MAX_THREADS 64
+
+/**
+ * Barrier and start gate of one team (embed it in the shared state).
+ */
+typedef struct {
+    int num_threads;
+    pthread_barrier_t barrier;
+    pthread_mutex_t start_mutex;
+    pthread_cond_t start_cond;
+    int start;                 // 0 = wait, 1 = run, -1 = give up
+} ParallelTeam;
+
+/**
+ * Run @p fn on @p num_threads tasks, one thread each; the caller runs task 0.
+ * Task i is at @p tasks + i * @p stride bytes. Returns once every task is done.
+ * @return 1 if the tasks ran, 0 if the threads could not be set up (no task
+ *         ran; the caller falls back to one thread). One thread always runs.
+ */
+int parallel_run(ParallelTeam* team, int num_threads, void* (*fn)(void*), void* tasks,
+                 size_t stride);
+
+/**
+ * Wait until every thread of the team gets here (no-op for one thread).
+ */
+void parallel_sync(ParallelTeam* team);
+
+#endif /* PARALLEL_H */
@@ -0,0 +1,172 @@
+#define _GNU_SOURCE
+#include "perfcounters.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+static const char* event_names[PERF_EV_COUNT] = {
+    "cycles", "instructions", "cache_misses", "branch_misses"
+};
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+const char* perf_event_name(PerfEvent ev) {
+    return (ev >= 0 && ev < PERF_EV_COUNT) ? event_names[ev] : "unknown";
+}
+
+#ifdef __linux__
+
+static const unsigned long long event_configs[PERF_EV_COUNT] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+/**
+ * Open a single user-space hardware counter for the calling thread.
+ */
+static int open_event(unsigned long long config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0 /* this thread */, -1, -1, 0);
+}
+
+int perf_counters_open(PerfCounters* pc) {
+    if (!pc) return 0;
+    int available = 0;
+    for (int i = 0; i < PERF_EV_COUNT; i++) {
+        pc->fds[i] = open_event(event_configs[i]);
+        if (pc->fds[i] >= 0) available = 1;
+    }
+    pc->start_ns = 0.0;
+    return available;
+}
+
+void perf_counters_start(PerfCounters* pc) {
+    if (!pc) return;
+    for (int i = 0; i < PERF_EV_COUNT; i++) {
+        if (pc->fds[i] < 0) continue;
+        ioctl(pc->fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(pc->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+    pc->start_ns = now_ns();
+}
+
+void perf_counters_stop(PerfCounters* pc, PerfSample* out) {
+    double end = now_ns();
+    if (!pc || !out) return;
+    memset(out, 0, sizeof(*out));
+
+    for (int i = 0; i < PERF_EV_COUNT; i++) {
+        if (pc->fds[i] < 0) continue;
+        ioctl(pc->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+        unsigned long long buf[3]; // value, time_enabled, time_running
+        if (read(pc->fds[i], buf, sizeof(buf)) != (ssize_t)sizeof(buf)) continue;
+        if (buf[2] == 0) continue; // never scheduled on the PMU
+
+        // Scale up if the kernel multiplexed the counter
+        double scale = buf[2] < buf[1] ? (double)buf[1] / (double)buf[2] : 1.0;
+        out->values[i] = (unsigned long long)((double)buf[0] * scale);
+        out->valid_mask |= 1u << i;
+    }
+    out->wall_ns = end - pc->start_ns;
+    out->calls = 1;
+}
+
+void perf_counters_close(PerfCounters* pc) {
+    if (!pc) return;
+    for (int i = 0; i < PERF_EV_COUNT; i++) {
+        if (pc->fds[i] >= 0) close(pc->fds[i]);
+        pc->fds[i] = -1;
+    }
+}
+
+#else /* !__linux__ */
+
+int perf_counters_open(PerfCounters* pc) {
+    if (!pc) return 0;
+    for (int i = 0; i < PERF_EV_COUNT; i++) pc->fds[i] = -1;
+    pc->start_ns = 0.0;
+    return 0;
+}
+
+void perf_counters_start(PerfCounters* pc) {
+    if (pc) pc->start_ns = now_ns();
+}
+
+void perf_counters_stop(PerfCounters* pc, PerfSample* out) {
+    double end = now_ns();
+    if (!pc || !out) return;
+    memset(out, 0, sizeof(*out));
+    out->wall_ns = end - pc->start_ns;
+    out->calls = 1;
+}
+
+void perf_counters_close(PerfCounters* pc) {
+    (void)pc;
+}
+
+#endif /* __linux__ */
+
+void perf_sample_add(PerfSample* acc, const PerfSample* s) {
+    if (!acc || !s) return;
+    unsigned int mask = acc->calls ? (acc->valid_mask & s->valid_mask) : s->valid_mask;
+    for (int i = 0; i < PERF_EV_COUNT; i++) {
+        acc->values[i] = (mask & (1u << i)) ? acc->values[i] + s->values[i] : 0;
+    }
+    acc->valid_mask = mask;
+    acc->wall_ns += s->wall_ns;
+    acc->calls += s->calls;
+}
+
+int perf_sample_format(const PerfSample* s, char* buf, size_t len) {
+    if (!s || !buf || len == 0) return 0;
+    double calls = s->calls ? (double)s->calls : 1.0;
+    int off = snprintf(buf, len, "wall=%.0fns", s->wall_ns / calls);
+
+    for (int i = 0; i < PERF_EV_COUNT; i++) {
+        if (!(s->valid_mask & (1u << i)) || off >= (int)len) continue;
+        off += snprintf(buf + off, len - (size_t)off, " %s=%.0f",
+                        event_names[i], (double)s->values[i] / calls);
+    }
+
+    unsigned int need_ipc = (1u << PERF_EV_CYCLES) | (1u << PERF_EV_INSTRUCTIONS);
+    if ((s->valid_mask & need_ipc) == need_ipc && s->values[PERF_EV_CYCLES] && off < (int)len) {
+        off += snprintf(buf + off, len - (size_t)off, " ipc=%.2f",
+                        (double)s->values[PERF_EV_INSTRUCTIONS] / (double)s->values[PERF_EV_CYCLES]);
+    }
+    if ((s->valid_mask & (1u << PERF_EV_INSTRUCTIONS)) && s->values[PERF_EV_INSTRUCTIONS]) {
+        double kinstr = (double)s->values[PERF_EV_INSTRUCTIONS] / 1000.0;
+        if ((s->valid_mask & (1u << PERF_EV_CACHE_MISSES)) && off < (int)len) {
+            off += snprintf(buf + off, len - (size_t)off, " cache_mpki=%.2f",
+                            (double)s->values[PERF_EV_CACHE_MISSES] / kinstr);
+        }
+        if ((s->valid_mask & (1u << PERF_EV_BRANCH_MISSES)) && off < (int)len) {
+            off += snprintf(buf + off, len - (size_t)off, " branch_mpki=%.2f",
+                            (double)s->values[PERF_EV_BRANCH_MISSES] / kinstr);
+        }
+    }
+    if (off >= (int)len) off = (int)len - 1;
+    return off;
+}
@@ -0,0 +1,87 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <stddef.h>
+
+/**
+ * @file perfcounters.h
+ * Optional hardware performance counter instrumentation (Linux perf_event_open).
+ *
+ * Counts cycles, instructions, cache misses and branch misses of the calling
+ * thread between perf_counters_start() and perf_counters_stop(). Each event is
+ * opened independently, so a host that lacks one event (common in VMs) still
+ * reports the others. On non-Linux hosts, or when the kernel refuses access
+ * (see /proc/sys/kernel/perf_event_paranoid), only wall time is recorded.
+ */
+
+typedef enum {
+    PERF_EV_CYCLES = 0,
+    PERF_EV_INSTRUCTIONS,
+    PERF_EV_CACHE_MISSES,
+    PERF_EV_BRANCH_MISSES,
+    PERF_EV_COUNT
+} PerfEvent;
+
+/**
+ * One measurement (or an accumulation of several).
+ */
+typedef struct {
+    unsigned long long values[PERF_EV_COUNT]; // Event counts, indexed by PerfEvent
+    unsigned int valid_mask;                  // Bit i set if values[i] was measured
+    double wall_ns;                           // Elapsed wall time
+    unsigned long long calls;                 // Number of measurements accumulated
+} PerfSample;
+
+/**
+ * Per-thread counter set. Counters measure the thread that opened them.
+ */
+typedef struct {
+    int fds[PERF_EV_COUNT];   // -1 if the event is unavailable
+    double start_ns;
+} PerfCounters;
+
+/**
+ * Open the counters for the calling thread.
+ * @param pc Counter set to initialize.
+ * @return 1 if at least one hardware counter is available, 0 if only wall time is.
+ */
+int perf_counters_open(PerfCounters* pc);
+
+/**
+ * Reset and enable the counters.
+ * @param pc Counter set (from perf_counters_open).
+ */
+void perf_counters_start(PerfCounters* pc);
+
+/**
+ * Disable the counters and read them.
+ * @param pc Counter set.
+ * @param out OUT: measurement since the matching perf_counters_start().
+ */
+void perf_counters_stop(PerfCounters* pc, PerfSample* out);
+
+/**
+ * Release the counters (safe to call on a set that failed to open).
+ * @param pc Counter set.
+ */
+void perf_counters_close(PerfCounters* pc);
+
+/**
+ * Add @p s into @p acc (events missing from either side are dropped).
+ * An all-zero @p acc is a valid empty accumulator.
+ */
+void perf_sample_add(PerfSample* acc, const PerfSample* s);
+
+/**
+ * Format a sample as per-call averages plus IPC and misses per 1000
+ * instructions, e.g. "cycles=1200 instr=2400 ipc=2.00 cache-mpki=1.2 ...".
+ * @return Number of characters written (as snprintf).
+ */
+int perf_sample_format(const PerfSample* s, char* buf, size_t len);
+
+/**
+ * Short event name ("cycles", "instructions", "cache_misses", "branch_misses").
+ */
+const char* perf_event_name(PerfEvent ev);
+
+#endif /* PERFCOUNTERS_H */
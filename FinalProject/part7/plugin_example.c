@@ -0,0 +1,52 @@
+/**
+ * @file plugin_example.c
+ * Example strategy plugin: adds algorithm 10, degree statistics.
+ *
+ * Build with `make plugins`, then start a server with
+ * GRAPH_PLUGINS=./plugin_example.so. After rebuilding the .so, send the
+ * server SIGHUP to switch to the new code.
+ *
+ * The plugin is loaded with RTLD_LOCAL and cannot call into the server;
+ * anything beyond the Graph structure has to be linked into the .so.
+ */
+#include "strategy_plugin.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static char* degrees_execute(const Graph* g, const AlgorithmParams* params,
+                             AlgorithmWorkspace* ws) {
+    (void)ws;
+    char* result = (char*)malloc(160);
+    if (!result) return NULL;
+
+    long long total = 0;
+    int min_degree = -1, max_degree = -1, max_vertex = 0;
+    for (int v = 0; v < g->n; v++) {
+        int degree = 0;
+        for (EdgeNode* e = g->adj[v].head; e; e = e->next) degree++;
+        total += degree;
+        if (min_degree < 0 || degree < min_degree) min_degree = degree;
+        if (degree > max_degree) {
+            max_degree = degree;
+            max_vertex = v;
+        }
+    }
+
+    // Report the vertex under the id the client sent
+    if (params && params->original_ids) max_vertex = params->original_ids[max_vertex];
+    snprintf(result, 160, "Degrees: min %d, max %d (vertex %d), average %.2f",
+             min_degree, max_degree, max_vertex, g->n ? (double)total / g->n : 0.0);
+    return result;
+}
+
+static const AlgorithmStrategy example_strategies[] = {
+    {degrees_execute, "degrees", "Degree Statistics (plugin example)", 10}
+};
+
+const StrategyPlugin graph_strategy_plugin = {
+    STRATEGY_PLUGIN_ABI_VERSION,
+    sizeof(AlgorithmParams),
+    "plugin_example",
+    example_strategies,
+    1
+};
@@ -0,0 +1,165 @@
+#define _POSIX_C_SOURCE 200809L
+#include "request_trace.h"
+#include "graph_alloc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+
+#define TRACE_MAGIC "GRTR"
+#define TRACE_VERSION 1
+#define TRACE_MAX_RECORD (64u * 1024 * 1024)
+
+struct RequestTrace {
+    FILE* file;
+    pthread_mutex_t lock;
+    struct timespec start;
+    long long records;
+};
+
+static unsigned long long elapsed_ns(const struct timespec* from) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)(now.tv_sec - from->tv_sec) * 1000000000ULL +
+           (unsigned long long)now.tv_nsec - (unsigned long long)from->tv_nsec;
+}
+
+RequestTrace* request_trace_open(const char* path) {
+    if (!path) return NULL;
+    RequestTrace* trace = (RequestTrace*)GRAPH_CALLOC(1, sizeof(RequestTrace));
+    if (!trace) return NULL;
+    trace->file = fopen(path, "wb");
+    if (!trace->file) {
+        GRAPH_FREE(trace);
+        return NULL;
+    }
+    pthread_mutex_init(&trace->lock, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &trace->start);
+
+    struct timespec wall;
+    clock_gettime(CLOCK_REALTIME, &wall);
+    uint32_t version = TRACE_VERSION;
+    uint64_t start_ns = (uint64_t)wall.tv_sec * 1000000000ULL + (uint64_t)wall.tv_nsec;
+    if (fwrite(TRACE_MAGIC, 4, 1, trace->file) != 1 ||
+        fwrite(&version, sizeof(version), 1, trace->file) != 1 ||
+        fwrite(&start_ns, sizeof(start_ns), 1, trace->file) != 1 || fflush(trace->file) != 0) {
+        request_trace_close(trace);
+        return NULL;
+    }
+    return trace;
+}
+
+unsigned long long request_trace_clock(const RequestTrace* trace) {
+    return trace ? elapsed_ns(&trace->start) : 0;
+}
+
+int request_trace_record(RequestTrace* trace, unsigned long long arrival_ns,
+                         const void* head, size_t head_len, const void* tail, size_t tail_len) {
+    if (!trace || head_len + tail_len > TRACE_MAX_RECORD) return 0;
+    uint64_t arrival = arrival_ns;
+    uint32_t length = (uint32_t)(head_len + tail_len);
+
+    pthread_mutex_lock(&trace->lock);
+    int ok = fwrite(&arrival, sizeof(arrival), 1, trace->file) == 1 &&
+             fwrite(&length, sizeof(length), 1, trace->file) == 1 &&
+             (head_len == 0 || fwrite(head, head_len, 1, trace->file) == 1) &&
+             (tail_len == 0 || fwrite(tail, tail_len, 1, trace->file) == 1) &&
+             fflush(trace->file) == 0;
+    if (ok) trace->records++;
+    pthread_mutex_unlock(&trace->lock);
+    return ok;
+}
+
+long long request_trace_close(RequestTrace* trace) {
+    if (!trace) return 0;
+    long long records = trace->records;
+    fclose(trace->file);
+    pthread_mutex_destroy(&trace->lock);
+    GRAPH_FREE(trace);
+    return records;
+}
+
+static int by_arrival(const void* a, const void* b) {
+    const TraceRecord* x = (const TraceRecord*)a;
+    const TraceRecord* y = (const TraceRecord*)b;
+    if (x->arrival_ns != y->arrival_ns) return x->arrival_ns < y->arrival_ns ? -1 : 1;
+    // Same arrival: keep file order (records were appended in order)
+    return x->data < y->data ? -1 : x->data > y->data;
+}
+
+int request_trace_load(const char* path, TraceRecord** records, size_t* count) {
+    if (!path || !records || !count) return 0;
+    *records = NULL;
+    *count = 0;
+    FILE* f = fopen(path, "rb");
+    if (!f) return 0;
+
+    char magic[4];
+    uint32_t version;
+    uint64_t start_ns;
+    if (fread(magic, 4, 1, f) != 1 || memcmp(magic, TRACE_MAGIC, 4) != 0 ||
+        fread(&version, sizeof(version), 1, f) != 1 || version != TRACE_VERSION ||
+        fread(&start_ns, sizeof(start_ns), 1, f) != 1) {
+        fclose(f);
+        return 0;
+    }
+
+    // All payloads share one block so the sort tie-break can use addresses
+    long header_end = ftell(f);
+    fseek(f, 0, SEEK_END);
+    long file_size = ftell(f);
+    fseek(f, header_end, SEEK_SET);
+    size_t payload_cap = file_size > header_end ? (size_t)(file_size - header_end) : 1;
+    char* payload = (char*)GRAPH_MALLOC(payload_cap);
+
+    size_t cap = 0, n = 0, used = 0;
+    TraceRecord* list = NULL;
+    int ok = payload != NULL;
+    while (ok) {
+        uint64_t arrival;
+        uint32_t length;
+        if (fread(&arrival, sizeof(arrival), 1, f) != 1 ||
+            fread(&length, sizeof(length), 1, f) != 1 || length > payload_cap - used ||
+            (length > 0 && fread(payload + used, length, 1, f) != 1)) {
+            break;
+        }
+        if (n == cap) {
+            cap = cap ? cap * 2 : 256;
+            TraceRecord* grown = (TraceRecord*)GRAPH_REALLOC(list, cap * sizeof(TraceRecord));
+            if (!grown) {
+                ok = 0;
+                break;
+            }
+            list = grown;
+        }
+        list[n].arrival_ns = arrival;
+        list[n].length = length;
+        list[n].data = payload + used;
+        used += length;
+        n++;
+    }
+    fclose(f);
+
+    if (!ok || n == 0) {
+        GRAPH_FREE(list);
+        GRAPH_FREE(payload);
+        return ok;
+    }
+    qsort(list, n, sizeof(TraceRecord), by_arrival);
+    *records = list;
+    *count = n;
+    return 1;
+}
+
+void request_trace_free_records(TraceRecord* records, size_t count) {
+    if (!records) return;
+    // The payloads are one block, starting at the lowest data pointer
+    char* block = records[0].data;
+    for (size_t i = 1; i < count; i++) {
+        if (records[i].data < block) block = records[i].data;
+    }
+    GRAPH_FREE(block);
+    GRAPH_FREE(records);
+}
@@ -0,0 +1,69 @@
+#ifndef REQUEST_TRACE_H
+#define REQUEST_TRACE_H
+
+#include <stddef.h>
+
+/**
+ * @file request_trace.h
+ * Binary traces of server requests, for replaying real load.
+ *
+ * A trace file is a header followed by one record per request:
+ *
+ *   header: "GRTR" | u32 version (1) | u64 start time (ns since the epoch)
+ *   record: u64 arrival (ns since the start) | u32 length | request bytes
+ *
+ * The request bytes are what the client sent, exactly as read (parameter
+ * blocks and batch payloads included). Integers are in host byte order,
+ * like the wire protocol. Records are appended as requests are read, so
+ * concurrent requests may be slightly out of arrival order;
+ * request_trace_load() sorts them.
+ */
+
+typedef struct RequestTrace RequestTrace;
+
+/**
+ * One recorded request.
+ */
+typedef struct {
+    unsigned long long arrival_ns;  // Since the start of the trace
+    size_t length;
+    char* data;
+} TraceRecord;
+
+/**
+ * Create @p path and write the header. The trace clock starts now.
+ * @return The trace, or NULL if the file cannot be written
+ */
+RequestTrace* request_trace_open(const char* path);
+
+/**
+ * Nanoseconds since the trace was opened (take it when the request arrives).
+ */
+unsigned long long request_trace_clock(const RequestTrace* trace);
+
+/**
+ * Append one request made of @p head followed by @p tail (either may be
+ * empty). Thread-safe; each record is flushed, so the trace survives a
+ * server that is killed.
+ * @return 1 on success, 0 on a write error
+ */
+int request_trace_record(RequestTrace* trace, unsigned long long arrival_ns,
+                         const void* head, size_t head_len, const void* tail, size_t tail_len);
+
+/**
+ * Close the file.
+ * @return Records written
+ */
+long long request_trace_close(RequestTrace* trace);
+
+/**
+ * Read every record of @p path, sorted by arrival. A record cut off at
+ * the end of the file (server killed mid-write) is dropped.
+ * @param records OUT: array of @p count records (free with request_trace_free_records)
+ * @return 1 on success, 0 if the file is missing or not a trace
+ */
+int request_trace_load(const char* path, TraceRecord** records, size_t* count);
+
+void request_trace_free_records(TraceRecord* records, size_t count);
+
+#endif /* REQUEST_TRACE_H */
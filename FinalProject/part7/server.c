@@ -1,3 +1,4 @@
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -5,12 +6,17 @@
 #include <sys/socket.h>
 #include <arpa/inet.h>
 #include <errno.h>
+#include <signal.h>
 #include "graph.h"
 #include "factory.h"
+#include "strategy_plugin.h"
 
 #define BUFFER_SIZE 4096
 #define MAX_CLIENTS 10
 
+/* Scratch memory reused by every request (the server is single-threaded) */
+static AlgorithmWorkspace server_workspace;
+
 
 /* Send response back to client */
 static int send_algorithm_response(int client_socket, const char* result) {
@@ -42,7 +48,8 @@ static int send_algorithm_response(int client_socket, const char* result) {
 }
 
 /* Process MST request with weighted edges - FIXED VERSION */
-static int process_mst_weighted_request(int client_socket, int* buffer, int bytes_received) {
+static int process_mst_weighted_request(int client_socket, int* buffer, int bytes_received,
+                                        const AlgorithmParams* params) {
     // Validate minimum data size: [algorithm_id][n][num_edges]
     if (bytes_received < 3 * (int)sizeof(int)) {
         printf("  → Error: MST request too small\n");
@@ -182,7 +189,7 @@ static int process_mst_weighted_request(int client_socket, int* buffer, int byte
     
     // Execute algorithm using Factory + Strategy patterns
     printf("  → Using Factory Pattern to create Strategy and execute\n");
-    char* result = algorithm_factory_execute(g, algorithm_id);
+    char* result = algorithm_factory_execute_params(g, algorithm_id, params, &server_workspace);
     
     if (result) {
         printf("  → MST result: %s\n", result);
@@ -199,7 +206,8 @@ static int process_mst_weighted_request(int client_socket, int* buffer, int byte
 }
 
 /* Process standard unweighted request */
-static int process_unweighted_request(int client_socket, int* buffer, int bytes_received) {
+static int process_unweighted_request(int client_socket, int* buffer, int bytes_received,
+                                      const AlgorithmParams* params) {
     // Validate minimum data size: [algorithm_id][n]
     if (bytes_received < 2 * (int)sizeof(int)) {
         printf("  → Error: Request too small\n");
@@ -254,7 +262,7 @@ static int process_unweighted_request(int client_socket, int* buffer, int bytes_
     
     // Execute algorithm using Factory + Strategy patterns
     printf("  → Using Factory Pattern to create Strategy and execute\n");
-    char* result = algorithm_factory_execute(g, algorithm_id);
+    char* result = algorithm_factory_execute_params(g, algorithm_id, params, &server_workspace);
     
     if (result) {
         printf("  → Algorithm result: %s\n", result);
@@ -280,19 +288,53 @@ static int process_algorithm_request(int client_socket, int* buffer, int bytes_r
     
     int algorithm_id = buffer[0];
     
+    // Optional parameter block: [id | ALGO_PARAMS_FLAG][source][sink][k][budget_ms][threads][variant][n]...
+    AlgorithmParams params;
+    algorithm_params_init(&params);
+    if (algorithm_id > 0 && (algorithm_id & ALGO_PARAMS_FLAG)) {
+        if (bytes_received < (1 + ALGO_PARAMS_WIRE_INTS) * (int)sizeof(int)) {
+            printf("  → Error: Incomplete parameter block\n");
+            send_algorithm_response(client_socket, NULL);
+            return -1;
+        }
+        algorithm_params_decode(&params, buffer + 1);
+        algorithm_id &= ~ALGO_PARAMS_FLAG;
+        
+        // Drop the block so the handlers see the plain request layout
+        buffer += ALGO_PARAMS_WIRE_INTS;
+        bytes_received -= ALGO_PARAMS_WIRE_INTS * (int)sizeof(int);
+        buffer[0] = algorithm_id;
+        printf("  → Parameters: source=%d sink=%d k=%d budget=%dms threads=%d\n",
+               params.source, params.sink, params.clique_size,
+               params.time_budget_ms, params.num_threads);
+    }
+    
     // Validate algorithm ID
-    if (algorithm_id < 1 || algorithm_id > 5) {
+    // IDs above 9 are accepted when a loaded plugin provides them
+    int builtin = algorithm_id >= 1 && algorithm_id <= 9;
+    if (!builtin && !algorithm_get_strategy(algorithm_id)) {
         printf("  → Error: Invalid algorithm ID: %d\n", algorithm_id);
         send_algorithm_response(client_socket, NULL);
         return -1;
     }
     
     // Route to appropriate handler based on algorithm
-    if (algorithm_id == 2 || algorithm_id == 3) { // Max Flow or MST - use weighted protocol
-        return process_mst_weighted_request(client_socket, buffer, bytes_received);
+    int status;
+    if (algorithm_id == 2 || algorithm_id == 3 || algorithm_id >= 6) { // Max Flow, MST, SSSP, hops, weighted clique, coloring or plugin - use weighted protocol
+        status = process_mst_weighted_request(client_socket, buffer, bytes_received, &params);
     } else { // Others - use unweighted protocol
-        return process_unweighted_request(client_socket, buffer, bytes_received);
+        status = process_unweighted_request(client_socket, buffer, bytes_received, &params);
     }
+    
+    // Keep the scratch memory, sized for the largest request so far
+    workspace_reset(&server_workspace);
+    return status;
+}
+
+/* SIGHUP: reload the strategy plugins before the next request */
+static void reload_handler(int sig) {
+    (void)sig;
+    strategy_plugins_request_reload();
 }
 
 /* Handle single client connection */
@@ -347,12 +389,25 @@ int main(int argc, char* argv[]) {
     struct sockaddr_in address;
     int opt = 1;
     
+    if (!workspace_init(&server_workspace, 0)) {
+        printf("Error: Failed to initialize algorithm workspace\n");
+        return 1;
+    }
+    
     printf("=== Enhanced Graph Algorithm Server (Factory + Strategy) ===\n");
     printf("Starting server on port %d...\n", port);
     
     // Print available algorithms using Factory
     algorithm_factory_print_available();
     
+    // SIGHUP reloads the strategy plugins between requests
+    struct sigaction reload_action;
+    memset(&reload_action, 0, sizeof(reload_action));
+    reload_action.sa_handler = reload_handler;
+    reload_action.sa_flags = SA_RESTART;
+    sigaction(SIGHUP, &reload_action, NULL);
+    printf("Strategy plugins: %d loaded\n", strategy_plugins_init());
+    
     /* Create socket */
     if ((server_fd = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
         perror("Socket creation failed");
@@ -405,5 +460,6 @@ int main(int argc, char* argv[]) {
     }
     
     close(server_fd);
+    workspace_destroy(&server_workspace);
     return 0;
 }
\ No newline at end of file
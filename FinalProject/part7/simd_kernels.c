@@ -0,0 +1,220 @@
+#include "simd_kernels.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+typedef struct {
+    uint64_t (*and_popcount)(const uint64_t* a, const uint64_t* b, size_t words);
+    size_t (*intersect_count)(const int* a, size_t na, const int* b, size_t nb);
+} SimdKernels;
+
+static const char* const level_names[SIMD_LEVEL_COUNT] = {"scalar", "sse4.2", "avx2", "avx512"};
+
+/* ---------- Portable C ---------- */
+
+static uint64_t and_popcount_scalar(const uint64_t* a, const uint64_t* b, size_t words) {
+    uint64_t count = 0;
+    for (size_t i = 0; i < words; i++) count += (uint64_t)__builtin_popcountll(a[i] & b[i]);
+    return count;
+}
+
+static size_t intersect_count_scalar(const int* a, size_t na, const int* b, size_t nb) {
+    size_t i = 0, j = 0, count = 0;
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            i++;
+        } else if (a[i] > b[j]) {
+            j++;
+        } else {
+            count++;
+            i++;
+            j++;
+        }
+    }
+    return count;
+}
+
+#ifdef SIMD_X86
+
+/* ---------- SSE4.2 ---------- */
+
+__attribute__((target("popcnt")))
+static uint64_t and_popcount_sse42(const uint64_t* a, const uint64_t* b, size_t words) {
+    // Four independent sums keep the popcnt units busy
+    uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= words; i += 4) {
+        c0 += (uint64_t)_mm_popcnt_u64(a[i] & b[i]);
+        c1 += (uint64_t)_mm_popcnt_u64(a[i + 1] & b[i + 1]);
+        c2 += (uint64_t)_mm_popcnt_u64(a[i + 2] & b[i + 2]);
+        c3 += (uint64_t)_mm_popcnt_u64(a[i + 3] & b[i + 3]);
+    }
+    for (; i < words; i++) c0 += (uint64_t)_mm_popcnt_u64(a[i] & b[i]);
+    return c0 + c1 + c2 + c3;
+}
+
+/**
+ * Compare blocks of 4 from each list all against all (the block of b is
+ * rotated through every position), then advance the block whose last value
+ * is smaller. Values are unique in each list, so every match is seen once.
+ * The AVX levels use it too: blocks of 8 were slower on the short neighbor
+ * lists this is called with, as more of each block is wasted.
+ */
+__attribute__((target("sse4.2,popcnt")))
+static size_t intersect_count_sse42(const int* a, size_t na, const int* b, size_t nb) {
+    size_t i = 0, j = 0, count = 0;
+    while (i + 4 <= na && j + 4 <= nb) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + j));
+        __m128i eq = _mm_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 4; r++) {
+            vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+            eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, vb));
+        }
+        count += (size_t)_mm_popcnt_u32((unsigned)_mm_movemask_ps(_mm_castsi128_ps(eq)));
+
+        int a_last = a[i + 3], b_last = b[j + 3];
+        if (a_last <= b_last) i += 4;
+        if (b_last <= a_last) j += 4;
+    }
+    return count + intersect_count_scalar(a + i, na - i, b + j, nb - j);
+}
+
+/* ---------- AVX2 ---------- */
+
+/**
+ * Popcount of 256 bits per step: a 16-entry table lookup per nibble
+ * (vpshufb), summed per 64-bit lane with vpsadbw.
+ */
+__attribute__((target("avx2,popcnt")))
+static uint64_t and_popcount_avx2(const uint64_t* a, const uint64_t* b, size_t words) {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0f);
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= words; i += 4) {
+        __m256i v = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(a + i)),
+                                     _mm256_loadu_si256((const __m256i*)(b + i)));
+        __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(v, low));
+        __m256i hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(_mm256_add_epi8(lo, hi),
+                                                        _mm256_setzero_si256()));
+    }
+
+    uint64_t count = (uint64_t)_mm256_extract_epi64(total, 0) + (uint64_t)_mm256_extract_epi64(total, 1) +
+                     (uint64_t)_mm256_extract_epi64(total, 2) + (uint64_t)_mm256_extract_epi64(total, 3);
+    for (; i < words; i++) count += (uint64_t)_mm_popcnt_u64(a[i] & b[i]);
+    return count;
+}
+
+/* ---------- AVX-512 ---------- */
+
+/**
+ * One vpopcntq per 512 bits; the tail is a masked load, so there is no
+ * scalar loop.
+ */
+__attribute__((target("avx512f,avx512vpopcntdq")))
+static uint64_t and_popcount_avx512(const uint64_t* a, const uint64_t* b, size_t words) {
+    __m512i total = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 8 <= words; i += 8) {
+        __m512i v = _mm512_and_si512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+        total = _mm512_add_epi64(total, _mm512_popcnt_epi64(v));
+    }
+    if (i < words) {
+        __mmask8 tail = (__mmask8)((1u << (words - i)) - 1);
+        __m512i v = _mm512_and_si512(_mm512_maskz_loadu_epi64(tail, a + i),
+                                     _mm512_maskz_loadu_epi64(tail, b + i));
+        total = _mm512_add_epi64(total, _mm512_popcnt_epi64(v));
+    }
+    return (uint64_t)_mm512_reduce_add_epi64(total);
+}
+
+static const SimdKernels kernels[SIMD_LEVEL_COUNT] = {
+    {and_popcount_scalar, intersect_count_scalar},
+    {and_popcount_sse42, intersect_count_sse42},
+    {and_popcount_avx2, intersect_count_sse42},
+    {and_popcount_avx512, intersect_count_sse42},
+};
+
+#else
+
+static const SimdKernels kernels[SIMD_LEVEL_COUNT] = {
+    {and_popcount_scalar, intersect_count_scalar},
+    {and_popcount_scalar, intersect_count_scalar},
+    {and_popcount_scalar, intersect_count_scalar},
+    {and_popcount_scalar, intersect_count_scalar},
+};
+
+#endif /* SIMD_X86 */
+
+/* ---------- Selection ---------- */
+
+static pthread_once_t detect_once = PTHREAD_ONCE_INIT;
+static SimdLevel detected_level = SIMD_LEVEL_SCALAR;
+static SimdLevel active_level = SIMD_LEVEL_SCALAR;
+
+static void detect_level(void) {
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vpopcntdq")) {
+        detected_level = SIMD_LEVEL_AVX512;
+    } else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+        detected_level = SIMD_LEVEL_AVX2;
+    } else if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt")) {
+        detected_level = SIMD_LEVEL_SSE42;
+    }
+#endif
+    active_level = detected_level;
+
+    SimdLevel forced;
+    const char* env = getenv("GRAPH_SIMD");
+    if (env && simd_parse_level(env, &forced) && forced < active_level) active_level = forced;
+}
+
+SimdLevel simd_level(void) {
+    pthread_once(&detect_once, detect_level);
+    return active_level;
+}
+
+SimdLevel simd_detected_level(void) {
+    pthread_once(&detect_once, detect_level);
+    return detected_level;
+}
+
+SimdLevel simd_set_level(SimdLevel level) {
+    pthread_once(&detect_once, detect_level);
+    if (level < SIMD_LEVEL_SCALAR) level = SIMD_LEVEL_SCALAR;
+    active_level = level < detected_level ? level : detected_level;
+    return active_level;
+}
+
+const char* simd_level_name(SimdLevel level) {
+    if (level < SIMD_LEVEL_SCALAR || level >= SIMD_LEVEL_COUNT) return "unknown";
+    return level_names[level];
+}
+
+int simd_parse_level(const char* name, SimdLevel* level) {
+    if (!name || !level) return 0;
+    for (int i = 0; i < SIMD_LEVEL_COUNT; i++) {
+        if (strcmp(name, level_names[i]) == 0) {
+            *level = (SimdLevel)i;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+uint64_t simd_and_popcount(const uint64_t* a, const uint64_t* b, size_t words) {
+    return kernels[simd_level()].and_popcount(a, b, words);
+}
+
+size_t simd_intersect_count(const int* a, size_t na, const int* b, size_t nb) {
+    return kernels[simd_level()].intersect_count(a, na, b, nb);
+}
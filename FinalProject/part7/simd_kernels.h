@@ -0,0 +1,66 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file simd_kernels.h
+ * Bitset and sorted-list kernels with one implementation per instruction
+ * set, picked once at startup from what the CPU reports (CPUID).
+ *
+ * One binary runs everywhere: the per-ISA versions are compiled with
+ * function target attributes, not with -m flags, and only the one the CPU
+ * supports is ever called. The GRAPH_SIMD environment variable (scalar,
+ * sse4.2, avx2 or avx512) lowers the level, e.g. to compare them on one
+ * host; it never raises it above what the CPU supports.
+ */
+
+typedef enum {
+    SIMD_LEVEL_SCALAR = 0,  // Portable C
+    SIMD_LEVEL_SSE42,       // SSE4.2 and hardware popcount
+    SIMD_LEVEL_AVX2,        // AVX2
+    SIMD_LEVEL_AVX512,      // AVX-512F with VPOPCNTDQ
+    SIMD_LEVEL_COUNT
+} SimdLevel;
+
+/**
+ * Level in use (detected on the first call).
+ */
+SimdLevel simd_level(void);
+
+/**
+ * Highest level the CPU supports, ignoring GRAPH_SIMD and simd_set_level().
+ */
+SimdLevel simd_detected_level(void);
+
+/**
+ * Use @p level, capped at the detected level. Set it before starting
+ * threads that run algorithms.
+ * @return The level now in use.
+ */
+SimdLevel simd_set_level(SimdLevel level);
+
+/**
+ * Name of a level ("scalar", "sse4.2", "avx2", "avx512").
+ */
+const char* simd_level_name(SimdLevel level);
+
+/**
+ * Parse a level name.
+ * @return 1 on success, 0 for an unknown name
+ */
+int simd_parse_level(const char* name, SimdLevel* level);
+
+/**
+ * Number of bits set in both @p a and @p b (@p words words each).
+ */
+uint64_t simd_and_popcount(const uint64_t* a, const uint64_t* b, size_t words);
+
+/**
+ * Number of values present in both sorted lists. Each list must be strictly
+ * increasing.
+ */
+size_t simd_intersect_count(const int* a, size_t na, const int* b, size_t nb);
+
+#endif /* SIMD_KERNELS_H */
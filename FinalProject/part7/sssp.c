@@ -0,0 +1,447 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L   // pthread_barrier_t
+#endif
+#include "sssp.h"
+#include "graph_alloc.h"
+#include "parallel.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SSSP_INF LLONG_MAX
+#define SSSP_MAX_THREADS 64
+#define DELTA_MAX_BINS 1024    // Bounds the circular bucket array
+
+/**
+ * Check the weights and count the adjacency entries.
+ * @return 0 if a weight is negative
+ */
+static int scan_weights(const Graph* g, long long* entries, int* max_weight) {
+    long long count = 0;
+    int max_w = 0;
+    for (int u = 0; u < g->n; u++) {
+        for (EdgeNode* e = g->adj[u].head; e; e = e->next) {
+            if (e->weight < 0) return 0;
+            if (e->weight > max_w) max_w = e->weight;
+            count++;
+        }
+    }
+    *entries = count;
+    *max_weight = max_w;
+    return 1;
+}
+
+static int result_alloc(SSSP_Result* result, int n, int source) {
+    result->n = n;
+    result->source = source;
+    result->reached = 0;
+    result->dist = (long long*)GRAPH_MALLOC((size_t)n * sizeof(long long));
+    result->parent = (int*)GRAPH_MALLOC((size_t)n * sizeof(int));
+    if (!result->dist || !result->parent) {
+        sssp_result_free(result);
+        return 0;
+    }
+    for (int v = 0; v < n; v++) {
+        result->dist[v] = SSSP_INF;
+        result->parent[v] = -1;
+    }
+    return 1;
+}
+
+/**
+ * Replace SSSP_INF with SSSP_UNREACHABLE and count the reached vertices.
+ */
+static void result_finish(SSSP_Result* result) {
+    int reached = 0;
+    for (int v = 0; v < result->n; v++) {
+        if (result->dist[v] == SSSP_INF) {
+            result->dist[v] = SSSP_UNREACHABLE;
+        } else {
+            reached++;
+        }
+    }
+    result->reached = reached;
+}
+
+void sssp_result_free(SSSP_Result* result) {
+    if (!result) return;
+    GRAPH_FREE(result->dist);
+    GRAPH_FREE(result->parent);
+    result->dist = NULL;
+    result->parent = NULL;
+}
+
+/* ---------- Radix heap Dijkstra ---------- */
+
+#define RADIX_BUCKETS 65
+
+typedef struct {
+    long long key;
+    int vertex;
+    int next;              // Next node in the same bucket, -1 at the end
+} RadixNode;
+
+/**
+ * Monotone priority queue: pushed keys must not be below the last key
+ * popped. Nodes come from a pool and are linked into buckets; nothing
+ * is freed until the whole heap goes.
+ */
+typedef struct {
+    RadixNode* nodes;
+    long long capacity;
+    long long used;
+    int head[RADIX_BUCKETS];
+    long long last;        // Last minimum popped
+} RadixHeap;
+
+static int radix_bucket(const RadixHeap* h, long long key) {
+    if (key == h->last) return 0;
+    return 64 - __builtin_clzll((unsigned long long)(key ^ h->last));
+}
+
+static void radix_push(RadixHeap* h, long long key, int vertex) {
+    RadixNode* node = &h->nodes[h->used];
+    int b = radix_bucket(h, key);
+    node->key = key;
+    node->vertex = vertex;
+    node->next = h->head[b];
+    h->head[b] = (int)h->used++;
+}
+
+/**
+ * @return 0 if the heap is empty
+ */
+static int radix_pop(RadixHeap* h, long long* key, int* vertex) {
+    if (h->head[0] < 0) {
+        int b = 1;
+        while (b < RADIX_BUCKETS && h->head[b] < 0) b++;
+        if (b == RADIX_BUCKETS) return 0;
+
+        // The bucket's minimum becomes the new reference; every other entry
+        // now shares more high bits with it and moves to a lower bucket
+        long long min = SSSP_INF;
+        for (int i = h->head[b]; i >= 0; i = h->nodes[i].next) {
+            if (h->nodes[i].key < min) min = h->nodes[i].key;
+        }
+        h->last = min;
+
+        int i = h->head[b];
+        h->head[b] = -1;
+        while (i >= 0) {
+            int next = h->nodes[i].next;
+            int nb = radix_bucket(h, h->nodes[i].key);
+            h->nodes[i].next = h->head[nb];
+            h->head[nb] = i;
+            i = next;
+        }
+    }
+
+    int i = h->head[0];
+    h->head[0] = h->nodes[i].next;
+    *key = h->nodes[i].key;
+    *vertex = h->nodes[i].vertex;
+    return 1;
+}
+
+int graph_sssp_radix_heap_ws(const Graph* g, int source, SSSP_Result* result,
+                             AlgorithmWorkspace* ws) {
+    if (!g || !result || source < 0 || source >= g->n) return 0;
+    memset(result, 0, sizeof(*result));
+
+    long long entries;
+    int max_weight;
+    if (!scan_weights(g, &entries, &max_weight)) return 0;
+    // Node indices are ints: one push per adjacency entry, plus the source
+    if (entries + 1 > INT_MAX) return 0;
+
+    AlgorithmWorkspace local;
+    if (!ws) {
+        if (!workspace_init(&local, 0)) return 0;
+        ws = &local;
+    }
+    WorkspaceMark mark = workspace_mark(ws);
+
+    RadixHeap heap;
+    heap.capacity = entries + 1;
+    heap.used = 0;
+    heap.last = 0;
+    heap.nodes = (RadixNode*)workspace_alloc(ws, (size_t)heap.capacity * sizeof(RadixNode));
+    for (int b = 0; b < RADIX_BUCKETS; b++) heap.head[b] = -1;
+
+    int ok = heap.nodes && result_alloc(result, g->n, source);
+    if (ok) {
+        long long* dist = result->dist;
+        dist[source] = 0;
+        radix_push(&heap, 0, source);
+
+        long long d;
+        int u;
+        while (radix_pop(&heap, &d, &u)) {
+            if (d > dist[u]) continue; // Stale entry
+
+            for (EdgeNode* e = g->adj[u].head; e; e = e->next) {
+                long long nd = d + e->weight;
+                if (nd < dist[e->to]) {
+                    dist[e->to] = nd;
+                    result->parent[e->to] = u;
+                    radix_push(&heap, nd, e->to);
+                }
+            }
+        }
+        result_finish(result);
+    }
+
+    workspace_release(ws, mark);
+    if (ws == &local) workspace_destroy(&local);
+    return ok;
+}
+
+/* ---------- Delta-stepping ---------- */
+
+typedef struct {
+    int* items;
+    int size;
+    int capacity;
+} VertexBin;
+
+static int bin_push(VertexBin* bin, int v) {
+    if (bin->size == bin->capacity) {
+        int cap = bin->capacity ? bin->capacity * 2 : 64;
+        int* grown = (int*)GRAPH_REALLOC(bin->items, (size_t)cap * sizeof(int));
+        if (!grown) return 0;
+        bin->items = grown;
+        bin->capacity = cap;
+    }
+    bin->items[bin->size++] = v;
+    return 1;
+}
+
+typedef struct {
+    const Graph* g;
+    long long* dist;
+    long long delta;
+    int num_bins;              // Circular: a relaxation lands at most num_bins - 1 bins ahead
+    int num_threads;
+    ParallelTeam team;
+
+    int* frontier;             // Vertices of the current bin, from all threads
+    int frontier_size;
+    int frontier_capacity;
+    long long next_bin[SSSP_MAX_THREADS];   // Each thread's lowest non-empty bin
+    int counts[SSSP_MAX_THREADS];           // Each thread's share of the next frontier
+    int failed;                // Set when an allocation fails
+} DeltaShared;
+
+typedef struct {
+    DeltaShared* shared;
+    int index;
+    VertexBin* bins;           // num_bins local bins
+} DeltaTask;
+
+static void delta_sync(DeltaShared* s) {
+    parallel_sync(&s->team);
+}
+
+/**
+ * Lower dist[v] to @p value if it is smaller.
+ * @return 1 if this call lowered it
+ */
+static int atomic_min_dist(long long* dist, int v, long long value) {
+    long long old = __atomic_load_n(&dist[v], __ATOMIC_RELAXED);
+    while (value < old) {
+        if (__atomic_compare_exchange_n(&dist[v], &old, value, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void* delta_run(void* arg) {
+    DeltaTask* t = (DeltaTask*)arg;
+    DeltaShared* s = t->shared;
+
+    long long delta = s->delta;
+    int num_bins = s->num_bins;
+    long long current = 0;
+    int failed = 0;
+
+    while (1) {
+        // Relax our share of the frontier; entries whose vertex has since
+        // moved to an earlier (already finished) bin are skipped
+        for (int i = t->index; i < s->frontier_size; i += s->num_threads) {
+            int u = s->frontier[i];
+            long long du = __atomic_load_n(&s->dist[u], __ATOMIC_RELAXED);
+            if (du / delta != current) continue;
+
+            for (EdgeNode* e = s->g->adj[u].head; e; e = e->next) {
+                long long nd = du + e->weight;
+                if (atomic_min_dist(s->dist, e->to, nd)) {
+                    if (!bin_push(&t->bins[(nd / delta) % num_bins], e->to)) failed = 1;
+                }
+            }
+        }
+
+        // Lowest non-empty local bin at or after the current one
+        long long mine = -1;
+        for (int k = 0; k < num_bins && mine < 0; k++) {
+            if (t->bins[(current + k) % num_bins].size > 0) mine = current + k;
+        }
+        s->next_bin[t->index] = failed ? -2 : mine;
+        delta_sync(s);
+
+        long long next = -1;
+        int abort = 0;
+        for (int i = 0; i < s->num_threads; i++) {
+            if (s->next_bin[i] == -2) abort = 1;
+            if (s->next_bin[i] >= 0 && (next < 0 || s->next_bin[i] < next)) next = s->next_bin[i];
+        }
+        if (abort || next < 0) break;  // Same decision in every thread
+
+        VertexBin* bin = &t->bins[next % num_bins];
+        s->counts[t->index] = bin->size;
+        delta_sync(s);
+
+        if (t->index == 0) {
+            int total = 0;
+            for (int i = 0; i < s->num_threads; i++) total += s->counts[i];
+            if (total > s->frontier_capacity) {
+                int* grown = (int*)GRAPH_REALLOC(s->frontier, (size_t)total * sizeof(int));
+                if (grown) {
+                    s->frontier = grown;
+                    s->frontier_capacity = total;
+                } else {
+                    s->failed = 1;
+                }
+            }
+            s->frontier_size = s->failed ? 0 : total;
+        }
+        delta_sync(s);
+        if (s->failed) break;
+
+        int offset = 0;
+        for (int i = 0; i < t->index; i++) offset += s->counts[i];
+        if (bin->size > 0) memcpy(s->frontier + offset, bin->items, (size_t)bin->size * sizeof(int));
+        bin->size = 0;
+        current = next;
+        delta_sync(s);
+    }
+
+    if (failed) s->failed = 1;
+    return NULL;
+}
+
+/**
+ * Run delta-stepping over @p dist (source already at 0).
+ * @return 1 on success, 0 on allocation failure
+ */
+static int delta_stepping(DeltaShared* s, int source, int num_threads) {
+    s->num_threads = num_threads;
+    s->failed = 0;
+    s->frontier_capacity = 64;
+    s->frontier = (int*)GRAPH_MALLOC((size_t)s->frontier_capacity * sizeof(int));
+    DeltaTask tasks[SSSP_MAX_THREADS];
+    VertexBin* bins = (VertexBin*)GRAPH_CALLOC((size_t)num_threads * s->num_bins, sizeof(VertexBin));
+    if (!s->frontier || !bins) {
+        GRAPH_FREE(s->frontier);
+        GRAPH_FREE(bins);
+        return 0;
+    }
+    s->frontier[0] = source;
+    s->frontier_size = 1;
+    for (int i = 0; i < num_threads; i++) {
+        tasks[i].shared = s;
+        tasks[i].index = i;
+        tasks[i].bins = bins + (size_t)i * s->num_bins;
+    }
+
+    if (!parallel_run(&s->team, num_threads, delta_run, tasks, sizeof(DeltaTask))) {
+        // The threads could not be set up: run serially instead
+        GRAPH_FREE(s->frontier);
+        GRAPH_FREE(bins);
+        return delta_stepping(s, source, 1);
+    }
+
+    for (int i = 0; i < num_threads * s->num_bins; i++) GRAPH_FREE(bins[i].items);
+    GRAPH_FREE(bins);
+    GRAPH_FREE(s->frontier);
+    return !s->failed;
+}
+
+/**
+ * Shortest-path tree over the edges with dist[u] + w == dist[v], found by
+ * a BFS from the source (zero weights rule out taking any tight edge).
+ */
+static int build_parents(const Graph* g, SSSP_Result* result) {
+    int* queue = (int*)GRAPH_MALLOC((size_t)g->n * sizeof(int));
+    if (!queue) return 0;
+
+    const long long* dist = result->dist;
+    int* parent = result->parent;
+    int head = 0, tail = 0;
+    queue[tail++] = result->source;
+    parent[result->source] = result->source; // Marks it visited, reset below
+    while (head < tail) {
+        int u = queue[head++];
+        for (EdgeNode* e = g->adj[u].head; e; e = e->next) {
+            int v = e->to;
+            if (parent[v] < 0 && dist[v] != SSSP_INF && dist[u] + e->weight == dist[v]) {
+                parent[v] = u;
+                queue[tail++] = v;
+            }
+        }
+    }
+    parent[result->source] = -1;
+    GRAPH_FREE(queue);
+    return 1;
+}
+
+int graph_sssp_delta_stepping(const Graph* g, int source, int delta, int num_threads,
+                              SSSP_Result* result) {
+    if (!g || !result || source < 0 || source >= g->n) return 0;
+    memset(result, 0, sizeof(*result));
+
+    long long entries;
+    int max_weight;
+    if (!scan_weights(g, &entries, &max_weight)) return 0;
+
+    // About one relaxation per bin and vertex: width max_weight / average degree
+    long long width = delta;
+    if (width <= 0) {
+        width = entries > 0 ? (long long)max_weight * g->n / entries : 1;
+    }
+    long long min_width = (max_weight + DELTA_MAX_BINS - 3) / (DELTA_MAX_BINS - 2);
+    if (width < min_width) width = min_width;
+    if (width < 1) width = 1;
+
+    if (num_threads < 1) num_threads = 1;
+    if (num_threads > SSSP_MAX_THREADS) num_threads = SSSP_MAX_THREADS;
+
+    if (!result_alloc(result, g->n, source)) return 0;
+    result->dist[source] = 0;
+
+    DeltaShared shared;
+    memset(&shared, 0, sizeof(shared));
+    shared.g = g;
+    shared.dist = result->dist;
+    shared.delta = width;
+    shared.num_bins = (int)(max_weight / width) + 2;
+
+    if (!delta_stepping(&shared, source, num_threads) || !build_parents(g, result)) {
+        sssp_result_free(result);
+        return 0;
+    }
+    result_finish(result);
+    return 1;
+}
+
+int graph_sssp_with_params(const Graph* g, const AlgorithmParams* params,
+                           SSSP_Result* result, AlgorithmWorkspace* ws) {
+    if (!g) return 0;
+    int source = params && params->source >= 0 ? params->source : 0;
+
+    if (params && params->variant == ALGO_VARIANT_DELTA_STEPPING) {
+        return graph_sssp_delta_stepping(g, source, 0, params->num_threads, result);
+    }
+    return graph_sssp_radix_heap_ws(g, source, result, ws);
+}
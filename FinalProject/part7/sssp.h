@@ -0,0 +1,65 @@
+#ifndef SSSP_H
+#define SSSP_H
+
+#include "graph.h"
+#include "workspace.h"
+#include "algorithm_params.h"
+
+/**
+ * @file sssp.h
+ * Single-source shortest paths over non-negative integer edge weights.
+ *
+ * Two implementations:
+ * - Dijkstra with a radix heap. Distances leave the heap in increasing
+ *   order, so a key only has to be compared with the last one removed.
+ *   Key k goes in bucket "highest bit where k differs from the last
+ *   minimum". Each entry moves down at most 64 times, against log(m)
+ *   comparisons per operation in a binary heap.
+ * - Delta-stepping. Vertices are grouped by distance into buckets of
+ *   width delta, and all vertices of the lowest bucket are relaxed at once,
+ *   in parallel. A vertex can be relaxed more than once, which the
+ *   parallelism pays for on large graphs.
+ */
+
+#define SSSP_UNREACHABLE (-1LL)
+
+typedef struct {
+    int n;
+    int source;
+    long long* dist;    // Distance from source, SSSP_UNREACHABLE if none
+    int* parent;        // Previous vertex on a shortest path, -1 for source/unreachable
+    int reached;        // Vertices with a path from source (source included)
+} SSSP_Result;
+
+/**
+ * Dijkstra's algorithm with a radix heap.
+ * @param result OUT: distances and parents (free with sssp_result_free)
+ * @param ws Workspace for the heap, or NULL for a temporary one
+ * @return 1 on success, 0 on invalid input, a negative weight or allocation failure
+ */
+int graph_sssp_radix_heap_ws(const Graph* g, int source, SSSP_Result* result,
+                             AlgorithmWorkspace* ws);
+
+/**
+ * Delta-stepping. Same result as graph_sssp_radix_heap_ws(); where several
+ * shortest paths exist, the parent may differ.
+ * @param delta Bucket width (0 = choose from the weights and degrees)
+ * @param num_threads Threads to use (0 or 1 = single-threaded)
+ * @return 1 on success, 0 on invalid input, a negative weight or allocation failure
+ */
+int graph_sssp_delta_stepping(const Graph* g, int source, int delta, int num_threads,
+                              SSSP_Result* result);
+
+/**
+ * Run the variant selected in @p params (radix heap by default) from
+ * params->source (-1 = vertex 0).
+ */
+int graph_sssp_with_params(const Graph* g, const AlgorithmParams* params,
+                           SSSP_Result* result, AlgorithmWorkspace* ws);
+
+/**
+ * Free the distance and parent arrays.
+ */
+void sssp_result_free(SSSP_Result* result);
+
+#endif /* SSSP_H */
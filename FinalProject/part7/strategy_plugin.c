@@ -0,0 +1,303 @@
+#define _GNU_SOURCE
+#include "strategy_plugin.h"
+#include <dirent.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Registry entry of one plugin strategy. Slots are never freed and keep
+ * their id across reloads, so pointers handed out stay valid. */
+typedef struct {
+    AlgorithmStrategy strategy;   // name/description point at the buffers below
+    char name[32];
+    char description[96];
+    int active;
+} PluginSlot;
+
+static PluginSlot slots[STRATEGY_PLUGIN_MAX_STRATEGIES];
+static void* handles[STRATEGY_PLUGIN_MAX_FILES];
+static int num_handles = 0;
+static char* remembered_paths = NULL;   // ':'-joined, for reloads
+
+static pthread_once_t lock_once = PTHREAD_ONCE_INIT;
+static pthread_rwlock_t registry_lock;
+static pthread_mutex_t reload_mutex = PTHREAD_MUTEX_INITIALIZER;
+static volatile sig_atomic_t reload_requested = 0;
+
+static void init_lock(void) {
+    pthread_rwlockattr_t attr;
+    pthread_rwlockattr_init(&attr);
+#ifdef __GLIBC__
+    // A steady stream of requests must not hold a reload off forever
+    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+    pthread_rwlock_init(&registry_lock, &attr);
+    pthread_rwlockattr_destroy(&attr);
+}
+
+static void write_lock(void) {
+    pthread_once(&lock_once, init_lock);
+    pthread_rwlock_wrlock(&registry_lock);
+}
+
+void strategy_plugins_read_lock(void) {
+    pthread_once(&lock_once, init_lock);
+    pthread_rwlock_rdlock(&registry_lock);
+}
+
+void strategy_plugins_read_unlock(void) {
+    pthread_rwlock_unlock(&registry_lock);
+}
+
+/* ---------- Loading (write lock held) ---------- */
+
+/**
+ * Slot already used for @p id, else a never used one.
+ */
+static PluginSlot* slot_for(int id) {
+    PluginSlot* unused = NULL;
+    for (int i = 0; i < STRATEGY_PLUGIN_MAX_STRATEGIES; i++) {
+        if (slots[i].strategy.id == id) return &slots[i];
+        if (!unused && slots[i].strategy.id == 0) unused = &slots[i];
+    }
+    return unused;
+}
+
+static int active_count(void) {
+    int count = 0;
+    for (int i = 0; i < STRATEGY_PLUGIN_MAX_STRATEGIES; i++) {
+        if (slots[i].active) count++;
+    }
+    return count;
+}
+
+/**
+ * @return Strategies taken from the file, or -1 if it is not a usable plugin.
+ */
+static int load_file(const char* path) {
+    if (num_handles == STRATEGY_PLUGIN_MAX_FILES) {
+        printf("Plugins: Skipping '%s', at most %d files\n", path, STRATEGY_PLUGIN_MAX_FILES);
+        return -1;
+    }
+
+    void* handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        printf("Plugins: Could not load '%s': %s\n", path, dlerror());
+        return -1;
+    }
+
+    const StrategyPlugin* plugin = (const StrategyPlugin*)dlsym(handle, STRATEGY_PLUGIN_SYMBOL);
+    if (!plugin) {
+        printf("Plugins: '%s' has no %s\n", path, STRATEGY_PLUGIN_SYMBOL);
+        dlclose(handle);
+        return -1;
+    }
+    if (plugin->abi_version != STRATEGY_PLUGIN_ABI_VERSION ||
+        plugin->params_size != sizeof(AlgorithmParams)) {
+        printf("Plugins: '%s' was built for ABI %d (params %zu bytes), expected %d (%zu bytes)\n",
+               path, plugin->abi_version, plugin->params_size,
+               STRATEGY_PLUGIN_ABI_VERSION, sizeof(AlgorithmParams));
+        dlclose(handle);
+        return -1;
+    }
+
+    int loaded = 0;
+    for (int i = 0; i < plugin->num_strategies; i++) {
+        const AlgorithmStrategy* s = &plugin->strategies[i];
+        if (!s->execute || !s->name || s->id < 1 || s->id > STRATEGY_PLUGIN_MAX_ID) {
+            printf("Plugins: '%s' strategy %d is invalid, skipped\n", path, i);
+            continue;
+        }
+        PluginSlot* slot = slot_for(s->id);
+        if (!slot) {
+            printf("Plugins: No room for strategy %d of '%s'\n", s->id, path);
+            continue;
+        }
+
+        snprintf(slot->name, sizeof(slot->name), "%s", s->name);
+        snprintf(slot->description, sizeof(slot->description), "%s",
+                 s->description ? s->description : "");
+        slot->strategy.execute = s->execute;
+        slot->strategy.name = slot->name;
+        slot->strategy.description = slot->description;
+        slot->strategy.id = s->id;
+        slot->active = 1;
+        loaded++;
+        printf("Plugins: '%s' provides strategy %d (%s)\n",
+               plugin->name ? plugin->name : path, s->id, slot->name);
+    }
+
+    if (loaded == 0) {
+        dlclose(handle);
+        return 0;
+    }
+    handles[num_handles++] = handle;
+    return loaded;
+}
+
+static int compare_names(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+/**
+ * Load every *.so in @p dir, in name order.
+ * @return Strategies loaded, or -1 if the directory cannot be read.
+ */
+static int load_directory(const char* dir) {
+    DIR* d = opendir(dir);
+    if (!d) return -1;
+
+    char* names[STRATEGY_PLUGIN_MAX_FILES];
+    int count = 0;
+    struct dirent* entry;
+    while ((entry = readdir(d)) != NULL && count < STRATEGY_PLUGIN_MAX_FILES) {
+        size_t len = strlen(entry->d_name);
+        if (len > 3 && strcmp(entry->d_name + len - 3, ".so") == 0) {
+            names[count] = (char*)malloc(strlen(dir) + len + 2);
+            if (!names[count]) break;
+            sprintf(names[count], "%s/%s", dir, entry->d_name);
+            count++;
+        }
+    }
+    closedir(d);
+
+    qsort(names, (size_t)count, sizeof(char*), compare_names);
+    int loaded = 0;
+    for (int i = 0; i < count; i++) {
+        int n = load_file(names[i]);
+        if (n > 0) loaded += n;
+        free(names[i]);
+    }
+    return loaded;
+}
+
+/**
+ * @return Strategies loaded, or -1 if any path could not be used.
+ */
+static int load_paths(const char* paths) {
+    char* copy = strdup(paths);
+    if (!copy) return -1;
+
+    int loaded = 0, failed = 0;
+    char* save = NULL;
+    for (char* path = strtok_r(copy, ":", &save); path; path = strtok_r(NULL, ":", &save)) {
+        DIR* d = opendir(path);
+        int n;
+        if (d) {
+            closedir(d);
+            n = load_directory(path);
+        } else {
+            n = load_file(path);
+        }
+        if (n < 0) failed = 1;
+        else loaded += n;
+    }
+    free(copy);
+    return failed ? -1 : loaded;
+}
+
+static void unload_all(void) {
+    for (int i = 0; i < STRATEGY_PLUGIN_MAX_STRATEGIES; i++) slots[i].active = 0;
+    for (int i = 0; i < num_handles; i++) dlclose(handles[i]);
+    num_handles = 0;
+}
+
+/* ---------- Public API ---------- */
+
+static pthread_once_t env_once = PTHREAD_ONCE_INIT;
+
+static void load_from_env(void) {
+    const char* paths = getenv("GRAPH_PLUGINS");
+    if (!paths || !*paths) return;
+    if (strategy_plugins_load(paths) < 0) {
+        printf("Plugins: Some of '%s' could not be loaded\n", paths);
+    }
+}
+
+int strategy_plugins_init(void) {
+    pthread_once(&env_once, load_from_env);
+    strategy_plugins_read_lock();
+    int count = active_count();
+    strategy_plugins_read_unlock();
+    return count;
+}
+
+int strategy_plugins_load(const char* paths) {
+    if (!paths) return -1;
+
+    write_lock();
+    int loaded = load_paths(paths);
+
+    size_t old_len = remembered_paths ? strlen(remembered_paths) : 0;
+    char* joined = (char*)realloc(remembered_paths, old_len + strlen(paths) + 2);
+    if (joined) {
+        sprintf(joined + old_len, "%s%s", old_len ? ":" : "", paths);
+        remembered_paths = joined;
+    }
+    pthread_rwlock_unlock(&registry_lock);
+    return loaded;
+}
+
+int strategy_plugins_reload(void) {
+    write_lock();
+    unload_all();
+    int loaded = remembered_paths ? load_paths(remembered_paths) : 0;
+    printf("Plugins: Reloaded, %d strategies active\n", active_count());
+    pthread_rwlock_unlock(&registry_lock);
+    return loaded;
+}
+
+void strategy_plugins_unload(void) {
+    write_lock();
+    unload_all();
+    pthread_rwlock_unlock(&registry_lock);
+}
+
+void strategy_plugins_request_reload(void) {
+    reload_requested = 1;
+}
+
+void strategy_plugins_poll(void) {
+    if (!reload_requested) return;
+
+    // One thread reloads; the others find the flag cleared
+    pthread_mutex_lock(&reload_mutex);
+    if (reload_requested) {
+        reload_requested = 0;
+        strategy_plugins_reload();
+    }
+    pthread_mutex_unlock(&reload_mutex);
+}
+
+AlgorithmStrategy* strategy_plugins_lookup(int id) {
+    for (int i = 0; i < STRATEGY_PLUGIN_MAX_STRATEGIES; i++) {
+        if (slots[i].active && slots[i].strategy.id == id) return &slots[i].strategy;
+    }
+    return NULL;
+}
+
+AlgorithmStrategy* strategy_plugins_lookup_by_name(const char* name) {
+    if (!name) return NULL;
+    for (int i = 0; i < STRATEGY_PLUGIN_MAX_STRATEGIES; i++) {
+        if (slots[i].active && strcmp(slots[i].name, name) == 0) return &slots[i].strategy;
+    }
+    return NULL;
+}
+
+int strategy_plugins_owns(const AlgorithmStrategy* strategy) {
+    for (int i = 0; i < STRATEGY_PLUGIN_MAX_STRATEGIES; i++) {
+        if (strategy == &slots[i].strategy) return 1;
+    }
+    return 0;
+}
+
+int strategy_plugins_list(AlgorithmStrategy** out, int max) {
+    int count = 0;
+    for (int i = 0; i < STRATEGY_PLUGIN_MAX_STRATEGIES && count < max; i++) {
+        if (slots[i].active) out[count++] = &slots[i].strategy;
+    }
+    return count;
+}
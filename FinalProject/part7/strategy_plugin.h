@@ -0,0 +1,114 @@
+#ifndef STRATEGY_PLUGIN_H
+#define STRATEGY_PLUGIN_H
+
+#include <stddef.h>
+#include "algorithm_strategy.h"
+
+/**
+ * @file strategy_plugin.h
+ * Algorithm strategies loaded from shared objects at run time.
+ *
+ * A plugin exports a StrategyPlugin named STRATEGY_PLUGIN_SYMBOL. Each of
+ * its strategies replaces the built-in strategy with the same id, or adds
+ * a new id (10-255; servers read those requests in the weighted format).
+ * $GRAPH_PLUGINS lists plugin files and directories (every *.so inside),
+ * separated by ':'. They are loaded the first time the registry is used.
+ *
+ * strategy_plugins_reload() closes every plugin and opens the list again,
+ * so a rebuilt .so replaces the running code without a server restart.
+ * Servers call strategy_plugins_request_reload() from their SIGHUP handler;
+ * the reload happens before the next request, once the requests still
+ * running plugin code have finished.
+ *
+ * Strategies run with the registry read-locked, so plugin code must not
+ * call the registry functions; algorithm_get_builtin_strategy() is safe.
+ */
+
+#define STRATEGY_PLUGIN_ABI_VERSION 1
+#define STRATEGY_PLUGIN_SYMBOL "graph_strategy_plugin"
+#define STRATEGY_PLUGIN_MAX_ID 255      // Ids above collide with the wire flags
+#define STRATEGY_PLUGIN_MAX_STRATEGIES 16
+#define STRATEGY_PLUGIN_MAX_FILES 16
+
+/**
+ * What a plugin exports, for example:
+ *
+ *   const StrategyPlugin graph_strategy_plugin = {
+ *       STRATEGY_PLUGIN_ABI_VERSION, sizeof(AlgorithmParams),
+ *       "fast-mst", fast_strategies, 1
+ *   };
+ *
+ * A plugin built against another ABI version or AlgorithmParams layout is
+ * rejected.
+ */
+typedef struct {
+    int abi_version;                      // STRATEGY_PLUGIN_ABI_VERSION
+    size_t params_size;                   // sizeof(AlgorithmParams)
+    const char* name;                     // Shown in the logs
+    const AlgorithmStrategy* strategies;
+    int num_strategies;
+} StrategyPlugin;
+
+/**
+ * Load $GRAPH_PLUGINS (once per process).
+ * @return Number of plugin strategies active afterwards.
+ */
+int strategy_plugins_init(void);
+
+/**
+ * Load the plugins in @p paths (':'-separated files or directories) and
+ * remember them for strategy_plugins_reload().
+ * @return Number of strategies loaded, or -1 if a path could not be used.
+ */
+int strategy_plugins_load(const char* paths);
+
+/**
+ * Close all plugins and load the remembered paths again.
+ * @return Number of strategies loaded, or -1 if a path could not be used.
+ */
+int strategy_plugins_reload(void);
+
+/**
+ * Close all plugins; the built-in strategies are used again.
+ */
+void strategy_plugins_unload(void);
+
+/**
+ * Ask for a reload before the next request. Safe to call from a signal
+ * handler.
+ */
+void strategy_plugins_request_reload(void);
+
+/**
+ * Run a reload if one was requested.
+ */
+void strategy_plugins_poll(void);
+
+/**
+ * Hold the registry for reading while a plugin strategy is looked up and
+ * run. Not recursive.
+ */
+void strategy_plugins_read_lock(void);
+void strategy_plugins_read_unlock(void);
+
+/**
+ * Plugin strategy with this id or name, or NULL. The caller holds the read
+ * lock. The pointer stays valid after a reload, but only the strategy found
+ * again under the lock may be executed.
+ */
+AlgorithmStrategy* strategy_plugins_lookup(int id);
+AlgorithmStrategy* strategy_plugins_lookup_by_name(const char* name);
+
+/**
+ * Copy up to @p max active plugin strategies to @p out. The caller holds
+ * the read lock.
+ * @return Number copied
+ */
+int strategy_plugins_list(AlgorithmStrategy** out, int max);
+
+/**
+ * @return 1 if @p strategy is one of the plugin registry's entries
+ */
+int strategy_plugins_owns(const AlgorithmStrategy* strategy);
+
+#endif /* STRATEGY_PLUGIN_H */
@@ -0,0 +1,122 @@
+#include "subgraph.h"
+#include "graph_alloc.h"
+#include <string.h>
+
+static void* view_alloc(AlgorithmWorkspace* ws, size_t bytes) {
+    return ws ? workspace_alloc(ws, bytes) : GRAPH_MALLOC(bytes);
+}
+
+/**
+ * Point @p view at @p parent with room for @p capacity vertices and a map,
+ * borrowed or new (all -1).
+ */
+static int view_setup(SubgraphView* view, const GraphCSR* parent, int capacity, int* map,
+                      AlgorithmWorkspace* ws) {
+    memset(view, 0, sizeof(*view));
+    view->parent = parent;
+    view->owned = ws == NULL;
+
+    // Not zeroed: only the entries the view fills are ever touched
+    view->vertices = (int*)view_alloc(ws, (size_t)(capacity > 0 ? capacity : 1) * sizeof(int));
+    if (!view->vertices) return 0;
+
+    if (map) {
+        view->map = map;
+        return 1;
+    }
+    view->map = (int*)view_alloc(ws, (size_t)parent->n * sizeof(int));
+    if (!view->map) return 0;
+    view->owns_map = 1;
+    memset(view->map, 0xff, (size_t)parent->n * sizeof(int));
+    return 1;
+}
+
+int subgraph_view_init(SubgraphView* view, const GraphCSR* parent, const int* vertices,
+                       int count, int* map, AlgorithmWorkspace* ws) {
+    if (!view) return 0;
+    memset(view, 0, sizeof(*view));
+    if (!parent || !parent->offsets || count < 0 || (count > 0 && !vertices)) return 0;
+
+    if (!view_setup(view, parent, count, map, ws)) {
+        subgraph_view_free(view);
+        return 0;
+    }
+
+    for (int i = 0; i < count; i++) {
+        int p = vertices[i];
+        if (p < 0 || p >= parent->n || view->map[p] >= 0) {
+            subgraph_view_free(view);
+            return 0;
+        }
+        view->map[p] = i;
+        view->vertices[i] = p;
+        view->n++;
+    }
+    return 1;
+}
+
+int subgraph_view_ego(SubgraphView* view, const GraphCSR* parent, int center, int radius,
+                      int max_vertices, int* map, AlgorithmWorkspace* ws) {
+    if (!view) return 0;
+    memset(view, 0, sizeof(*view));
+    if (!parent || !parent->offsets || center < 0 || center >= parent->n || radius < 0) return 0;
+
+    int limit = max_vertices > 0 && max_vertices < parent->n ? max_vertices : parent->n;
+    if (!view_setup(view, parent, limit, map, ws)) {
+        subgraph_view_free(view);
+        return 0;
+    }
+
+    // The vertex list doubles as the BFS queue; [level_start, level_end) is one level
+    view->vertices[0] = center;
+    view->map[center] = 0;
+    view->n = 1;
+    int level_start = 0;
+    for (int level = 0; level < radius && view->n < limit; level++) {
+        int level_end = view->n;
+        for (int i = level_start; i < level_end && view->n < limit; i++) {
+            int u = view->vertices[i];
+            for (long long a = parent->offsets[u]; a < parent->offsets[u + 1]; a++) {
+                int v = parent->targets[a];
+                if (view->map[v] >= 0) continue;
+                view->map[v] = view->n;
+                view->vertices[view->n++] = v;
+                if (view->n == limit) break;
+            }
+        }
+        if (view->n == level_end) break;
+        level_start = level_end;
+    }
+    return 1;
+}
+
+long long subgraph_view_arcs(const SubgraphView* view) {
+    if (!view) return 0;
+    long long arcs = 0;
+    for (int v = 0; v < view->n; v++) {
+        int p = view->vertices[v];
+        for (long long a = view->parent->offsets[p]; a < view->parent->offsets[p + 1]; a++) {
+            arcs += view->map[view->parent->targets[a]] >= 0;
+        }
+    }
+    return arcs;
+}
+
+int subgraph_view_arc_filter(void* ctx, int u, int v) {
+    const SubgraphView* view = (const SubgraphView*)ctx;
+    return view->map[u] >= 0 && view->map[v] >= 0;
+}
+
+void subgraph_view_free(SubgraphView* view) {
+    if (!view) return;
+
+    // A borrowed map goes back to all -1 for the next view
+    if (view->map && !view->owns_map) {
+        for (int i = 0; i < view->n; i++) view->map[view->vertices[i]] = -1;
+    }
+    if (view->owned) {
+        GRAPH_FREE(view->vertices);
+        if (view->owns_map) GRAPH_FREE(view->map);
+    }
+    memset(view, 0, sizeof(*view));
+}
@@ -0,0 +1,114 @@
+#ifndef SUBGRAPH_H
+#define SUBGRAPH_H
+
+#include "graph.h"
+#include "workspace.h"
+#include "bfs.h"
+
+/**
+ * @file subgraph.h
+ * Induced subgraph views over a frozen GraphCSR.
+ *
+ * A view is a vertex subset of the parent and a map between the two
+ * numberings; no arcs are copied. View vertex i is parent vertex
+ * vertices[i], and map[p] is the view id of parent vertex p (-1 outside).
+ * Neighbor iteration walks the parent's arcs and skips the ones leaving
+ * the subset, so a view costs O(size) to set up and its arcs cost what
+ * the parent's do.
+ *
+ * The map has one entry per parent vertex. Pass the same all -1 map to a
+ * sequence of views (one at a time) to avoid that O(n) cost per view:
+ * subgraph_view_free() puts back the -1 entries it set.
+ *
+ * Consumers: graph_bfs_ws() with subgraph_view_arc_filter(),
+ * graph_max_weight_clique_view() and graph_max_flow_view_ws().
+ */
+
+typedef struct {
+    const GraphCSR* parent;
+    int n;                  // Vertices in the view
+    int* vertices;          // Parent id of each view vertex
+    int* map;               // View id of each parent vertex, -1 outside
+    int owned;              // Arrays allocated with GRAPH_MALLOC
+    int owns_map;           // map allocated by the view (otherwise only its entries are reset)
+} SubgraphView;
+
+/**
+ * Position in one view vertex's neighbor list. Set up with
+ * subgraph_view_neighbors() and advanced with subgraph_neighbor_next().
+ */
+typedef struct {
+    const SubgraphView* view;
+    long long arc;
+    long long end;
+} SubgraphNeighborIter;
+
+static inline void subgraph_view_neighbors(const SubgraphView* view, int v,
+                                           SubgraphNeighborIter* it) {
+    int p = view->vertices[v];
+    it->view = view;
+    it->arc = view->parent->offsets[p];
+    it->end = view->parent->offsets[p + 1];
+}
+
+/**
+ * Next neighbor inside the view, in the parent's arc order.
+ * @param to OUT: view id of the neighbor
+ * @param weight OUT: arc weight (1 if the parent has none), may be NULL
+ * @return 1 if a neighbor was read, 0 at the end of the list
+ */
+static inline int subgraph_neighbor_next(SubgraphNeighborIter* it, int* to, int* weight) {
+    const GraphCSR* parent = it->view->parent;
+    while (it->arc < it->end) {
+        long long a = it->arc++;
+        int local = it->view->map[parent->targets[a]];
+        if (local < 0) continue;
+        *to = local;
+        if (weight) *weight = parent->weights ? parent->weights[a] : 1;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * View of the subgraph induced by @p vertices (parent ids, no repeats).
+ * View ids follow the order of @p vertices.
+ *
+ * @param map parent->n ints, all -1, or NULL to allocate one
+ * @param ws Workspace for the arrays (valid until a mark taken before the
+ *           call is released), or NULL for GRAPH_MALLOC
+ * @return 1 on success, 0 on invalid arguments (out-of-range or repeated
+ *         vertex) or allocation failure
+ */
+int subgraph_view_init(SubgraphView* view, const GraphCSR* parent, const int* vertices,
+                       int count, int* map, AlgorithmWorkspace* ws);
+
+/**
+ * Ego network: the subgraph induced by the vertices within @p radius hops
+ * of @p center, in BFS order (the center is view vertex 0). Only the
+ * vertices found and their arcs are visited.
+ *
+ * @param max_vertices Stop adding vertices after this many (0 = no limit)
+ * @return 1 on success, 0 on invalid arguments or allocation failure
+ */
+int subgraph_view_ego(SubgraphView* view, const GraphCSR* parent, int center, int radius,
+                      int max_vertices, int* map, AlgorithmWorkspace* ws);
+
+/**
+ * Arcs with both ends in the view (self-loops once per arc).
+ */
+long long subgraph_view_arcs(const SubgraphView* view);
+
+/**
+ * BfsArcFilter that keeps a search on @p ctx, a SubgraphView of the CSR it
+ * runs over. Distances and parents stay in parent ids.
+ */
+int subgraph_view_arc_filter(void* ctx, int u, int v);
+
+/**
+ * Reset the map entries of the view and free what it allocated with
+ * GRAPH_MALLOC.
+ */
+void subgraph_view_free(SubgraphView* view);
+
+#endif /* SUBGRAPH_H */
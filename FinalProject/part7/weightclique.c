@@ -0,0 +1,365 @@
+#include "weightclique.h"
+#include "graph_alloc.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Search state. Vertex sets are bitsets of `words` 64-bit words; the
+ * per-node arrays are taken from the workspace and released on return.
+ */
+typedef struct {
+    int n;
+    int words;
+    const uint64_t* adj;        // Neighbor set of v at adj + v * words
+    int** edge_weight;          // Edge weights, or NULL when they do not count
+    long long* gain;            // Weight that adding v to the current clique adds
+    uint64_t* uncolored;        // Scratch sets for color_candidates()
+    uint64_t* color_class;
+    int* current;               // Current clique, current[d] chosen at depth d
+    long long current_weight;
+    int* best;
+    int best_size;
+    long long best_weight;
+    int failed;                 // A node could not get its arrays
+    SearchBudget* budget;
+    AlgorithmWorkspace* ws;
+} WeightSearch;
+
+static inline int set_any(const uint64_t* set, int words) {
+    for (int w = 0; w < words; w++) {
+        if (set[w]) return 1;
+    }
+    return 0;
+}
+
+/**
+ * Twice the most that @p v can add to the current clique together with
+ * other candidates: its gain, and half of each positive edge to them.
+ */
+static long long doubled_potential(const WeightSearch* s, const uint64_t* candidates, int v) {
+    long long p = 2 * s->gain[v];
+    if (!s->edge_weight) return p;
+
+    const uint64_t* row = s->adj + (size_t)v * s->words;
+    for (int w = 0; w < s->words; w++) {
+        uint64_t bits = candidates[w] & row[w];
+        while (bits) {
+            int u = w * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (s->edge_weight[v][u] > 0) p += s->edge_weight[v][u];
+        }
+    }
+    return p;
+}
+
+/**
+ * Greedy coloring of @p candidates into @p order, one color class after
+ * another. bound[i] is twice the most any clique inside order[0..i] can
+ * add: the best doubled potential of each class up to the class of
+ * order[i], ignoring negative ones.
+ * @return Number of candidates
+ */
+static int color_candidates(WeightSearch* s, const uint64_t* candidates, int* order,
+                            long long* bound) {
+    int words = s->words;
+    uint64_t* uncolored = s->uncolored;
+    uint64_t* color_class = s->color_class;
+    memcpy(uncolored, candidates, words * sizeof(uint64_t));
+
+    int count = 0;
+    long long total = 0;
+    while (set_any(uncolored, words)) {
+        // One class: repeatedly take the first vertex, drop its neighbors
+        memcpy(color_class, uncolored, words * sizeof(uint64_t));
+        int start = count;
+        long long class_max = 0;
+        for (int w = 0; w < words; w++) {
+            while (color_class[w]) {
+                int v = w * 64 + __builtin_ctzll(color_class[w]);
+                const uint64_t* row = s->adj + (size_t)v * words;
+                color_class[w] &= color_class[w] - 1;
+                for (int k = w; k < words; k++) color_class[k] &= ~row[k];
+                uncolored[w] &= ~((uint64_t)1 << (v & 63));
+
+                long long p = doubled_potential(s, candidates, v);
+                if (p > class_max) class_max = p;
+                order[count++] = v;
+            }
+        }
+        total += class_max;
+        for (int i = start; i < count; i++) bound[i] = total;
+    }
+    return count;
+}
+
+/**
+ * Record the current clique if it is the heaviest so far.
+ */
+static void record_clique(WeightSearch* s, int size) {
+    if (s->current_weight <= s->best_weight) return;
+    s->best_weight = s->current_weight;
+    s->best_size = size;
+    memcpy(s->best, s->current, size * sizeof(int));
+}
+
+/**
+ * Extend the clique current[0..depth-1] with vertices of @p candidates.
+ */
+static void weight_expand(WeightSearch* s, const uint64_t* candidates, int depth) {
+    if (search_budget_expired(s->budget)) return;
+
+    int words = s->words;
+    WorkspaceMark mark = workspace_mark(s->ws);
+    int* order = (int*)workspace_alloc(s->ws, s->n * sizeof(int));
+    long long* bound = (long long*)workspace_alloc(s->ws, s->n * sizeof(long long));
+    uint64_t* rest = (uint64_t*)workspace_alloc(s->ws, words * sizeof(uint64_t));
+    uint64_t* next = (uint64_t*)workspace_alloc(s->ws, words * sizeof(uint64_t));
+    if (!order || !bound || !rest || !next) {
+        s->failed = 1;
+        workspace_release(s->ws, mark);
+        return;
+    }
+
+    int count = color_candidates(s, candidates, order, bound);
+    memcpy(rest, candidates, words * sizeof(uint64_t));
+
+    // Last class first; bound only shrinks from there, so stop at the first miss
+    for (int i = count - 1; i >= 0; i--) {
+        if (2 * s->current_weight + bound[i] <= 2 * s->best_weight) break;
+
+        int v = order[i];
+        const uint64_t* row = s->adj + (size_t)v * words;
+        rest[v >> 6] &= ~((uint64_t)1 << (v & 63));
+        for (int w = 0; w < words; w++) next[w] = rest[w] & row[w];
+
+        s->current[depth] = v;
+        s->current_weight += s->gain[v];
+        if (s->edge_weight) {
+            for (int w = 0; w < words; w++) {
+                for (uint64_t bits = next[w]; bits; bits &= bits - 1) {
+                    int u = w * 64 + __builtin_ctzll(bits);
+                    s->gain[u] += s->edge_weight[u][v];
+                }
+            }
+        }
+        record_clique(s, depth + 1);
+
+        if (set_any(next, words)) weight_expand(s, next, depth + 1);
+
+        if (s->edge_weight) {
+            for (int w = 0; w < words; w++) {
+                for (uint64_t bits = next[w]; bits; bits &= bits - 1) {
+                    int u = w * 64 + __builtin_ctzll(bits);
+                    s->gain[u] -= s->edge_weight[u][v];
+                }
+            }
+        }
+        s->current_weight -= s->gain[v];
+        if (s->failed || s->budget->expired) break;
+    }
+
+    workspace_release(s->ws, mark);
+}
+
+/**
+ * Where the search reads its graph from: a Graph, or a view of a CSR.
+ */
+typedef struct {
+    const Graph* g;
+    const SubgraphView* view;
+} CliqueSource;
+
+/**
+ * Default weight of @p v: its self-loop weight (0 without one) in a Graph,
+ * 1 in a view.
+ */
+static long long default_weight(const CliqueSource* src, int v) {
+    if (!src->g) return 1;
+    for (EdgeNode* e = src->g->adj[v].head; e; e = e->next) {
+        if (e->to == v) return e->weight;
+    }
+    return 0;
+}
+
+/**
+ * Set the neighbors of vertex @p u (search position @p p) in its row, and
+ * their edge weights when @p edge_weight is set.
+ */
+static void fill_row(const CliqueSource* src, int u, int p, const int* position, uint64_t* row,
+                     int** edge_weight) {
+    if (src->g) {
+        for (EdgeNode* e = src->g->adj[u].head; e; e = e->next) {
+            if (e->to == u) continue;
+            int q = position[e->to];
+            row[q >> 6] |= (uint64_t)1 << (q & 63);
+            if (edge_weight) edge_weight[p][q] = e->weight;
+        }
+        return;
+    }
+
+    SubgraphNeighborIter it;
+    int v, weight;
+    subgraph_view_neighbors(src->view, u, &it);
+    while (subgraph_neighbor_next(&it, &v, &weight)) {
+        if (v == u) continue;
+        int q = position[v];
+        row[q >> 6] |= (uint64_t)1 << (q & 63);
+        if (edge_weight) edge_weight[p][q] = weight;
+    }
+}
+
+typedef struct {
+    long long weight;
+    int vertex;
+} VertexWeight;
+
+static int compare_vertex_weights(const void* a, const void* b) {
+    const VertexWeight* x = (const VertexWeight*)a;
+    const VertexWeight* y = (const VertexWeight*)b;
+    if (x->weight != y->weight) return x->weight < y->weight ? -1 : 1;
+    return x->vertex - y->vertex;
+}
+
+/**
+ * Copy the heaviest clique into @p result, ascending.
+ */
+static int store_weight_clique(WeightClique_Result* result, int* clique, int size, long long weight) {
+    for (int i = 1; i < size; i++) {
+        int v = clique[i], j = i - 1;
+        while (j >= 0 && clique[j] > v) {
+            clique[j + 1] = clique[j];
+            j--;
+        }
+        clique[j + 1] = v;
+    }
+
+    if (size > 0) {
+        result->vertices = (int*)GRAPH_MALLOC(size * sizeof(int));
+        if (!result->vertices) return 0;
+        memcpy(result->vertices, clique, size * sizeof(int));
+    }
+    result->size = size;
+    result->weight = weight;
+    result->is_valid = 1;
+    return 1;
+}
+
+/**
+ * Heaviest clique of @p src (n vertices); see graph_max_weight_clique_ws().
+ */
+static int max_weight_clique(const CliqueSource* src, int n, const long long* vertex_weights,
+                             int edge_weighted, const AlgorithmParams* params,
+                             WeightClique_Result* result, AlgorithmWorkspace* ws) {
+    memset(result, 0, sizeof(*result));
+    if (n == 0) {
+        result->is_valid = 1;
+        return 1;
+    }
+
+    // Without a caller workspace, use a temporary one for this call
+    AlgorithmWorkspace local;
+    if (!ws) {
+        if (!workspace_init(&local, 0)) return 0;
+        ws = &local;
+    }
+    WorkspaceMark mark = workspace_mark(ws);
+
+    WeightSearch s;
+    memset(&s, 0, sizeof(s));
+    s.n = n;
+    s.words = (n + 63) / 64;
+    s.ws = ws;
+
+    int* vertex_at = (int*)workspace_alloc(ws, n * sizeof(int));
+    int* position = (int*)workspace_alloc(ws, n * sizeof(int));
+    VertexWeight* sorted = (VertexWeight*)workspace_alloc(ws, n * sizeof(VertexWeight));
+    uint64_t* adj = (uint64_t*)workspace_calloc(ws, (size_t)n * s.words, sizeof(uint64_t));
+    uint64_t* all = (uint64_t*)workspace_calloc(ws, s.words, sizeof(uint64_t));
+    s.gain = (long long*)workspace_alloc(ws, n * sizeof(long long));
+    s.uncolored = (uint64_t*)workspace_alloc(ws, s.words * sizeof(uint64_t));
+    s.color_class = (uint64_t*)workspace_alloc(ws, s.words * sizeof(uint64_t));
+    s.current = (int*)workspace_alloc(ws, n * sizeof(int));
+    s.best = (int*)workspace_alloc(ws, n * sizeof(int));
+    if (edge_weighted) s.edge_weight = workspace_matrix(ws, n);
+
+    int ok = vertex_at && position && sorted && adj && all && s.gain && s.uncolored && s.color_class && s.current && s.best &&
+             (!edge_weighted || s.edge_weight);
+    if (ok) {
+        // Search in order of increasing vertex weight: the heaviest vertices
+        // get the last colors and are tried first, which finds heavy cliques early
+        for (int v = 0; v < n; v++) {
+            sorted[v].weight = vertex_weights ? vertex_weights[v] : default_weight(src, v);
+            sorted[v].vertex = v;
+        }
+        qsort(sorted, n, sizeof(VertexWeight), compare_vertex_weights);
+        for (int p = 0; p < n; p++) {
+            vertex_at[p] = sorted[p].vertex;
+            position[sorted[p].vertex] = p;
+        }
+
+        // Sets, weights and the clique below are indexed by search position
+        s.adj = adj;
+        for (int p = 0; p < n; p++) {
+            int u = vertex_at[p];
+            fill_row(src, u, p, position, adj + (size_t)p * s.words, s.edge_weight);
+            all[p >> 6] |= (uint64_t)1 << (p & 63);
+            s.gain[p] = sorted[p].weight;
+        }
+
+        // Start from the heaviest single vertex, so every bound compares with a real clique
+        s.best_size = 1;
+        s.best[0] = 0;
+        s.best_weight = s.gain[0];
+        for (int v = 1; v < n; v++) {
+            if (s.gain[v] > s.best_weight) {
+                s.best[0] = v;
+                s.best_weight = s.gain[v];
+            }
+        }
+
+        SearchBudget budget;
+        search_budget_init(&budget, params ? params->time_budget_ms : 0);
+        s.budget = &budget;
+        weight_expand(&s, all, 0);
+
+        result->timed_out = budget.expired;
+        for (int i = 0; i < s.best_size; i++) s.best[i] = vertex_at[s.best[i]];
+        ok = !s.failed && store_weight_clique(result, s.best, s.best_size, s.best_weight);
+    }
+
+    // Cleanup
+    workspace_release(ws, mark);
+    if (ws == &local) workspace_destroy(&local);
+
+    return ok;
+}
+
+int graph_max_weight_clique_ws(const Graph* g, const long long* vertex_weights, int edge_weighted,
+                               const AlgorithmParams* params, WeightClique_Result* result,
+                               AlgorithmWorkspace* ws) {
+    if (!g || !result) return 0;
+    CliqueSource src = {g, NULL};
+    return max_weight_clique(&src, g->n, vertex_weights, edge_weighted, params, result, ws);
+}
+
+int graph_max_weight_clique_view(const SubgraphView* view, const long long* vertex_weights,
+                                 int edge_weighted, const AlgorithmParams* params,
+                                 WeightClique_Result* result, AlgorithmWorkspace* ws) {
+    if (!view || !result) return 0;
+    CliqueSource src = {NULL, view};
+    return max_weight_clique(&src, view->n, vertex_weights, edge_weighted, params, result, ws);
+}
+
+int graph_max_weight_clique_with_params(const Graph* g, const AlgorithmParams* params,
+                                        WeightClique_Result* result, AlgorithmWorkspace* ws) {
+    return graph_max_weight_clique_ws(g, NULL, 1, params, result, ws);
+}
+
+void weight_clique_result_free(WeightClique_Result* result) {
+    if (!result) return;
+    GRAPH_FREE(result->vertices);
+    result->vertices = NULL;
+    result->size = 0;
+    result->is_valid = 0;
+}
@@ -0,0 +1,72 @@
+#ifndef WEIGHTCLIQUE_H
+#define WEIGHTCLIQUE_H
+
+#include "graph.h"
+#include "workspace.h"
+#include "algorithm_params.h"
+#include "subgraph.h"
+
+/**
+ * @file weightclique.h
+ * Maximum weight clique by branch and bound over bitset candidate sets.
+ *
+ * The weight of a clique is the sum of its vertex weights, plus the sum of
+ * its edge weights when those are counted. Each search node colors its
+ * candidates greedily. A clique takes at most one vertex per color class,
+ * so the largest possible gain of each class, summed over the classes,
+ * bounds what the candidates can still add. With edge weights, the gain of
+ * a vertex includes its edges to the clique so far and half of its
+ * positive edges to the other candidates.
+ */
+
+typedef struct {
+    int* vertices;       // Vertices of the clique, ascending
+    int size;
+    long long weight;    // Weight of the clique
+    int is_valid;        // 1 if result is valid, 0 otherwise
+    int timed_out;       // 1 if the time budget ran out (heaviest clique found so far)
+} WeightClique_Result;
+
+/**
+ * Heaviest clique of @p g, honoring params->time_budget_ms.
+ *
+ * @param vertex_weights Weight of each vertex, or NULL for the weight of its
+ *                       self-loop (0 without one)
+ * @param edge_weighted 1 to add the weight of every clique edge
+ * @param params Parameters, or NULL for defaults
+ * @param result OUT: the clique (free with weight_clique_result_free)
+ * @param ws Workspace to use, or NULL for a temporary one
+ * @return 1 on success, 0 on invalid input or allocation failure
+ */
+int graph_max_weight_clique_ws(const Graph* g, const long long* vertex_weights, int edge_weighted,
+                               const AlgorithmParams* params, WeightClique_Result* result,
+                               AlgorithmWorkspace* ws);
+
+/**
+ * Heaviest clique of the subgraph induced by @p view, read from the parent
+ * CSR without copying it. Vertex ids, in @p vertex_weights and in the
+ * result, are view ids (view->vertices maps them back).
+ *
+ * @param vertex_weights Weight of each view vertex, or NULL for 1 each, which
+ *                       with @p edge_weighted unset finds a maximum clique
+ * @param edge_weighted 1 to add the parent's arc weights (see
+ *                      graph_csr_build_weighted(); 1 each without them)
+ * @return 1 on success, 0 on invalid input or allocation failure
+ */
+int graph_max_weight_clique_view(const SubgraphView* view, const long long* vertex_weights,
+                                 int edge_weighted, const AlgorithmParams* params,
+                                 WeightClique_Result* result, AlgorithmWorkspace* ws);
+
+/**
+ * Heaviest clique counting self-loop weights as vertex weights and adding
+ * edge weights: the weighting used by the server strategy.
+ */
+int graph_max_weight_clique_with_params(const Graph* g, const AlgorithmParams* params,
+                                        WeightClique_Result* result, AlgorithmWorkspace* ws);
+
+/**
+ * Free the vertex array.
+ */
+void weight_clique_result_free(WeightClique_Result* result);
+
+#endif /* WEIGHTCLIQUE_H */
@@ -0,0 +1,139 @@
+#include "workspace.h"
+#include "graph_alloc.h"
+#include <stdint.h>
+#include <string.h>
+
+#define ALIGN_UP(x) (((x) + (WORKSPACE_ALIGN - 1)) & ~(size_t)(WORKSPACE_ALIGN - 1))
+#define CHUNK_HEADER ALIGN_UP(sizeof(WorkspaceChunk))
+
+static unsigned char* chunk_data(WorkspaceChunk* c) {
+    return (unsigned char*)c + CHUNK_HEADER;
+}
+
+int workspace_init(AlgorithmWorkspace* ws, size_t initial_bytes) {
+    if (!ws) return 0;
+    memset(ws, 0, sizeof(*ws));
+
+    if (initial_bytes > 0) {
+        initial_bytes = ALIGN_UP(initial_bytes);
+        ws->base = (unsigned char*)GRAPH_MALLOC(initial_bytes);
+        if (!ws->base) return 0;
+        ws->capacity = initial_bytes;
+        ws->grows = 1;
+    }
+    return 1;
+}
+
+void workspace_destroy(AlgorithmWorkspace* ws) {
+    if (!ws) return;
+    while (ws->overflow) {
+        WorkspaceChunk* prev = ws->overflow->prev;
+        GRAPH_FREE(ws->overflow);
+        ws->overflow = prev;
+    }
+    GRAPH_FREE(ws->base);
+    memset(ws, 0, sizeof(*ws));
+}
+
+/**
+ * Serve a request that does not fit in the base block.
+ */
+static void* overflow_alloc(AlgorithmWorkspace* ws, size_t bytes) {
+    WorkspaceChunk* c = ws->overflow;
+    if (c && c->capacity - c->used >= bytes) {
+        void* p = chunk_data(c) + c->used;
+        c->used += bytes;
+        return p;
+    }
+
+    // Chunks double in size so a run of small requests needs few of them
+    size_t capacity = WORKSPACE_MIN_CHUNK;
+    if (c && c->capacity * 2 > capacity) capacity = c->capacity * 2;
+    if (ws->capacity > capacity) capacity = ws->capacity;
+    if (bytes > capacity) capacity = bytes;
+
+    WorkspaceChunk* chunk = (WorkspaceChunk*)GRAPH_MALLOC(CHUNK_HEADER + capacity);
+    if (!chunk) return NULL;
+    chunk->prev = c;
+    chunk->capacity = capacity;
+    chunk->used = bytes;
+    ws->overflow = chunk;
+    ws->grows++;
+    return chunk_data(chunk);
+}
+
+void* workspace_alloc(AlgorithmWorkspace* ws, size_t bytes) {
+    if (!ws) return NULL;
+    bytes = ALIGN_UP(bytes ? bytes : 1);
+
+    void* p;
+    if (!ws->overflow && ws->capacity - ws->used >= bytes) {
+        p = ws->base + ws->used;
+        ws->used += bytes;
+    } else {
+        p = overflow_alloc(ws, bytes);
+        if (!p) return NULL;
+    }
+
+    ws->in_use += bytes;
+    if (ws->in_use > ws->peak) ws->peak = ws->in_use;
+    return p;
+}
+
+void* workspace_calloc(AlgorithmWorkspace* ws, size_t count, size_t size) {
+    if (size && count > SIZE_MAX / size) return NULL;
+    void* p = workspace_alloc(ws, count * size);
+    if (p) memset(p, 0, count * size);
+    return p;
+}
+
+int** workspace_matrix(AlgorithmWorkspace* ws, int n) {
+    if (n <= 0) return NULL;
+    int** rows = (int**)workspace_alloc(ws, (size_t)n * sizeof(int*));
+    int* data = (int*)workspace_alloc(ws, (size_t)n * (size_t)n * sizeof(int));
+    if (!rows || !data) return NULL;
+
+    for (int i = 0; i < n; i++) {
+        rows[i] = data + (size_t)i * (size_t)n;
+    }
+    return rows;
+}
+
+WorkspaceMark workspace_mark(const AlgorithmWorkspace* ws) {
+    WorkspaceMark mark;
+    mark.used = ws->used;
+    mark.overflow = ws->overflow;
+    mark.overflow_used = ws->overflow ? ws->overflow->used : 0;
+    mark.in_use = ws->in_use;
+    return mark;
+}
+
+void workspace_release(AlgorithmWorkspace* ws, WorkspaceMark mark) {
+    if (!ws) return;
+    while (ws->overflow && ws->overflow != mark.overflow) {
+        WorkspaceChunk* prev = ws->overflow->prev;
+        GRAPH_FREE(ws->overflow);
+        ws->overflow = prev;
+    }
+    if (ws->overflow) ws->overflow->used = mark.overflow_used;
+    ws->used = mark.used;
+    ws->in_use = mark.in_use;
+}
+
+void workspace_reset(AlgorithmWorkspace* ws) {
+    if (!ws) return;
+    WorkspaceMark empty = {0, NULL, 0, 0};
+    workspace_release(ws, empty);
+
+    // Coalesce: one base block covering the largest footprint seen so far
+    if (ws->peak > ws->capacity) {
+        size_t capacity = ALIGN_UP(ws->peak);
+        unsigned char* base = (unsigned char*)GRAPH_MALLOC(capacity);
+        if (base) {
+            GRAPH_FREE(ws->base);
+            ws->base = base;
+            ws->capacity = capacity;
+            ws->grows++;
+        }
+    }
+}
@@ -0,0 +1,111 @@
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include <stddef.h>
+
+/**
+ * @file workspace.h
+ * Reusable scratch memory for the graph algorithms.
+ *
+ * An AlgorithmWorkspace is a grow-only bump arena. Algorithms take their
+ * matrices, queues and helper arrays from it instead of calling malloc, and
+ * give the memory back with a mark/release pair when they return. Requests
+ * that do not fit in the base block are served from overflow chunks;
+ * workspace_reset() then replaces the base block with one large enough for
+ * the biggest request seen so far, so a long-lived workspace (one per server
+ * worker thread) stops allocating after the first few requests.
+ *
+ * A workspace is not thread-safe: keep one per thread.
+ */
+
+#define WORKSPACE_ALIGN 16
+#define WORKSPACE_MIN_CHUNK 16384
+
+/**
+ * Overflow chunk, used when the base block is full.
+ */
+typedef struct WorkspaceChunk {
+    struct WorkspaceChunk* prev;   // Previously allocated chunk
+    size_t capacity;               // Usable bytes after the header
+    size_t used;                   // Bytes handed out from this chunk
+} WorkspaceChunk;
+
+/**
+ * Algorithm workspace.
+ */
+typedef struct {
+    unsigned char* base;           // Base block
+    size_t capacity;               // Size of the base block
+    size_t used;                   // Bytes handed out from the base block
+    WorkspaceChunk* overflow;      // Newest overflow chunk, or NULL
+    size_t in_use;                 // Bytes handed out in total
+    size_t peak;                   // High-water mark of in_use
+    unsigned long long grows;      // Number of blocks/chunks allocated
+} AlgorithmWorkspace;
+
+/**
+ * Position in a workspace, used to give back everything allocated after it.
+ */
+typedef struct {
+    size_t used;
+    WorkspaceChunk* overflow;
+    size_t overflow_used;
+    size_t in_use;
+} WorkspaceMark;
+
+/**
+ * Initialize a workspace.
+ * @param ws Workspace to initialize.
+ * @param initial_bytes Size of the base block (0 to allocate lazily).
+ * @return 1 on success, 0 on failure.
+ */
+int workspace_init(AlgorithmWorkspace* ws, size_t initial_bytes);
+
+/**
+ * Release all memory owned by a workspace.
+ * @param ws Workspace to destroy.
+ */
+void workspace_destroy(AlgorithmWorkspace* ws);
+
+/**
+ * Give back all memory and grow the base block to the high-water mark, so
+ * later requests of the same size are served without allocating.
+ * @param ws Workspace to reset.
+ */
+void workspace_reset(AlgorithmWorkspace* ws);
+
+/**
+ * Allocate uninitialized scratch memory, aligned to WORKSPACE_ALIGN.
+ * @param ws Workspace.
+ * @param bytes Number of bytes.
+ * @return Pointer valid until the enclosing release/reset, or NULL on failure.
+ */
+void* workspace_alloc(AlgorithmWorkspace* ws, size_t bytes);
+
+/**
+ * Allocate zeroed scratch memory for @p count elements of @p size bytes.
+ * @return Pointer, or NULL on failure.
+ */
+void* workspace_calloc(AlgorithmWorkspace* ws, size_t count, size_t size);
+
+/**
+ * Allocate an uninitialized n×n int matrix backed by one contiguous block.
+ * @return Row pointer array, or NULL on failure.
+ */
+int** workspace_matrix(AlgorithmWorkspace* ws, int n);
+
+/**
+ * Remember the current position of a workspace.
+ * @param ws Workspace.
+ * @return Mark to pass to workspace_release().
+ */
+WorkspaceMark workspace_mark(const AlgorithmWorkspace* ws);
+
+/**
+ * Give back everything allocated since @p mark.
+ * @param ws Workspace.
+ * @param mark Mark returned by workspace_mark().
+ */
+void workspace_release(AlgorithmWorkspace* ws, WorkspaceMark mark);
+
+#endif /* WORKSPACE_H */
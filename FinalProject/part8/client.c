@@ -109,7 +109,7 @@ static void quick_test(int port, int algorithm_id) {
     int sock = connect_to_server(port);
     if (sock < 0) return;
     
-    if (algorithm_id == 2 || algorithm_id == 3) {
+    if (algorithm_id == 2 || algorithm_id == 3 || algorithm_id >= 6) {
         int request[] = {algorithm_id, 4, 3, 0,1,5, 1,2,3, 2,3,7};
         send_request(sock, request, 10);
     } else {
@@ -143,7 +143,7 @@ int main(int argc, char* argv[]) {
     int port = atoi(argv[1]);
     
     while (1) {
-        printf("\n1.Euler 2.MaxFlow 3.MST 4.Clique 5.Count 6.Quick 7.Concurrent 0.Exit\n");
+        printf("\n1.Euler 2.MaxFlow 3.MST 4.Clique 5.Count 6.Quick 7.Concurrent 8.SSSP 9.Hops 10.WeightClique 11.Coloring 0.Exit\n");
         printf("Choice: ");
         
         int choice;
@@ -167,6 +167,10 @@ int main(int argc, char* argv[]) {
                 test_concurrent(port, num); 
                 break;
             }
+            case 8: test_weighted(port, 6); break;
+            case 9: test_weighted(port, 7); break;
+            case 10: test_weighted(port, 8); break;
+            case 11: test_weighted(port, 9); break;
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,551 @@
+/*
+** loadgen.c -- multi-threaded load generator for the graph servers
+**
+** Drives the part7/part8 algorithm servers ("algo" protocol) or the part9
+** pipeline server ("pipeline" protocol) with random graphs.
+**
+**   closed loop: each thread sends its next request as soon as the previous
+**                response arrives (-R 0, the default)
+**   open loop:   requests are scheduled at a fixed aggregate rate (-R req/s);
+**                latency is measured from the *intended* send time, so a
+**                stalled server is charged for the requests it delayed
+**                (coordinated-omission correction)
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <math.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include "../part7/algorithm_params.h"
+
+#define MAX_ALGORITHMS 5
+#define MAX_REQUEST_BYTES 4096   // servers read a request with a single 4 KB recv
+#define MAX_RESPONSE_BYTES 8192
+
+typedef enum {
+    PROTO_ALGO = 0,     // [algorithm_id][n][...] -> [status][length][string]
+    PROTO_PIPELINE      // [seed][max_weight][n] + edges -> text until close
+} Protocol;
+
+/**
+ * Load generator configuration (filled from the command line).
+ */
+typedef struct {
+    const char* host;
+    int port;
+    Protocol protocol;
+    int concurrency;        // Number of client threads
+    double duration_s;      // Stop after this many seconds (0 = use max_requests)
+    long max_requests;      // Stop after this many requests (0 = use duration)
+    double rate;            // Aggregate target rate in req/s (0 = closed loop)
+    int mix[MAX_ALGORITHMS + 1]; // Relative weight of each algorithm id
+    int mix_total;
+    int min_vertices, max_vertices;
+    double density;         // Edge probability
+    int max_weight;
+    unsigned int seed;
+    int use_params;         // 1 to send a parameter block (-q)
+    int params[ALGO_PARAMS_WIRE_INTS]; // source, sink, k, budget_ms, threads, variant
+} LoadConfig;
+
+/**
+ * Per-thread measurements. Latencies are stored raw and merged at the end.
+ */
+typedef struct {
+    int id;
+    const LoadConfig* cfg;
+    double start_ns;        // Common start time for all threads
+
+    double* latency_ns;     // Response time (from intended send time)
+    double* service_ns;     // Service time (from actual send time)
+    long count, capacity;
+    long errors;
+    long per_algorithm[MAX_ALGORITHMS + 1];
+} WorkerState;
+
+/* ---------- Timing ---------- */
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void sleep_until_ns(double target_ns) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)(target_ns / 1e9);
+    ts.tv_nsec = (long)(target_ns - (double)ts.tv_sec * 1e9);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+/* ---------- Networking ---------- */
+
+static int connect_to_server(const LoadConfig* cfg) {
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) return -1;
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(cfg->port);
+    if (inet_pton(AF_INET, cfg->host, &addr.sin_addr) <= 0 ||
+        connect(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+static int send_all(int sock, const void* buf, size_t len) {
+    const char* p = (const char*)buf;
+    while (len > 0) {
+        ssize_t sent = send(sock, p, len, 0);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return 0;
+        p += sent;
+        len -= (size_t)sent;
+    }
+    return 1;
+}
+
+static int recv_exact(int sock, void* buf, size_t len) {
+    char* p = (char*)buf;
+    while (len > 0) {
+        ssize_t got = recv(sock, p, len, 0);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return 0;
+        p += got;
+        len -= (size_t)got;
+    }
+    return 1;
+}
+
+/**
+ * Read an algo-protocol response: [status][length][string + '\0'].
+ * @return 1 if the server reported success, 0 otherwise.
+ */
+static int read_algo_response(int sock) {
+    int header[2];
+    if (!recv_exact(sock, header, sizeof(header))) return 0;
+    if (header[0] != 1) return 0;
+    if (header[1] < 0 || header[1] >= MAX_RESPONSE_BYTES) return 0;
+
+    char body[MAX_RESPONSE_BYTES];
+    return recv_exact(sock, body, (size_t)header[1] + 1);
+}
+
+/**
+ * Read a pipeline response: plain text until the server closes.
+ * @return 1 if any response bytes were received.
+ */
+static int read_pipeline_response(int sock) {
+    char body[MAX_RESPONSE_BYTES];
+    long total = 0;
+    for (;;) {
+        ssize_t got = recv(sock, body, sizeof(body), 0);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) break;
+        total += got;
+    }
+    return total > 0;
+}
+
+/* ---------- Request generation ---------- */
+
+static int pick_algorithm(const LoadConfig* cfg, unsigned int* rng) {
+    int r = (int)(rand_r(rng) % (unsigned int)cfg->mix_total);
+    for (int id = 1; id <= MAX_ALGORITHMS; id++) {
+        if (r < cfg->mix[id]) return id;
+        r -= cfg->mix[id];
+    }
+    return 1;
+}
+
+static int pick_vertices(const LoadConfig* cfg, unsigned int* rng) {
+    int span = cfg->max_vertices - cfg->min_vertices + 1;
+    return cfg->min_vertices + (int)(rand_r(rng) % (unsigned int)span);
+}
+
+static int coin(const LoadConfig* cfg, unsigned int* rng) {
+    return (double)rand_r(rng) / RAND_MAX < cfg->density;
+}
+
+/**
+ * Insert the -q parameter block right after word @p flag_index (the algorithm
+ * id or the pipeline vertex count) and set ALGO_PARAMS_FLAG on that word.
+ * @return Request size in bytes, or 0 if it would not fit.
+ */
+static size_t finish_request(const LoadConfig* cfg, int* buf, size_t buf_ints,
+                             size_t len_ints, size_t flag_index) {
+    if (!cfg->use_params) return len_ints * sizeof(int);
+    if (len_ints + ALGO_PARAMS_WIRE_INTS > buf_ints) return 0;
+
+    memmove(buf + flag_index + 1 + ALGO_PARAMS_WIRE_INTS, buf + flag_index + 1,
+            (len_ints - flag_index - 1) * sizeof(int));
+    memcpy(buf + flag_index + 1, cfg->params, sizeof(cfg->params));
+    buf[flag_index] |= ALGO_PARAMS_FLAG;
+    return (len_ints + ALGO_PARAMS_WIRE_INTS) * sizeof(int);
+}
+
+/**
+ * Build one request into @p buf.
+ * @return Request size in bytes, or 0 if it would not fit.
+ */
+static size_t build_request(const LoadConfig* cfg, unsigned int* rng, int algorithm_id,
+                            int* buf, size_t buf_ints) {
+    int n = pick_vertices(cfg, rng);
+
+    if (cfg->protocol == PROTO_PIPELINE) {
+        // [seed][max_weight][n] followed by (u, v, w) triplets
+        size_t k = 3;
+        buf[0] = (int)rand_r(rng);
+        buf[1] = cfg->max_weight;
+        buf[2] = n;
+        for (int u = 0; u < n; u++) {
+            for (int v = u + 1; v < n; v++) {
+                if (!coin(cfg, rng)) continue;
+                if (k + 3 > buf_ints) return 0;
+                buf[k++] = u;
+                buf[k++] = v;
+                buf[k++] = (int)(rand_r(rng) % (unsigned int)cfg->max_weight) + 1;
+            }
+        }
+        return finish_request(cfg, buf, buf_ints, k, 2);
+    }
+
+    if (algorithm_id == 2 || algorithm_id == 3) {
+        // Weighted: [id][n][num_edges][(src, dest, weight)...]
+        size_t k = 3;
+        buf[0] = algorithm_id;
+        buf[1] = n;
+        for (int u = 0; u < n; u++) {
+            for (int v = u + 1; v < n; v++) {
+                if (!coin(cfg, rng)) continue;
+                if (k + 3 > buf_ints) return 0;
+                buf[k++] = u;
+                buf[k++] = v;
+                buf[k++] = (int)(rand_r(rng) % (unsigned int)cfg->max_weight) + 1;
+            }
+        }
+        if (k == 3) { // servers reject edge-less weighted graphs
+            buf[k++] = 0;
+            buf[k++] = n - 1;
+            buf[k++] = 1;
+        }
+        buf[2] = (int)((k - 3) / 3);
+        return finish_request(cfg, buf, buf_ints, k, 0);
+    }
+
+    // Unweighted: [id][n][n*n adjacency matrix]
+    size_t total = 2 + (size_t)n * n;
+    if (total > buf_ints) return 0;
+    memset(buf, 0, total * sizeof(int));
+    buf[0] = algorithm_id;
+    buf[1] = n;
+    for (int u = 0; u < n; u++) {
+        for (int v = u + 1; v < n; v++) {
+            if (coin(cfg, rng)) buf[2 + u * n + v] = buf[2 + v * n + u] = 1;
+        }
+    }
+    return finish_request(cfg, buf, buf_ints, total, 0);
+}
+
+/**
+ * Issue a single request on a fresh connection.
+ * @return 1 on success, 0 on any failure.
+ */
+static int issue_request(const LoadConfig* cfg, const int* req, size_t len) {
+    int sock = connect_to_server(cfg);
+    if (sock < 0) return 0;
+
+    int ok;
+    if (cfg->protocol == PROTO_PIPELINE) {
+        // The pipeline server reads the header and the edges with separate recv calls
+        ok = send_all(sock, req, 3 * sizeof(int)) &&
+             (len == 3 * sizeof(int) || send_all(sock, req + 3, len - 3 * sizeof(int))) &&
+             read_pipeline_response(sock);
+    } else {
+        ok = send_all(sock, req, len) && read_algo_response(sock);
+    }
+    close(sock);
+    return ok;
+}
+
+/* ---------- Workers ---------- */
+
+static int record_sample(WorkerState* ws, double latency, double service) {
+    if (ws->count == ws->capacity) {
+        long cap = ws->capacity ? ws->capacity * 2 : 1024;
+        double* nl = (double*)realloc(ws->latency_ns, sizeof(double) * (size_t)cap);
+        if (!nl) return 0;
+        ws->latency_ns = nl;
+        double* ns = (double*)realloc(ws->service_ns, sizeof(double) * (size_t)cap);
+        if (!ns) return 0;
+        ws->service_ns = ns;
+        ws->capacity = cap;
+    }
+    ws->latency_ns[ws->count] = latency;
+    ws->service_ns[ws->count] = service;
+    ws->count++;
+    return 1;
+}
+
+static void* worker_thread(void* arg) {
+    WorkerState* ws = (WorkerState*)arg;
+    const LoadConfig* cfg = ws->cfg;
+    unsigned int rng = cfg->seed ^ (0x9e3779b9u * (unsigned int)(ws->id + 1));
+
+    int request[MAX_REQUEST_BYTES / sizeof(int)];
+    double end_ns = cfg->duration_s > 0 ? ws->start_ns + cfg->duration_s * 1e9 : 0;
+
+    long quota = -1;        // -1 = unlimited (duration mode)
+    if (cfg->max_requests > 0) {
+        quota = cfg->max_requests / cfg->concurrency;
+        if (ws->id < cfg->max_requests % cfg->concurrency) quota++;
+    }
+
+    // Open loop: thread i owns every concurrency-th slot of the global schedule
+    double interval_ns = cfg->rate > 0 ? 1e9 * cfg->concurrency / cfg->rate : 0;
+    double intended = ws->start_ns + (cfg->rate > 0 ? ws->id * 1e9 / cfg->rate : 0);
+
+    for (long k = 0; ; k++) {
+        if (quota >= 0 && k >= quota) break;
+        if (end_ns > 0 && (cfg->rate > 0 ? intended : now_ns()) >= end_ns) break;
+
+        int algorithm_id = cfg->protocol == PROTO_ALGO ? pick_algorithm(cfg, &rng) : 0;
+        size_t len = build_request(cfg, &rng, algorithm_id, request,
+                                   sizeof(request) / sizeof(request[0]));
+
+        if (cfg->rate > 0) sleep_until_ns(intended);
+        double sent = now_ns();
+        double scheduled = cfg->rate > 0 ? intended : sent;
+
+        int ok = len > 0 && issue_request(cfg, request, len);
+        double done = now_ns();
+
+        if (ok) {
+            if (!record_sample(ws, done - scheduled, done - sent)) ws->errors++;
+            ws->per_algorithm[algorithm_id]++;
+        } else {
+            ws->errors++;
+        }
+        intended += interval_ns;
+    }
+    return NULL;
+}
+
+/* ---------- Reporting ---------- */
+
+static int cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double* sorted, long count, double pct) {
+    if (count <= 0) return 0.0;
+    long rank = (long)ceil(pct / 100.0 * (double)count);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return sorted[rank - 1];
+}
+
+static void print_distribution(const char* label, double* values, long count) {
+    if (count == 0) {
+        printf("%-9s no samples\n", label);
+        return;
+    }
+    qsort(values, (size_t)count, sizeof(double), cmp_double);
+    double sum = 0.0;
+    for (long i = 0; i < count; i++) sum += values[i];
+
+    printf("%-9s mean %9.3f  p50 %9.3f  p90 %9.3f  p99 %9.3f  p99.9 %9.3f  max %9.3f (ms)\n",
+           label, sum / count / 1e6,
+           percentile(values, count, 50.0) / 1e6, percentile(values, count, 90.0) / 1e6,
+           percentile(values, count, 99.0) / 1e6, percentile(values, count, 99.9) / 1e6,
+           values[count - 1] / 1e6);
+}
+
+static void report(const LoadConfig* cfg, WorkerState* workers, double elapsed_ns) {
+    long total = 0, errors = 0;
+    long per_algorithm[MAX_ALGORITHMS + 1] = {0};
+    for (int i = 0; i < cfg->concurrency; i++) {
+        total += workers[i].count;
+        errors += workers[i].errors;
+        for (int a = 0; a <= MAX_ALGORITHMS; a++) per_algorithm[a] += workers[i].per_algorithm[a];
+    }
+
+    double* latency = (double*)malloc(sizeof(double) * (size_t)(total ? total : 1));
+    double* service = (double*)malloc(sizeof(double) * (size_t)(total ? total : 1));
+    if (!latency || !service) {
+        free(latency); free(service);
+        fprintf(stderr, "loadgen: out of memory while merging results\n");
+        return;
+    }
+    long k = 0;
+    for (int i = 0; i < cfg->concurrency; i++) {
+        memcpy(latency + k, workers[i].latency_ns, sizeof(double) * (size_t)workers[i].count);
+        memcpy(service + k, workers[i].service_ns, sizeof(double) * (size_t)workers[i].count);
+        k += workers[i].count;
+    }
+
+    printf("\n=== Load Generator Results ===\n");
+    printf("Mode:       %s", cfg->rate > 0 ? "open loop" : "closed loop");
+    if (cfg->rate > 0) printf(" (target %.1f req/s)", cfg->rate);
+    printf("\nDuration:   %.3f s\n", elapsed_ns / 1e9);
+    printf("Requests:   %ld ok, %ld errors\n", total, errors);
+    printf("Throughput: %.1f req/s\n", elapsed_ns > 0 ? total / (elapsed_ns / 1e9) : 0.0);
+    if (cfg->protocol == PROTO_ALGO) {
+        printf("Mix:       ");
+        for (int a = 1; a <= MAX_ALGORITHMS; a++) printf(" [%d]=%ld", a, per_algorithm[a]);
+        printf("\n");
+    }
+    print_distribution(cfg->rate > 0 ? "Latency*" : "Latency", latency, total);
+    if (cfg->rate > 0) {
+        print_distribution("Service", service, total);
+        printf("(* measured from intended send time, corrected for coordinated omission)\n");
+    }
+
+    free(latency);
+    free(service);
+}
+
+/* ---------- Command line ---------- */
+
+/**
+ * Parse a mix such as "1:2,3:1,4:1" into per-algorithm weights.
+ */
+static int parse_mix(const char* s, LoadConfig* cfg) {
+    memset(cfg->mix, 0, sizeof(cfg->mix));
+    cfg->mix_total = 0;
+
+    char buf[128];
+    snprintf(buf, sizeof(buf), "%s", s);
+    for (char* tok = strtok(buf, ","); tok; tok = strtok(NULL, ",")) {
+        int id, weight = 1;
+        if (sscanf(tok, "%d:%d", &id, &weight) < 1) return 0;
+        if (id < 1 || id > MAX_ALGORITHMS || weight < 0) return 0;
+        cfg->mix[id] += weight;
+        cfg->mix_total += weight;
+    }
+    return cfg->mix_total > 0;
+}
+
+static void print_usage(const char* prog) {
+    fprintf(stderr,
+        "Usage: %s -p <port> [-P algo|pipeline] [-H host] [-c threads]\n"
+        "          [-d seconds | -N requests] [-R rate] [-m mix]\n"
+        "          [-n min[-max]] [-e density] [-w max_weight] [-s seed]\n"
+        "          [-q source,sink,k,budget_ms,threads[,variant]]\n"
+        "  -P  algo: part7/part8 servers, pipeline: part9 server (default algo)\n"
+        "  -R  aggregate target rate in req/s for open loop (default 0 = closed loop)\n"
+        "  -m  algorithm mix as id:weight list (default 1:1,2:1,3:1,4:1,5:1)\n"
+        "  -n  vertex count or range (default 5-10; part8 accepts at most 20)\n"
+        "  -q  send an algorithm parameter block (-1/0 keep a default)\n",
+        prog);
+}
+
+int main(int argc, char* argv[]) {
+    LoadConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.host = "127.0.0.1";
+    cfg.protocol = PROTO_ALGO;
+    cfg.concurrency = 4;
+    cfg.duration_s = 10.0;
+    cfg.min_vertices = 5;
+    cfg.max_vertices = 10;
+    cfg.density = 0.3;
+    cfg.max_weight = 10;
+    cfg.seed = (unsigned int)time(NULL);
+    parse_mix("1:1,2:1,3:1,4:1,5:1", &cfg);
+
+    int opt;
+    while ((opt = getopt(argc, argv, "p:P:H:c:d:N:R:m:n:e:w:s:q:")) != -1) {
+        switch (opt) {
+            case 'p': cfg.port = atoi(optarg); break;
+            case 'P':
+                if (strcmp(optarg, "algo") == 0) cfg.protocol = PROTO_ALGO;
+                else if (strcmp(optarg, "pipeline") == 0) cfg.protocol = PROTO_PIPELINE;
+                else { print_usage(argv[0]); return 1; }
+                break;
+            case 'H': cfg.host = optarg; break;
+            case 'c': cfg.concurrency = atoi(optarg); break;
+            case 'd': cfg.duration_s = atof(optarg); cfg.max_requests = 0; break;
+            case 'N': cfg.max_requests = atol(optarg); cfg.duration_s = 0; break;
+            case 'R': cfg.rate = atof(optarg); break;
+            case 'm':
+                if (!parse_mix(optarg, &cfg)) { print_usage(argv[0]); return 1; }
+                break;
+            case 'n':
+                if (sscanf(optarg, "%d-%d", &cfg.min_vertices, &cfg.max_vertices) == 1) {
+                    cfg.max_vertices = cfg.min_vertices;
+                }
+                break;
+            case 'e': cfg.density = atof(optarg); break;
+            case 'w': cfg.max_weight = atoi(optarg); break;
+            case 's': cfg.seed = (unsigned int)atoi(optarg); break;
+            case 'q':
+                // The variant is optional: five values keep automatic selection
+                if (sscanf(optarg, "%d,%d,%d,%d,%d,%d", &cfg.params[0], &cfg.params[1],
+                           &cfg.params[2], &cfg.params[3], &cfg.params[4], &cfg.params[5]) < 5) {
+                    print_usage(argv[0]);
+                    return 1;
+                }
+                cfg.use_params = 1;
+                break;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (cfg.port <= 0 || cfg.port > 65535 || cfg.concurrency <= 0 || cfg.rate < 0 ||
+        cfg.min_vertices <= 1 || cfg.max_vertices < cfg.min_vertices ||
+        cfg.max_weight <= 0 || cfg.density < 0.0 || cfg.density > 1.0 ||
+        (cfg.duration_s <= 0 && cfg.max_requests <= 0)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    WorkerState* workers = (WorkerState*)calloc((size_t)cfg.concurrency, sizeof(WorkerState));
+    pthread_t* threads = (pthread_t*)malloc(sizeof(pthread_t) * (size_t)cfg.concurrency);
+    if (!workers || !threads) {
+        free(workers); free(threads);
+        fprintf(stderr, "loadgen: out of memory\n");
+        return 1;
+    }
+
+    printf("=== Graph Server Load Generator ===\n");
+    printf("Target %s:%d (%s protocol), %d threads, %s\n", cfg.host, cfg.port,
+           cfg.protocol == PROTO_ALGO ? "algo" : "pipeline", cfg.concurrency,
+           cfg.rate > 0 ? "open loop" : "closed loop");
+
+    double start = now_ns();
+    for (int i = 0; i < cfg.concurrency; i++) {
+        workers[i].id = i;
+        workers[i].cfg = &cfg;
+        workers[i].start_ns = start;
+        pthread_create(&threads[i], NULL, worker_thread, &workers[i]);
+    }
+    for (int i = 0; i < cfg.concurrency; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    double elapsed = now_ns() - start;
+
+    report(&cfg, workers, elapsed);
+
+    for (int i = 0; i < cfg.concurrency; i++) {
+        free(workers[i].latency_ns);
+        free(workers[i].service_ns);
+    }
+    free(workers);
+    free(threads);
+    return 0;
+}
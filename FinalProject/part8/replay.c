@@ -0,0 +1,363 @@
+/*
+** replay.c -- re-issue requests recorded with `server -r` (see request_trace.h)
+**
+** Each request goes out on a fresh connection at its recorded offset from
+** the start of the trace, divided by the speed factor:
+**
+**   -s 1   original timing (default)
+**   -s 4   four times faster, same order and relative spacing
+**   -s 0   no waiting: every thread sends its next request as soon as it
+**          has a reply (closed loop)
+**
+** Requests are handed out in trace order. Latency is measured from the
+** intended send time, as in loadgen, so a slow server is charged for the
+** requests it delays. With -l, each loop starts one mean inter-arrival
+** gap after the last request of the one before. -o writes every reply
+** in trace order, so the output of two engines on the same trace can be
+** diffed.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <math.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include "../part7/request_trace.h"
+
+#define MAX_RESPONSE_BYTES (16 * 1024 * 1024)
+
+/**
+ * Replay configuration (filled from the command line).
+ */
+typedef struct {
+    const char* host;
+    int port;
+    double speed;           // Time compression factor (0 = no waiting)
+    int concurrency;        // Sending threads
+    int loops;              // Times to play the trace
+    const char* output;     // -o: reply per request, or NULL
+} ReplayConfig;
+
+/**
+ * Outcome of one replayed request.
+ */
+typedef struct {
+    int status;             // 1 ok, 0 rejected by the server, -1 connection error
+    double latency_ns;      // From intended send time
+    double service_ns;      // From actual send time
+    char* reply;            // Reply text (-o only)
+} ReplayResult;
+
+typedef struct {
+    const ReplayConfig* cfg;
+    const TraceRecord* records;
+    size_t count;
+    size_t total;           // count * loops
+    unsigned long long first_ns, span_ns;
+    unsigned long long period_ns;   // Start of one loop to the next
+    double start_ns;
+    size_t next;            // Next request to send (shared, atomic)
+    ReplayResult* results;
+} ReplayState;
+
+/* ---------- Timing ---------- */
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void sleep_until_ns(double target_ns) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)(target_ns / 1e9);
+    ts.tv_nsec = (long)(target_ns - (double)ts.tv_sec * 1e9);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+/* ---------- Networking ---------- */
+
+static int connect_to_server(const ReplayConfig* cfg) {
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) return -1;
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(cfg->port);
+    if (inet_pton(AF_INET, cfg->host, &addr.sin_addr) <= 0 ||
+        connect(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+static int send_all(int sock, const void* buf, size_t len) {
+    const char* p = (const char*)buf;
+    while (len > 0) {
+        ssize_t sent = send(sock, p, len, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return 0;
+        p += sent;
+        len -= (size_t)sent;
+    }
+    return 1;
+}
+
+static int recv_exact(int sock, void* buf, size_t len) {
+    char* p = (char*)buf;
+    while (len > 0) {
+        ssize_t got = recv(sock, p, len, 0);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return 0;
+        p += got;
+        len -= (size_t)got;
+    }
+    return 1;
+}
+
+/**
+ * Send one recorded request and read the [status][length][string + '\0'] reply.
+ * @param reply OUT: malloc'd reply text if @p keep, else untouched
+ * @return 1 ok, 0 rejected, -1 connection error
+ */
+static int issue_request(const ReplayConfig* cfg, const TraceRecord* rec, int keep, char** reply) {
+    int sock = connect_to_server(cfg);
+    if (sock < 0) return -1;
+
+    int header[2];
+    int status = -1;
+    if (send_all(sock, rec->data, rec->length) && recv_exact(sock, header, sizeof(header))) {
+        status = header[0] == 1 ? 1 : 0;
+        if (status == 1) {
+            if (header[1] < 0 || header[1] >= MAX_RESPONSE_BYTES) {
+                status = -1;
+            } else {
+                char* body = (char*)malloc((size_t)header[1] + 1);
+                if (!body || !recv_exact(sock, body, (size_t)header[1] + 1)) {
+                    status = -1;
+                    free(body);
+                } else if (keep) {
+                    body[header[1]] = '\0';
+                    *reply = body;
+                } else {
+                    free(body);
+                }
+            }
+        }
+    }
+    close(sock);
+    return status;
+}
+
+/* ---------- Replay ---------- */
+
+static void* replay_thread(void* arg) {
+    ReplayState* st = (ReplayState*)arg;
+    const ReplayConfig* cfg = st->cfg;
+
+    for (;;) {
+        size_t i = __atomic_fetch_add(&st->next, 1, __ATOMIC_RELAXED);
+        if (i >= st->total) break;
+        size_t loop = i / st->count;
+        const TraceRecord* rec = &st->records[i % st->count];
+
+        double intended = 0;
+        if (cfg->speed > 0) {
+            double offset = (double)(loop * st->period_ns + (rec->arrival_ns - st->first_ns));
+            intended = st->start_ns + offset / cfg->speed;
+            sleep_until_ns(intended);
+        }
+        double sent = now_ns();
+        if (cfg->speed <= 0) intended = sent;
+
+        ReplayResult* res = &st->results[i];
+        res->status = issue_request(cfg, rec, cfg->output != NULL, &res->reply);
+        double done = now_ns();
+        res->latency_ns = done - intended;
+        res->service_ns = done - sent;
+    }
+    return NULL;
+}
+
+/* ---------- Reporting ---------- */
+
+static int cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double* sorted, long count, double pct) {
+    if (count <= 0) return 0.0;
+    long rank = (long)ceil(pct / 100.0 * (double)count);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return sorted[rank - 1];
+}
+
+static void print_distribution(const char* label, double* values, long count) {
+    if (count == 0) {
+        printf("%-9s no samples\n", label);
+        return;
+    }
+    qsort(values, (size_t)count, sizeof(double), cmp_double);
+    double sum = 0.0;
+    for (long i = 0; i < count; i++) sum += values[i];
+
+    printf("%-9s mean %9.3f  p50 %9.3f  p90 %9.3f  p99 %9.3f  p99.9 %9.3f  max %9.3f (ms)\n",
+           label, sum / count / 1e6,
+           percentile(values, count, 50.0) / 1e6, percentile(values, count, 90.0) / 1e6,
+           percentile(values, count, 99.0) / 1e6, percentile(values, count, 99.9) / 1e6,
+           values[count - 1] / 1e6);
+}
+
+static void report(const ReplayState* st, double elapsed_ns) {
+    long ok = 0, rejected = 0, errors = 0;
+    double* latency = (double*)malloc(sizeof(double) * (st->total ? st->total : 1));
+    double* service = (double*)malloc(sizeof(double) * (st->total ? st->total : 1));
+    if (!latency || !service) {
+        free(latency); free(service);
+        fprintf(stderr, "replay: out of memory while merging results\n");
+        return;
+    }
+
+    // Rejections are answers too (a trace can hold invalid requests)
+    long answered = 0;
+    for (size_t i = 0; i < st->total; i++) {
+        const ReplayResult* res = &st->results[i];
+        if (res->status < 0) {
+            errors++;
+            continue;
+        }
+        if (res->status == 1) ok++;
+        else rejected++;
+        latency[answered] = res->latency_ns;
+        service[answered++] = res->service_ns;
+    }
+
+    printf("\n=== Replay Results ===\n");
+    printf("Trace:      %zu requests over %.3f s", st->count, st->span_ns / 1e9);
+    if (st->cfg->loops > 1) printf(", played %d times", st->cfg->loops);
+    printf("\nSpeed:      ");
+    if (st->cfg->speed > 0) printf("x%g\n", st->cfg->speed);
+    else printf("unpaced (%d threads, closed loop)\n", st->cfg->concurrency);
+    printf("Duration:   %.3f s\n", elapsed_ns / 1e9);
+    printf("Requests:   %ld ok, %ld rejected, %ld errors\n", ok, rejected, errors);
+    printf("Throughput: %.1f req/s\n", elapsed_ns > 0 ? answered / (elapsed_ns / 1e9) : 0.0);
+    print_distribution(st->cfg->speed > 0 ? "Latency*" : "Latency", latency, answered);
+    if (st->cfg->speed > 0) {
+        print_distribution("Service", service, answered);
+        printf("(* measured from intended send time, corrected for coordinated omission)\n");
+    }
+
+    free(latency);
+    free(service);
+}
+
+/* One line per request in trace order: index, status, reply */
+static int write_replies(const ReplayState* st, const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return 0;
+    }
+    for (size_t i = 0; i < st->total; i++) {
+        const ReplayResult* res = &st->results[i];
+        fprintf(f, "%zu %d %s\n", i, res->status, res->reply ? res->reply : "");
+    }
+    fclose(f);
+    return 1;
+}
+
+/* ---------- Command line ---------- */
+
+static void print_usage(const char* prog) {
+    fprintf(stderr,
+        "Usage: %s -p <port> [-H host] [-s speed] [-c threads] [-l loops]\n"
+        "          [-o replies.txt] <trace_file>\n"
+        "  -s  Speed factor: 1 = recorded timing (default), 0 = no waiting\n"
+        "  -c  Sending threads (default 16)\n"
+        "  -l  Play the trace this many times back to back (default 1)\n"
+        "  -o  Write every reply, in trace order\n",
+        prog);
+}
+
+int main(int argc, char* argv[]) {
+    ReplayConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.host = "127.0.0.1";
+    cfg.speed = 1.0;
+    cfg.concurrency = 16;
+    cfg.loops = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "p:H:s:c:l:o:")) != -1) {
+        switch (opt) {
+            case 'p': cfg.port = atoi(optarg); break;
+            case 'H': cfg.host = optarg; break;
+            case 's': cfg.speed = atof(optarg); break;
+            case 'c': cfg.concurrency = atoi(optarg); break;
+            case 'l': cfg.loops = atoi(optarg); break;
+            case 'o': cfg.output = optarg; break;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+    if (cfg.port <= 0 || cfg.concurrency < 1 || cfg.loops < 1 || cfg.speed < 0 ||
+        argc - optind != 1) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    ReplayState st;
+    memset(&st, 0, sizeof(st));
+    st.cfg = &cfg;
+    TraceRecord* records = NULL;
+    if (!request_trace_load(argv[optind], &records, &st.count)) {
+        fprintf(stderr, "replay: cannot read trace %s\n", argv[optind]);
+        return 1;
+    }
+    if (st.count == 0) {
+        printf("Trace is empty\n");
+        return 0;
+    }
+    st.records = records;
+    st.total = st.count * (size_t)cfg.loops;
+    st.first_ns = records[0].arrival_ns;
+    st.span_ns = records[st.count - 1].arrival_ns - st.first_ns;
+    // Leave the mean gap between the last request of a loop and the first
+    // of the next, rather than sending both at once
+    st.period_ns = st.span_ns + (st.count > 1 ? st.span_ns / (st.count - 1) : 0);
+    st.results = (ReplayResult*)calloc(st.total, sizeof(ReplayResult));
+    if (!st.results) {
+        fprintf(stderr, "replay: out of memory\n");
+        request_trace_free_records(records, st.count);
+        return 1;
+    }
+
+    printf("Replaying %zu requests against %s:%d\n", st.total, cfg.host, cfg.port);
+    pthread_t* threads = (pthread_t*)malloc(sizeof(pthread_t) * (size_t)cfg.concurrency);
+    if (!threads) return 1;
+    st.start_ns = now_ns();
+    for (int i = 0; i < cfg.concurrency; i++) pthread_create(&threads[i], NULL, replay_thread, &st);
+    for (int i = 0; i < cfg.concurrency; i++) pthread_join(threads[i], NULL);
+    double elapsed = now_ns() - st.start_ns;
+
+    report(&st, elapsed);
+    int ok = !cfg.output || write_replies(&st, cfg.output);
+
+    for (size_t i = 0; i < st.total; i++) free(st.results[i].reply);
+    free(st.results);
+    free(threads);
+    request_trace_free_records(records, st.count);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,563 @@
+/*
+** router.c -- sharding router in front of several part8 servers
+**
+** Accepts client connections on one port and forwards each request to one
+** of N backend servers, unchanged. Clients keep speaking the algo protocol.
+**
+**   spawn mode:    router [-n N] [-s ./server] <port> starts N servers on
+**                  ports port+1 .. port+N and restarts any that exit
+**   backend mode:  router -b host:port [-b host:port ...] <port> routes to
+**                  servers that are already running (other machines too)
+**
+** Requests are routed by a hash of the graph (everything after the
+** algorithm id and parameter block), so every request for one graph goes
+** to the same backend whatever the algorithm. The backend is chosen by
+** rendezvous hashing: each backend scores hash(graph, backend) and the
+** highest healthy score wins. When a backend is down, only its graphs move
+** and each goes to its own next-ranked backend.
+**
+** A health thread connects to every backend once per second. A backend
+** that fails a probe or a forwarded request is skipped until a probe
+** succeeds again. A request that got no response bytes is retried on the
+** next-ranked backend; the servers do not keep state between requests, so
+** a retry is safe.
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <arpa/inet.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+#include "../part7/algorithm_params.h"
+#include "../part7/graph_batch.h"
+
+#define MAX_BACKENDS 64
+#define ROUTER_THREADS 16
+#define BUFFER_SIZE 4096
+#define MAX_REQUEST_BYTES (16 * 1024 * 1024 + 64)   // largest batch plus its header
+#define HEALTH_INTERVAL_MS 1000
+#define CONNECT_TIMEOUT_MS 1000
+
+/**
+ * One backend server and its counters. healthy, requests and failures are
+ * shared between the workers and the health thread (__atomic builtins).
+ */
+typedef struct {
+    char host[128];
+    int port;
+    uint64_t seed;          // Rendezvous hashing salt, from "host:port"
+    pid_t pid;              // Child process in spawn mode, 0 otherwise
+    int healthy;
+    long requests;          // Requests answered
+    long failures;          // Forwarding failures (probes not counted)
+} Backend;
+
+static Backend backends[MAX_BACKENDS];
+static int num_backends = 0;
+static const char* server_path = "./server";
+static int verbose = 0;             // -v: keep the backend servers' output
+static sigset_t child_mask;         // Signal mask before the router blocked its signals
+
+static int listener_fd = -1;
+static pthread_mutex_t accept_mutex = PTHREAD_MUTEX_INITIALIZER;
+static volatile sig_atomic_t shutdown_flag = 0;
+static volatile sig_atomic_t reload_flag = 0;
+static long failovers = 0;          // Requests answered by other than their first choice
+static long unrouted = 0;           // Requests no backend answered
+
+/* ---------- Hashing ---------- */
+
+static uint64_t fnv1a(const void* data, size_t len, uint64_t h) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+#define FNV_OFFSET 0xcbf29ce484222325ULL
+
+/* splitmix64 finalizer: spreads the combined key over all 64 bits */
+static uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+ * Backends in rendezvous order for @p key: highest score first.
+ * @param order OUT: num_backends indices
+ */
+static void rank_backends(uint64_t key, int* order) {
+    uint64_t score[MAX_BACKENDS];
+    for (int i = 0; i < num_backends; i++) {
+        uint64_t s = mix64(key ^ backends[i].seed);
+        int j = i;
+        while (j > 0 && score[j - 1] < s) {
+            score[j] = score[j - 1];
+            order[j] = order[j - 1];
+            j--;
+        }
+        score[j] = s;
+        order[j] = i;
+    }
+}
+
+/* ---------- Request framing ---------- */
+
+/**
+ * Size of the request starting with the @p have ints in @p w, following
+ * the server's parsing.
+ * @param graph_offset OUT: first int of the graph (after id and parameters)
+ * @return Total bytes, -1 if the header is not complete yet, or 0 if the
+ *         request is malformed (it is forwarded as read and the backend
+ *         rejects it)
+ */
+static long long request_bytes(const int* w, size_t have, size_t* graph_offset) {
+    *graph_offset = 1;
+    if (have < 1) return -1;
+
+    int id = w[0];
+    if (id <= 0) return 0;
+    size_t off = 1;
+    if (id & ALGO_PARAMS_FLAG) {
+        off += ALGO_PARAMS_WIRE_INTS;
+        id &= ~ALGO_PARAMS_FLAG;
+    }
+    int batch = (id & ALGO_BATCH_FLAG) != 0;
+    id &= ~ALGO_BATCH_FLAG;
+    int weighted = id == 2 || id == 3 || id >= 6;
+    *graph_offset = off;
+
+    // [count][payload_ints], [n][m] or [n], then the body
+    size_t head = batch || weighted ? 2 : 1;
+    if (have < off + head) return -1;
+    long long body;
+    if (batch) body = w[off + 1];
+    else if (weighted) body = 3LL * w[off + 1];
+    else body = (long long)w[off] * w[off];
+
+    long long total = ((long long)(off + head) + body) * (long long)sizeof(int);
+    if (body < 0 || total > MAX_REQUEST_BYTES) return 0;
+    return total;
+}
+
+/**
+ * Read one whole request from a client.
+ * @param out OUT: malloc'd request bytes
+ * @param key OUT: hash of the graph part
+ * @return Request length, or 0 if the client sent nothing
+ */
+static size_t read_request(int fd, char** out, uint64_t* key) {
+    size_t cap = BUFFER_SIZE, len = 0, graph_offset = 1;
+    char* buf = malloc(cap);
+    if (!buf) return 0;
+
+    for (;;) {
+        long long need = request_bytes((const int*)buf, len / sizeof(int), &graph_offset);
+        if (need == 0 && len > 0) break;
+        if (need > 0 && len >= (size_t)need) break;
+
+        if (need > 0 && (size_t)need > cap) {
+            char* grown = realloc(buf, (size_t)need);
+            if (!grown) break;
+            buf = grown;
+            cap = (size_t)need;
+        }
+        size_t want = need > 0 ? (size_t)need - len : cap - len;
+        if (want == 0) break;
+        ssize_t got = recv(fd, buf + len, want, 0);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) break;
+        len += (size_t)got;
+    }
+
+    size_t graph_bytes = graph_offset * sizeof(int);
+    *key = len > graph_bytes ? fnv1a(buf + graph_bytes, len - graph_bytes, FNV_OFFSET)
+                             : FNV_OFFSET;
+    if (len == 0) {
+        free(buf);
+        buf = NULL;
+    }
+    *out = buf;
+    return len;
+}
+
+/* ---------- Networking ---------- */
+
+static int send_all(int sock, const void* buf, size_t len) {
+    const char* p = (const char*)buf;
+    while (len > 0) {
+        ssize_t sent = send(sock, p, len, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return 0;
+        p += sent;
+        len -= (size_t)sent;
+    }
+    return 1;
+}
+
+/**
+ * Connect to a backend, giving up after CONNECT_TIMEOUT_MS.
+ * @return Socket, or -1
+ */
+static int connect_backend(const Backend* b) {
+    char port[16];
+    snprintf(port, sizeof(port), "%d", b->port);
+    struct addrinfo hints, *res = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(b->host, port, &hints, &res) != 0 || !res) return -1;
+
+    int sock = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sock >= 0) {
+        // Linux applies the send timeout to connect(); cleared afterwards
+        struct timeval tv = {CONNECT_TIMEOUT_MS / 1000, (CONNECT_TIMEOUT_MS % 1000) * 1000};
+        setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        if (connect(sock, res->ai_addr, res->ai_addrlen) < 0) {
+            close(sock);
+            sock = -1;
+        } else {
+            struct timeval none = {0, 0};
+            setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &none, sizeof(none));
+        }
+    }
+    freeaddrinfo(res);
+    return sock;
+}
+
+static void set_healthy(int i, int healthy) {
+    int was = __atomic_exchange_n(&backends[i].healthy, healthy, __ATOMIC_RELAXED);
+    if (was != healthy) {
+        printf("[ROUTER] Backend %d (%s:%d) is %s\n", i, backends[i].host, backends[i].port,
+               healthy ? "up" : "down");
+    }
+}
+
+/**
+ * Forward @p request to backend @p i and relay its response to the client.
+ * @return 1 once any response bytes reached the client (the request is
+ *         answered, even if the relay broke off later), 0 to try another
+ *         backend
+ */
+static int forward(int i, int client_fd, const char* request, size_t len) {
+    int sock = connect_backend(&backends[i]);
+    if (sock < 0) return 0;
+
+    // A send error still leaves a response to read: the server may have
+    // answered [0,0] after its first read and closed on the rest
+    send_all(sock, request, len);
+    shutdown(sock, SHUT_WR);
+
+    char buf[BUFFER_SIZE];
+    size_t relayed = 0;
+    for (;;) {
+        ssize_t got = recv(sock, buf, sizeof(buf), 0);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) break;
+        if (!send_all(client_fd, buf, (size_t)got)) break;
+        relayed += (size_t)got;
+    }
+    close(sock);
+    return relayed > 0;
+}
+
+/* Route one client request */
+static void process_client(int client_fd) {
+    char* request;
+    uint64_t key;
+    size_t len = read_request(client_fd, &request, &key);
+    if (len == 0) {
+        close(client_fd);
+        return;
+    }
+
+    // Healthy backends in rank order, then the rest in case a probe is stale
+    int order[MAX_BACKENDS];
+    rank_backends(key, order);
+    int answered = 0, attempts = 0;
+    for (int pass = 0; pass < 2 && !answered; pass++) {
+        for (int r = 0; r < num_backends && !answered; r++) {
+            int i = order[r];
+            if (__atomic_load_n(&backends[i].healthy, __ATOMIC_RELAXED) != (pass == 0)) continue;
+            attempts++;
+            if (forward(i, client_fd, request, len)) {
+                __atomic_fetch_add(&backends[i].requests, 1, __ATOMIC_RELAXED);
+                answered = 1;
+            } else {
+                __atomic_fetch_add(&backends[i].failures, 1, __ATOMIC_RELAXED);
+                set_healthy(i, 0);
+            }
+        }
+    }
+
+    if (!answered) {
+        int response[2] = {0, 0};
+        send_all(client_fd, response, sizeof(response));
+        __atomic_fetch_add(&unrouted, 1, __ATOMIC_RELAXED);
+    } else if (attempts > 1) {
+        __atomic_fetch_add(&failovers, 1, __ATOMIC_RELAXED);
+    }
+    free(request);
+    close(client_fd);
+}
+
+/* Worker thread: the workers take turns accepting, then relay outside the lock */
+static void* worker_thread(void* arg) {
+    (void)arg;
+    while (!shutdown_flag) {
+        pthread_mutex_lock(&accept_mutex);
+        int client_fd = shutdown_flag ? -1 : accept4(listener_fd, NULL, NULL, SOCK_CLOEXEC);
+        pthread_mutex_unlock(&accept_mutex);
+
+        if (client_fd >= 0) process_client(client_fd);
+        else if (errno != EINTR && errno != ECONNABORTED) break;
+    }
+    return NULL;
+}
+
+/* ---------- Backend processes ---------- */
+
+static void spawn_backend(int i) {
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return;
+    }
+    if (pid == 0) {
+#ifdef __linux__
+        prctl(PR_SET_PDEATHSIG, SIGTERM);
+#endif
+        // The mask survives exec; the server must get SIGINT, SIGTERM and SIGHUP
+        pthread_sigmask(SIG_SETMASK, &child_mask, NULL);
+        if (!verbose) {
+            int null_fd = open("/dev/null", O_WRONLY);
+            if (null_fd >= 0) dup2(null_fd, STDOUT_FILENO);
+        }
+        char port[16];
+        snprintf(port, sizeof(port), "%d", backends[i].port);
+        execl(server_path, server_path, port, (char*)NULL);
+        perror(server_path);
+        _exit(127);
+    }
+    backends[i].pid = pid;
+}
+
+static void sleep_ms(int ms) {
+    struct timespec ts = {ms / 1000, (long)(ms % 1000) * 1000000L};
+    while (nanosleep(&ts, &ts) < 0 && errno == EINTR) {
+    }
+}
+
+/* Probe every backend once; restart spawned servers that exited */
+static int check_backends(void) {
+    int up = 0;
+    for (int i = 0; i < num_backends; i++) {
+        if (backends[i].pid > 0 && waitpid(backends[i].pid, NULL, WNOHANG) == backends[i].pid) {
+            printf("[ROUTER] Backend %d (port %d) exited, restarting\n", i, backends[i].port);
+            set_healthy(i, 0);
+            spawn_backend(i);
+        }
+        int sock = connect_backend(&backends[i]);
+        if (sock >= 0) close(sock);
+        set_healthy(i, sock >= 0);
+        up += sock >= 0;
+    }
+    return up;
+}
+
+static void* health_thread(void* arg) {
+    (void)arg;
+    while (!shutdown_flag) {
+        sleep_ms(HEALTH_INTERVAL_MS);
+        if (!shutdown_flag) check_backends();
+    }
+    return NULL;
+}
+
+static void stop_backends(void) {
+    for (int i = 0; i < num_backends; i++) {
+        if (backends[i].pid <= 0) continue;
+        kill(backends[i].pid, SIGTERM);
+        waitpid(backends[i].pid, NULL, 0);
+        backends[i].pid = 0;
+    }
+}
+
+/* ---------- Setup ---------- */
+
+static int add_backend(const char* host, int port) {
+    if (num_backends >= MAX_BACKENDS || port <= 0 || port > 65535) return 0;
+    Backend* b = &backends[num_backends++];
+    memset(b, 0, sizeof(*b));
+    snprintf(b->host, sizeof(b->host), "%s", host);
+    b->port = port;
+
+    char name[160];
+    int len = snprintf(name, sizeof(name), "%s:%d", b->host, port);
+    b->seed = mix64(fnv1a(name, (size_t)len, FNV_OFFSET));
+    return 1;
+}
+
+/* Parse "host:port" or "port" (localhost) */
+static int parse_backend(const char* arg) {
+    const char* colon = strrchr(arg, ':');
+    if (!colon) return add_backend("127.0.0.1", atoi(arg));
+    char host[128];
+    size_t len = (size_t)(colon - arg);
+    if (len == 0 || len >= sizeof(host)) return 0;
+    memcpy(host, arg, len);
+    host[len] = '\0';
+    return add_backend(host, atoi(colon + 1));
+}
+
+static void signal_handler(int sig) {
+    if (sig == SIGHUP) reload_flag = 1;
+    else shutdown_flag = 1;
+}
+
+static void print_usage(const char* prog) {
+    fprintf(stderr,
+        "Usage: %s [-n backends] [-s server_path] [-v] <port>\n"
+        "       %s -b host:port [-b host:port ...] <port>\n"
+        "  -n  Servers to start on ports port+1 .. port+n (default: one per CPU)\n"
+        "  -s  Server binary to start (default ./server)\n"
+        "  -b  Route to a running server instead of starting them (repeatable)\n"
+        "  -v  Keep the started servers' output\n",
+        prog, prog);
+}
+
+static void print_stats(void) {
+    printf("\n=== Router statistics ===\n");
+    for (int i = 0; i < num_backends; i++) {
+        printf("Backend %d (%s:%d): %ld requests, %ld failures\n", i, backends[i].host,
+               backends[i].port, backends[i].requests, backends[i].failures);
+    }
+    printf("Failovers: %ld, unrouted: %ld\n", failovers, unrouted);
+}
+
+int main(int argc, char* argv[]) {
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int spawn_count = cpus > 0 ? (int)(cpus < MAX_BACKENDS ? cpus : MAX_BACKENDS) : 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:b:v")) != -1) {
+        switch (opt) {
+            case 'n': spawn_count = atoi(optarg); break;
+            case 's': server_path = optarg; break;
+            case 'b':
+                if (!parse_backend(optarg)) {
+                    fprintf(stderr, "Bad backend '%s'\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'v': verbose = 1; break;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+    if (argc - optind != 1 || spawn_count < 1 || spawn_count > MAX_BACKENDS) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    int port = atoi(argv[optind]);
+
+    int spawn = num_backends == 0;
+    if (spawn) {
+        for (int i = 0; i < spawn_count; i++) {
+            if (!add_backend("127.0.0.1", port + 1 + i)) {
+                print_usage(argv[0]);
+                return 1;
+            }
+        }
+    }
+
+    // Only the main thread takes signals; the others inherit this mask
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigaddset(&mask, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &mask, &child_mask);
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = signal_handler;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGHUP, &sa, NULL);
+
+    listener_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int reuse = 1;
+    setsockopt(listener_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = INADDR_ANY;
+    addr.sin_port = htons(port);
+    if (bind(listener_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        perror("bind");
+        return 1;
+    }
+    if (listen(listener_fd, 128) < 0) {
+        perror("listen");
+        return 1;
+    }
+
+    printf("=== Sharding Router ===\n");
+    printf("Port: %d, backends: %d (%s), threads: %d\n", port, num_backends,
+           spawn ? "started" : "external", ROUTER_THREADS);
+    if (spawn) {
+        for (int i = 0; i < num_backends; i++) spawn_backend(i);
+    }
+
+    // Give started servers a moment to listen before taking requests
+    for (int tries = 0; tries < 30 && check_backends() < num_backends; tries++) {
+        sleep_ms(100);
+    }
+
+    pthread_t workers[ROUTER_THREADS], health;
+    for (int i = 0; i < ROUTER_THREADS; i++) pthread_create(&workers[i], NULL, worker_thread, NULL);
+    pthread_create(&health, NULL, health_thread, NULL);
+    printf("Router listening, Ctrl+C to stop (SIGHUP is passed on to started servers)\n");
+
+    while (!shutdown_flag) {
+        sigsuspend(&child_mask);
+        if (reload_flag) {
+            reload_flag = 0;
+            for (int i = 0; i < num_backends; i++) {
+                if (backends[i].pid > 0) kill(backends[i].pid, SIGHUP);
+            }
+            printf("[ROUTER] Passed SIGHUP to the backends\n");
+        }
+    }
+
+    // Wake the worker blocked in accept(); the others see the flag
+    shutdown(listener_fd, SHUT_RDWR);
+    for (int i = 0; i < ROUTER_THREADS; i++) pthread_join(workers[i], NULL);
+    pthread_join(health, NULL);
+    close(listener_fd);
+
+    stop_backends();
+    print_stats();
+    return 0;
+}
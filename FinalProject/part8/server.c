@@ -9,8 +9,14 @@
 
 #include "../part7/graph.h"
 #include "../part7/factory.h"
+#include "../part7/graph_alloc.h"
+#include "../part7/graph_batch.h"
+#include "../part7/simd_kernels.h"
+#include "../part7/strategy_plugin.h"
+#include "../part7/request_trace.h"
 #define THREAD_POOL_SIZE 4
 #define BUFFER_SIZE 4096
+#define BATCH_MAX_BYTES (16 * 1024 * 1024)
 
 static int listener_fd;
 static pthread_mutex_t leader_mutex = PTHREAD_MUTEX_INITIALIZER;
@@ -18,6 +24,21 @@ static pthread_cond_t leader_cond = PTHREAD_COND_INITIALIZER;
 static int current_leader = 0;
 static volatile int shutdown_flag = 0;
 static int total_requests = 0;
+static int alloc_report = 0;      // -a: print allocation stats per request
+static RequestTrace* trace = NULL; // -r: record every request
+
+/* A batch request waiting for its payload before it is traced */
+typedef struct {
+    const char* head;     // First read, before the handlers rewrite it
+    int head_bytes;
+    unsigned long long arrival_ns;
+} PendingTrace;
+
+static void trace_batch(const PendingTrace* pending, const void* tail, size_t tail_len) {
+    if (!pending) return;
+    request_trace_record(trace, pending->arrival_ns, pending->head, pending->head_bytes,
+                         tail, tail_len);
+}
 
 /* Send response to client */
 static void send_response(int client_fd, const char* result) {
@@ -41,7 +62,8 @@ static void send_response(int client_fd, const char* result) {
 }
 
 /* Process weighted algorithm request */
-static void process_weighted_request(int client_fd, int* data, int size) {
+static void process_weighted_request(int client_fd, int* data, int size,
+                                     const AlgorithmParams* params, AlgorithmWorkspace* ws) {
     if (size < 3) {
         send_response(client_fd, NULL);
         return;
@@ -87,7 +109,7 @@ static void process_weighted_request(int client_fd, int* data, int size) {
     }
     
     // Execute using Factory Pattern from part 7
-    char* result = algorithm_factory_execute(g, algorithm_id);
+    char* result = algorithm_factory_execute_params(g, algorithm_id, params, ws);
     send_response(client_fd, result);
     
     if (result) free(result);
@@ -95,7 +117,8 @@ static void process_weighted_request(int client_fd, int* data, int size) {
 }
 
 /* Process unweighted algorithm request */
-static void process_unweighted_request(int client_fd, int* data, int size) {
+static void process_unweighted_request(int client_fd, int* data, int size,
+                                       const AlgorithmParams* params, AlgorithmWorkspace* ws) {
     if (size < 2) {
         send_response(client_fd, NULL);
         return;
@@ -128,15 +151,88 @@ static void process_unweighted_request(int client_fd, int* data, int size) {
     }
     
     // Execute using Factory Pattern from part 7
-    char* result = algorithm_factory_execute(g, algorithm_id);
+    char* result = algorithm_factory_execute_params(g, algorithm_id, params, ws);
     send_response(client_fd, result);
     
     if (result) free(result);
     graph_destroy(g);
 }
 
+/* Receive exactly len bytes */
+static int recv_all(int client_fd, char* buf, size_t len) {
+    while (len > 0) {
+        ssize_t got = recv(client_fd, buf, len, 0);
+        if (got <= 0) return 0;
+        buf += got;
+        len -= (size_t)got;
+    }
+    return 1;
+}
+
+/* Process batch request: [algorithm_id][count][payload_ints] then the graphs */
+static void process_batch_request(int client_fd, int* data, int size, int extra_bytes,
+                                  const AlgorithmParams* params, const PendingTrace* pending) {
+    if (size < 3) {
+        trace_batch(pending, NULL, 0);
+        send_response(client_fd, NULL);
+        return;
+    }
+    
+    int algorithm_id = data[0];
+    int count = data[1];
+    int payload_ints = data[2];
+    
+    printf("  Processing batch of %d graphs for algorithm %d\n", count, algorithm_id);
+    
+    // Every graph takes at least [n][m], which bounds count before it sizes anything
+    if (count < 0 || payload_ints < 0 || payload_ints > BATCH_MAX_BYTES / (int)sizeof(int) ||
+        count > payload_ints / 2) {
+        trace_batch(pending, NULL, 0);
+        send_response(client_fd, NULL);
+        return;
+    }
+    
+    // The payload can be larger than the first read; fetch the rest
+    int* payload = data + 3;
+    int* large = NULL;
+    size_t have = (size_t)(size - 3) * sizeof(int) + extra_bytes;
+    size_t need = (size_t)payload_ints * sizeof(int);
+    if (have < need) {
+        large = malloc(need);
+        if (!large) {
+            trace_batch(pending, NULL, 0);
+            send_response(client_fd, NULL);
+            return;
+        }
+        memcpy(large, payload, have);
+        if (!recv_all(client_fd, (char*)large + have, need - have)) {
+            trace_batch(pending, NULL, 0);
+            free(large);
+            send_response(client_fd, NULL);
+            return;
+        }
+        payload = large;
+    }
+    trace_batch(pending, large ? (char*)large + have : NULL, large ? need - have : 0);
+    
+    GraphBatch batch;
+    graph_batch_init(&batch);
+    long long* results = malloc((count > 0 ? count : 1) * sizeof(long long));
+    char* result = NULL;
+    if (results && graph_batch_decode(&batch, count, payload, payload_ints) == payload_ints &&
+        graph_batch_run(&batch, algorithm_id, params, results)) {
+        result = graph_batch_format_results(results, count);
+    }
+    send_response(client_fd, result);
+    
+    free(result);
+    free(results);
+    free(large);
+    graph_batch_free(&batch);
+}
+
 /* Process single client request */
-static void process_client(int client_fd) {
+static void process_client(int client_fd, AlgorithmWorkspace* ws) {
     int buffer[BUFFER_SIZE / sizeof(int)];
     int bytes = recv(client_fd, buffer, BUFFER_SIZE, 0);
     
@@ -145,6 +241,22 @@ static void process_client(int client_fd) {
         return;
     }
     
+    // -r: record the request as read; a batch once its payload is complete
+    PendingTrace pending = {NULL, 0, 0};
+    char trace_head[BUFFER_SIZE];
+    int traced_batch = 0;
+    if (trace) {
+        pending.arrival_ns = request_trace_clock(trace);
+        traced_batch = bytes >= (int)sizeof(int) && buffer[0] > 0 && (buffer[0] & ALGO_BATCH_FLAG);
+        if (traced_batch) {
+            memcpy(trace_head, buffer, bytes);
+            pending.head = trace_head;
+            pending.head_bytes = bytes;
+        } else {
+            request_trace_record(trace, pending.arrival_ns, buffer, bytes, NULL, 0);
+        }
+    }
+    
     int size = bytes / sizeof(int);
     if (size < 1) {
         send_response(client_fd, NULL);
@@ -152,19 +264,66 @@ static void process_client(int client_fd) {
         return;
     }
     
+    int* data = buffer;
     int algorithm_id = buffer[0];
-    if (algorithm_id < 1 || algorithm_id > 5) {
+    
+    // Optional parameter block: [id | ALGO_PARAMS_FLAG][source][sink][k][budget_ms][threads][variant][n]...
+    AlgorithmParams params;
+    algorithm_params_init(&params);
+    if (algorithm_id > 0 && (algorithm_id & ALGO_PARAMS_FLAG)) {
+        if (size < 1 + ALGO_PARAMS_WIRE_INTS) {
+            if (traced_batch) trace_batch(&pending, NULL, 0);
+            send_response(client_fd, NULL);
+            close(client_fd);
+            return;
+        }
+        algorithm_params_decode(&params, buffer + 1);
+        algorithm_id &= ~ALGO_PARAMS_FLAG;
+        
+        // Drop the block so the handlers see the plain request layout
+        data = buffer + ALGO_PARAMS_WIRE_INTS;
+        size -= ALGO_PARAMS_WIRE_INTS;
+        data[0] = algorithm_id;
+    }
+    
+    // Batch requests carry many graphs for one algorithm
+    int batch = algorithm_id > 0 && (algorithm_id & ALGO_BATCH_FLAG);
+    if (batch) {
+        algorithm_id &= ~ALGO_BATCH_FLAG;
+        data[0] = algorithm_id;
+    }
+    
+    // Batches cover algorithms 1-5; single requests also take 6-9 and plugin IDs
+    int builtin = algorithm_id >= 1 && algorithm_id <= 9;
+    int valid = batch ? algorithm_id >= 1 && algorithm_id <= 5
+                      : builtin || algorithm_get_strategy(algorithm_id);
+    if (!valid) {
+        if (traced_batch) trace_batch(&pending, NULL, 0);
         send_response(client_fd, NULL);
         close(client_fd);
         return;
     }
     
+    // Allocation stats are per thread, so this request is measured in isolation
+    if (alloc_report) graph_alloc_stats_reset();
+
     // Route to appropriate handler
-    if (algorithm_id == 2 || algorithm_id == 3) {
-        process_weighted_request(client_fd, buffer, size);
+    if (batch) {
+        process_batch_request(client_fd, data, size, bytes % (int)sizeof(int), &params,
+                              traced_batch ? &pending : NULL);
+    } else if (algorithm_id == 2 || algorithm_id == 3 || algorithm_id >= 6) {
+        process_weighted_request(client_fd, data, size, &params, ws);
     } else {
-        process_unweighted_request(client_fd, buffer, size);
+        process_unweighted_request(client_fd, data, size, &params, ws);
+    }
+
+    if (alloc_report) {
+        printf("[ALLOC] Request (algorithm %d): ", algorithm_id);
+        graph_alloc_print_report(stdout, 5);
     }
+
+    // Keep the scratch memory, sized for the largest request so far
+    workspace_reset(ws);
     
     close(client_fd);
     total_requests++;
@@ -175,6 +334,13 @@ static void* worker_thread(void* arg) {
     int thread_id = *(int*)arg;
     free(arg);
     
+    // Per-thread scratch memory: steady-state requests do not allocate in the algorithms
+    AlgorithmWorkspace ws;
+    if (!workspace_init(&ws, 0)) {
+        printf("[LF] Thread %d: failed to initialize workspace\n", thread_id);
+        return NULL;
+    }
+    
     printf("[LF] Thread %d started\n", thread_id);
     
     while (!shutdown_flag) {
@@ -211,11 +377,12 @@ static void* worker_thread(void* arg) {
             
             // Process client (now as worker, not leader)
             printf("[LF] Thread %d processing as Worker\n", thread_id);
-            process_client(client_fd);
+            process_client(client_fd, &ws);
             printf("[LF] Thread %d finished processing\n", thread_id);
         }
     }
     
+    workspace_destroy(&ws);
     printf("[LF] Thread %d exiting\n", thread_id);
     return NULL;
 }
@@ -227,15 +394,43 @@ static void signal_handler(int sig) {
     pthread_cond_broadcast(&leader_cond);
 }
 
+/* SIGHUP: reload the strategy plugins before the next request */
+static void reload_handler(int sig) {
+    (void)sig;
+    strategy_plugins_request_reload();
+}
+
 /* Main function */
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        printf("Usage: %s <port>\n", argv[0]);
+    int flag;
+    const char* trace_path = NULL;
+    while ((flag = getopt(argc, argv, "ar:")) != -1) {
+        if (flag == 'a') {
+            alloc_report = 1;
+        } else if (flag == 'r') {
+            trace_path = optarg;
+        } else {
+            printf("Usage: %s [-a] [-r trace_file] <port>\n", argv[0]);
+            return 1;
+        }
+    }
+    if (argc - optind != 1) {
+        printf("Usage: %s [-a] [-r trace_file] <port>\n", argv[0]);
         return 1;
     }
     
-    int port = atoi(argv[1]);
+    int port = atoi(argv[optind]);
+    if (alloc_report) graph_alloc_set_profiling(1);
+    if (trace_path) {
+        trace = request_trace_open(trace_path);
+        if (!trace) {
+            perror(trace_path);
+            return 1;
+        }
+        printf("Recording requests to %s\n", trace_path);
+    }
     signal(SIGINT, signal_handler);
+    signal(SIGHUP, reload_handler);
     
     printf("=== Simple Leader-Follower Server ===\n");
     printf("Port: %d, Threads: %d\n", port, THREAD_POOL_SIZE);
@@ -261,6 +456,8 @@ int main(int argc, char* argv[]) {
     }
     
     printf("Server listening...\n");
+    printf("SIMD kernels: %s\n", simd_level_name(simd_level()));
+    printf("Strategy plugins: %d loaded (SIGHUP reloads)\n", strategy_plugins_init());
     
     // Create thread pool
     pthread_t threads[THREAD_POOL_SIZE];
@@ -281,6 +478,7 @@ int main(int argc, char* argv[]) {
     }
     
     close(listener_fd);
+    if (trace) printf("Recorded %lld requests\n", request_trace_close(trace));
     printf("Server stopped. Total requests: %d\n", total_requests);
     return 0;
 }
\ No newline at end of file
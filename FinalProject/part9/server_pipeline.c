@@ -14,11 +14,17 @@
 #include "../part7/maxflow.h"
 #include "../part7/maxclique.h"
 #include "../part7/cliquecount.h"
+#include "../part7/perfcounters.h"
+#include "../part7/algorithm_params.h"
+#include "../part7/graph_profile.h"
+#include "../part7/cost_model.h"
+#include "../part7/factory.h"
 
 #define PORT 3490
 #define BACKLOG 10
 #define MAX_QUEUE 32
 #define MAX_EDGES 1000
+#define NUM_STAGES 4
 
 // === Job Structure ===
 typedef struct {
@@ -26,6 +32,8 @@ typedef struct {
     Graph *graph;
     int client_sock;
     time_t start_time;
+    AlgorithmParams params;   // Request parameters (defaults unless the client sent a block)
+    GraphProfile profile;     // Taken once at load time, used to pick each stage's variant
     
     // Results from each stage
     char mst_result[256];
@@ -33,6 +41,9 @@ typedef struct {
     char maxclique_result[256];
     char cliquecount_result[256];
     
+    // Per-stage instrumentation (filled only when -H is given)
+    PerfSample stage_perf[NUM_STAGES];
+    
     char final_response[2048];
 } Job;
 
@@ -56,6 +67,52 @@ volatile int shutdown_flag = 0;
 static int next_job_id = 1;
 pthread_mutex_t job_id_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+// === Stage Metrics ===
+static int hw_counters_enabled = 0;
+static const char* stage_names[NUM_STAGES] = {"MST", "MaxFlow", "MaxClique", "CliqueCount"};
+static PerfSample stage_totals[NUM_STAGES];
+static pthread_mutex_t metrics_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Open the calling stage thread's counters (wall time only if the PMU is unavailable)
+static void stage_counters_open(int stage, PerfCounters *pc) {
+    if (!hw_counters_enabled) return;
+    if (!perf_counters_open(pc)) {
+        printf("[Stage %d] Hardware counters unavailable, recording wall time only\n", stage + 1);
+    }
+}
+
+static void stage_counters_begin(PerfCounters *pc) {
+    if (hw_counters_enabled) perf_counters_start(pc);
+}
+
+// Record this stage's measurement in the job and in the cumulative totals
+static void stage_counters_end(int stage, PerfCounters *pc, Job *job) {
+    if (!hw_counters_enabled) return;
+    perf_counters_stop(pc, &job->stage_perf[stage]);
+    
+    pthread_mutex_lock(&metrics_mutex);
+    perf_sample_add(&stage_totals[stage], &job->stage_perf[stage]);
+    pthread_mutex_unlock(&metrics_mutex);
+}
+
+static void stage_counters_close(PerfCounters *pc) {
+    if (hw_counters_enabled) perf_counters_close(pc);
+}
+
+void print_stage_metrics(void) {
+    if (!hw_counters_enabled) return;
+    
+    char line[256];
+    printf("[Metrics] Cumulative per-stage counters (per job averages):\n");
+    pthread_mutex_lock(&metrics_mutex);
+    for (int i = 0; i < NUM_STAGES; i++) {
+        perf_sample_format(&stage_totals[i], line, sizeof(line));
+        printf("[Metrics]   Stage %d (%s), %llu jobs: %s\n",
+               i + 1, stage_names[i], stage_totals[i].calls, line);
+    }
+    pthread_mutex_unlock(&metrics_mutex);
+}
+
 // === Queue Management Functions ===
 void queue_init(BlockingQueue *q, const char* name) {
     q->head = q->tail = q->count = 0;
@@ -114,21 +171,41 @@ Job* queue_pop(BlockingQueue *q) {
 }
 
 // === Stage 1: MST Computation ===
+/**
+ * Copy of the job's parameters with the variant of @p algorithm_id resolved
+ * (the client's choice if it names one of its variants, else the cost model's).
+ */
+static AlgorithmParams job_stage_params(const Job *job, int algorithm_id) {
+    AlgorithmParams params = job->params;
+    params.variant = algorithm_select_variant(algorithm_id, &job->profile, job->params.variant);
+    return params;
+}
+
 void* stage1_mst_worker(void *arg) {
     printf("[Stage 1] MST worker started\n");
     
+    PerfCounters pc;
+    stage_counters_open(0, &pc);
+    AlgorithmWorkspace ws;     // Scratch memory reused by every job of this stage
+    workspace_init(&ws, 0);
+    
     while (!shutdown_flag) {
         Job* job = queue_pop(&stage1_queue);
         if (!job) continue;
         
-        printf("[Stage 1] Processing Job %d - MST Algorithm\n", job->job_id);
+        AlgorithmParams params = job_stage_params(job, ALGO_MST);
+        printf("[Stage 1] Processing Job %d - MST Algorithm (%s)\n", job->job_id,
+               cost_model_variant_name(params.variant));
         
         MST_Result mst_result;
-        int success = graph_mst_prim(job->graph, &mst_result);
+        stage_counters_begin(&pc);
+        int success = graph_mst_with_params(job->graph, &params, &mst_result, &ws);
+        stage_counters_end(0, &pc, job);
+        workspace_reset(&ws);
         
         if (success && mst_result.is_connected) {
             snprintf(job->mst_result, sizeof(job->mst_result),
-                     "MST: Weight=%d, Edges=%d", 
+                     "MST: Weight=%lld, Edges=%d", 
                      mst_result.total_weight, mst_result.num_edges);
             mst_result_free(&mst_result);
         } else {
@@ -142,6 +219,8 @@ void* stage1_mst_worker(void *arg) {
         queue_push(&stage2_queue, job);
     }
     
+    stage_counters_close(&pc);
+    workspace_destroy(&ws);
     printf("[Stage 1] MST worker shutting down\n");
     return NULL;
 }
@@ -150,19 +229,33 @@ void* stage1_mst_worker(void *arg) {
 void* stage2_maxflow_worker(void *arg) {
     printf("[Stage 2] MaxFlow worker started\n");
     
+    PerfCounters pc;
+    stage_counters_open(1, &pc);
+    AlgorithmWorkspace ws;     // Scratch memory reused by every job of this stage
+    workspace_init(&ws, 0);
+    
     while (!shutdown_flag) {
         Job* job = queue_pop(&stage2_queue);
         if (!job) continue;
         
-        printf("[Stage 2] Processing Job %d - MaxFlow Algorithm\n", job->job_id);
+        AlgorithmParams params = job_stage_params(job, ALGO_MAX_FLOW);
+        printf("[Stage 2] Processing Job %d - MaxFlow Algorithm (%s)\n", job->job_id,
+               cost_model_variant_name(params.variant));
         
-        int flow_value;
-        int success = graph_max_flow_default(job->graph, &flow_value);
+        long long flow_value;
+        int source, sink;
+        int success = 0;
+        stage_counters_begin(&pc);
+        if (algorithm_params_flow_endpoints(&params, job->graph->n, &source, &sink)) {
+            success = graph_max_flow_with_params(job->graph, &params, &flow_value, &ws);
+        }
+        stage_counters_end(1, &pc, job);
+        workspace_reset(&ws);
         
         if (success) {
             snprintf(job->maxflow_result, sizeof(job->maxflow_result),
-                     "MaxFlow: Value=%d (source=0, sink=%d)", 
-                     flow_value, job->graph->n - 1);
+                     "MaxFlow: Value=%lld (source=%d, sink=%d)", 
+                     flow_value, source, sink);
         } else {
             snprintf(job->maxflow_result, sizeof(job->maxflow_result),
                      "MaxFlow: Calculation failed");
@@ -174,6 +267,8 @@ void* stage2_maxflow_worker(void *arg) {
         queue_push(&stage3_queue, job);
     }
     
+    stage_counters_close(&pc);
+    workspace_destroy(&ws);
     printf("[Stage 2] MaxFlow worker shutting down\n");
     return NULL;
 }
@@ -182,18 +277,30 @@ void* stage2_maxflow_worker(void *arg) {
 void* stage3_maxclique_worker(void *arg) {
     printf("[Stage 3] MaxClique worker started\n");
     
+    PerfCounters pc;
+    stage_counters_open(2, &pc);
+    AlgorithmWorkspace ws;     // Scratch memory reused by every job of this stage
+    workspace_init(&ws, 0);
+    
     while (!shutdown_flag) {
         Job* job = queue_pop(&stage3_queue);
         if (!job) continue;
         
-        printf("[Stage 3] Processing Job %d - MaxClique Algorithm\n", job->job_id);
+        AlgorithmParams params = job_stage_params(job, ALGO_MAX_CLIQUE);
+        printf("[Stage 3] Processing Job %d - MaxClique Algorithm (%s)\n", job->job_id,
+               cost_model_variant_name(params.variant));
         
-        int clique_size;
-        int success = graph_max_clique_size(job->graph, &clique_size);
+        MaxClique_Result clique;
+        stage_counters_begin(&pc);
+        int success = graph_max_clique_with_params(job->graph, &params, &clique, &ws);
+        stage_counters_end(2, &pc, job);
+        workspace_reset(&ws);
         
-        if (success) {
+        if (success && clique.is_valid) {
             snprintf(job->maxclique_result, sizeof(job->maxclique_result),
-                     "MaxClique: Size=%d", clique_size);
+                     "MaxClique: Size=%d%s", clique.size,
+                     clique.timed_out ? " (time budget exceeded)" : "");
+            maxclique_result_free(&clique);
         } else {
             snprintf(job->maxclique_result, sizeof(job->maxclique_result),
                      "MaxClique: Calculation failed");
@@ -205,6 +312,8 @@ void* stage3_maxclique_worker(void *arg) {
         queue_push(&stage4_queue, job);
     }
     
+    stage_counters_close(&pc);
+    workspace_destroy(&ws);
     printf("[Stage 3] MaxClique worker shutting down\n");
     return NULL;
 }
@@ -213,18 +322,34 @@ void* stage3_maxclique_worker(void *arg) {
 void* stage4_cliquecount_worker(void *arg) {
     printf("[Stage 4] CliqueCount worker started\n");
     
+    PerfCounters pc;
+    stage_counters_open(3, &pc);
+    AlgorithmWorkspace ws;     // Scratch memory reused by every job of this stage
+    workspace_init(&ws, 0);
+    
     while (!shutdown_flag) {
         Job* job = queue_pop(&stage4_queue);
         if (!job) continue;
         
         printf("[Stage 4] Processing Job %d - CliqueCount Algorithm\n", job->job_id);
         
-        int total_cliques;
-        int success = graph_total_clique_count(job->graph, &total_cliques);
+        CliqueCount_Result counts;
+        stage_counters_begin(&pc);
+        int success = graph_count_cliques_with_params(job->graph, &job->params, &counts, &ws);
+        stage_counters_end(3, &pc, job);
+        workspace_reset(&ws);
         
-        if (success) {
-            snprintf(job->cliquecount_result, sizeof(job->cliquecount_result),
-                     "CliqueCount: Total=%d", total_cliques);
+        if (success && counts.is_valid) {
+            const char* partial = counts.timed_out ? " (time budget exceeded)" : "";
+            if (job->params.clique_size > 0) {
+                snprintf(job->cliquecount_result, sizeof(job->cliquecount_result),
+                         "CliqueCount: Size%d=%lld%s", job->params.clique_size,
+                         counts.total_cliques, partial);
+            } else {
+                snprintf(job->cliquecount_result, sizeof(job->cliquecount_result),
+                         "CliqueCount: Total=%lld%s", counts.total_cliques, partial);
+            }
+            clique_count_result_free(&counts);
         } else {
             snprintf(job->cliquecount_result, sizeof(job->cliquecount_result),
                      "CliqueCount: Calculation failed");
@@ -251,6 +376,19 @@ void* stage4_cliquecount_worker(void *arg) {
                  job->mst_result, job->maxflow_result, 
                  job->maxclique_result, job->cliquecount_result);
         
+        // Append per-stage hardware counters when instrumentation is enabled
+        if (hw_counters_enabled) {
+            size_t off = strlen(job->final_response);
+            off += snprintf(job->final_response + off, sizeof(job->final_response) - off,
+                            "=== STAGE COUNTERS ===\n");
+            for (int i = 0; i < NUM_STAGES && off < sizeof(job->final_response); i++) {
+                char line[256];
+                perf_sample_format(&job->stage_perf[i], line, sizeof(line));
+                off += snprintf(job->final_response + off, sizeof(job->final_response) - off,
+                                "Stage %d (%s): %s\n", i + 1, stage_names[i], line);
+            }
+        }
+        
         // Send response to client
         printf("[Stage 4] Sending response to client for Job %d\n", job->job_id);
         send(job->client_sock, job->final_response, strlen(job->final_response), 0);
@@ -263,6 +401,8 @@ void* stage4_cliquecount_worker(void *arg) {
 
     }
     
+    stage_counters_close(&pc);
+    workspace_destroy(&ws);
     printf("[Stage 4] CliqueCount worker shutting down\n");
     return NULL;
 }
@@ -287,6 +427,23 @@ void* handle_client_request(void *arg) {
     int max_weight = header[1];
     int vertices = header[2];
     
+    // Optional parameter block follows the header when flagged on the vertex count
+    AlgorithmParams params;
+    algorithm_params_init(&params);
+    if (vertices > 0 && (vertices & ALGO_PARAMS_FLAG)) {
+        int words[ALGO_PARAMS_WIRE_INTS];
+        if (recv(client_sock, words, sizeof(words), MSG_WAITALL) != (ssize_t)sizeof(words)) {
+            printf("[Client] Failed to receive parameter block\n");
+            close(client_sock);
+            return NULL;
+        }
+        algorithm_params_decode(&params, words);
+        vertices &= ~ALGO_PARAMS_FLAG;
+        printf("[Client] Parameters - Source: %d, Sink: %d, K: %d, Budget: %dms, Threads: %d\n",
+               params.source, params.sink, params.clique_size,
+               params.time_budget_ms, params.num_threads);
+    }
+    
     printf("[Client] Header received - Seed: %d, MaxWeight: %d, Vertices: %d\n", 
            seed, max_weight, vertices);
     
@@ -342,6 +499,11 @@ void* handle_client_request(void *arg) {
     pthread_mutex_unlock(&job_id_mutex);
     
     job->graph = graph;
+    job->params = params;
+    if (graph_profile_compute(graph, &job->profile)) {
+        printf("[Client] ");
+        graph_profile_print(&job->profile);
+    }
     job->client_sock = client_sock;
     job->start_time = time(NULL);
     
@@ -366,13 +528,25 @@ void signal_handler(int sig) {
 }
 
 // === Main Server ===
-int main() {
+int main(int argc, char *argv[]) {
+    int flag;
+    while ((flag = getopt(argc, argv, "H")) != -1) {
+        switch (flag) {
+            case 'H': hw_counters_enabled = 1; break;
+            default:
+                fprintf(stderr, "Usage: %s [-H]\n", argv[0]);
+                fprintf(stderr, "  -H  record per-stage hardware performance counters\n");
+                return 1;
+        }
+    }
+    
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
     
     printf("=== Pipeline Pattern Graph Algorithm Server ===\n");
     printf("Using 4-stage pipeline: MST → MaxFlow → MaxClique → CliqueCount\n");
     printf("Listening on port %d\n", PORT);
+    if (hw_counters_enabled) printf("Per-stage hardware counters: enabled\n");
     
     // Initialize pipeline queues
     queue_init(&stage1_queue, "MST_Queue");
@@ -450,6 +624,7 @@ int main() {
     pthread_join(stage4_thread, NULL);
     
     close(server_fd);
+    print_stage_metrics();
     printf("[Main] Pipeline server shutdown complete\n");
     
     return 0;